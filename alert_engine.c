@@ -0,0 +1,438 @@
+/*
+ * Smart Stock Tracker - Alert Engine
+ * Price and move alerts indexed by sorted threshold books
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * Every symbol has two books of alert levels sorted ascending: price levels
+ * for "crosses" rules and percent levels for "moves" rules. Rules for any
+ * symbol live in two shared books. A quote update remembers the previous
+ * price and |change|; the levels crossed since then form one contiguous run
+ * of each book, found with two binary searches. A check costs
+ * O(log r + hits) whatever the number of rules.
+ */
+
+#include "stock_tracker.h"
+#include <math.h>
+#include <time.h>
+
+#define ALERT_NO_KEY (~0ULL)   // Empty slot in the firing table
+
+// First index whose level is >= value
+static int lower_bound(const double* levels, int count, double value) {
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (levels[mid] < value) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// First index whose level is > value
+static int upper_bound(const double* levels, int count, double value) {
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (levels[mid] <= value) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// =============================================================================
+// THRESHOLD BOOKS
+// =============================================================================
+
+static int book_insert(AlertBook* book, double level, int rule) {
+    if (book->count == book->capacity) {
+        int new_capacity = book->capacity ? book->capacity * 2 : 4;
+        double* levels = realloc(book->levels, (size_t)new_capacity * sizeof(double));
+        if (!levels) return 0;
+        book->levels = levels;
+        int* rules = realloc(book->rules, (size_t)new_capacity * sizeof(int));
+        if (!rules) return 0;
+        book->rules = rules;
+        book->capacity = new_capacity;
+    }
+
+    // Equal levels keep insertion order
+    int pos = upper_bound(book->levels, book->count, level);
+    int tail = book->count - pos;
+    memmove(&book->levels[pos + 1], &book->levels[pos], (size_t)tail * sizeof(double));
+    memmove(&book->rules[pos + 1], &book->rules[pos], (size_t)tail * sizeof(int));
+    book->levels[pos] = level;
+    book->rules[pos] = rule;
+    book->count++;
+    return 1;
+}
+
+static int book_remove(AlertBook* book, double level, int rule) {
+    for (int pos = lower_bound(book->levels, book->count, level);
+         pos < book->count && book->levels[pos] == level; pos++) {
+        if (book->rules[pos] == rule) {
+            int tail = book->count - pos - 1;
+            memmove(&book->levels[pos], &book->levels[pos + 1], (size_t)tail * sizeof(double));
+            memmove(&book->rules[pos], &book->rules[pos + 1], (size_t)tail * sizeof(int));
+            book->count--;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void book_free(AlertBook* book) {
+    free(book->levels);
+    free(book->rules);
+    memset(book, 0, sizeof(*book));
+}
+
+// =============================================================================
+// DEDUPLICATION AND RATE LIMITING
+// =============================================================================
+
+static unsigned long long fire_key(int rule, int symbol_id) {
+    return ((unsigned long long)(unsigned int)rule << 32) | (unsigned int)symbol_id;
+}
+
+static int fire_slot(const AlertEngine* engine, unsigned long long key) {
+    unsigned long long h = key * 0x9E3779B97F4A7C15ULL;
+    int mask = engine->fired_capacity - 1;
+    int pos = (int)(h >> 32) & mask;
+    while (engine->fired_keys[pos] != ALERT_NO_KEY && engine->fired_keys[pos] != key) {
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+static int fired_rehash(AlertEngine* engine, int new_capacity) {
+    unsigned long long* keys = malloc((size_t)new_capacity * sizeof(unsigned long long));
+    long long* times = malloc((size_t)new_capacity * sizeof(long long));
+    if (!keys || !times) {
+        free(keys);
+        free(times);
+        return 0;
+    }
+    for (int i = 0; i < new_capacity; i++) {
+        keys[i] = ALERT_NO_KEY;
+    }
+
+    unsigned long long* old_keys = engine->fired_keys;
+    long long* old_times = engine->fired_times;
+    int old_capacity = engine->fired_capacity;
+    engine->fired_keys = keys;
+    engine->fired_times = times;
+    engine->fired_capacity = new_capacity;
+
+    for (int i = 0; i < old_capacity; i++) {
+        if (old_keys[i] != ALERT_NO_KEY) {
+            int pos = fire_slot(engine, old_keys[i]);
+            keys[pos] = old_keys[i];
+            times[pos] = old_times[i];
+        }
+    }
+    free(old_keys);
+    free(old_times);
+    return 1;
+}
+
+// Drop a firing already delivered within the dedup window
+static int is_duplicate(const AlertEngine* engine, int rule, int symbol_id, long long now) {
+    int pos = fire_slot(engine, fire_key(rule, symbol_id));
+    return engine->fired_keys[pos] != ALERT_NO_KEY &&
+           now - engine->fired_times[pos] < ALERT_DEDUP_SECONDS;
+}
+
+static void remember_firing(AlertEngine* engine, int rule, int symbol_id, long long now) {
+    if ((engine->fired_count + 1) * 2 > engine->fired_capacity &&
+        !fired_rehash(engine, engine->fired_capacity * 2)) {
+        return;
+    }
+    unsigned long long key = fire_key(rule, symbol_id);
+    int pos = fire_slot(engine, key);
+    if (engine->fired_keys[pos] == ALERT_NO_KEY) {
+        engine->fired_keys[pos] = key;
+        engine->fired_count++;
+    }
+    engine->fired_times[pos] = now;
+}
+
+// Token bucket shared by every rule: ALERT_RATE_PER_MINUTE, bursts of ALERT_BURST
+static int take_token(AlertEngine* engine, long long now) {
+    if (now > engine->token_time) {
+        engine->tokens += (now - engine->token_time) * (ALERT_RATE_PER_MINUTE / 60.0);
+        if (engine->tokens > ALERT_BURST) {
+            engine->tokens = ALERT_BURST;
+        }
+        engine->token_time = now;
+    }
+    if (engine->tokens < 1.0) {
+        return 0;
+    }
+    engine->tokens -= 1.0;
+    return 1;
+}
+
+// =============================================================================
+// DELIVERY
+// =============================================================================
+
+static int fire(AlertEngine* engine, int rule_id, int symbol_id, const Stock* stock,
+                int direction, long long now) {
+    const AlertRule* rule = &engine->rules[rule_id];
+    if (is_duplicate(engine, rule_id, symbol_id, now) || !take_token(engine, now)) {
+        engine->suppressed++;
+        metrics_increment(METRIC_ALERT_SUPPRESSED);
+        return 0;
+    }
+    remember_firing(engine, rule_id, symbol_id, now);
+
+    AlertEvent* event = &engine->recent[engine->recent_next];
+    engine->recent_next = (engine->recent_next + 1) % ALERT_RECENT_EVENTS;
+    if (engine->recent_count < ALERT_RECENT_EVENTS) {
+        engine->recent_count++;
+    }
+    event->rule = rule_id;
+    event->kind = rule->kind;
+    event->direction = direction;
+    event->threshold = rule->threshold;
+    event->price = stock->current_price;
+    event->change_percent = stock->change_percent;
+    event->time = now;
+    strcpy(event->symbol, stock->symbol);
+
+    char message[LOG_RECORD_SIZE];
+    if (rule->kind == ALERT_CROSSES) {
+        snprintf(message, sizeof(message), "🔔 ALERT #%d: crossed %s %.2f",
+                 rule_id, direction > 0 ? "above" : "below", rule->threshold);
+    } else {
+        snprintf(message, sizeof(message), "🔔 ALERT #%d: moved more than %.2f%%",
+                 rule_id, rule->threshold);
+    }
+    log_trading_activity(message, (Stock*)stock);
+
+    engine->fired++;
+    metrics_increment(METRIC_ALERT_FIRED);
+    return 1;
+}
+
+// Fire the price levels between the previous and the new price
+static int check_crossings(AlertEngine* engine, const AlertBook* book, int symbol_id,
+                           const Stock* stock, double previous, double price, long long now) {
+    if (book->count == 0 || previous == price) {
+        return 0;
+    }
+    int fired = 0;
+    if (price > previous) {
+        // Rising: previous < level <= price
+        int end = upper_bound(book->levels, book->count, price);
+        for (int i = upper_bound(book->levels, book->count, previous); i < end; i++) {
+            fired += fire(engine, book->rules[i], symbol_id, stock, 1, now);
+        }
+    } else {
+        // Falling: price <= level < previous, nearest level first
+        int begin = lower_bound(book->levels, book->count, price);
+        for (int i = lower_bound(book->levels, book->count, previous) - 1; i >= begin; i--) {
+            fired += fire(engine, book->rules[i], symbol_id, stock, -1, now);
+        }
+    }
+    return fired;
+}
+
+// Fire the move levels |change| rose past since the previous update
+static int check_moves(AlertEngine* engine, const AlertBook* book, int symbol_id,
+                       const Stock* stock, double previous, double move, long long now) {
+    if (book->count == 0 || move <= previous) {
+        return 0;
+    }
+    // previous <= level < move
+    int fired = 0;
+    int direction = stock->change_percent >= 0 ? 1 : -1;
+    int end = lower_bound(book->levels, book->count, move);
+    for (int i = lower_bound(book->levels, book->count, previous); i < end; i++) {
+        fired += fire(engine, book->rules[i], symbol_id, stock, direction, now);
+    }
+    return fired;
+}
+
+// =============================================================================
+// ENGINE
+// =============================================================================
+
+// Grow the per-symbol arrays to cover symbol id
+static int ensure_symbol(AlertEngine* engine, int id) {
+    if (id < engine->symbol_capacity) {
+        return 1;
+    }
+    int new_capacity = engine->symbol_capacity ? engine->symbol_capacity : 64;
+    while (new_capacity <= id) {
+        new_capacity *= 2;
+    }
+
+    AlertBook* crosses = realloc(engine->crosses, (size_t)new_capacity * sizeof(AlertBook));
+    if (!crosses) return 0;
+    engine->crosses = crosses;
+    AlertBook* moves = realloc(engine->moves, (size_t)new_capacity * sizeof(AlertBook));
+    if (!moves) return 0;
+    engine->moves = moves;
+    AlertSymbolState* state = realloc(engine->state, (size_t)new_capacity * sizeof(AlertSymbolState));
+    if (!state) return 0;
+    engine->state = state;
+
+    size_t added = (size_t)(new_capacity - engine->symbol_capacity);
+    memset(&crosses[engine->symbol_capacity], 0, added * sizeof(AlertBook));
+    memset(&moves[engine->symbol_capacity], 0, added * sizeof(AlertBook));
+    memset(&state[engine->symbol_capacity], 0, added * sizeof(AlertSymbolState));
+    engine->symbol_capacity = new_capacity;
+    return 1;
+}
+
+static AlertBook* rule_book(AlertEngine* engine, AlertKind kind, int symbol_id) {
+    if (symbol_id < 0) {
+        return kind == ALERT_CROSSES ? &engine->any_crosses : &engine->any_moves;
+    }
+    return kind == ALERT_CROSSES ? &engine->crosses[symbol_id] : &engine->moves[symbol_id];
+}
+
+// Initialize an empty engine
+int alert_engine_init(AlertEngine* engine) {
+    if (!engine) {
+        return 0;
+    }
+    memset(engine, 0, sizeof(*engine));
+    engine->tokens = ALERT_BURST;
+    if (!symbol_map_init(&engine->symbols, 64) || !fired_rehash(engine, 64)) {
+        alert_engine_free(engine);
+        return 0;
+    }
+    return 1;
+}
+
+// Release the engine's memory
+void alert_engine_free(AlertEngine* engine) {
+    if (!engine) {
+        return;
+    }
+    for (int i = 0; i < engine->symbol_capacity; i++) {
+        book_free(&engine->crosses[i]);
+        book_free(&engine->moves[i]);
+    }
+    book_free(&engine->any_crosses);
+    book_free(&engine->any_moves);
+    free(engine->crosses);
+    free(engine->moves);
+    free(engine->state);
+    free(engine->rules);
+    free(engine->fired_keys);
+    free(engine->fired_times);
+    symbol_map_free(&engine->symbols);
+    memset(engine, 0, sizeof(*engine));
+}
+
+// Add a rule; symbol NULL or "*" matches every symbol. Returns the rule id or -1.
+int alert_engine_add(AlertEngine* engine, const char* symbol, AlertKind kind, double threshold) {
+    if (!engine || !(threshold > 0) || (kind != ALERT_CROSSES && kind != ALERT_MOVES)) {
+        return -1;
+    }
+
+    int symbol_id = -1;
+    if (symbol && strcmp(symbol, "*") != 0) {
+        symbol_id = symbol_map_insert(&engine->symbols, symbol);
+        if (symbol_id < 0 || !ensure_symbol(engine, symbol_id)) {
+            return -1;
+        }
+    }
+
+    if (engine->rule_count == engine->rule_capacity) {
+        int new_capacity = engine->rule_capacity ? engine->rule_capacity * 2 : 64;
+        AlertRule* rules = realloc(engine->rules, (size_t)new_capacity * sizeof(AlertRule));
+        if (!rules) {
+            return -1;
+        }
+        engine->rules = rules;
+        engine->rule_capacity = new_capacity;
+    }
+
+    int id = engine->rule_count;
+    if (!book_insert(rule_book(engine, kind, symbol_id), threshold, id)) {
+        return -1;
+    }
+    AlertRule* rule = &engine->rules[id];
+    rule->kind = kind;
+    rule->symbol_id = symbol_id;
+    rule->threshold = threshold;
+    rule->active = 1;
+    engine->rule_count++;
+    engine->active_rules++;
+    return id;
+}
+
+// Remove a rule; its id is not reused
+int alert_engine_remove(AlertEngine* engine, int rule_id) {
+    if (!engine || rule_id < 0 || rule_id >= engine->rule_count || !engine->rules[rule_id].active) {
+        return 0;
+    }
+    AlertRule* rule = &engine->rules[rule_id];
+    book_remove(rule_book(engine, rule->kind, rule->symbol_id), rule->threshold, rule_id);
+    rule->active = 0;
+    engine->active_rules--;
+    return 1;
+}
+
+// Check one quote update against the rules; returns the number of alerts delivered
+int alert_engine_check(AlertEngine* engine, const Stock* stock) {
+    if (!engine || !stock || engine->active_rules == 0 || stock->current_price <= 0) {
+        return 0;
+    }
+
+    // Symbols without rules of their own are still tracked for the any-symbol books
+    int id = symbol_map_insert(&engine->symbols, stock->symbol);
+    if (id < 0 || !ensure_symbol(engine, id)) {
+        return 0;
+    }
+
+    AlertSymbolState* state = &engine->state[id];
+    double price = stock->current_price;
+    double move = fabs(stock->change_percent);
+    double previous_move = state->seen ? state->move : 0.0;
+    long long now = stock->last_update > 0 ? (long long)stock->last_update : (long long)time(NULL);
+
+    int fired = 0;
+    if (state->seen) {
+        fired += check_crossings(engine, &engine->crosses[id], id, stock, state->price, price, now);
+        fired += check_crossings(engine, &engine->any_crosses, id, stock, state->price, price, now);
+    }
+    fired += check_moves(engine, &engine->moves[id], id, stock, previous_move, move, now);
+    fired += check_moves(engine, &engine->any_moves, id, stock, previous_move, move, now);
+
+    state->price = price;
+    state->move = move;
+    state->seen = 1;
+    return fired;
+}
+
+// Copy up to max recent alerts, newest first; returns the number copied
+int alert_engine_recent(const AlertEngine* engine, AlertEvent events[], int max_count) {
+    if (!engine || !events) {
+        return 0;
+    }
+    int count = engine->recent_count < max_count ? engine->recent_count : max_count;
+    for (int i = 0; i < count; i++) {
+        int slot = (engine->recent_next - 1 - i + ALERT_RECENT_EVENTS) % ALERT_RECENT_EVENTS;
+        events[i] = engine->recent[slot];
+    }
+    return count;
+}
+
+// Parse "crosses" / "moves"
+int parse_alert_kind(const char* text, AlertKind* kind) {
+    if (strcmp(text, "crosses") == 0) {
+        *kind = ALERT_CROSSES;
+        return 1;
+    }
+    if (strcmp(text, "moves") == 0) {
+        *kind = ALERT_MOVES;
+        return 1;
+    }
+    return 0;
+}
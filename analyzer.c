@@ -6,32 +6,242 @@
  */
 
 #include "stock_tracker.h"
+#include <math.h>
+#include <stddef.h>
+
+// Display labels, indexed by StockStatus
+static const char* STATUS_LABELS[] = {
+    "🔴 AVOID", "📉 BEARISH", "🟡 WATCH", "⚪ NEUTRAL",
+    "🟢 POSITIVE", "📈 BULLISH", "🚀 STRONG BUY", "❌ INVALID", "FETCHING"
+};
+
+// Display strings, indexed by Recommendation
+static const char* RECOMMENDATION_LABELS[] = {
+    "STRONG SELL - Major decline, exit immediately",
+    "SELL - Significant decline, limit losses",
+    "WATCH - Declining, consider exit strategy",
+    "HOLD - Minimal movement, watch closely",
+    "HOLD - Slight upward movement",
+    "BUY - Positive trend with good volume",
+    "STRONG BUY - High momentum with strong volume",
+    "INVALID DATA"
+};
+
+// Rule parameters used by the live classifiers
+static RuleParams active_rules = {
+    STRONG_BUY_THRESHOLD, BUY_THRESHOLD, SELL_THRESHOLD, STRONG_SELL_THRESHOLD,
+    RECOMMEND_STRONG_BUY_CHANGE, RECOMMEND_STRONG_BUY_VOLUME,
+    RECOMMEND_BUY_CHANGE, RECOMMEND_BUY_VOLUME,
+    RECOMMEND_HOLD_UP_CHANGE, RECOMMEND_HOLD_FLAT_CHANGE,
+    RECOMMEND_WATCH_CHANGE, RECOMMEND_SELL_CHANGE
+};
+
+// active_rules compiled into threshold tables (kept in sync by rule_params_set_active)
+static CompiledRules active_compiled = {
+    {STRONG_SELL_THRESHOLD, SELL_THRESHOLD, 0.0},
+    {0.0, BUY_THRESHOLD, STRONG_BUY_THRESHOLD},
+    {RECOMMEND_SELL_CHANGE, RECOMMEND_WATCH_CHANGE, RECOMMEND_HOLD_FLAT_CHANGE,
+     RECOMMEND_HOLD_UP_CHANGE, RECOMMEND_BUY_CHANGE, RECOMMEND_STRONG_BUY_CHANGE},
+    RECOMMEND_STRONG_BUY_VOLUME, RECOMMEND_BUY_VOLUME
+};
+
+// Parameter names accepted by rule_params_set_field() and config files
+static const struct {
+    const char* name;
+    size_t offset;
+} RULE_FIELDS[] = {
+    {"strong_buy_threshold", offsetof(RuleParams, strong_buy_threshold)},
+    {"buy_threshold", offsetof(RuleParams, buy_threshold)},
+    {"sell_threshold", offsetof(RuleParams, sell_threshold)},
+    {"strong_sell_threshold", offsetof(RuleParams, strong_sell_threshold)},
+    {"strong_buy_change", offsetof(RuleParams, strong_buy_change)},
+    {"strong_buy_volume", offsetof(RuleParams, strong_buy_volume)},
+    {"buy_change", offsetof(RuleParams, buy_change)},
+    {"buy_volume", offsetof(RuleParams, buy_volume)},
+    {"hold_up_change", offsetof(RuleParams, hold_up_change)},
+    {"hold_flat_change", offsetof(RuleParams, hold_flat_change)},
+    {"watch_change", offsetof(RuleParams, watch_change)},
+    {"sell_change", offsetof(RuleParams, sell_change)}
+};
+
+#define RULE_FIELD_COUNT (int)(sizeof(RULE_FIELDS) / sizeof(RULE_FIELDS[0]))
+
+// Fill rule parameters with the compiled-in defaults
+void rule_params_default(RuleParams* params) {
+    if (!params) {
+        return;
+    }
+    params->strong_buy_threshold = STRONG_BUY_THRESHOLD;
+    params->buy_threshold = BUY_THRESHOLD;
+    params->sell_threshold = SELL_THRESHOLD;
+    params->strong_sell_threshold = STRONG_SELL_THRESHOLD;
+    params->strong_buy_change = RECOMMEND_STRONG_BUY_CHANGE;
+    params->strong_buy_volume = RECOMMEND_STRONG_BUY_VOLUME;
+    params->buy_change = RECOMMEND_BUY_CHANGE;
+    params->buy_volume = RECOMMEND_BUY_VOLUME;
+    params->hold_up_change = RECOMMEND_HOLD_UP_CHANGE;
+    params->hold_flat_change = RECOMMEND_HOLD_FLAT_CHANGE;
+    params->watch_change = RECOMMEND_WATCH_CHANGE;
+    params->sell_change = RECOMMEND_SELL_CHANGE;
+}
+
+// Set one parameter by name
+int rule_params_set_field(RuleParams* params, const char* name, double value) {
+    if (!params || !name) {
+        return 0;
+    }
+    for (int i = 0; i < RULE_FIELD_COUNT; i++) {
+        if (strcmp(RULE_FIELDS[i].name, name) == 0) {
+            *(double*)((char*)params + RULE_FIELDS[i].offset) = value;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Read one parameter by name
+int rule_params_get_field(const RuleParams* params, const char* name, double* value) {
+    if (!params || !name || !value) {
+        return 0;
+    }
+    for (int i = 0; i < RULE_FIELD_COUNT; i++) {
+        if (strcmp(RULE_FIELDS[i].name, name) == 0) {
+            *value = *(const double*)((const char*)params + RULE_FIELDS[i].offset);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Check that the thresholds are ordered so every band is reachable
+int rule_params_validate(const RuleParams* params) {
+    if (!params) {
+        return 0;
+    }
+    return params->strong_buy_threshold >= params->buy_threshold &&
+           params->buy_threshold > 0 &&
+           params->sell_threshold < 0 &&
+           params->sell_threshold >= params->strong_sell_threshold &&
+           params->strong_buy_change >= params->buy_change &&
+           params->buy_change >= params->hold_up_change &&
+           params->hold_up_change >= params->hold_flat_change &&
+           params->hold_flat_change >= params->watch_change &&
+           params->watch_change >= params->sell_change &&
+           params->strong_buy_volume >= 0 && params->buy_volume >= 0;
+}
+
+// Rule parameters used by the live classifiers
+const RuleParams* rule_params_active() {
+    return &active_rules;
+}
+
+// Compile rule parameters into ascending threshold tables
+int rule_params_compile(const RuleParams* params, CompiledRules* compiled) {
+    if (!compiled || !rule_params_validate(params)) {
+        return 0;
+    }
+    // Status: one step up for each cut the change clears, so the
+    // bucket index is the StockStatus code (AVOID = 0 ... STRONG BUY = 6)
+    compiled->status_above[0] = params->strong_sell_threshold;
+    compiled->status_above[1] = params->sell_threshold;
+    compiled->status_above[2] = 0.0;
+    compiled->status_at_least[0] = 0.0;
+    compiled->status_at_least[1] = params->buy_threshold;
+    compiled->status_at_least[2] = params->strong_buy_threshold;
+
+    // Recommendation: change bucket, then volume demotes BUY / STRONG BUY
+    compiled->recommend_at_least[0] = params->sell_change;
+    compiled->recommend_at_least[1] = params->watch_change;
+    compiled->recommend_at_least[2] = params->hold_flat_change;
+    compiled->recommend_at_least[3] = params->hold_up_change;
+    compiled->recommend_at_least[4] = params->buy_change;
+    compiled->recommend_at_least[5] = params->strong_buy_change;
+    compiled->strong_buy_volume = params->strong_buy_volume;
+    compiled->buy_volume = params->buy_volume;
+    return 1;
+}
+
+// Replace the live rule parameters (call before worker threads start)
+int rule_params_set_active(const RuleParams* params) {
+    CompiledRules compiled;
+    if (!rule_params_compile(params, &compiled)) {
+        return 0;
+    }
+    active_rules = *params;
+    active_compiled = compiled;
+    return 1;
+}
+
+// Compiled form of the live rule parameters
+const CompiledRules* compiled_rules_active() {
+    return &active_compiled;
+}
+
+// Bucket search without branches: count the cuts the change clears
+static inline int status_code(const CompiledRules* rules, double price, double change) {
+    int code = 0;
+    for (int k = 0; k < RULE_STATUS_CUTS; k++) {
+        code += change > rules->status_above[k];
+        code += change >= rules->status_at_least[k];
+    }
+    return price > 0 ? code : STATUS_INVALID;
+}
+
+static inline int recommendation_code(const CompiledRules* rules, double price, double change, double volume) {
+    int code = 0;
+    for (int k = 0; k < RULE_RECOMMEND_CUTS; k++) {
+        code += change >= rules->recommend_at_least[k];
+    }
+    // Without the volume, STRONG BUY falls to BUY and BUY falls to HOLD
+    code -= (code == RECOMMEND_STRONG_BUY) & !(volume > rules->strong_buy_volume);
+    code -= (code == RECOMMEND_BUY) & !(volume > rules->buy_volume);
+    return price > 0 ? code : RECOMMEND_INVALID;
+}
+
+// Classify a stock's performance under the given rules (pure, thread-safe)
+StockStatus classify_status_with(const Stock* stock, const CompiledRules* rules) {
+    if (!stock) {
+        return STATUS_INVALID;
+    }
+    return (StockStatus)status_code(rules, stock->current_price, stock->change_percent);
+}
+
+// Classify a stock's performance under the live rules
+StockStatus classify_status(const Stock* stock) {
+    return classify_status_with(stock, &active_compiled);
+}
+
+// Classify a whole column of quotes. Same bucket search as status_code(),
+// written with double-valued steps and blends so GCC if-converts and
+// vectorizes it (integer-valued comparisons of doubles defeat the vectorizer)
+void classify_status_column(const CompiledRules* rules, const double* restrict prices,
+                            const double* restrict changes, int count, unsigned char* restrict codes) {
+    double above0 = rules->status_above[0], above1 = rules->status_above[1], above2 = rules->status_above[2];
+    double least0 = rules->status_at_least[0], least1 = rules->status_at_least[1], least2 = rules->status_at_least[2];
+    for (int i = 0; i < count; i++) {
+        double change = changes[i];
+        double code = (change > above0 ? 1.0 : 0.0) + (change > above1 ? 1.0 : 0.0)
+                    + (change > above2 ? 1.0 : 0.0) + (change >= least0 ? 1.0 : 0.0)
+                    + (change >= least1 ? 1.0 : 0.0) + (change >= least2 ? 1.0 : 0.0);
+        double invalid = prices[i] > 0 ? 0.0 : 1.0;
+        codes[i] = (unsigned char)(int)(code + invalid * (STATUS_INVALID - code));
+    }
+}
+
+// Display label for a status code
+const char* stock_status_label(StockStatus status) {
+    if (status < 0 || status > STATUS_PENDING) {
+        status = STATUS_INVALID;
+    }
+    return STATUS_LABELS[status];
+}
 
 // Analyze individual stock performance and set status
 void analyze_stock_performance(Stock* stock) {
-    if (!stock || stock->current_price <= 0) {
-        strcpy(stock->status, "❌ INVALID");
+    if (!stock) {
         return;
     }
-    
-    double change = stock->change_percent;
-    
-    // Categorize based on performance thresholds
-    if (change >= STRONG_BUY_THRESHOLD) {
-        strcpy(stock->status, "🚀 STRONG BUY");
-    } else if (change >= BUY_THRESHOLD) {
-        strcpy(stock->status, "📈 BULLISH");
-    } else if (change > 0) {
-        strcpy(stock->status, "🟢 POSITIVE");
-    } else if (change == 0) {
-        strcpy(stock->status, "⚪ NEUTRAL");
-    } else if (change > SELL_THRESHOLD) {
-        strcpy(stock->status, "🟡 WATCH");
-    } else if (change > STRONG_SELL_THRESHOLD) {
-        strcpy(stock->status, "📉 BEARISH");
-    } else {
-        strcpy(stock->status, "🔴 AVOID");
-    }
+    stock->status = classify_status(stock);
 }
 
 // Find the best performing stock
@@ -98,11 +308,18 @@ double calculate_total_value(Stock stocks[], int count) {
     
     double total = 0.0;
     
-    for (int i = 0; i < count; i++) {
-        if (stocks[i].current_price > 0) {
-            // Assuming 1 share of each stock for simplicity
-            total += stocks[i].current_price;
+    // Summed per ANALYSIS_CHUNK_STOCKS partition, then across partitions, so
+    // market_scan_parallel() adds in the same order and gets the same total
+    for (int begin = 0; begin < count; begin += ANALYSIS_CHUNK_STOCKS) {
+        int end = count - begin > ANALYSIS_CHUNK_STOCKS ? begin + ANALYSIS_CHUNK_STOCKS : count;
+        double chunk_total = 0.0;
+        for (int i = begin; i < end; i++) {
+            if (stocks[i].current_price > 0) {
+                // Assuming 1 share of each stock for simplicity
+                chunk_total += stocks[i].current_price;
+            }
         }
+        total += chunk_total;
     }
     
     return total;
@@ -126,36 +343,65 @@ void sort_stocks_by_performance(Stock stocks[], int count) {
     }
 }
 
-// Generate detailed recommendation
-const char* generate_recommendation(Stock* stock) {
-    if (!stock || stock->current_price <= 0) {
-        return "INVALID DATA";
+// Multi-factor recommendation under the given rules (pure, thread-safe)
+Recommendation classify_recommendation_with(const Stock* stock, const CompiledRules* rules) {
+    if (!stock) {
+        return RECOMMEND_INVALID;
     }
-    
-    double change = stock->change_percent;
-    double price = stock->current_price;
-    double volume = stock->volume;
-    
-    // Multi-factor analysis
-    static char recommendation[200];
-    
-    if (change >= 3.0 && volume > 1000000) {
-        strcpy(recommendation, "STRONG BUY - High momentum with strong volume");
-    } else if (change >= 1.0 && volume > 500000) {
-        strcpy(recommendation, "BUY - Positive trend with good volume");
-    } else if (change >= 0.5) {
-        strcpy(recommendation, "HOLD - Slight upward movement");
-    } else if (change >= -0.5) {
-        strcpy(recommendation, "HOLD - Minimal movement, watch closely");
-    } else if (change >= -2.0) {
-        strcpy(recommendation, "WATCH - Declining, consider exit strategy");
-    } else if (change >= -5.0) {
-        strcpy(recommendation, "SELL - Significant decline, limit losses");
-    } else {
-        strcpy(recommendation, "STRONG SELL - Major decline, exit immediately");
+    return (Recommendation)recommendation_code(rules, stock->current_price, stock->change_percent, stock->volume);
+}
+
+// Multi-factor recommendation under the live rules
+Recommendation classify_recommendation(const Stock* stock) {
+    return classify_recommendation_with(stock, &active_compiled);
+}
+
+// Set the status of each hot quote record
+void classify_quotes(const CompiledRules* rules, StockQuote quotes[], int count) {
+    for (int i = 0; i < count; i++) {
+        quotes[i].status = (unsigned char)status_code(rules, quotes[i].current_price, quotes[i].change_percent);
     }
-    
-    return recommendation;
+}
+
+// Classify a whole column of quotes (vectorizable form of recommendation_code())
+void classify_recommendation_column(const CompiledRules* rules, const double* restrict prices,
+                                    const double* restrict changes, const double* restrict volumes,
+                                    int count, unsigned char* restrict codes) {
+    double cut0 = rules->recommend_at_least[0], cut1 = rules->recommend_at_least[1];
+    double cut2 = rules->recommend_at_least[2], cut3 = rules->recommend_at_least[3];
+    double cut4 = rules->recommend_at_least[4], cut5 = rules->recommend_at_least[5];
+    double strong_buy_volume = rules->strong_buy_volume;
+    double buy_volume = rules->buy_volume;
+    for (int i = 0; i < count; i++) {
+        double change = changes[i];
+        double volume = volumes[i];
+        // Up to HOLD (up) from change alone, then BUY / STRONG BUY when volume confirms
+        double code = (change >= cut0 ? 1.0 : 0.0) + (change >= cut1 ? 1.0 : 0.0)
+                    + (change >= cut2 ? 1.0 : 0.0) + (change >= cut3 ? 1.0 : 0.0);
+        // Both conditions hold when the two indicators sum to 2 (a product
+        // of two selects turns back into a branch)
+        double buy = (change >= cut4 ? 1.0 : 0.0) + (volume > buy_volume ? 1.0 : 0.0);
+        double strong_buy = (change >= cut5 ? 1.0 : 0.0) + (volume > strong_buy_volume ? 1.0 : 0.0);
+        buy = buy > 1.5 ? 1.0 : 0.0;
+        strong_buy = strong_buy > 1.5 ? 1.0 : 0.0;
+        code += buy * (RECOMMEND_BUY - code);
+        code += strong_buy * (RECOMMEND_STRONG_BUY - code);
+        double invalid = prices[i] > 0 ? 0.0 : 1.0;
+        codes[i] = (unsigned char)(int)(code + invalid * (RECOMMEND_INVALID - code));
+    }
+}
+
+// Display string for a recommendation code
+const char* recommendation_label(Recommendation recommendation) {
+    if (recommendation < 0 || recommendation > RECOMMEND_INVALID) {
+        recommendation = RECOMMEND_INVALID;
+    }
+    return RECOMMENDATION_LABELS[recommendation];
+}
+
+// Generate detailed recommendation
+const char* generate_recommendation(Stock* stock) {
+    return recommendation_label(classify_recommendation(stock));
 }
 
 // Calculate moving average (simplified)
@@ -327,16 +573,144 @@ double calculate_average_change(Stock stocks[], int count) {
     double total_change = 0.0;
     int valid_stocks = 0;
     
-    for (int i = 0; i < count; i++) {
-        if (stocks[i].current_price > 0) {
-            total_change += stocks[i].change_percent;
-            valid_stocks++;
+    // Partitioned like calculate_total_value()
+    for (int begin = 0; begin < count; begin += ANALYSIS_CHUNK_STOCKS) {
+        int end = count - begin > ANALYSIS_CHUNK_STOCKS ? begin + ANALYSIS_CHUNK_STOCKS : count;
+        double chunk_change = 0.0;
+        for (int i = begin; i < end; i++) {
+            if (stocks[i].current_price > 0) {
+                chunk_change += stocks[i].change_percent;
+                valid_stocks++;
+            }
         }
+        total_change += chunk_change;
     }
     
     return (valid_stocks > 0) ? total_change / valid_stocks : 0.0;
 }
 
+// One partition's share of a market scan; same comparisons and starting
+// points as the serial functions, so ties go to the lowest index
+static void scan_partition(const Stock stocks[], int begin, int end, MarketScan* scan) {
+    memset(scan, 0, sizeof(*scan));
+    scan->best = scan->most_volatile = scan->unusual_volume = -1;
+    scan->best_change = -1000.0;
+    for (int i = begin; i < end; i++) {
+        const Stock* stock = &stocks[i];
+        if (stock->current_price <= 0) {
+            continue;
+        }
+        double change = stock->change_percent;
+        double abs_change = fabs(change);
+        if (change > scan->best_change) {
+            scan->best = i;
+            scan->best_change = change;
+        }
+        if (abs_change > scan->highest_volatility) {
+            scan->most_volatile = i;
+            scan->highest_volatility = abs_change;
+        }
+        if (stock->volume > scan->highest_volume) {
+            scan->unusual_volume = i;
+            scan->highest_volume = stock->volume;
+        }
+        scan->valid++;
+        scan->bullish += change > 0;
+        scan->sentiment_up += change > 1.0;
+        scan->sentiment_down += change < -1.0;
+        scan->change_sum += change;
+        scan->value_sum += stock->current_price;
+    }
+}
+
+// Fold a later partition into the running result
+static void combine_partition(MarketScan* into, const MarketScan* part) {
+    if (part->best >= 0 && part->best_change > into->best_change) {
+        into->best = part->best;
+        into->best_change = part->best_change;
+    }
+    if (part->most_volatile >= 0 && part->highest_volatility > into->highest_volatility) {
+        into->most_volatile = part->most_volatile;
+        into->highest_volatility = part->highest_volatility;
+    }
+    if (part->unusual_volume >= 0 && part->highest_volume > into->highest_volume) {
+        into->unusual_volume = part->unusual_volume;
+        into->highest_volume = part->highest_volume;
+    }
+    into->valid += part->valid;
+    into->bullish += part->bullish;
+    into->sentiment_up += part->sentiment_up;
+    into->sentiment_down += part->sentiment_down;
+    into->change_sum += part->change_sum;
+    into->value_sum += part->value_sum;
+}
+
+typedef struct {
+    const Stock* stocks;
+    MarketScan* partitions;   // One per ANALYSIS_CHUNK_STOCKS stocks
+} MarketScanJob;
+
+static void market_scan_task(int begin, int end, int worker, void* context) {
+    (void)worker;
+    MarketScanJob* job = (MarketScanJob*)context;
+    scan_partition(job->stocks, begin, end, &job->partitions[begin / ANALYSIS_CHUNK_STOCKS]);
+}
+
+// Every aggregate of the serial analysis functions in one partitioned pass
+int market_scan_parallel(const Stock stocks[], int count, int threads, MarketScan* scan) {
+    if (!scan) {
+        return -1;
+    }
+    scan_partition(stocks, 0, 0, scan);
+    if (!stocks || count <= 0) {
+        return 0;
+    }
+    scan->count = count;
+    int partition_count = (count + ANALYSIS_CHUNK_STOCKS - 1) / ANALYSIS_CHUNK_STOCKS;
+    MarketScanJob job = {stocks, malloc((size_t)partition_count * sizeof(MarketScan))};
+    if (!job.partitions) {
+        return -1;
+    }
+    int used = parallel_for(count, ANALYSIS_CHUNK_STOCKS, threads, market_scan_task, &job);
+
+    // Partition order, not completion order: the same result for any thread count
+    for (int p = 0; p < partition_count; p++) {
+        combine_partition(scan, &job.partitions[p]);
+    }
+    free(job.partitions);
+    return used;
+}
+
+// Same value as calculate_average_change()
+double market_scan_average_change(const MarketScan* scan) {
+    return (scan && scan->valid > 0) ? scan->change_sum / scan->valid : 0.0;
+}
+
+// Same label as analyze_market_sentiment()
+const char* market_scan_sentiment(const MarketScan* scan) {
+    if (!scan || scan->count <= 0) {
+        return "UNKNOWN";
+    }
+    int bullish = scan->sentiment_up, bearish = scan->sentiment_down;
+    int neutral = scan->valid - bullish - bearish;
+    if (bullish > bearish && bullish > neutral) {
+        return "🟢 BULLISH MARKET";
+    } else if (bearish > bullish && bearish > neutral) {
+        return "🔴 BEARISH MARKET";
+    }
+    return "🟡 NEUTRAL MARKET";
+}
+
+// Same value as calculate_portfolio_diversity()
+double market_scan_diversity(const MarketScan* scan) {
+    if (!scan || scan->valid == 0) {
+        return 0.0;
+    }
+    double positive = scan->bullish, negative = scan->valid - scan->bullish;
+    double ratio = (positive < negative) ? positive / scan->valid : negative / scan->valid;
+    return ratio * 100.0;
+}
+
 // Generate market summary
 void generate_market_summary(Stock stocks[], int count, char* summary, size_t size) {
     if (!stocks || !summary || count <= 0) {
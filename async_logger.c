@@ -0,0 +1,290 @@
+/*
+ * Smart Stock Tracker - Asynchronous Trading Logger
+ * Background writer fed by a lock-free ring of preformatted records
+ * Author: [Your Name]
+ * Date: October 2025
+ */
+
+#include "stock_tracker.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+// One ring slot: a sequence number (Vyukov bounded queue) plus the record text
+typedef struct {
+    size_t sequence;
+    size_t length;
+    char text[LOG_RECORD_SIZE];
+} LogSlot;
+
+// Logger state (one background writer per process)
+static LogSlot *ring = NULL;
+static size_t ring_mask = 0;
+static size_t ring_tail = 0;                // Next slot producers claim
+static size_t ring_head = 0;                // Next slot the writer drains
+static unsigned long long dropped_records = 0;
+static unsigned long long written_records = 0;
+static int logger_running = 0;
+static int log_fd = -1;
+static LoggerConfig active_config;
+static pthread_t writer_thread;
+
+// Per-thread timestamp cache so strftime runs at most once per second per thread
+static __thread time_t cached_second = 0;
+static __thread char cached_stamp[32];
+
+// Round up to the next power of two (ring indexing uses a mask)
+static size_t next_power_of_two(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+static void sleep_milliseconds(int ms) {
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+static long long monotonic_milliseconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000L;
+}
+
+// Write a whole buffer, retrying on short writes
+static void write_fully(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = write(fd, data, length);
+        if (n <= 0) {
+            return;
+        }
+        data += n;
+        length -= (size_t)n;
+    }
+}
+
+// Drain everything currently published in the ring into one batched write.
+// Returns the number of records drained.
+static size_t drain_ring(char* batch, size_t batch_size) {
+    size_t used = 0;
+    size_t drained = 0;
+
+    for (;;) {
+        LogSlot *slot = &ring[ring_head & ring_mask];
+        size_t seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        if (seq != ring_head + 1) {
+            break;  // Slot not yet published
+        }
+
+        if (used + slot->length > batch_size) {
+            write_fully(log_fd, batch, used);
+            used = 0;
+        }
+        memcpy(batch + used, slot->text, slot->length);
+        used += slot->length;
+
+        // Hand the slot back to producers for the next lap
+        __atomic_store_n(&slot->sequence, ring_head + ring_mask + 1, __ATOMIC_RELEASE);
+        ring_head++;
+        drained++;
+    }
+
+    if (used > 0) {
+        write_fully(log_fd, batch, used);
+    }
+    return drained;
+}
+
+// Background writer loop
+static void* logger_thread_main(void* arg) {
+    (void)arg;
+    char *batch = malloc(LOG_BATCH_BYTES);
+    if (!batch) {
+        return NULL;
+    }
+
+    long long last_sync = monotonic_milliseconds();
+
+    for (;;) {
+        int running = __atomic_load_n(&logger_running, __ATOMIC_ACQUIRE);
+        size_t drained = drain_ring(batch, LOG_BATCH_BYTES);
+        __atomic_add_fetch(&written_records, drained, __ATOMIC_RELAXED);
+
+        if (drained > 0) {
+            if (active_config.fsync_policy == LOG_FSYNC_EVERY_BATCH) {
+                fsync(log_fd);
+            } else if (active_config.fsync_policy == LOG_FSYNC_INTERVAL) {
+                long long now = monotonic_milliseconds();
+                if (now - last_sync >= active_config.fsync_interval_ms) {
+                    fsync(log_fd);
+                    last_sync = now;
+                }
+            }
+        }
+
+        if (!running) {
+            break;  // Final drain done after stop was requested
+        }
+        if (drained == 0) {
+            sleep_milliseconds(active_config.flush_interval_ms);
+        }
+    }
+
+    if (active_config.fsync_policy != LOG_FSYNC_NEVER) {
+        fsync(log_fd);
+    }
+    free(batch);
+    return NULL;
+}
+
+// Fill a config structure with the defaults
+void logger_default_config(LoggerConfig* config) {
+    if (!config) {
+        return;
+    }
+    config->filename = LOG_FILE;
+    config->ring_capacity = LOG_RING_CAPACITY;
+    config->flush_interval_ms = LOG_FLUSH_INTERVAL_MS;
+    config->fsync_policy = LOG_FSYNC_NEVER;
+    config->fsync_interval_ms = 1000;
+}
+
+// Start the background logger
+int logger_start(const LoggerConfig* config) {
+    if (logger_running) {
+        return 1;
+    }
+
+    if (config) {
+        active_config = *config;
+    } else {
+        logger_default_config(&active_config);
+    }
+    if (active_config.ring_capacity < 2) {
+        active_config.ring_capacity = 2;
+    }
+    if (active_config.flush_interval_ms <= 0) {
+        active_config.flush_interval_ms = 1;
+    }
+
+    size_t capacity = next_power_of_two(active_config.ring_capacity);
+    ring = malloc(capacity * sizeof(LogSlot));
+    if (!ring) {
+        display_error("Cannot allocate trading log ring");
+        return 0;
+    }
+    for (size_t i = 0; i < capacity; i++) {
+        ring[i].sequence = i;
+        ring[i].length = 0;
+    }
+    ring_mask = capacity - 1;
+    ring_tail = 0;
+    ring_head = 0;
+    dropped_records = 0;
+    written_records = 0;
+
+    log_fd = open(active_config.filename, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (log_fd < 0) {
+        display_error("Cannot open trading log file");
+        free(ring);
+        ring = NULL;
+        return 0;
+    }
+
+    __atomic_store_n(&logger_running, 1, __ATOMIC_RELEASE);
+    if (pthread_create(&writer_thread, NULL, logger_thread_main, NULL) != 0) {
+        display_error("Cannot start trading log writer thread");
+        __atomic_store_n(&logger_running, 0, __ATOMIC_RELEASE);
+        close(log_fd);
+        log_fd = -1;
+        free(ring);
+        ring = NULL;
+        return 0;
+    }
+
+    return 1;
+}
+
+// Stop the logger, flushing every record already accepted
+void logger_stop() {
+    if (!logger_running) {
+        return;
+    }
+
+    __atomic_store_n(&logger_running, 0, __ATOMIC_RELEASE);
+    pthread_join(writer_thread, NULL);
+
+    close(log_fd);
+    log_fd = -1;
+    free(ring);
+    ring = NULL;
+}
+
+// Check whether the background logger is accepting records
+int logger_is_running() {
+    return __atomic_load_n(&logger_running, __ATOMIC_ACQUIRE);
+}
+
+// Submit a preformatted record; never blocks, drops when the ring is full
+int logger_submit(const char* record, size_t length) {
+    if (!record || !logger_is_running()) {
+        return 0;
+    }
+    if (length > LOG_RECORD_SIZE) {
+        length = LOG_RECORD_SIZE;
+    }
+
+    size_t pos = __atomic_load_n(&ring_tail, __ATOMIC_RELAXED);
+    LogSlot *slot;
+
+    for (;;) {
+        slot = &ring[pos & ring_mask];
+        size_t seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        long diff = (long)(seq - pos);
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring_tail, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;  // Slot claimed
+            }
+        } else if (diff < 0) {
+            // Ring is full: count the drop instead of waiting for the writer
+            __atomic_add_fetch(&dropped_records, 1, __ATOMIC_RELAXED);
+            return 0;
+        } else {
+            pos = __atomic_load_n(&ring_tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(slot->text, record, length);
+    slot->length = length;
+    __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// Number of records dropped because the ring was full
+unsigned long long logger_dropped_count() {
+    return __atomic_load_n(&dropped_records, __ATOMIC_RELAXED);
+}
+
+// Number of records written to disk so far
+unsigned long long logger_written_count() {
+    return __atomic_load_n(&written_records, __ATOMIC_RELAXED);
+}
+
+// Format the current second once per thread and reuse it until the clock moves on
+const char* logger_cached_timestamp() {
+    time_t now = time(NULL);
+    if (now != cached_second || cached_stamp[0] == '\0') {
+        struct tm local;
+        localtime_r(&now, &local);
+        strftime(cached_stamp, sizeof(cached_stamp), "%Y-%m-%d %H:%M:%S", &local);
+        cached_second = now;
+    }
+    return cached_stamp;
+}
@@ -0,0 +1,735 @@
+/*
+ * Smart Stock Tracker - Backtester
+ * Replays stored bar history through the status and recommendation rules
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * Trading model (long-only, one position per symbol):
+ *   - Each bar is turned into a quote (close vs. previous close, bar volume)
+ *     and the whole series is classified column-wise with the compiled rules.
+ *   - BUY or STRONG BUY recommendation while flat -> enter.
+ *   - BEARISH or AVOID status while long -> exit.
+ *   - Orders fill at the next bar's open, adjusted by slippage, and pay
+ *     commission on each side. A position still open at the end is marked
+ *     to the last close.
+ */
+
+#include "stock_tracker.h"
+#include <math.h>
+
+// Per-bar columns the trading loop reads, reused across symbols
+typedef struct {
+    double* changes;
+    unsigned char* status;            // StockStatus codes
+    unsigned char* recommendations;   // Recommendation codes
+    int capacity;
+} BarColumns;
+
+typedef struct {
+    const HistoryStore* store;
+    const BacktestConfig* config;
+    const CompiledRules* rules;
+    BacktestResult* results;
+} BacktestJob;
+
+static int columns_reserve(BarColumns* columns, int count) {
+    if (count <= columns->capacity) {
+        return 1;
+    }
+    free(columns->changes);
+    free(columns->status);
+    free(columns->recommendations);
+    columns->changes = malloc((size_t)count * sizeof(double));
+    columns->status = malloc((size_t)count);
+    columns->recommendations = malloc((size_t)count);
+    columns->capacity = count;
+    if (!columns->changes || !columns->status || !columns->recommendations) {
+        columns->capacity = 0;
+        return 0;
+    }
+    return 1;
+}
+
+static void columns_free(BarColumns* columns) {
+    free(columns->changes);
+    free(columns->status);
+    free(columns->recommendations);
+    memset(columns, 0, sizeof(*columns));
+}
+
+// Percent change of each close over the previous close (0 for the first bar)
+static void compute_changes(const PriceSeries* series, double changes[]) {
+    if (series->count > 0) {
+        changes[0] = 0.0;
+    }
+    for (int i = 1; i < series->count; i++) {
+        double previous = series->close[i - 1];
+        changes[i] = previous > 0 ? (series->close[i] - previous) / previous * 100.0 : 0.0;
+    }
+}
+
+// Classify every bar at once; the trading loop then only reads codes
+static void classify_bars(const PriceSeries* series, const double changes[], const CompiledRules* rules,
+                          BarColumns* columns) {
+    classify_status_column(rules, series->close, changes, series->count, columns->status);
+    classify_recommendation_column(rules, series->close, changes, series->volume,
+                                   series->count, columns->recommendations);
+}
+
+// Run the trading loop over one symbol's classified bars
+static void simulate_series(const PriceSeries* series, const BarColumns* columns,
+                            const BacktestConfig* config, BacktestResult* result) {
+    memset(result, 0, sizeof(*result));
+    strcpy(result->symbol, series->symbol);
+    result->bars = series->count;
+    if (series->count < 2) {
+        result->final_equity = config->initial_cash;
+        return;
+    }
+
+    double cost = config->commission_bps / 10000.0;
+    double slip = config->slippage_bps / 10000.0;
+    double cash = config->initial_cash;
+    double shares = 0.0;
+    double entry_value = 0.0;
+    double peak = cash;
+    int enter = 0, exit = 0;
+    int bars_in_market = 0;
+
+    for (int i = 1; i < series->count; i++) {
+        // Fill yesterday's order at today's open
+        if (enter || exit) {
+            double open = series->open[i] > 0 ? series->open[i] : series->close[i - 1];
+            if (enter) {
+                double fill = open * (1.0 + slip);
+                entry_value = cash;
+                shares = cash * (1.0 - cost) / fill;
+                cash = 0.0;
+            } else {
+                double fill = open * (1.0 - slip);
+                cash = shares * fill * (1.0 - cost);
+                shares = 0.0;
+                result->trades++;
+                if (cash > entry_value) {
+                    result->winning_trades++;
+                }
+            }
+            enter = exit = 0;
+        }
+
+        double equity = cash + shares * series->close[i];
+        if (equity > peak) {
+            peak = equity;
+        }
+        double drawdown = peak > 0 ? (peak - equity) / peak : 0.0;
+        if (drawdown > result->max_drawdown) {
+            result->max_drawdown = drawdown;
+        }
+        if (shares > 0) {
+            bars_in_market++;
+        }
+
+        // Signal at today's close, filled at tomorrow's open
+        if (i + 1 < series->count) {
+            if (shares > 0) {
+                exit = columns->status[i] == STATUS_BEARISH || columns->status[i] == STATUS_AVOID;
+            } else {
+                enter = columns->recommendations[i] == RECOMMEND_BUY ||
+                        columns->recommendations[i] == RECOMMEND_STRONG_BUY;
+            }
+        }
+    }
+
+    // Close any open position at the last close for trade statistics
+    double final_equity = cash + shares * series->close[series->count - 1];
+    if (shares > 0) {
+        result->trades++;
+        if (final_equity > entry_value) {
+            result->winning_trades++;
+        }
+    }
+
+    result->final_equity = final_equity;
+    result->total_return = final_equity / config->initial_cash - 1.0;
+    result->buy_and_hold_return = series->close[0] > 0
+                                ? series->close[series->count - 1] / series->close[0] - 1.0
+                                : 0.0;
+    result->hit_rate = result->trades > 0 ? (double)result->winning_trades / result->trades : 0.0;
+    result->exposure = (double)bars_in_market / (series->count - 1);
+}
+
+// Compute, classify and simulate one symbol with caller-owned columns
+static int backtest_with_columns(const PriceSeries* series, const CompiledRules* rules,
+                                 const BacktestConfig* config, BarColumns* columns, BacktestResult* result) {
+    if (!columns_reserve(columns, series->count)) {
+        return 0;
+    }
+    compute_changes(series, columns->changes);
+    classify_bars(series, columns->changes, rules, columns);
+    simulate_series(series, columns, config, result);
+    return 1;
+}
+
+// Compile config->rules, falling back to the live rules
+static int compile_config_rules(const BacktestConfig* config, CompiledRules* compiled) {
+    if (!config->rules) {
+        *compiled = *compiled_rules_active();
+        return 1;
+    }
+    return rule_params_compile(config->rules, compiled);
+}
+
+// Run the rules over one symbol's history
+void backtest_series(const PriceSeries* series, const BacktestConfig* config, BacktestResult* result) {
+    CompiledRules rules;
+    BarColumns columns = {NULL, NULL, NULL, 0};
+    if (!compile_config_rules(config, &rules) ||
+        !backtest_with_columns(series, &rules, config, &columns, result)) {
+        memset(result, 0, sizeof(*result));
+        strcpy(result->symbol, series->symbol);
+    }
+    columns_free(&columns);
+}
+
+// Fold one symbol's result into a summary (average_return holds the sum until finished)
+static void summary_add(BacktestSummary* summary, const BacktestResult* result) {
+    summary->symbols++;
+    summary->bars += result->bars;
+    summary->trades += result->trades;
+    summary->winning_trades += result->winning_trades;
+    summary->average_return += result->total_return;
+    if (result->max_drawdown > summary->worst_drawdown) {
+        summary->worst_drawdown = result->max_drawdown;
+    }
+}
+
+static void summary_finish(BacktestSummary* summary) {
+    summary->average_return = summary->symbols > 0 ? summary->average_return / summary->symbols : 0.0;
+    summary->hit_rate = summary->trades > 0 ? (double)summary->winning_trades / summary->trades : 0.0;
+}
+
+static void backtest_range(int begin, int end, int worker, void* context) {
+    (void)worker;
+    BacktestJob* job = (BacktestJob*)context;
+    BarColumns columns = {NULL, NULL, NULL, 0};
+    for (int i = begin; i < end; i++) {
+        const PriceSeries* series = &job->store->series[i];
+        if (!backtest_with_columns(series, job->rules, job->config, &columns, &job->results[i])) {
+            memset(&job->results[i], 0, sizeof(job->results[i]));
+            strcpy(job->results[i].symbol, series->symbol);
+        }
+    }
+    columns_free(&columns);
+}
+
+// Fill a config with the defaults
+void backtest_default_config(BacktestConfig* config) {
+    if (!config) {
+        return;
+    }
+    config->initial_cash = 10000.0;
+    config->commission_bps = 1.0;
+    config->slippage_bps = 2.0;
+    config->threads = 0;
+    config->rules = NULL;
+}
+
+// Backtest every symbol in the store in parallel
+int backtest_run(const HistoryStore* store, const BacktestConfig* config,
+                 BacktestResult* results, BacktestSummary* summary) {
+    CompiledRules rules;
+    if (!store || !config || !results || !summary || !compile_config_rules(config, &rules)) {
+        return 0;
+    }
+
+    long long start = metrics_now_ns();
+    BacktestJob job = {store, config, &rules, results};
+    parallel_for(store->count, BACKTEST_SYMBOLS_PER_CHUNK, config->threads, backtest_range, &job);
+
+    // Combine in symbol order so the summary is deterministic
+    memset(summary, 0, sizeof(*summary));
+    for (int i = 0; i < store->count; i++) {
+        summary_add(summary, &results[i]);
+    }
+    summary_finish(summary);
+    summary->elapsed_ns = metrics_now_ns() - start;
+    return 1;
+}
+
+// Work description for backtest_sweep
+typedef struct {
+    const HistoryStore* store;
+    const BacktestConfig* config;
+    double* changes;          // Per-bar change for every series, back to back
+    long long* offsets;       // Start of each series in changes
+    int max_bars;             // Longest series
+    const RuleParams* sets;
+    SweepResult* results;
+    int failed;               // Set by any chunk that could not get its scratch columns
+} SweepJob;
+
+// Indicators depend only on the data, so compute them once for all sets
+static void sweep_precompute_range(int begin, int end, int worker, void* context) {
+    (void)worker;
+    SweepJob* job = (SweepJob*)context;
+    for (int s = begin; s < end; s++) {
+        compute_changes(&job->store->series[s], job->changes + job->offsets[s]);
+    }
+}
+
+// Symbol-major inside a chunk so each series stays in cache across its sets
+static void sweep_range(int begin, int end, int worker, void* context) {
+    (void)worker;
+    SweepJob* job = (SweepJob*)context;
+    CompiledRules compiled[SWEEP_SETS_PER_CHUNK];
+    BarColumns columns = {NULL, NULL, NULL, 0};
+    BacktestResult result;
+
+    // Results start empty even if the chunk fails, so nothing is left uninitialized
+    for (int r = begin; r < end; r++) {
+        memset(&job->results[r], 0, sizeof(job->results[r]));
+        job->results[r].rules = job->sets[r];
+    }
+    if (end - begin > SWEEP_SETS_PER_CHUNK || !columns_reserve(&columns, job->max_bars)) {
+        columns_free(&columns);
+        __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    for (int r = begin; r < end; r++) {
+        rule_params_compile(&job->sets[r], &compiled[r - begin]);
+    }
+    for (int s = 0; s < job->store->count; s++) {
+        const PriceSeries* series = &job->store->series[s];
+        const double* changes = job->changes + job->offsets[s];
+        for (int r = begin; r < end; r++) {
+            classify_bars(series, changes, &compiled[r - begin], &columns);
+            simulate_series(series, &columns, job->config, &result);
+            summary_add(&job->results[r].summary, &result);
+        }
+    }
+    for (int r = begin; r < end; r++) {
+        summary_finish(&job->results[r].summary);
+    }
+    columns_free(&columns);
+}
+
+// Evaluate every parameter set against the whole store
+int backtest_sweep(const HistoryStore* store, const BacktestConfig* config,
+                   const RuleParams sets[], int set_count, SweepResult results[]) {
+    if (!store || !config || !sets || !results || set_count <= 0) {
+        return 0;
+    }
+    for (int r = 0; r < set_count; r++) {
+        if (!rule_params_validate(&sets[r])) {
+            return 0;
+        }
+    }
+
+    SweepJob job;
+    job.store = store;
+    job.config = config;
+    job.sets = sets;
+    job.results = results;
+    job.failed = 0;
+    job.max_bars = 1;
+    job.offsets = malloc((size_t)(store->count + 1) * sizeof(long long));
+    if (!job.offsets) {
+        return 0;
+    }
+    job.offsets[0] = 0;
+    for (int s = 0; s < store->count; s++) {
+        job.offsets[s + 1] = job.offsets[s] + store->series[s].count;
+        if (store->series[s].count > job.max_bars) {
+            job.max_bars = store->series[s].count;
+        }
+    }
+    job.changes = malloc((size_t)(job.offsets[store->count] > 0 ? job.offsets[store->count] : 1) * sizeof(double));
+    if (!job.changes) {
+        free(job.offsets);
+        return 0;
+    }
+
+    long long start = metrics_now_ns();
+    parallel_for(store->count, BACKTEST_SYMBOLS_PER_CHUNK, config->threads, sweep_precompute_range, &job);
+    parallel_for(set_count, SWEEP_SETS_PER_CHUNK, config->threads, sweep_range, &job);
+    long long elapsed = metrics_now_ns() - start;
+    for (int r = 0; r < set_count; r++) {
+        results[r].summary.elapsed_ns = elapsed;
+    }
+
+    free(job.changes);
+    free(job.offsets);
+    if (job.failed) {
+        display_error("Out of memory running the parameter sweep");
+        return 0;
+    }
+    return 1;
+}
+
+static int compare_result_return(const void* a, const void* b) {
+    double ra = ((const BacktestResult*)a)->total_return;
+    double rb = ((const BacktestResult*)b)->total_return;
+    return (rb > ra) - (rb < ra);
+}
+
+// Command line entry:
+// backtest <history.csv> | --synthetic SYMBOLS BARS  [--commission bps] [--slippage bps]
+//          [--cash amount] [--rules file] [--threads N] [--top N] [--csv]
+int run_backtest_command(int argc, char* argv[]) {
+    BacktestConfig config;
+    backtest_default_config(&config);
+    RuleParams rules = *rule_params_active();
+    config.rules = &rules;
+    const char* filename = NULL;
+    int synthetic_symbols = 0, synthetic_bars = 0;
+    int top = 10;
+    int csv = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--synthetic") == 0 && i + 2 < argc) {
+            synthetic_symbols = atoi(argv[++i]);
+            synthetic_bars = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--commission") == 0 && i + 1 < argc) {
+            config.commission_bps = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--slippage") == 0 && i + 1 < argc) {
+            config.slippage_bps = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--cash") == 0 && i + 1 < argc) {
+            config.initial_cash = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--rules") == 0 && i + 1 < argc) {
+            if (load_rule_params(argv[++i], &rules) < 0) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            top = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else if (argv[i][0] != '-' && !filename) {
+            filename = argv[i];
+        } else {
+            fprintf(stderr, "❌ Unknown backtest option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!filename && synthetic_symbols <= 0) {
+        fprintf(stderr, "usage: stock_tracker backtest <history.csv> | --synthetic SYMBOLS BARS "
+                        "[--commission bps] [--slippage bps] [--cash amount] [--rules file] [--threads N] [--top N] [--csv]\n");
+        return 1;
+    }
+    if (!rule_params_validate(&rules)) {
+        display_error("Rule thresholds are out of order");
+        return 1;
+    }
+
+    HistoryStore store;
+    long long load_start = metrics_now_ns();
+    if (!history_store_open(&store, filename, synthetic_symbols, synthetic_bars, config.threads)) {
+        return 1;
+    }
+    long long load_ns = metrics_now_ns() - load_start;
+
+    BacktestResult* results = malloc((size_t)(store.count > 0 ? store.count : 1) * sizeof(BacktestResult));
+    BacktestSummary summary;
+    if (!results || !backtest_run(&store, &config, results, &summary)) {
+        free(results);
+        history_store_free(&store);
+        return 1;
+    }
+
+    qsort(results, store.count, sizeof(BacktestResult), compare_result_return);
+
+    if (csv) {
+        printf("symbol,bars,trades,hit_rate,total_return,buy_and_hold_return,max_drawdown,exposure\n");
+        for (int i = 0; i < store.count; i++) {
+            const BacktestResult* r = &results[i];
+            printf("%s,%d,%d,%.4f,%.6f,%.6f,%.6f,%.4f\n", r->symbol, r->bars, r->trades, r->hit_rate,
+                   r->total_return, r->buy_and_hold_return, r->max_drawdown, r->exposure);
+        }
+    } else {
+        printf("📊 BACKTEST RESULTS\n");
+        printf("══════════════════════════════\n");
+        printf("• Symbols: %d, bars: %lld (loaded in %.2fs)\n", summary.symbols, summary.bars, load_ns / 1e9);
+        printf("• Backtest time: %.3fs (%.1fM bars/s)\n", summary.elapsed_ns / 1e9,
+               summary.elapsed_ns > 0 ? summary.bars * 1e3 / summary.elapsed_ns : 0.0);
+        printf("• Trades: %lld, hit rate: %.1f%%\n", summary.trades, summary.hit_rate * 100.0);
+        printf("• Average return: %.2f%%, worst drawdown: %.2f%%\n\n",
+               summary.average_return * 100.0, summary.worst_drawdown * 100.0);
+
+        printf("%-8s %8s %7s %9s %10s %10s %9s\n", "SYMBOL", "BARS", "TRADES", "HIT %", "RETURN %", "B&H %", "MAX DD %");
+        for (int i = 0; i < store.count && i < top; i++) {
+            const BacktestResult* r = &results[i];
+            printf("%-8s %8d %7d %9.1f %10.2f %10.2f %9.2f\n", r->symbol, r->bars, r->trades,
+                   r->hit_rate * 100.0, r->total_return * 100.0, r->buy_and_hold_return * 100.0,
+                   r->max_drawdown * 100.0);
+        }
+    }
+
+    free(results);
+    history_store_free(&store);
+    return 0;
+}
+
+// One swept parameter: its name and the values to try
+typedef struct {
+    char name[32];
+    double* values;
+    int count;
+} SweepAxis;
+
+// Parse "name=start:stop:step" or "name=v1,v2,..."
+static int parse_sweep_axis(const char* spec, SweepAxis* axis) {
+    const char* eq = strchr(spec, '=');
+    double probe;
+    if (!eq || eq == spec || (size_t)(eq - spec) >= sizeof(axis->name)) {
+        return 0;
+    }
+    memcpy(axis->name, spec, (size_t)(eq - spec));
+    axis->name[eq - spec] = '\0';
+    if (!rule_params_get_field(rule_params_active(), axis->name, &probe)) {
+        fprintf(stderr, "❌ Unknown rule parameter '%s'\n", axis->name);
+        return 0;
+    }
+
+    double start, stop, step;
+    if (sscanf(eq + 1, "%lf:%lf:%lf", &start, &stop, &step) == 3) {
+        if (step <= 0 || stop < start) {
+            return 0;
+        }
+        int count = (int)floor((stop - start) / step + 1e-9) + 1;
+        axis->values = malloc((size_t)count * sizeof(double));
+        if (!axis->values) {
+            return 0;
+        }
+        for (int i = 0; i < count; i++) {
+            axis->values[i] = start + step * i;
+        }
+        axis->count = count;
+        return 1;
+    }
+
+    int count = 1;
+    for (const char* p = eq + 1; *p; p++) {
+        count += *p == ',';
+    }
+    axis->values = malloc((size_t)count * sizeof(double));
+    if (!axis->values) {
+        return 0;
+    }
+    axis->count = 0;
+    const char* p = eq + 1;
+    char* next;
+    while (axis->count < count) {
+        axis->values[axis->count] = strtod(p, &next);
+        if (next == p) {
+            return 0;
+        }
+        axis->count++;
+        p = *next == ',' ? next + 1 : next;
+    }
+    return *p == '\0';
+}
+
+static void free_sweep_axes(SweepAxis axes[], int count) {
+    for (int a = 0; a < count; a++) {
+        free(axes[a].values);
+    }
+}
+
+// Cartesian product of the axes over base, dropping sets with out-of-order thresholds
+static RuleParams* build_sweep_grid(const RuleParams* base, const SweepAxis axes[], int axis_count,
+                                    long long* grid_size, int* set_count) {
+    long long total = 1;
+    for (int a = 0; a < axis_count; a++) {
+        total *= axes[a].count;
+        if (total > SWEEP_MAX_SETS) {
+            fprintf(stderr, "❌ Grid has more than %d parameter sets\n", SWEEP_MAX_SETS);
+            return NULL;
+        }
+    }
+
+    RuleParams* sets = malloc((size_t)total * sizeof(RuleParams));
+    if (!sets) {
+        display_error("Out of memory building the parameter grid");
+        return NULL;
+    }
+    int count = 0;
+    for (long long index = 0; index < total; index++) {
+        RuleParams params = *base;
+        long long rest = index;
+        for (int a = axis_count - 1; a >= 0; a--) {
+            rule_params_set_field(&params, axes[a].name, axes[a].values[rest % axes[a].count]);
+            rest /= axes[a].count;
+        }
+        if (rule_params_validate(&params)) {
+            sets[count++] = params;
+        }
+    }
+    if (count == 0) {
+        display_error("No parameter set in the grid has ordered thresholds");
+        free(sets);
+        return NULL;
+    }
+
+    *grid_size = total;
+    *set_count = count;
+    return sets;
+}
+
+static int compare_sweep_return(const void* a, const void* b) {
+    double ra = ((const SweepResult*)a)->summary.average_return;
+    double rb = ((const SweepResult*)b)->summary.average_return;
+    return (rb > ra) - (rb < ra);
+}
+
+// Print the best sets (results sorted) and optionally write all of them as CSV
+static void report_sweep(const SweepResult results[], int set_count, const SweepAxis axes[], int axis_count,
+                         int top, const char* output) {
+    for (int a = 0; a < axis_count; a++) {
+        printf("%-22s ", axes[a].name);
+    }
+    printf("%10s %8s %9s %9s\n", "RETURN %", "HIT %", "TRADES", "MAX DD %");
+    for (int r = 0; r < set_count && r < top; r++) {
+        for (int a = 0; a < axis_count; a++) {
+            double value = 0.0;
+            rule_params_get_field(&results[r].rules, axes[a].name, &value);
+            printf("%-22g ", value);
+        }
+        printf("%10.2f %8.1f %9lld %9.2f\n", results[r].summary.average_return * 100.0,
+               results[r].summary.hit_rate * 100.0, results[r].summary.trades,
+               results[r].summary.worst_drawdown * 100.0);
+    }
+
+    if (!output) {
+        return;
+    }
+    FILE* file = fopen(output, "w");
+    if (!file) {
+        display_error("Cannot write sweep output");
+        return;
+    }
+    for (int a = 0; a < axis_count; a++) {
+        fprintf(file, "%s,", axes[a].name);
+    }
+    fprintf(file, "average_return,hit_rate,trades,worst_drawdown\n");
+    for (int r = 0; r < set_count; r++) {
+        for (int a = 0; a < axis_count; a++) {
+            double value = 0.0;
+            rule_params_get_field(&results[r].rules, axes[a].name, &value);
+            fprintf(file, "%g,", value);
+        }
+        fprintf(file, "%.6f,%.4f,%lld,%.6f\n", results[r].summary.average_return,
+                results[r].summary.hit_rate, results[r].summary.trades,
+                results[r].summary.worst_drawdown);
+    }
+    fclose(file);
+    printf("\n✅ Wrote %d parameter sets to %s\n", set_count, output);
+}
+
+// Run the sweep once the grid is built
+static int run_sweep(const char* filename, int synthetic_symbols, int synthetic_bars,
+                     const BacktestConfig* config, const RuleParams sets[], int set_count,
+                     long long grid_size, const SweepAxis axes[], int axis_count,
+                     int top, const char* output) {
+    HistoryStore store;
+    long long load_start = metrics_now_ns();
+    if (!history_store_open(&store, filename, synthetic_symbols, synthetic_bars, config->threads)) {
+        return 0;
+    }
+    long long load_ns = metrics_now_ns() - load_start;
+
+    SweepResult* results = malloc((size_t)set_count * sizeof(SweepResult));
+    if (!results || !backtest_sweep(&store, config, sets, set_count, results)) {
+        free(results);
+        history_store_free(&store);
+        return 0;
+    }
+
+    long long bars = history_store_bar_count(&store);
+    long long elapsed = results[0].summary.elapsed_ns;
+    printf("🧪 PARAMETER SWEEP\n");
+    printf("══════════════════════════════\n");
+    printf("• Symbols: %d, bars: %lld (loaded in %.2fs)\n", store.count, bars, load_ns / 1e9);
+    printf("• Parameter sets: %d of %lld in grid\n", set_count, grid_size);
+    printf("• Sweep time: %.3fs (%.1fM bars/s across all sets)\n\n", elapsed / 1e9,
+           elapsed > 0 ? (double)bars * set_count * 1e3 / elapsed : 0.0);
+
+    qsort(results, set_count, sizeof(SweepResult), compare_sweep_return);
+    report_sweep(results, set_count, axes, axis_count, top, output);
+
+    free(results);
+    history_store_free(&store);
+    return 1;
+}
+
+// Command line entry:
+// sweep <history.csv> | --synthetic SYMBOLS BARS  --grid name=start:stop:step | name=v1,v2 ...
+//       [--rules file] [--commission bps] [--slippage bps] [--threads N] [--top N] [--output file.csv]
+int run_sweep_command(int argc, char* argv[]) {
+    BacktestConfig config;
+    backtest_default_config(&config);
+    RuleParams base = *rule_params_active();
+    SweepAxis axes[16];
+    int axis_count = 0;
+    const char* filename = NULL;
+    const char* output = NULL;
+    int synthetic_symbols = 0, synthetic_bars = 0;
+    int top = 10;
+    int ok = 1;
+
+    for (int i = 1; i < argc && ok; i++) {
+        if (strcmp(argv[i], "--grid") == 0 && i + 1 < argc) {
+            i++;
+            if (axis_count == (int)(sizeof(axes) / sizeof(axes[0]))) {
+                ok = 0;
+            } else {
+                memset(&axes[axis_count], 0, sizeof(SweepAxis));
+                ok = parse_sweep_axis(argv[i], &axes[axis_count]);
+                axis_count++;
+            }
+            if (!ok) {
+                fprintf(stderr, "❌ Invalid grid: %s\n", argv[i]);
+            }
+        } else if (strcmp(argv[i], "--synthetic") == 0 && i + 2 < argc) {
+            synthetic_symbols = atoi(argv[++i]);
+            synthetic_bars = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rules") == 0 && i + 1 < argc) {
+            ok = load_rule_params(argv[++i], &base) >= 0;
+        } else if (strcmp(argv[i], "--commission") == 0 && i + 1 < argc) {
+            config.commission_bps = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--slippage") == 0 && i + 1 < argc) {
+            config.slippage_bps = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            config.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            top = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (argv[i][0] != '-' && !filename) {
+            filename = argv[i];
+        } else {
+            fprintf(stderr, "❌ Unknown sweep option: %s\n", argv[i]);
+            ok = 0;
+        }
+    }
+    if (ok && ((!filename && synthetic_symbols <= 0) || axis_count == 0)) {
+        fprintf(stderr, "usage: stock_tracker sweep <history.csv> | --synthetic SYMBOLS BARS "
+                        "--grid name=start:stop:step [--grid name=v1,v2 ...] [--rules file] "
+                        "[--commission bps] [--slippage bps] [--threads N] [--top N] [--output file.csv]\n");
+        ok = 0;
+    }
+
+    long long grid_size = 0;
+    int set_count = 0;
+    RuleParams* sets = ok ? build_sweep_grid(&base, axes, axis_count, &grid_size, &set_count) : NULL;
+    if (sets) {
+        ok = run_sweep(filename, synthetic_symbols, synthetic_bars, &config, sets, set_count,
+                       grid_size, axes, axis_count, top, output);
+    } else {
+        ok = 0;
+    }
+
+    free(sets);
+    free_sweep_axes(axes, axis_count);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,318 @@
+/*
+ * Smart Stock Tracker - Bar Builder
+ * Intraday OHLCV bars aggregated from the quote stream
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * Each quote updates the open 1m, 5m, 15m and 1h bar of its symbol: high,
+ * low, close, the volume traded since the previous quote, turnover for
+ * VWAP and a quote count. Bar periods are aligned to the session open
+ * (to the close for after-hours quotes), so bars never straddle a session
+ * boundary. A quote that falls in a later period closes the bar into a
+ * per-symbol ring; the rings for every symbol are carved out of one slab
+ * when the symbol is first seen, so an update never allocates.
+ * bar_builder_flush() later drains closed bars into a HistoryStore per
+ * interval, off the hot path.
+ */
+
+#include "stock_tracker.h"
+#include <time.h>
+
+#define SECONDS_PER_DAY 86400LL
+
+static const int BAR_SECONDS[BAR_INTERVAL_COUNT] = {60, 300, 900, 3600};
+static const char* BAR_NAMES[BAR_INTERVAL_COUNT] = {"1m", "5m", "15m", "1h"};
+
+// Floor division for possibly negative offsets
+static long long floor_div(long long a, long long b) {
+    long long q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+// Start of the bar period containing `when`
+static long long bar_period_start(long long when, int seconds) {
+    long long day = floor_div(when, SECONDS_PER_DAY) * SECONDS_PER_DAY;
+    long long close = day + SESSION_CLOSE_UTC;
+    long long anchor = when >= close ? close : day + SESSION_OPEN_UTC;
+    return anchor + floor_div(when - anchor, seconds) * seconds;
+}
+
+static BarSeries* builder_series(const BarBuilder* builder, int id, BarInterval interval) {
+    return &builder->series[(size_t)id * BAR_INTERVAL_COUNT + interval];
+}
+
+static OhlcvBar* builder_ring(const BarBuilder* builder, int id, BarInterval interval) {
+    return &builder->rings[((size_t)id * BAR_INTERVAL_COUNT + interval) * builder->ring_capacity];
+}
+
+// Grow every per-symbol array, including the ring slab, to hold count symbols
+static int bar_builder_reserve(BarBuilder* builder, int count) {
+    if (count <= builder->capacity) {
+        return 1;
+    }
+    int new_capacity = builder->capacity ? builder->capacity : 16;
+    while (new_capacity < count) {
+        new_capacity *= 2;
+    }
+    size_t old_slots = (size_t)builder->capacity * BAR_INTERVAL_COUNT;
+    size_t new_slots = (size_t)new_capacity * BAR_INTERVAL_COUNT;
+
+    BarSeries* series = realloc(builder->series, new_slots * sizeof(BarSeries));
+    if (!series) {
+        return 0;
+    }
+    memset(&series[old_slots], 0, (new_slots - old_slots) * sizeof(BarSeries));
+    builder->series = series;
+
+    OhlcvBar* rings = realloc(builder->rings, new_slots * builder->ring_capacity * sizeof(OhlcvBar));
+    if (!rings) {
+        return 0;
+    }
+    builder->rings = rings;
+
+    double* last_cumulative = realloc(builder->last_cumulative, (size_t)new_capacity * sizeof(double));
+    if (!last_cumulative) {
+        return 0;
+    }
+    builder->last_cumulative = last_cumulative;
+    long long* last_time = realloc(builder->last_time, (size_t)new_capacity * sizeof(long long));
+    if (!last_time) {
+        return 0;
+    }
+    builder->last_time = last_time;
+    for (int i = builder->capacity; i < new_capacity; i++) {
+        builder->last_cumulative[i] = 0.0;
+        builder->last_time[i] = 0;
+    }
+    builder->capacity = new_capacity;
+    return 1;
+}
+
+// Initialize an empty builder
+int bar_builder_init(BarBuilder* builder, int expected_symbols, int ring_capacity) {
+    if (!builder || ring_capacity <= 0) {
+        return 0;
+    }
+    memset(builder, 0, sizeof(*builder));
+    builder->ring_capacity = ring_capacity;
+    if (!symbol_map_init(&builder->symbols, expected_symbols) ||
+        !bar_builder_reserve(builder, expected_symbols > 0 ? expected_symbols : 1)) {
+        bar_builder_free(builder);
+        return 0;
+    }
+    return 1;
+}
+
+// Release the builder's memory (sinks belong to the caller)
+void bar_builder_free(BarBuilder* builder) {
+    if (!builder) {
+        return;
+    }
+    free(builder->series);
+    free(builder->rings);
+    free(builder->last_cumulative);
+    free(builder->last_time);
+    symbol_map_free(&builder->symbols);
+    memset(builder, 0, sizeof(*builder));
+}
+
+// Route an interval's closed bars to a history store
+void bar_builder_set_sink(BarBuilder* builder, BarInterval interval, HistoryStore* store) {
+    if (builder && interval >= 0 && interval < BAR_INTERVAL_COUNT) {
+        builder->sinks[interval] = store;
+    }
+}
+
+// Move the open bar into the ring
+static void close_bar(BarBuilder* builder, int id, BarInterval interval) {
+    BarSeries* series = builder_series(builder, id, interval);
+    if (series->current.trades == 0) {
+        return;
+    }
+    builder_ring(builder, id, interval)[series->head] = series->current;
+    series->head = (series->head + 1) % builder->ring_capacity;
+    if (series->count < builder->ring_capacity) {
+        series->count++;
+    }
+    if (series->unflushed == builder->ring_capacity) {
+        builder->bars_dropped++;  // Oldest unflushed bar was just overwritten
+    } else {
+        series->unflushed++;
+    }
+    series->current.trades = 0;  // No bar open until the next quote
+    builder->bars_closed++;
+}
+
+// Id of a symbol, growing the arrays and rings if it is new
+static int builder_symbol(BarBuilder* builder, const char* symbol) {
+    if (!symbol || !symbol[0] || strlen(symbol) >= MAX_SYMBOL_LENGTH) {
+        return -1;
+    }
+    int id = symbol_map_insert(&builder->symbols, symbol);
+    if (id < 0 || !bar_builder_reserve(builder, id + 1)) {
+        return -1;
+    }
+    return id;
+}
+
+// Fold a trade into every interval's open bar; constant work, no allocation
+static void add_to_bars(BarBuilder* builder, int id, long long when, double price, double volume) {
+    for (int k = 0; k < BAR_INTERVAL_COUNT; k++) {
+        BarSeries* series = builder_series(builder, id, (BarInterval)k);
+        OhlcvBar* bar = &series->current;
+        long long start = bar_period_start(when, BAR_SECONDS[k]);
+        if (bar->trades > 0 && start > bar->start) {
+            close_bar(builder, id, (BarInterval)k);
+        }
+        if (bar->trades == 0) {
+            bar->start = start;
+            bar->open = bar->high = bar->low = price;
+            bar->volume = 0.0;
+            bar->turnover = 0.0;
+        }
+        // A late quote for an earlier period is folded into the open bar
+        if (price > bar->high) bar->high = price;
+        if (price < bar->low) bar->low = price;
+        bar->close = price;
+        bar->volume += volume;
+        bar->turnover += price * volume;
+        bar->trades++;
+    }
+}
+
+// Add one trade (or quote) to every interval's open bar
+int bar_builder_add_trade(BarBuilder* builder, const char* symbol, long long when,
+                          double price, double volume) {
+    if (!builder || price <= 0 || volume < 0) {
+        return 0;
+    }
+    int id = builder_symbol(builder, symbol);
+    if (id < 0) {
+        return 0;
+    }
+    add_to_bars(builder, id, when, price, volume);
+    return 1;
+}
+
+// Add a quote; its volume is the change in day volume since the symbol's previous quote
+int bar_builder_update(BarBuilder* builder, const Stock* stock) {
+    if (!builder || !stock || stock->current_price <= 0) {
+        return 0;
+    }
+    int id = builder_symbol(builder, stock->symbol);
+    if (id < 0) {
+        return 0;
+    }
+
+    long long when = stock->last_update > 0 ? (long long)stock->last_update : (long long)time(NULL);
+    double volume = 0.0;  // The first quote only sets the baseline
+    long long previous = builder->last_time[id];
+    if (previous != 0) {
+        int new_session = floor_div(previous, SECONDS_PER_DAY) != floor_div(when, SECONDS_PER_DAY);
+        volume = (new_session || stock->volume < builder->last_cumulative[id])
+               ? stock->volume : stock->volume - builder->last_cumulative[id];
+    }
+    builder->last_cumulative[id] = stock->volume;
+    builder->last_time[id] = when;
+    add_to_bars(builder, id, when, stock->current_price, volume > 0 ? volume : 0.0);
+    return 1;
+}
+
+// Close every open bar whose period ended by `now`
+int bar_builder_close(BarBuilder* builder, long long now) {
+    if (!builder) {
+        return 0;
+    }
+    long long before = builder->bars_closed;
+    for (int id = 0; id < builder->symbols.count; id++) {
+        for (int k = 0; k < BAR_INTERVAL_COUNT; k++) {
+            const OhlcvBar* bar = &builder_series(builder, id, (BarInterval)k)->current;
+            if (bar->trades > 0 && (now <= 0 || bar_period_start(now, BAR_SECONDS[k]) > bar->start)) {
+                close_bar(builder, id, (BarInterval)k);
+            }
+        }
+    }
+    return (int)(builder->bars_closed - before);
+}
+
+// Write closed bars that have not been written yet to each interval's sink
+int bar_builder_flush(BarBuilder* builder) {
+    if (!builder) {
+        return -1;
+    }
+    int written = 0;
+    for (int k = 0; k < BAR_INTERVAL_COUNT; k++) {
+        HistoryStore* sink = builder->sinks[k];
+        for (int id = 0; id < builder->symbols.count; id++) {
+            BarSeries* series = builder_series(builder, id, (BarInterval)k);
+            if (series->unflushed == 0) {
+                continue;
+            }
+            if (sink) {
+                PriceSeries* target = history_store_series(sink, symbol_map_name(&builder->symbols, id), 1);
+                if (!target) {
+                    return -1;
+                }
+                const OhlcvBar* ring = builder_ring(builder, id, (BarInterval)k);
+                for (int n = series->unflushed; n > 0; n--) {
+                    const OhlcvBar* bar = &ring[(series->head - n + builder->ring_capacity) % builder->ring_capacity];
+                    if (!price_series_append(target, bar->start, bar->open, bar->high, bar->low,
+                                             bar->close, bar->volume)) {
+                        return -1;
+                    }
+                    written++;
+                }
+            }
+            series->unflushed = 0;
+        }
+    }
+    return written;
+}
+
+// Open bar of a symbol
+const OhlcvBar* bar_builder_current(const BarBuilder* builder, const char* symbol, BarInterval interval) {
+    if (!builder || interval < 0 || interval >= BAR_INTERVAL_COUNT) {
+        return NULL;
+    }
+    int id = symbol_map_find(&builder->symbols, symbol);
+    if (id < 0) {
+        return NULL;
+    }
+    const OhlcvBar* bar = &builder_series(builder, id, interval)->current;
+    return bar->trades > 0 ? bar : NULL;
+}
+
+// A recently closed bar of a symbol, 0 = newest
+const OhlcvBar* bar_builder_recent(const BarBuilder* builder, const char* symbol, BarInterval interval, int back) {
+    if (!builder || interval < 0 || interval >= BAR_INTERVAL_COUNT || back < 0) {
+        return NULL;
+    }
+    int id = symbol_map_find(&builder->symbols, symbol);
+    if (id < 0) {
+        return NULL;
+    }
+    const BarSeries* series = builder_series(builder, id, interval);
+    if (back >= series->count) {
+        return NULL;
+    }
+    int slot = (series->head - 1 - back + 2 * builder->ring_capacity) % builder->ring_capacity;
+    return &builder_ring(builder, id, interval)[slot];
+}
+
+// Volume-weighted average price of a bar
+double bar_vwap(const OhlcvBar* bar) {
+    if (!bar) {
+        return 0.0;
+    }
+    return bar->volume > 0 ? bar->turnover / bar->volume : bar->close;
+}
+
+// Length of an interval
+int bar_interval_seconds(BarInterval interval) {
+    return (interval >= 0 && interval < BAR_INTERVAL_COUNT) ? BAR_SECONDS[interval] : 0;
+}
+
+// Name of an interval
+const char* bar_interval_name(BarInterval interval) {
+    return (interval >= 0 && interval < BAR_INTERVAL_COUNT) ? BAR_NAMES[interval] : "unknown";
+}
@@ -0,0 +1,924 @@
+/*
+ * Smart Stock Tracker - Microbenchmarks
+ * Times the hot paths over synthetic universes of different sizes
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * Usage: ./stock_bench [--format csv|json] [--sizes 10,10000,1000000]
+ *                      [--min-time-ms N] [--filter substring] [--seed N]
+ *                      [--scaling]
+ *
+ * Each result row reports ns/op, ops/sec and heap allocations per op.
+ * Aggregate benchmarks count one call over the whole universe as an op;
+ * per-symbol benchmarks count one call on a single stock as an op.
+ *
+ * --scaling times market_scan_parallel() against the serial analysis
+ * functions it replaces at 1, 2, 4, ... threads, on universes of 1M to 10M
+ * symbols by default. Each universe is first checked for identical results.
+ */
+
+#include "stock_tracker.h"
+#include <time.h>
+
+#ifndef BENCH_REVISION
+#define BENCH_REVISION "unknown"
+#endif
+
+#define BENCH_MAX_SIZES 8
+#define BENCH_JSON_POOL 4096                  // Distinct API responses for the parser benchmark
+#define BENCH_QUADRATIC_LIMIT 10000           // Largest universe for O(n^2) benchmarks
+#define BENCH_OUTPUT_DIR "bench_out"
+#define BENCH_ALERT_ANY_LEVELS 1000           // Any-symbol price levels, $1..$1000
+#define BENCH_PORTFOLIO_ACCOUNTS 10000
+#define BENCH_POSITIONS_PER_ACCOUNT 100
+#define BENCH_INDUSTRIES_PER_SECTOR 8
+#define BENCH_INDEX_MEMBERS 500               // Symbols in the custom breadth index
+#define BENCH_LEADERBOARD_PAGE 20             // Entries per leaderboard page
+#define BENCH_BAR_RING 4                      // Closed bars kept per symbol and interval
+#define BENCH_SCALING_INVALID 100             // Every Nth scaling symbol has no price
+
+// =============================================================================
+// ALLOCATION COUNTING
+// =============================================================================
+
+// Every malloc/calloc/realloc in the process (including libc and json-c
+// internals) is routed through these wrappers so allocations/op is exact.
+static unsigned long long allocation_count = 0;
+
+#ifdef __GLIBC__
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size) {
+    __atomic_add_fetch(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    __atomic_add_fetch(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    __atomic_add_fetch(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __libc_realloc(ptr, size);
+}
+#define ALLOCATIONS_COUNTED 1
+#else
+#define ALLOCATIONS_COUNTED 0
+#endif
+
+// =============================================================================
+// HARNESS
+// =============================================================================
+
+// Shared state handed to every benchmark body
+typedef struct {
+    Stock* universe;          // Synthetic stocks
+    Stock* scratch;           // Copy target for destructive benchmarks
+    int count;                // Universe size
+    char** json_pool;         // Preformatted GLOBAL_QUOTE responses
+    int json_count;
+    double* prices;           // Price column for the moving average
+    double* changes;          // Change percent column for column classifiers
+    double* volumes;          // Volume column for column classifiers
+    unsigned char* codes;     // Output codes for column classifiers
+    SimSymbol* sim_states;    // Generator state behind the universe
+    QuoteStore quotes;        // Same universe as hot records + cold metadata
+    AlertEngine alerts;       // Per-symbol and any-symbol alert rules
+    Portfolio portfolio;      // BENCH_PORTFOLIO_ACCOUNTS accounts over the universe
+    int* portfolio_ids;       // Portfolio symbol id for each universe stock
+    BreadthEngine breadth;    // Sector, industry and index groups over the universe
+    RankIndex ranks;          // Change, volume and price order of the universe
+    VolumeProfile volume_profile;  // Volume baselines for the universe
+    BarBuilder bars;          // Intraday bars for the universe
+} BenchContext;
+
+typedef void (*BenchBody)(BenchContext* ctx, long long iteration);
+
+typedef struct {
+    const char* name;
+    BenchBody body;
+    int quadratic;            // Skip above BENCH_QUADRATIC_LIMIT
+} BenchCase;
+
+static volatile double bench_sink = 0.0;   // Defeats dead-code elimination
+static int output_json = 0;
+static long long min_time_ns = 200000000LL;
+static const char* name_filter = NULL;
+static unsigned long long bench_seed = SIM_DEFAULT_SEED;
+static SimConfig tick_config;
+
+// Build a universe of count synthetic stocks from the market generator
+static Stock* build_universe(int count, SimSymbol** states_out) {
+    Stock* stocks = malloc((size_t)count * sizeof(Stock));
+    SimSymbol* states = malloc((size_t)count * sizeof(SimSymbol));
+    if (!stocks || !states) {
+        free(stocks);
+        free(states);
+        return NULL;
+    }
+
+    SimConfig config;
+    sim_default_config(&config);
+    config.seed = bench_seed;
+
+    for (int i = 0; i < count; i++) {
+        char symbol[MAX_SYMBOL_LENGTH];
+        snprintf(symbol, sizeof(symbol), "S%07d", i % 10000000);
+        sim_init_symbol(&config, &states[i], symbol, -1);
+    }
+
+    // Half a session of one-minute ticks gives a spread of intraday changes
+    config.tick_seconds = 60.0;
+    config.ticks_per_session = 390;
+    sim_generate_parallel(&config, states, count, 195, 0, NULL, NULL);
+
+    for (int i = 0; i < count; i++) {
+        Stock* s = &stocks[i];
+        memset(s, 0, sizeof(*s));
+        sim_fill_stock(&states[i], s);
+        snprintf(s->name, sizeof(s->name), "Synthetic Company %d", i);
+        analyze_stock_performance(s);
+    }
+
+    *states_out = states;
+    return stocks;
+}
+
+// Four price levels and two move levels per symbol, plus any-symbol rules
+static int build_alert_rules(AlertEngine* engine, const Stock* stocks, int count) {
+    static const double PRICE_OFFSETS[] = {0.98, 0.99, 1.01, 1.02};
+    if (!alert_engine_init(engine)) {
+        return 0;
+    }
+    for (int i = 0; i < count; i++) {
+        for (int k = 0; k < 4; k++) {
+            if (alert_engine_add(engine, stocks[i].symbol, ALERT_CROSSES,
+                                 stocks[i].current_price * PRICE_OFFSETS[k]) < 0) {
+                return 0;
+            }
+        }
+        if (alert_engine_add(engine, stocks[i].symbol, ALERT_MOVES, 3.0) < 0 ||
+            alert_engine_add(engine, stocks[i].symbol, ALERT_MOVES, 6.0) < 0) {
+            return 0;
+        }
+    }
+    for (int level = 1; level <= BENCH_ALERT_ANY_LEVELS; level++) {
+        if (alert_engine_add(engine, NULL, ALERT_CROSSES, level) < 0) {
+            return 0;
+        }
+    }
+    return alert_engine_add(engine, NULL, ALERT_MOVES, 5.0) >= 0;
+}
+
+// Each account holds a run of consecutive symbols starting at a spread-out offset
+static int build_portfolio(Portfolio* portfolio, int* ids, const Stock* stocks, int count) {
+    if (!portfolio_init(portfolio)) {
+        return 0;
+    }
+    int held = count < BENCH_POSITIONS_PER_ACCOUNT ? count : BENCH_POSITIONS_PER_ACCOUNT;
+    for (int a = 0; a < BENCH_PORTFOLIO_ACCOUNTS; a++) {
+        char account[MAX_SYMBOL_LENGTH];
+        snprintf(account, sizeof(account), "A%07d", a);
+        for (int k = 0; k < held; k++) {
+            const Stock* s = &stocks[((long long)a * 7919 + k) % count];
+            if (!portfolio_add_position(portfolio, account, s->symbol, 10 + (a + k) % 90,
+                                        s->previous_close * 0.9)) {
+                return 0;
+            }
+        }
+    }
+    if (!portfolio_build(portfolio)) {
+        return 0;
+    }
+    for (int i = 0; i < count; i++) {
+        ids[i] = symbol_map_find(&portfolio->symbols, stocks[i].symbol);
+    }
+    return 1;
+}
+
+// Groups from the generator's sectors, a few industries per sector and one custom index
+static int build_breadth_groups(BreadthEngine* engine, const Stock* stocks,
+                                const SimSymbol* states, int count) {
+    if (!breadth_init(engine)) {
+        return 0;
+    }
+    for (int i = 0; i < count; i++) {
+        char name[BREADTH_NAME_LENGTH];
+        snprintf(name, sizeof(name), "Sector %d", states[i].sector);
+        if (!breadth_assign(engine, stocks[i].symbol, breadth_group_id(engine, BREADTH_SECTOR, name))) {
+            return 0;
+        }
+        snprintf(name, sizeof(name), "Industry %d.%d", states[i].sector, i % BENCH_INDUSTRIES_PER_SECTOR);
+        if (!breadth_assign(engine, stocks[i].symbol, breadth_group_id(engine, BREADTH_INDUSTRY, name))) {
+            return 0;
+        }
+        if (i < BENCH_INDEX_MEMBERS &&
+            !breadth_assign(engine, stocks[i].symbol, breadth_group_id(engine, BREADTH_INDEX, "Bench 500"))) {
+            return 0;
+        }
+        if (!breadth_set_range(engine, stocks[i].symbol, stocks[i].day_high, stocks[i].day_low) ||
+            !breadth_update(engine, &stocks[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Build API responses in the Alpha Vantage GLOBAL_QUOTE shape
+static char** build_json_pool(const Stock* stocks, int count) {
+    char** pool = malloc((size_t)count * sizeof(char*));
+    if (!pool) {
+        return NULL;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const Stock* s = &stocks[i];
+        char buffer[1024];
+        snprintf(buffer, sizeof(buffer),
+                 "{\n    \"Global Quote\": {\n"
+                 "        \"01. symbol\": \"%s\",\n"
+                 "        \"02. open\": \"%.4f\",\n"
+                 "        \"03. high\": \"%.4f\",\n"
+                 "        \"04. low\": \"%.4f\",\n"
+                 "        \"05. price\": \"%.4f\",\n"
+                 "        \"06. volume\": \"%.0f\",\n"
+                 "        \"07. latest trading day\": \"2025-10-10\",\n"
+                 "        \"08. previous close\": \"%.4f\",\n"
+                 "        \"09. change\": \"%.4f\",\n"
+                 "        \"10. change percent\": \"%.4f%%\"\n"
+                 "    }\n}",
+                 s->symbol, s->previous_close, s->day_high, s->day_low,
+                 s->current_price, s->volume, s->previous_close,
+                 s->current_price - s->previous_close, s->change_percent);
+        pool[i] = malloc(strlen(buffer) + 1);
+        strcpy(pool[i], buffer);
+    }
+    return pool;
+}
+
+static void print_result(const char* name, int universe, long long iterations,
+                         long long elapsed_ns, unsigned long long allocations) {
+    double ns_per_op = (double)elapsed_ns / iterations;
+    double ops_per_sec = ns_per_op > 0 ? 1e9 / ns_per_op : 0.0;
+    double allocs_per_op = ALLOCATIONS_COUNTED ? (double)allocations / iterations : -1.0;
+
+    if (output_json) {
+        printf("{\"revision\":\"%s\",\"benchmark\":\"%s\",\"universe\":%d,\"iterations\":%lld,"
+               "\"ns_per_op\":%.2f,\"ops_per_sec\":%.2f,\"allocs_per_op\":%.3f}\n",
+               BENCH_REVISION, name, universe, iterations, ns_per_op, ops_per_sec, allocs_per_op);
+    } else {
+        printf("%s,%s,%d,%lld,%.2f,%.2f,%.3f\n",
+               BENCH_REVISION, name, universe, iterations, ns_per_op, ops_per_sec, allocs_per_op);
+    }
+    fflush(stdout);
+}
+
+// Run one benchmark: grow the iteration count until min_time_ns is covered
+static void run_case(const BenchCase* bench, BenchContext* ctx) {
+    if (name_filter && !strstr(bench->name, name_filter)) {
+        return;
+    }
+    if (bench->quadratic && ctx->count > BENCH_QUADRATIC_LIMIT) {
+        fprintf(stderr, "skipping %s at %d symbols (O(n^2))\n", bench->name, ctx->count);
+        return;
+    }
+
+    bench->body(ctx, 0);  // Warm-up
+
+    long long batch = 1;
+    for (;;) {
+        unsigned long long allocations_before = __atomic_load_n(&allocation_count, __ATOMIC_RELAXED);
+        long long start = metrics_now_ns();
+        for (long long i = 0; i < batch; i++) {
+            bench->body(ctx, i);
+        }
+        long long elapsed = metrics_now_ns() - start;
+        unsigned long long allocations = __atomic_load_n(&allocation_count, __ATOMIC_RELAXED) - allocations_before;
+
+        if (elapsed >= min_time_ns || batch >= (1LL << 40)) {
+            print_result(bench->name, ctx->count, batch, elapsed, allocations);
+            return;
+        }
+
+        // Aim straight for the target time, at most 100x per step
+        long long next = elapsed > 0 ? (long long)(batch * 1.2 * min_time_ns / elapsed) : batch * 100;
+        if (next > batch * 100) next = batch * 100;
+        if (next <= batch) next = batch * 2;
+        batch = next;
+    }
+}
+
+// =============================================================================
+// BENCHMARK BODIES
+// =============================================================================
+
+static void bench_parse_stock_json(BenchContext* ctx, long long i) {
+    Stock stock;
+    int index = (int)(i % ctx->json_count);
+    strcpy(stock.symbol, ctx->universe[index].symbol);
+    parse_stock_json(ctx->json_pool[index], &stock);
+    bench_sink += stock.current_price;
+}
+
+static void bench_analyze_stock_performance(BenchContext* ctx, long long i) {
+    analyze_stock_performance(&ctx->universe[i % ctx->count]);
+}
+
+static void bench_generate_recommendation(BenchContext* ctx, long long i) {
+    bench_sink += generate_recommendation(&ctx->universe[i % ctx->count])[0];
+}
+
+static void bench_classify_status_column(BenchContext* ctx, long long i) {
+    (void)i;
+    classify_status_column(compiled_rules_active(), ctx->prices, ctx->changes, ctx->count, ctx->codes);
+    bench_sink += ctx->codes[0];
+}
+
+static void bench_classify_recommendation_column(BenchContext* ctx, long long i) {
+    (void)i;
+    classify_recommendation_column(compiled_rules_active(), ctx->prices, ctx->changes, ctx->volumes,
+                                   ctx->count, ctx->codes);
+    bench_sink += ctx->codes[0];
+}
+
+static void bench_calculate_rsi(BenchContext* ctx, long long i) {
+    bench_sink += calculate_rsi(&ctx->universe[i % ctx->count]);
+}
+
+static void bench_detect_price_pattern(BenchContext* ctx, long long i) {
+    bench_sink += detect_price_pattern(&ctx->universe[i % ctx->count])[0];
+}
+
+static void bench_calculate_support_resistance(BenchContext* ctx, long long i) {
+    double support, resistance;
+    calculate_support_resistance(&ctx->universe[i % ctx->count], &support, &resistance);
+    bench_sink += support + resistance;
+}
+
+static void bench_assess_risk_level(BenchContext* ctx, long long i) {
+    bench_sink += assess_risk_level(&ctx->universe[i % ctx->count])[0];
+}
+
+static void bench_validate_stock_symbol(BenchContext* ctx, long long i) {
+    char clean[MAX_SYMBOL_LENGTH];
+    bench_sink += validate_stock_symbol(ctx->universe[i % ctx->count].symbol, clean, sizeof(clean));
+}
+
+static void bench_find_best_performing_stock(BenchContext* ctx, long long i) {
+    (void)i;
+    bench_sink += find_best_performing_stock(ctx->universe, ctx->count)->change_percent;
+}
+
+static void bench_find_most_volatile_stock(BenchContext* ctx, long long i) {
+    (void)i;
+    bench_sink += find_most_volatile_stock(ctx->universe, ctx->count)->change_percent;
+}
+
+static void bench_count_bullish_stocks(BenchContext* ctx, long long i) {
+    (void)i;
+    bench_sink += count_bullish_stocks(ctx->universe, ctx->count);
+}
+
+static void bench_calculate_total_value(BenchContext* ctx, long long i) {
+    (void)i;
+    bench_sink += calculate_total_value(ctx->universe, ctx->count);
+}
+
+static void bench_calculate_simple_moving_average(BenchContext* ctx, long long i) {
+    (void)i;
+    bench_sink += calculate_simple_moving_average(ctx->prices, ctx->count, ctx->count);
+}
+
+static void bench_analyze_market_sentiment(BenchContext* ctx, long long i) {
+    (void)i;
+    bench_sink += analyze_market_sentiment(ctx->universe, ctx->count)[0];
+}
+
+static void bench_calculate_portfolio_diversity(BenchContext* ctx, long long i) {
+    (void)i;
+    bench_sink += calculate_portfolio_diversity(ctx->universe, ctx->count);
+}
+
+static void bench_find_unusual_volume_stock(BenchContext* ctx, long long i) {
+    (void)i;
+    bench_sink += find_unusual_volume_stock(ctx->universe, ctx->count)->volume;
+}
+
+static void bench_calculate_average_change(BenchContext* ctx, long long i) {
+    (void)i;
+    bench_sink += calculate_average_change(ctx->universe, ctx->count);
+}
+
+static void bench_market_scan_parallel(BenchContext* ctx, long long i) {
+    (void)i;
+    MarketScan scan;
+    market_scan_parallel(ctx->universe, ctx->count, 0, &scan);
+    bench_sink += scan.change_sum;
+}
+
+static void bench_analyze_all_stocks(BenchContext* ctx, long long i) {
+    (void)i;
+    for (int s = 0; s < ctx->count; s++) {
+        analyze_stock_performance(&ctx->universe[s]);
+    }
+}
+
+static void bench_quote_store_analyze(BenchContext* ctx, long long i) {
+    (void)i;
+    quote_store_analyze(&ctx->quotes);
+}
+
+static void bench_quote_store_best_performer(BenchContext* ctx, long long i) {
+    (void)i;
+    bench_sink += quote_store_best_performer(&ctx->quotes);
+}
+
+static void bench_quote_store_count_bullish(BenchContext* ctx, long long i) {
+    (void)i;
+    bench_sink += quote_store_count_bullish(&ctx->quotes);
+}
+
+static void bench_quote_store_total_value(BenchContext* ctx, long long i) {
+    (void)i;
+    bench_sink += quote_store_total_value(&ctx->quotes);
+}
+
+static void bench_quote_store_average_change(BenchContext* ctx, long long i) {
+    (void)i;
+    bench_sink += quote_store_average_change(&ctx->quotes);
+}
+
+static void bench_quote_store_put(BenchContext* ctx, long long i) {
+    quote_store_put(&ctx->quotes, &ctx->universe[i % ctx->count]);
+}
+
+// One op = one quote update; alternate passes move every price 1.5% down and back up
+static void bench_alert_engine_check(BenchContext* ctx, long long i) {
+    Stock stock = ctx->universe[i % ctx->count];
+    if ((i / ctx->count) & 1) {
+        stock.current_price *= 0.985;
+    }
+    bench_sink += alert_engine_check(&ctx->alerts, &stock);
+}
+
+// One op = a refresh where every symbol's price moves (all held positions are touched)
+static void bench_portfolio_refresh(BenchContext* ctx, long long i) {
+    double factor = (i & 1) ? 1.001 : 1.0;
+    for (int s = 0; s < ctx->count; s++) {
+        portfolio_apply_price(&ctx->portfolio, ctx->portfolio_ids[s],
+                              ctx->universe[s].current_price * factor, ctx->universe[s].previous_close);
+    }
+    bench_sink += ctx->portfolio.firm.market_value;
+}
+
+// Same refresh done by recomputing everything, for comparison
+static void bench_portfolio_recompute(BenchContext* ctx, long long i) {
+    (void)i;
+    portfolio_recompute(&ctx->portfolio);
+    bench_sink += ctx->portfolio.firm.market_value;
+}
+
+// One op = one quote update; alternate passes flip every symbol between advancing and declining
+static void bench_breadth_update(BenchContext* ctx, long long i) {
+    Stock stock = ctx->universe[i % ctx->count];
+    if ((i / ctx->count) & 1) {
+        stock.change_percent = -stock.change_percent - 0.5;
+    }
+    breadth_update(&ctx->breadth, &stock);
+    bench_sink += ctx->breadth.groups[0].advancers;
+}
+
+// Every group recounted from scratch, what a rescan per refresh would cost
+static void bench_breadth_recompute(BenchContext* ctx, long long i) {
+    (void)i;
+    breadth_recompute(&ctx->breadth);
+    bench_sink += ctx->breadth.groups[0].advancers;
+}
+
+// One op = one quote update; alternate passes move every change by a point
+static void bench_rank_index_update(BenchContext* ctx, long long i) {
+    Stock stock = ctx->universe[i % ctx->count];
+    if ((i / ctx->count) & 1) {
+        stock.change_percent += 1.0;
+    }
+    bench_sink += rank_index_update(&ctx->ranks, &stock);
+}
+
+// One op = one leaderboard page at a rotating offset
+static void bench_rank_index_page(BenchContext* ctx, long long i) {
+    int ids[BENCH_LEADERBOARD_PAGE];
+    int offset = (int)((i * 7919) % ctx->count);
+    bench_sink += rank_index_range(&ctx->ranks, RANK_BY_CHANGE, 1, offset, BENCH_LEADERBOARD_PAGE, ids);
+}
+
+static void bench_rank_index_rank(BenchContext* ctx, long long i) {
+    bench_sink += rank_index_rank(&ctx->ranks, RANK_BY_VOLUME, ctx->universe[i % ctx->count].symbol);
+}
+
+static void bench_rank_index_percentile(BenchContext* ctx, long long i) {
+    bench_sink += rank_index_percentile(&ctx->ranks, RANK_BY_PRICE, ctx->universe[i % ctx->count].symbol);
+}
+
+// One op = one quote a minute after the symbol's previous one, with 1% more day volume
+static void bench_volume_profile_update(BenchContext* ctx, long long i) {
+    Stock stock = ctx->universe[i % ctx->count];
+    long long pass = i / ctx->count;
+    stock.volume *= 1.0 + 0.01 * (pass + 1);
+    stock.last_update = 1759757400 + 3600 + 60 * pass;
+    bench_sink += volume_profile_update(&ctx->volume_profile, &stock, NULL);
+}
+
+static void bench_volume_profile_top(BenchContext* ctx, long long i) {
+    (void)i;
+    int ids[VOLUME_TOP_SYMBOLS];
+    bench_sink += volume_profile_top(&ctx->volume_profile, VOLUME_TOP_SYMBOLS, ids);
+}
+
+// One op = one quote 20s after the symbol's previous one, so every third pass closes a 1m bar
+static void bench_bar_builder_update(BenchContext* ctx, long long i) {
+    Stock stock = ctx->universe[i % ctx->count];
+    long long pass = i / ctx->count;
+    stock.volume *= 1.0 + 0.01 * (pass + 1);
+    stock.current_price *= 1.0 + 0.001 * (pass % 7);
+    stock.last_update = 1759757400 + 20 * pass;
+    bench_sink += bar_builder_update(&ctx->bars, &stock);
+}
+
+// One op = a sweep closing every bar that ended by a later minute, then draining the rings
+static void bench_bar_builder_close(BenchContext* ctx, long long i) {
+    bench_sink += bar_builder_close(&ctx->bars, 1759757400 + 7200 + 60 * i);
+    bench_sink += bar_builder_flush(&ctx->bars);
+}
+
+static void bench_generate_market_summary(BenchContext* ctx, long long i) {
+    (void)i;
+    char summary[1024];
+    generate_market_summary(ctx->universe, ctx->count, summary, sizeof(summary));
+    bench_sink += summary[0];
+}
+
+static void bench_copy_universe(BenchContext* ctx, long long i) {
+    (void)i;
+    memcpy(ctx->scratch, ctx->universe, (size_t)ctx->count * sizeof(Stock));
+}
+
+static void bench_qsort_compare_stock_change(BenchContext* ctx, long long i) {
+    (void)i;
+    memcpy(ctx->scratch, ctx->universe, (size_t)ctx->count * sizeof(Stock));
+    qsort(ctx->scratch, ctx->count, sizeof(Stock), compare_stock_change);
+}
+
+static void bench_sort_stocks_by_performance(BenchContext* ctx, long long i) {
+    (void)i;
+    memcpy(ctx->scratch, ctx->universe, (size_t)ctx->count * sizeof(Stock));
+    sort_stocks_by_performance(ctx->scratch, ctx->count);
+}
+
+static void bench_sim_next_tick(BenchContext* ctx, long long i) {
+    SimTick tick;
+    sim_next_tick(&tick_config, &ctx->sim_states[i % ctx->count], &tick);
+    bench_sink += tick.price;
+}
+
+// One op = one tick for every symbol in the universe, on all cores
+static void bench_sim_generate_parallel(BenchContext* ctx, long long i) {
+    (void)i;
+    sim_generate_parallel(&tick_config, ctx->sim_states, ctx->count, 1, 0, NULL, NULL);
+}
+
+static void bench_generate_json_file(BenchContext* ctx, long long i) {
+    (void)i;
+    generate_json_file(ctx->universe, ctx->count, BENCH_OUTPUT_DIR "/dashboard.json");
+}
+
+static void bench_write_all_stocks_json(BenchContext* ctx, long long i) {
+    (void)i;
+    write_all_stocks_json(ctx->universe, ctx->count);
+}
+
+static void bench_write_best_stock_json(BenchContext* ctx, long long i) {
+    (void)i;
+    write_best_stock_json(ctx->universe, ctx->count);
+}
+
+static void bench_write_trending_json(BenchContext* ctx, long long i) {
+    (void)i;
+    write_trending_json(ctx->universe, ctx->count);
+}
+
+static const BenchCase BENCH_CASES[] = {
+    {"parse_stock_json", bench_parse_stock_json, 0},
+    {"analyze_stock_performance", bench_analyze_stock_performance, 0},
+    {"generate_recommendation", bench_generate_recommendation, 0},
+    {"classify_status_column", bench_classify_status_column, 0},
+    {"classify_recommendation_column", bench_classify_recommendation_column, 0},
+    {"calculate_rsi", bench_calculate_rsi, 0},
+    {"detect_price_pattern", bench_detect_price_pattern, 0},
+    {"calculate_support_resistance", bench_calculate_support_resistance, 0},
+    {"assess_risk_level", bench_assess_risk_level, 0},
+    {"validate_stock_symbol", bench_validate_stock_symbol, 0},
+    {"find_best_performing_stock", bench_find_best_performing_stock, 0},
+    {"find_most_volatile_stock", bench_find_most_volatile_stock, 0},
+    {"count_bullish_stocks", bench_count_bullish_stocks, 0},
+    {"calculate_total_value", bench_calculate_total_value, 0},
+    {"calculate_simple_moving_average", bench_calculate_simple_moving_average, 0},
+    {"analyze_market_sentiment", bench_analyze_market_sentiment, 0},
+    {"calculate_portfolio_diversity", bench_calculate_portfolio_diversity, 0},
+    {"find_unusual_volume_stock", bench_find_unusual_volume_stock, 0},
+    {"calculate_average_change", bench_calculate_average_change, 0},
+    {"market_scan_parallel", bench_market_scan_parallel, 0},
+    {"analyze_all_stocks", bench_analyze_all_stocks, 0},
+    {"quote_store_analyze", bench_quote_store_analyze, 0},
+    {"quote_store_best_performer", bench_quote_store_best_performer, 0},
+    {"quote_store_count_bullish", bench_quote_store_count_bullish, 0},
+    {"quote_store_total_value", bench_quote_store_total_value, 0},
+    {"quote_store_average_change", bench_quote_store_average_change, 0},
+    {"quote_store_put", bench_quote_store_put, 0},
+    {"alert_engine_check", bench_alert_engine_check, 0},
+    {"portfolio_refresh", bench_portfolio_refresh, 0},
+    {"portfolio_recompute", bench_portfolio_recompute, 0},
+    {"breadth_update", bench_breadth_update, 0},
+    {"breadth_recompute", bench_breadth_recompute, 0},
+    {"rank_index_update", bench_rank_index_update, 0},
+    {"rank_index_page", bench_rank_index_page, 0},
+    {"rank_index_rank", bench_rank_index_rank, 0},
+    {"rank_index_percentile", bench_rank_index_percentile, 0},
+    {"volume_profile_update", bench_volume_profile_update, 0},
+    {"volume_profile_top", bench_volume_profile_top, 0},
+    {"bar_builder_update", bench_bar_builder_update, 0},
+    {"bar_builder_close", bench_bar_builder_close, 0},
+    {"generate_market_summary", bench_generate_market_summary, 0},
+    {"copy_universe", bench_copy_universe, 0},
+    {"qsort_compare_stock_change", bench_qsort_compare_stock_change, 0},
+    {"sort_stocks_by_performance", bench_sort_stocks_by_performance, 1},
+    {"sim_next_tick", bench_sim_next_tick, 0},
+    {"sim_generate_parallel", bench_sim_generate_parallel, 0},
+    {"generate_json_file", bench_generate_json_file, 0},
+    {"write_all_stocks_json", bench_write_all_stocks_json, 0},
+    {"write_best_stock_json", bench_write_best_stock_json, 0},
+    {"write_trending_json", bench_write_trending_json, 0},
+};
+#define BENCH_CASE_COUNT (int)(sizeof(BENCH_CASES) / sizeof(BENCH_CASES[0]))
+
+// =============================================================================
+// DRIVER
+// =============================================================================
+
+static void run_universe(int count) {
+    BenchContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.count = count;
+    ctx.universe = build_universe(count, &ctx.sim_states);
+    ctx.scratch = malloc((size_t)count * sizeof(Stock));
+    ctx.prices = malloc((size_t)count * sizeof(double));
+    ctx.changes = malloc((size_t)count * sizeof(double));
+    ctx.volumes = malloc((size_t)count * sizeof(double));
+    ctx.codes = malloc((size_t)count);
+    ctx.json_count = count < BENCH_JSON_POOL ? count : BENCH_JSON_POOL;
+    ctx.json_pool = ctx.universe ? build_json_pool(ctx.universe, ctx.json_count) : NULL;
+    int quotes_ready = quote_store_init(&ctx.quotes, count);
+    int alerts_ready = ctx.universe && build_alert_rules(&ctx.alerts, ctx.universe, count);
+    ctx.portfolio_ids = malloc((size_t)count * sizeof(int));
+    int portfolio_ready = ctx.universe && ctx.portfolio_ids &&
+                          build_portfolio(&ctx.portfolio, ctx.portfolio_ids, ctx.universe, count);
+    int breadth_ready = ctx.universe &&
+                        build_breadth_groups(&ctx.breadth, ctx.universe, ctx.sim_states, count);
+    int ranks_ready = ctx.universe && rank_index_init(&ctx.ranks, count);
+    for (int i = 0; ranks_ready && i < count; i++) {
+        ranks_ready = rank_index_update(&ctx.ranks, &ctx.universe[i]);
+    }
+    int volumes_ready = volume_profile_init(&ctx.volume_profile, count);
+    int bars_ready = bar_builder_init(&ctx.bars, count, BENCH_BAR_RING);
+
+    if (!ctx.universe || !ctx.scratch || !ctx.prices || !ctx.changes || !ctx.volumes ||
+        !ctx.codes || !ctx.json_pool || !quotes_ready || !alerts_ready ||
+        !portfolio_ready || !breadth_ready || !ranks_ready ||
+        !volumes_ready || !bars_ready) {
+        fprintf(stderr, "out of memory for a universe of %d symbols\n", count);
+    } else {
+        for (int i = 0; i < count; i++) {
+            ctx.prices[i] = ctx.universe[i].current_price;
+            ctx.changes[i] = ctx.universe[i].change_percent;
+            ctx.volumes[i] = ctx.universe[i].volume;
+            quote_store_put(&ctx.quotes, &ctx.universe[i]);
+        }
+
+        size_t hot_bytes = 0;
+        size_t store_bytes = quote_store_footprint(&ctx.quotes, &hot_bytes);
+        fprintf(stderr, "footprint at %d symbols: Stock[] %.1f MB (%zu B/record), "
+                        "QuoteStore %.1f MB (hot %.1f MB, %zu B/record)\n",
+                count, count * sizeof(Stock) / 1048576.0, sizeof(Stock),
+                store_bytes / 1048576.0, hot_bytes / 1048576.0, sizeof(StockQuote));
+        for (int c = 0; c < BENCH_CASE_COUNT; c++) {
+            run_case(&BENCH_CASES[c], &ctx);
+        }
+    }
+
+    if (ctx.json_pool) {
+        for (int i = 0; i < ctx.json_count; i++) {
+            free(ctx.json_pool[i]);
+        }
+        free(ctx.json_pool);
+    }
+    free(ctx.prices);
+    free(ctx.changes);
+    free(ctx.volumes);
+    free(ctx.codes);
+    free(ctx.scratch);
+    free(ctx.universe);
+    free(ctx.sim_states);
+    quote_store_free(&ctx.quotes);
+    alert_engine_free(&ctx.alerts);
+    portfolio_free(&ctx.portfolio);
+    free(ctx.portfolio_ids);
+    breadth_free(&ctx.breadth);
+    rank_index_free(&ctx.ranks);
+    volume_profile_free(&ctx.volume_profile);
+    bar_builder_free(&ctx.bars);
+}
+
+// =============================================================================
+// SCALING
+// =============================================================================
+
+static int scaling_threads = 1;           // Thread count of the next scaling run
+
+// Every serial aggregate that one market scan replaces
+static void bench_serial_analysis(BenchContext* ctx, long long i) {
+    (void)i;
+    Stock* stocks = ctx->universe;
+    int count = ctx->count;
+    bench_sink += find_best_performing_stock(stocks, count)->change_percent;
+    bench_sink += find_most_volatile_stock(stocks, count)->change_percent;
+    bench_sink += find_unusual_volume_stock(stocks, count)->volume;
+    bench_sink += count_bullish_stocks(stocks, count);
+    bench_sink += calculate_total_value(stocks, count);
+    bench_sink += calculate_average_change(stocks, count);
+    bench_sink += analyze_market_sentiment(stocks, count)[0];
+    bench_sink += calculate_portfolio_diversity(stocks, count);
+}
+
+static void bench_scaling_scan(BenchContext* ctx, long long i) {
+    (void)i;
+    MarketScan scan;
+    market_scan_parallel(ctx->universe, ctx->count, scaling_threads, &scan);
+    bench_sink += market_scan_average_change(&scan) + market_scan_diversity(&scan) +
+                  market_scan_sentiment(&scan)[0];
+}
+
+// Cheap random quotes: the market generator is too slow for 10M symbols.
+// Changes are rounded to cents of a percent so ties between symbols happen
+static Stock* build_scaling_universe(int count) {
+    Stock* stocks = calloc((size_t)count, sizeof(Stock));
+    if (!stocks) {
+        return NULL;
+    }
+    unsigned long long state = bench_seed * 0x9E3779B97F4A7C15ULL + 1;
+    for (int i = 0; i < count; i++) {
+        Stock* s = &stocks[i];
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        snprintf(s->symbol, sizeof(s->symbol), "S%07d", i % 10000000);
+        s->current_price = i % BENCH_SCALING_INVALID == 0 ? 0.0 : 5.0 + (double)(state % 49500) / 100.0;
+        s->change_percent = ((double)((state >> 16) % 2001) - 1000.0) / 100.0;
+        s->volume = (double)((state >> 32) % 10000000);
+        s->previous_close = s->current_price;
+    }
+    return stocks;
+}
+
+// Parallel and serial results must agree exactly
+static int check_scan(const Stock* stocks, int count, int threads) {
+    MarketScan scan;
+    Stock* universe = (Stock*)stocks;
+    if (market_scan_parallel(stocks, count, threads, &scan) < 0) {
+        return 0;
+    }
+    const Stock* best = find_best_performing_stock(universe, count);
+    const Stock* volatile_stock = find_most_volatile_stock(universe, count);
+    const Stock* unusual = find_unusual_volume_stock(universe, count);
+    double total = calculate_total_value(universe, count);
+    double average = calculate_average_change(universe, count);
+    double diversity = calculate_portfolio_diversity(universe, count);
+    return (best ? best - stocks : -1) == scan.best &&
+           (volatile_stock ? volatile_stock - stocks : -1) == scan.most_volatile &&
+           (unusual ? unusual - stocks : -1) == scan.unusual_volume &&
+           count_bullish_stocks(universe, count) == scan.bullish &&
+           memcmp(&total, &scan.value_sum, sizeof(double)) == 0 &&
+           memcmp(&average, &(double){market_scan_average_change(&scan)}, sizeof(double)) == 0 &&
+           memcmp(&diversity, &(double){market_scan_diversity(&scan)}, sizeof(double)) == 0 &&
+           strcmp(analyze_market_sentiment(universe, count), market_scan_sentiment(&scan)) == 0;
+}
+
+static void run_scaling(int count) {
+    BenchContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.count = count;
+    ctx.universe = build_scaling_universe(count);
+    if (!ctx.universe) {
+        fprintf(stderr, "out of memory for a universe of %d symbols\n", count);
+        return;
+    }
+
+    int max_threads = parallel_default_threads();
+    int identical = 1;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        identical = identical && check_scan(ctx.universe, count, threads);
+    }
+    fprintf(stderr, "%s market_scan_parallel at %d symbols (%.1f MB of Stock records)\n",
+            identical ? "identical results from serial and" : "MISMATCH between serial and",
+            count, count * sizeof(Stock) / 1048576.0);
+
+    BenchCase serial = {"serial_analysis", bench_serial_analysis, 0};
+    run_case(&serial, &ctx);
+    for (int threads = 1; ; threads *= 2) {
+        // Powers of two, then the full thread count if that is not one
+        if (threads > max_threads) {
+            if (threads / 2 == max_threads) break;
+            threads = max_threads;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "market_scan_parallel/t%d", threads);
+        BenchCase scan = {name, bench_scaling_scan, 0};
+        scaling_threads = threads;
+        run_case(&scan, &ctx);
+        if (threads == max_threads) break;
+    }
+    free(ctx.universe);
+}
+
+static int parse_sizes(const char* list, int sizes[], int max_sizes) {
+    int count = 0;
+    const char* p = list;
+    while (*p && count < max_sizes) {
+        char* end;
+        long value = strtol(p, &end, 10);
+        if (end == p || value <= 0) {
+            return 0;
+        }
+        sizes[count++] = (int)value;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return count;
+}
+
+int main(int argc, char* argv[]) {
+    int sizes[BENCH_MAX_SIZES] = {10, 10000, 1000000};
+    int size_count = 3;
+    int sizes_given = 0;
+    int scaling = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            output_json = (strcmp(argv[++i], "json") == 0);
+        } else if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            size_count = parse_sizes(argv[++i], sizes, BENCH_MAX_SIZES);
+            sizes_given = 1;
+            if (size_count == 0) {
+                fprintf(stderr, "invalid --sizes list\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+            min_time_ns = atoll(argv[++i]) * 1000000LL;
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            name_filter = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            bench_seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--scaling") == 0) {
+            scaling = 1;
+        } else {
+            fprintf(stderr, "usage: %s [--format csv|json] [--sizes 10,10000,1000000] "
+                            "[--min-time-ms N] [--filter substring] [--seed N] [--scaling]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    sim_default_config(&tick_config);
+    tick_config.seed = bench_seed;
+
+    // Keep benchmark output away from the real dashboard directory
+    create_directory(BENCH_OUTPUT_DIR);
+    set_public_data_dir(BENCH_OUTPUT_DIR);
+
+    if (!output_json) {
+        printf("revision,benchmark,universe,iterations,ns_per_op,ops_per_sec,allocs_per_op\n");
+    }
+    if (scaling && !sizes_given) {
+        static const int SCALING_SIZES[] = {1000000, 3000000, 10000000};
+        size_count = 3;
+        memcpy(sizes, SCALING_SIZES, sizeof(SCALING_SIZES));
+    }
+    for (int s = 0; s < size_count; s++) {
+        if (scaling) {
+            run_scaling(sizes[s]);
+        } else {
+            run_universe(sizes[s]);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,449 @@
+/*
+ * Smart Stock Tracker - Market Breadth
+ * Advancers, decliners, new highs and lows per sector, industry and index
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * analyze_market_sentiment() and count_bullish_stocks() rescan the whole
+ * universe on every call and only know about one market-wide bucket. Here
+ * each symbol remembers the contribution its last quote made (advancing or
+ * not, change, cap x change, volume, new high or low) and the handful of
+ * groups it belongs to. A new quote computes the difference against that
+ * contribution and adds it to each group, so the cost of a refresh is
+ * proportional to the quotes that arrived, not to the universe.
+ */
+
+#include "stock_tracker.h"
+
+// Starting sizes of the symbol and group arrays
+#define BREADTH_INITIAL_SYMBOLS 64
+#define BREADTH_INITIAL_GROUPS 16
+
+// Grow the per-symbol states to cover every id in the symbol map
+static int breadth_reserve_states(BreadthEngine* engine, int count) {
+    if (count <= engine->state_capacity) {
+        return 1;
+    }
+    int new_capacity = engine->state_capacity ? engine->state_capacity : BREADTH_INITIAL_SYMBOLS;
+    while (new_capacity < count) {
+        new_capacity *= 2;
+    }
+    BreadthSymbol* grown = realloc(engine->states, (size_t)new_capacity * sizeof(BreadthSymbol));
+    if (!grown) {
+        return 0;
+    }
+    memset(&grown[engine->state_capacity], 0,
+           (size_t)(new_capacity - engine->state_capacity) * sizeof(BreadthSymbol));
+    engine->states = grown;
+    engine->state_capacity = new_capacity;
+    return 1;
+}
+
+// Id of a symbol, registering it with the market group if it is new
+static int breadth_symbol(BreadthEngine* engine, const char* symbol) {
+    if (!symbol || !symbol[0] || strlen(symbol) >= MAX_SYMBOL_LENGTH) {
+        return -1;
+    }
+    int known = engine->symbols.count;
+    int id = symbol_map_insert(&engine->symbols, symbol);
+    if (id < 0 || !breadth_reserve_states(engine, engine->symbols.count)) {
+        return -1;
+    }
+    if (id >= known) {
+        engine->groups[0].members++;
+    }
+    return id;
+}
+
+// Add sign x contribution to one group
+static void group_add(BreadthGroup* group, const BreadthContribution* c, int quoted, int sign) {
+    group->quoted += quoted;
+    group->advancers += sign * c->advancing;
+    group->decliners += sign * c->declining;
+    group->unchanged += sign * c->unchanged;
+    group->new_highs += sign * c->new_high;
+    group->new_lows += sign * c->new_low;
+    group->change_sum += sign * c->change;
+    group->cap_sum += sign * c->market_cap;
+    group->cap_change_sum += sign * c->cap_change;
+    group->volume += sign * c->volume;
+
+    // An empty group has no rounding left over from old deltas
+    if (group->quoted == 0) {
+        group->change_sum = 0.0;
+        group->cap_sum = 0.0;
+        group->cap_change_sum = 0.0;
+        group->volume = 0.0;
+    }
+}
+
+// Add sign x contribution to the market and each of the symbol's groups
+static void symbol_add(BreadthEngine* engine, const BreadthSymbol* state,
+                       const BreadthContribution* c, int quoted, int sign) {
+    group_add(&engine->groups[0], c, quoted, sign);
+    for (int k = 0; k < state->group_count; k++) {
+        group_add(&engine->groups[state->groups[k]], c, quoted, sign);
+    }
+}
+
+// What a quote contributes to its groups
+static void contribution_from_stock(const BreadthSymbol* state, const Stock* stock,
+                                    BreadthContribution* c) {
+    c->advancing = stock->change_percent > 0;
+    c->declining = stock->change_percent < 0;
+    c->unchanged = stock->change_percent == 0;
+    c->new_high = state->reference_high > 0 && state->session_high > state->reference_high;
+    c->new_low = state->reference_low > 0 && state->session_low > 0 &&
+                 state->session_low < state->reference_low;
+    c->change = stock->change_percent;
+    c->market_cap = stock->market_cap > 0 ? stock->market_cap : 0.0;
+    c->cap_change = c->market_cap * c->change;
+    c->volume = stock->volume > 0 ? stock->volume : 0.0;
+}
+
+// Initialize an engine holding only the market group
+int breadth_init(BreadthEngine* engine) {
+    if (!engine) {
+        return 0;
+    }
+    memset(engine, 0, sizeof(*engine));
+    engine->groups = calloc(BREADTH_INITIAL_GROUPS, sizeof(BreadthGroup));
+    if (!engine->groups || !symbol_map_init(&engine->symbols, BREADTH_INITIAL_SYMBOLS) ||
+        !breadth_reserve_states(engine, BREADTH_INITIAL_SYMBOLS)) {
+        breadth_free(engine);
+        return 0;
+    }
+    engine->group_capacity = BREADTH_INITIAL_GROUPS;
+    engine->group_count = 1;
+    strcpy(engine->groups[0].name, "Market");
+    engine->groups[0].kind = BREADTH_MARKET;
+    return 1;
+}
+
+// Release the engine's memory
+void breadth_free(BreadthEngine* engine) {
+    if (!engine) {
+        return;
+    }
+    free(engine->states);
+    free(engine->groups);
+    symbol_map_free(&engine->symbols);
+    memset(engine, 0, sizeof(*engine));
+}
+
+// Id of an existing group, -1 if absent (groups are few, so a scan is enough)
+int breadth_find_group(const BreadthEngine* engine, BreadthKind kind, const char* name) {
+    if (!engine || !name) {
+        return -1;
+    }
+    if (kind == BREADTH_MARKET) {
+        return 0;
+    }
+    for (int g = 1; g < engine->group_count; g++) {
+        if (engine->groups[g].kind == kind &&
+            strncmp(engine->groups[g].name, name, BREADTH_NAME_LENGTH - 1) == 0) {
+            return g;
+        }
+    }
+    return -1;
+}
+
+// Id of a group, adding it if it is new
+int breadth_group_id(BreadthEngine* engine, BreadthKind kind, const char* name) {
+    if (!engine || !name || !name[0]) {
+        return -1;
+    }
+    int id = breadth_find_group(engine, kind, name);
+    if (id >= 0) {
+        return id;
+    }
+
+    if (engine->group_count == engine->group_capacity) {
+        int new_capacity = engine->group_capacity * 2;
+        BreadthGroup* grown = realloc(engine->groups, (size_t)new_capacity * sizeof(BreadthGroup));
+        if (!grown) {
+            return -1;
+        }
+        engine->groups = grown;
+        engine->group_capacity = new_capacity;
+    }
+    id = engine->group_count++;
+    BreadthGroup* group = &engine->groups[id];
+    memset(group, 0, sizeof(*group));
+    strncpy(group->name, name, BREADTH_NAME_LENGTH - 1);
+    group->kind = kind;
+    return id;
+}
+
+// Add a symbol to a group
+int breadth_assign(BreadthEngine* engine, const char* symbol, int group) {
+    if (!engine || group <= 0 || group >= engine->group_count) {
+        return 0;
+    }
+    int id = breadth_symbol(engine, symbol);
+    if (id < 0) {
+        return 0;
+    }
+    BreadthSymbol* state = &engine->states[id];
+    for (int k = 0; k < state->group_count; k++) {
+        if (state->groups[k] == group) {
+            return 1;
+        }
+    }
+    if (state->group_count == BREADTH_MAX_MEMBERSHIPS) {
+        return 0;
+    }
+    state->groups[state->group_count++] = group;
+    engine->groups[group].members++;
+    if (state->active) {
+        group_add(&engine->groups[group], &state->last, 1, 1);
+    }
+    return 1;
+}
+
+// Set the highs and lows new quotes are compared against
+int breadth_set_range(BreadthEngine* engine, const char* symbol, double high, double low) {
+    if (!engine) {
+        return 0;
+    }
+    int id = breadth_symbol(engine, symbol);
+    if (id < 0) {
+        return 0;
+    }
+    engine->states[id].reference_high = high > 0 ? high : 0.0;
+    engine->states[id].reference_low = low > 0 ? low : 0.0;
+    return 1;
+}
+
+// Apply a symbol's latest quote as a delta against its last contribution
+int breadth_update(BreadthEngine* engine, const Stock* stock) {
+    if (!engine || !stock) {
+        return 0;
+    }
+    if (stock->current_price <= 0) {
+        breadth_remove(engine, stock->symbol);
+        return 1;
+    }
+    int id = breadth_symbol(engine, stock->symbol);
+    if (id < 0) {
+        return 0;
+    }
+    BreadthSymbol* state = &engine->states[id];
+
+    double high = stock->day_high > stock->current_price ? stock->day_high : stock->current_price;
+    double low = (stock->day_low > 0 && stock->day_low < stock->current_price)
+               ? stock->day_low : stock->current_price;
+    if (high > state->session_high) {
+        state->session_high = high;
+    }
+    if (state->session_low <= 0 || low < state->session_low) {
+        state->session_low = low;
+    }
+
+    BreadthContribution next;
+    contribution_from_stock(state, stock, &next);
+    if (state->active) {
+        const BreadthContribution* last = &state->last;
+        BreadthContribution delta;
+        delta.advancing = next.advancing - last->advancing;
+        delta.declining = next.declining - last->declining;
+        delta.unchanged = next.unchanged - last->unchanged;
+        delta.new_high = next.new_high - last->new_high;
+        delta.new_low = next.new_low - last->new_low;
+        delta.change = next.change - last->change;
+        delta.market_cap = next.market_cap - last->market_cap;
+        delta.cap_change = next.cap_change - last->cap_change;
+        delta.volume = next.volume - last->volume;
+        symbol_add(engine, state, &delta, 0, 1);
+    } else {
+        symbol_add(engine, state, &next, 1, 1);
+        state->active = 1;
+    }
+    state->last = next;
+    engine->updates++;
+    return 1;
+}
+
+// Drop a symbol's contribution
+int breadth_remove(BreadthEngine* engine, const char* symbol) {
+    if (!engine) {
+        return 0;
+    }
+    int id = symbol_map_find(&engine->symbols, symbol);
+    if (id < 0 || !engine->states[id].active) {
+        return 0;
+    }
+    BreadthSymbol* state = &engine->states[id];
+    symbol_add(engine, state, &state->last, -1, -1);
+    state->active = 0;
+    memset(&state->last, 0, sizeof(state->last));
+    return 1;
+}
+
+// Recount every group from the symbols' contributions
+void breadth_recompute(BreadthEngine* engine) {
+    if (!engine) {
+        return;
+    }
+    for (int g = 0; g < engine->group_count; g++) {
+        BreadthGroup* group = &engine->groups[g];
+        BreadthGroup kept = *group;
+        memset(group, 0, sizeof(*group));
+        memcpy(group->name, kept.name, sizeof(group->name));
+        group->kind = kept.kind;
+        group->members = kept.members;
+    }
+    for (int i = 0; i < engine->symbols.count; i++) {
+        if (engine->states[i].active) {
+            symbol_add(engine, &engine->states[i], &engine->states[i].last, 1, 1);
+        }
+    }
+}
+
+// Fold today's range into the references and start a new session
+void breadth_new_session(BreadthEngine* engine) {
+    if (!engine) {
+        return;
+    }
+    for (int i = 0; i < engine->symbols.count; i++) {
+        BreadthSymbol* state = &engine->states[i];
+        if (state->session_high > state->reference_high) {
+            state->reference_high = state->session_high;
+        }
+        if (state->session_low > 0 &&
+            (state->reference_low <= 0 || state->session_low < state->reference_low)) {
+            state->reference_low = state->session_low;
+        }
+        state->session_high = 0.0;
+        state->session_low = 0.0;
+        state->last.new_high = 0;
+        state->last.new_low = 0;
+    }
+    breadth_recompute(engine);
+}
+
+// Get a group
+const BreadthGroup* breadth_group(const BreadthEngine* engine, int group) {
+    if (!engine || group < 0 || group >= engine->group_count) {
+        return NULL;
+    }
+    return &engine->groups[group];
+}
+
+// Equal-weighted average change of the quoted members
+double breadth_average_change(const BreadthGroup* group) {
+    return (group && group->quoted > 0) ? group->change_sum / group->quoted : 0.0;
+}
+
+// Market-cap-weighted change
+double breadth_weighted_change(const BreadthGroup* group) {
+    if (!group) {
+        return 0.0;
+    }
+    return group->cap_sum > 0 ? group->cap_change_sum / group->cap_sum : breadth_average_change(group);
+}
+
+// Name of a group kind
+const char* breadth_kind_name(BreadthKind kind) {
+    switch (kind) {
+        case BREADTH_MARKET: return "market";
+        case BREADTH_SECTOR: return "sector";
+        case BREADTH_INDUSTRY: return "industry";
+        case BREADTH_INDEX: return "index";
+        default: return "unknown";
+    }
+}
+
+// Cut the next separator-delimited field off *cursor, trimming blanks
+static char* next_field(char** cursor, char separator) {
+    char* field = *cursor;
+    if (!field) {
+        return NULL;
+    }
+    char* end = strchr(field, separator);
+    if (end) {
+        *end = '\0';
+        *cursor = end + 1;
+    } else {
+        *cursor = NULL;
+    }
+    while (*field == ' ' || *field == '\t') {
+        field++;
+    }
+    size_t length = strlen(field);
+    while (length > 0 && strchr(" \t\r\n", field[length - 1])) {
+        field[--length] = '\0';
+    }
+    return field;
+}
+
+// Assign a symbol to a group named in the metadata file, if the field is set
+static int assign_named(BreadthEngine* engine, const char* symbol, BreadthKind kind, const char* name) {
+    if (!name || !name[0]) {
+        return 1;
+    }
+    return breadth_assign(engine, symbol, breadth_group_id(engine, kind, name));
+}
+
+// Load group memberships from a metadata file
+int breadth_load_groups(BreadthEngine* engine, const char* filename) {
+    if (!engine || !filename) {
+        return -1;
+    }
+
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        display_error("Cannot open breadth group file");
+        return -1;
+    }
+
+    char line[512];
+    int line_number = 0;
+    int loaded = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+        line_number++;
+        if (line[0] == '#' || strspn(line, " \t\r\n") == strlen(line)) {
+            continue;
+        }
+
+        char* cursor = line;
+        char* symbol = next_field(&cursor, ',');
+        char* sector = next_field(&cursor, ',');
+        char* industry = next_field(&cursor, ',');
+        char* indexes = next_field(&cursor, ',');
+        char* high = next_field(&cursor, ',');
+        char* low = next_field(&cursor, ',');
+
+        char clean[MAX_SYMBOL_LENGTH];
+        int valid = validate_stock_symbol(symbol, clean, sizeof(clean));
+        if (line_number == 1 && (!valid || strcmp(clean, "SYMBOL") == 0)) {
+            continue;  // Header row
+        }
+        if (!valid) {
+            fprintf(stderr, "❌ %s:%d: invalid symbol '%s'\n", filename, line_number, symbol);
+            fclose(file);
+            return -1;
+        }
+
+        int ok = breadth_symbol(engine, clean) >= 0 &&
+                 assign_named(engine, clean, BREADTH_SECTOR, sector) &&
+                 assign_named(engine, clean, BREADTH_INDUSTRY, industry);
+        while (ok && indexes) {
+            ok = assign_named(engine, clean, BREADTH_INDEX, next_field(&indexes, ';'));
+        }
+        if (ok && ((high && high[0]) || (low && low[0]))) {
+            ok = breadth_set_range(engine, clean, high ? atof(high) : 0.0, low ? atof(low) : 0.0);
+        }
+        if (!ok) {
+            fprintf(stderr, "❌ %s:%d: cannot add '%s' to its groups (at most %d each)\n",
+                    filename, line_number, clean, BREADTH_MAX_MEMBERSHIPS);
+            fclose(file);
+            return -1;
+        }
+        loaded++;
+    }
+
+    fclose(file);
+    return loaded;
+}
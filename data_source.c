@@ -0,0 +1,539 @@
+/*
+ * Smart Stock Tracker - Market Data Sources
+ * Pluggable quote providers behind one batch interface
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * A DataSource pairs a provider's operations with its state. Providers:
+ *   http        Alpha Vantage GLOBAL_QUOTE, one request per symbol, under
+ *               the free tier's quota, falling back to demo quotes
+ *   demo        Reproducible simulated quotes for the wall clock (what the
+ *               parser used to substitute when the API refused a request)
+ *   file:PATH   A directory of SYMBOL.json responses, or a recording made
+ *               with --record, stepped one response per symbol per fetch
+ *   sim[:SEED]  The synthetic market, one tick per fetch on its own clock
+ * data_source_fetch() keeps each source inside its request quota: when the
+ * quota covers only part of a batch, the symbols fetched rotate between
+ * calls so every symbol is refreshed in turn; skipped symbols keep their
+ * last quote. The fallback fills failed requests and symbols that have no
+ * quote yet. The offline providers never touch the network, so the whole
+ * refresh path can run at full speed against local data.
+ */
+
+#include "stock_tracker.h"
+#include <sys/stat.h>
+#include <time.h>
+
+// =============================================================================
+// HTTP PROVIDER (ALPHA VANTAGE)
+// =============================================================================
+
+static int http_open(DataSource* source, const char* location) {
+    (void)location;
+    // Under a quota each symbol may cost only the one request it was allowed
+    set_fetch_single_request(source->ops->requests_per_minute > 0 || source->ops->requests_per_day > 0);
+    return initialize_curl();
+}
+
+static int http_fetch(DataSource* source, Stock stocks[], int count, unsigned char fetched[]) {
+    (void)source;
+    long long before = fetch_request_count();
+    for (int i = 0; i < count; i++) {
+        fetched[i] = (unsigned char)fetch_stock_data(stocks[i].symbol, &stocks[i]);
+    }
+    // GLOBAL_QUOTE takes one symbol per request; charge what was really sent
+    // (quotes served from the last-good cache while the breaker is open cost none)
+    return (int)(fetch_request_count() - before);
+}
+
+static void http_close(DataSource* source) {
+    (void)source;
+    set_fetch_single_request(0);
+    cleanup_curl();
+}
+
+// =============================================================================
+// DEMO PROVIDER (SIMULATED QUOTES FOR THE WALL CLOCK)
+// =============================================================================
+
+static int demo_fetch(DataSource* source, Stock stocks[], int count, unsigned char fetched[]) {
+    (void)source;
+    for (int i = 0; i < count; i++) {
+        char symbol[MAX_SYMBOL_LENGTH];
+        strcpy(symbol, stocks[i].symbol);
+        fetched[i] = (unsigned char)sim_demo_stock(symbol, current_quote_time(), &stocks[i]);
+    }
+    return count;
+}
+
+// =============================================================================
+// SIM PROVIDER (SYNTHETIC MARKET ON ITS OWN CLOCK)
+// =============================================================================
+
+typedef struct {
+    SimConfig config;
+    SymbolMap symbols;
+    SimSymbol* states;        // Indexed by symbol id
+    int capacity;
+} SimSource;
+
+static int sim_open(DataSource* source, const char* location) {
+    SimSource* sim = calloc(1, sizeof(SimSource));
+    if (!sim || !symbol_map_init(&sim->symbols, 64)) {
+        free(sim);
+        return 0;
+    }
+    sim_default_config(&sim->config);
+    if (location && location[0]) {
+        char* end;
+        sim->config.seed = strtoull(location, &end, 10);
+        if (*end != '\0') {
+            fprintf(stderr, "❌ Invalid sim seed: %s\n", location);
+            symbol_map_free(&sim->symbols);
+            free(sim);
+            return 0;
+        }
+    }
+    sim->config.tick_seconds = DATA_SOURCE_SIM_TICK_SECONDS;
+    sim->config.ticks_per_session = (SESSION_CLOSE_UTC - SESSION_OPEN_UTC) / DATA_SOURCE_SIM_TICK_SECONDS;
+    source->state = sim;
+    return 1;
+}
+
+// Generator state of a symbol, created on first use
+static SimSymbol* sim_symbol(SimSource* sim, const char* symbol) {
+    int id = symbol_map_find(&sim->symbols, symbol);
+    if (id < 0) {
+        // Room first, so every symbol in the map has its state
+        if (sim->symbols.count >= sim->capacity) {
+            int new_capacity = sim->capacity ? sim->capacity * 2 : 64;
+            SimSymbol* grown = realloc(sim->states, (size_t)new_capacity * sizeof(SimSymbol));
+            if (!grown) {
+                return NULL;
+            }
+            sim->states = grown;
+            sim->capacity = new_capacity;
+        }
+        id = symbol_map_insert(&sim->symbols, symbol);
+        if (id < 0) {
+            return NULL;
+        }
+        sim_init_symbol(&sim->config, &sim->states[id], symbol, -1);
+    }
+    return &sim->states[id];
+}
+
+static int sim_fetch(DataSource* source, Stock stocks[], int count, unsigned char fetched[]) {
+    SimSource* sim = source->state;
+    for (int i = 0; i < count; i++) {
+        SimSymbol* state = sim_symbol(sim, stocks[i].symbol);
+        if (!state) {
+            fetched[i] = 0;
+            continue;
+        }
+        SimTick tick;
+        sim_next_tick(&sim->config, state, &tick);
+        sim_fill_stock(state, &stocks[i]);
+        stocks[i].last_update = (time_t)tick.timestamp;
+        fetched[i] = 1;
+    }
+    return count;
+}
+
+static void sim_close(DataSource* source) {
+    SimSource* sim = source->state;
+    if (sim) {
+        symbol_map_free(&sim->symbols);
+        free(sim->states);
+        free(sim);
+    }
+}
+
+// =============================================================================
+// FILE PROVIDER (RECORDED RESPONSES)
+// =============================================================================
+
+typedef struct {
+    int directory;            // 1 = PATH/SYMBOL.json snapshots, 0 = recording
+    char* buffer;             // Recording, payloads NUL-terminated in place
+    char** payloads;          // Responses in file order...
+    long long* timestamps_ms; // ...when they were recorded...
+    int* next;                // ...and the same symbol's next response, -1 at the end
+    int response_count;
+    SymbolMap symbols;
+    int* first;               // Per symbol id: first response
+    int* cursor;              // Next response to serve
+    int* laps;                // Times the symbol's responses wrapped around
+    long long span_ms;        // Time shift per lap, keeping replayed time increasing
+} FileSource;
+
+
+static void file_free(FileSource* file) {
+    free(file->buffer);
+    free(file->payloads);
+    free(file->timestamps_ms);
+    free(file->next);
+    free(file->first);
+    free(file->cursor);
+    free(file->laps);
+    symbol_map_free(&file->symbols);
+    free(file);
+}
+
+// Index a recording: payloads are NUL-terminated in place, and each
+// symbol's responses are chained in recording order
+static int file_index_recording(FileSource* file, size_t size) {
+    char* buffer = file->buffer;
+    int capacity = 0;
+    long long earliest = 0, latest = 0;
+    size_t pos = 0;
+
+    while (pos < size) {
+        long long epoch_ms;
+        char symbol[MAX_SYMBOL_LENGTH];
+        size_t length;
+        int consumed = 0;
+        if (strncmp(buffer + pos, RECORD_MAGIC, strlen(RECORD_MAGIC)) != 0 ||
+            sscanf(buffer + pos, RECORD_MAGIC "%lld %9s %zu%n", &epoch_ms, symbol, &length, &consumed) != 3) {
+            fprintf(stderr, "❌ Malformed recording at byte %zu\n", pos);
+            return 0;
+        }
+        pos += (size_t)consumed + 1;  // Skip header and its newline
+        if (pos + length > size) {
+            fprintf(stderr, "❌ Truncated recording for %s at byte %zu\n", symbol, pos);
+            return 0;
+        }
+
+        int n = file->response_count;
+        if (n == capacity) {
+            capacity = capacity ? capacity * 2 : 1024;
+            char** payloads = realloc(file->payloads, (size_t)capacity * sizeof(char*));
+            if (payloads) file->payloads = payloads;
+            long long* timestamps = realloc(file->timestamps_ms, (size_t)capacity * sizeof(long long));
+            if (timestamps) file->timestamps_ms = timestamps;
+            int* next = realloc(file->next, (size_t)capacity * sizeof(int));
+            if (next) file->next = next;
+            if (!payloads || !timestamps || !next) {
+                return 0;
+            }
+        }
+        int id = symbol_map_insert(&file->symbols, symbol);
+        if (id < 0) {
+            return 0;
+        }
+        file->payloads[n] = buffer + pos;
+        file->timestamps_ms[n] = epoch_ms;
+        file->next[n] = id;           // Symbol id until the chains are built
+        pos += length;
+        buffer[pos] = '\0';           // Overwrites the separator newline
+        pos += 1;
+        file->response_count++;
+
+        if (n == 0 || epoch_ms < earliest) earliest = epoch_ms;
+        if (n == 0 || epoch_ms > latest) latest = epoch_ms;
+    }
+
+    int symbols = file->symbols.count > 0 ? file->symbols.count : 1;
+    file->first = malloc((size_t)symbols * sizeof(int));
+    file->cursor = malloc((size_t)symbols * sizeof(int));
+    file->laps = calloc((size_t)symbols, sizeof(int));
+    if (!file->first || !file->cursor || !file->laps) {
+        return 0;
+    }
+    for (int id = 0; id < file->symbols.count; id++) {
+        file->first[id] = -1;
+    }
+    for (int n = file->response_count - 1; n >= 0; n--) {
+        int id = file->next[n];
+        file->next[n] = file->first[id];
+        file->first[id] = n;
+    }
+    memcpy(file->cursor, file->first, (size_t)symbols * sizeof(int));
+    file->span_ms = latest - earliest + 1000;
+    return 1;
+}
+
+static int file_open(DataSource* source, const char* location) {
+    if (!location || !location[0]) {
+        fprintf(stderr, "❌ The file source needs a path (file:PATH)\n");
+        return 0;
+    }
+    struct stat info;
+    if (stat(location, &info) != 0) {
+        fprintf(stderr, "❌ Cannot open %s\n", location);
+        return 0;
+    }
+    FileSource* file = calloc(1, sizeof(FileSource));
+    if (!file || !symbol_map_init(&file->symbols, 64)) {
+        free(file);
+        return 0;
+    }
+
+    if (S_ISDIR(info.st_mode)) {
+        file->directory = 1;
+        source->state = file;
+        return 1;
+    }
+
+    size_t size = 0;
+    file->buffer = read_entire_file(location, &size);
+    if (!file->buffer || !file_index_recording(file, size)) {
+        if (file->buffer) {
+            fprintf(stderr, "❌ %s is not a recording made with --record\n", location);
+        }
+        file_free(file);
+        return 0;
+    }
+    printf("📼 Loaded %d recorded responses for %d symbols from %s\n",
+           file->response_count, file->symbols.count, location);
+    source->state = file;
+    return 1;
+}
+
+// Parse a response as if it arrived at `when`
+static int file_parse(const char* payload, time_t when, Stock* stock) {
+    set_quote_clock(when);
+    long long parse_start = metrics_now_ns();
+    int parsed = parse_stock_json(payload, stock);
+    metrics_record_stage(METRIC_PARSE, metrics_now_ns() - parse_start);
+    set_quote_clock(0);
+    return parsed;
+}
+
+// Latest SYMBOL.json in the directory, stamped with its modification time
+static int file_fetch_snapshot(DataSource* source, Stock* stock) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.json", source->location, stock->symbol);
+    struct stat info;
+    size_t size = 0;
+    if (stat(path, &info) != 0) {
+        return 0;
+    }
+    char* payload = read_entire_file(path, &size);
+    if (!payload) {
+        return 0;
+    }
+    int parsed = file_parse(payload, info.st_mtime, stock);
+    free(payload);
+    return parsed;
+}
+
+// Next recorded response of the symbol; after the last one the recording
+// starts over, shifted forward so quote times keep increasing
+static int file_fetch_recorded(FileSource* file, Stock* stock) {
+    int id = symbol_map_find(&file->symbols, stock->symbol);
+    if (id < 0) {
+        return 0;
+    }
+    int n = file->cursor[id];
+    file->cursor[id] = file->next[n];
+    long long shift_ms = (long long)file->laps[id] * file->span_ms;
+    if (file->cursor[id] < 0) {
+        file->cursor[id] = file->first[id];
+        file->laps[id]++;
+    }
+    return file_parse(file->payloads[n], (time_t)((file->timestamps_ms[n] + shift_ms) / 1000), stock);
+}
+
+static int file_fetch(DataSource* source, Stock stocks[], int count, unsigned char fetched[]) {
+    FileSource* file = source->state;
+    for (int i = 0; i < count; i++) {
+        fetched[i] = (unsigned char)(file->directory ? file_fetch_snapshot(source, &stocks[i])
+                                                     : file_fetch_recorded(file, &stocks[i]));
+    }
+    return count;
+}
+
+static void file_close(DataSource* source) {
+    if (source->state) {
+        file_free(source->state);
+    }
+}
+
+// =============================================================================
+// SOURCE REGISTRY AND QUOTA
+// =============================================================================
+
+static const DataSourceOps HTTP_SOURCE = {
+    "http", DATA_SOURCE_NETWORK | DATA_SOURCE_QUOTA,
+    DATA_SOURCE_HTTP_PER_MINUTE, DATA_SOURCE_HTTP_PER_DAY,
+    http_open, http_fetch, http_close
+};
+
+static const DataSourceOps DEMO_SOURCE = {
+    "demo", DATA_SOURCE_OFFLINE | DATA_SOURCE_BATCH, 0, 0,
+    NULL, demo_fetch, NULL
+};
+
+static const DataSourceOps SIM_SOURCE = {
+    "sim", DATA_SOURCE_OFFLINE | DATA_SOURCE_BATCH | DATA_SOURCE_RECORDED_TIME, 0, 0,
+    sim_open, sim_fetch, sim_close
+};
+
+static const DataSourceOps FILE_SOURCE = {
+    "file", DATA_SOURCE_OFFLINE | DATA_SOURCE_BATCH | DATA_SOURCE_RECORDED_TIME, 0, 0,
+    file_open, file_fetch, file_close
+};
+
+static const DataSourceOps* const SOURCES[] = {&HTTP_SOURCE, &DEMO_SOURCE, &SIM_SOURCE, &FILE_SOURCE};
+
+// Open one source; "name" or "name:location"
+static DataSource* open_single(const char* spec) {
+    const char* colon = strchr(spec, ':');
+    size_t name_length = colon ? (size_t)(colon - spec) : strlen(spec);
+    const char* location = colon ? colon + 1 : "";
+
+    const DataSourceOps* ops = NULL;
+    for (size_t i = 0; i < sizeof(SOURCES) / sizeof(SOURCES[0]); i++) {
+        if (strlen(SOURCES[i]->name) == name_length && strncmp(SOURCES[i]->name, spec, name_length) == 0) {
+            ops = SOURCES[i];
+            break;
+        }
+    }
+    if (!ops) {
+        fprintf(stderr, "❌ Unknown data source '%s' (use http, demo, file:PATH or sim[:SEED])\n", spec);
+        return NULL;
+    }
+    if (strlen(location) >= sizeof(((DataSource*)0)->location)) {
+        fprintf(stderr, "❌ Data source location too long: %s\n", location);
+        return NULL;
+    }
+
+    DataSource* source = calloc(1, sizeof(DataSource));
+    if (!source) {
+        return NULL;
+    }
+    source->ops = ops;
+    strcpy(source->location, location);
+    if (ops->open && !ops->open(source, location)) {
+        free(source);
+        return NULL;
+    }
+    return source;
+}
+
+// Open a source from its specification
+DataSource* data_source_open(const char* spec) {
+    if (!spec || !spec[0]) {
+        spec = DATA_SOURCE_DEFAULT;
+    }
+    DataSource* source = open_single(spec);
+    if (source && source->ops == &HTTP_SOURCE) {
+        // Demo quotes stand in when the API cannot answer, as they always have
+        source->fallback = open_single("demo");
+    }
+    return source;
+}
+
+// Close a source and its fallback
+void data_source_close(DataSource* source) {
+    if (!source) {
+        return;
+    }
+    data_source_close(source->fallback);
+    if (source->ops->close) {
+        source->ops->close(source);
+    }
+    free(source);
+}
+
+// Start new quota windows when the minute or day has changed
+static void quota_roll(DataSource* source) {
+    long long now = (long long)time(NULL);
+    if (now / 60 != source->minute) {
+        source->minute = now / 60;
+        source->minute_used = 0;
+    }
+    if (now / 86400 != source->day) {
+        source->day = now / 86400;
+        source->day_used = 0;
+    }
+}
+
+// Requests left before the quota is reached
+int data_source_quota_remaining(DataSource* source) {
+    if (!source) {
+        return 0;
+    }
+    const DataSourceOps* ops = source->ops;
+    if (ops->requests_per_minute <= 0 && ops->requests_per_day <= 0) {
+        return -1;
+    }
+    quota_roll(source);
+    int remaining = -1;
+    if (ops->requests_per_minute > 0) {
+        remaining = ops->requests_per_minute - source->minute_used;
+    }
+    if (ops->requests_per_day > 0 && (remaining < 0 || ops->requests_per_day - source->day_used < remaining)) {
+        remaining = ops->requests_per_day - source->day_used;
+    }
+    return remaining > 0 ? remaining : 0;
+}
+
+// Hand stocks[begin, begin + count) to the provider and charge its quota
+static void fetch_range(DataSource* source, Stock stocks[], int begin, int count, unsigned char fetched[]) {
+    if (count <= 0) {
+        return;
+    }
+    int requests = source->ops->fetch_batch(source, stocks + begin, count, fetched + begin);
+    source->minute_used += requests;
+    source->day_used += requests;
+}
+
+// Refresh a batch within the quota, then fill the gaps from the fallback
+int data_source_fetch(DataSource* source, Stock stocks[], int count, unsigned char fetched[]) {
+    if (!source || !stocks || !fetched || count <= 0) {
+        return 0;
+    }
+    memset(fetched, 0, (size_t)count);
+
+    int remaining = data_source_quota_remaining(source);
+    int allowed = count;
+    if (remaining >= 0) {
+        // A batch provider spends one request per call, others one per symbol
+        allowed = data_source_has(source, DATA_SOURCE_BATCH) ? (remaining > 0 ? count : 0)
+                                                              : (remaining < count ? remaining : count);
+    }
+    int begin = 0, first = allowed;
+    if (allowed == count) {
+        fetch_range(source, stocks, 0, count, fetched);
+    } else if (allowed > 0) {
+        // Resume where the last partial batch stopped, wrapping around
+        begin = source->next_symbol % count;
+        first = allowed < count - begin ? allowed : count - begin;
+        fetch_range(source, stocks, begin, first, fetched);
+        fetch_range(source, stocks, 0, allowed - first, fetched);
+        source->next_symbol = (begin + allowed) % count;
+    }
+    if (allowed < count) {
+        printf("⏳ %s quota reached: requested %d of %d symbols\n", source->ops->name, allowed, count);
+    }
+    source->requested += count;
+
+    int refreshed = 0;
+    for (int i = 0; i < count; i++) {
+        // Symbols the quota skipped keep their last quote until their turn comes
+        int requested = (i >= begin && i < begin + first) || i < allowed - first;
+        if (fetched[i]) {
+            source->served++;
+            refreshed++;
+        } else if (source->fallback && (requested || stocks[i].current_price <= 0) &&
+                   data_source_fetch(source->fallback, &stocks[i], 1, &fetched[i])) {
+            printf("⚠️  Using %s data for %s\n", source->fallback->ops->name, stocks[i].symbol);
+            metrics_increment(METRIC_DEMO_FALLBACK);
+            source->fallbacks++;
+            refreshed++;
+        }
+    }
+    return refreshed;
+}
+
+// Check a source capability
+int data_source_has(const DataSource* source, DataSourceCapability capability) {
+    return source && (source->ops->capabilities & (unsigned int)capability) != 0;
+}
+
+// Name of a source's provider
+const char* data_source_name(const DataSource* source) {
+    return source ? source->ops->name : "none";
+}
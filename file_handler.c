@@ -18,6 +18,33 @@ int create_directory(const char* path) {
 #endif
 }
 
+// Read a whole file into a NUL-terminated buffer
+char* read_entire_file(const char* filename, size_t* size_out) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(file);
+        return NULL;
+    }
+
+    char* buffer = malloc((size_t)size + 1);
+    if (buffer && fread(buffer, 1, (size_t)size, file) != (size_t)size) {
+        free(buffer);
+        buffer = NULL;
+    }
+    fclose(file);
+    if (buffer) {
+        buffer[size] = '\0';
+        *size_out = (size_t)size;
+    }
+    return buffer;
+}
+
 // Save stock data to a text file
 // int save_stocks_to_file(Stock stocks[], int count, const char* filename) {
 //     if (!stocks || !filename || count <= 0) {
@@ -125,7 +152,7 @@ int generate_json_file(Stock stocks[], int count, const char* filename) {
         fprintf(file, "    \"name\": \"%s\",\n", best_stock->name);
         fprintf(file, "    \"price\": %.2f,\n", best_stock->current_price);
         fprintf(file, "    \"change\": %.2f,\n", best_stock->change_percent);
-        fprintf(file, "    \"status\": \"%s\"\n", best_stock->status);
+        fprintf(file, "    \"status\": \"%s\"\n", stock_status_label(best_stock->status));
         fprintf(file, "  },\n");
     }
 
@@ -159,7 +186,7 @@ int generate_json_file(Stock stocks[], int count, const char* filename) {
             fprintf(file, "      \"price\": %.2f,\n", stocks[i].current_price);
             fprintf(file, "      \"change\": %.2f,\n", stocks[i].change_percent);
             fprintf(file, "      \"volume\": %.0f,\n", stocks[i].volume);
-            fprintf(file, "      \"status\": \"%s\",\n", stocks[i].status);
+            fprintf(file, "      \"status\": \"%s\",\n", stock_status_label(stocks[i].status));
             fprintf(file, "      \"dayHigh\": %.2f,\n", stocks[i].day_high);
             fprintf(file, "      \"dayLow\": %.2f\n", stocks[i].day_low);
             written++;
@@ -181,23 +208,142 @@ int log_trading_activity(const char* message, Stock* stock) {
         return 0;
     }
     
+    // Preformat the whole record so the background logger only has to copy it
+    char record[LOG_RECORD_SIZE];
+    int length;
+    
+    if (stock) {
+        length = snprintf(record, sizeof(record), "[%s] %s - %s: $%.2f (%.2f%%)\n",
+                          logger_cached_timestamp(), message,
+                          stock->symbol, stock->current_price, stock->change_percent);
+    } else {
+        length = snprintf(record, sizeof(record), "[%s] %s\n",
+                          logger_cached_timestamp(), message);
+    }
+    
+    if (length < 0) {
+        return 0;
+    }
+    if ((size_t)length >= sizeof(record)) {
+        // Truncated: keep the record newline-terminated
+        length = sizeof(record) - 1;
+        record[length - 1] = '\n';
+    }
+    
+    if (logger_is_running()) {
+        return logger_submit(record, (size_t)length);
+    }
+    
+    // No background logger: fall back to a synchronous append
     FILE* file = fopen(LOG_FILE, "a");
     if (!file) {
         return 0;
     }
     
-    time_t now = time(NULL);
-    char timestamp[64];
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    fwrite(record, 1, (size_t)length, file);
+    fclose(file);
+    return 1;
+}
+
+// Load rule parameters from "name = value" lines ('#' starts a comment)
+int load_rule_params(const char* filename, RuleParams* params) {
+    if (!filename || !params) {
+        return -1;
+    }
     
-    fprintf(file, "[%s] %s", timestamp, message);
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        char error_msg[MAX_URL_LENGTH];
+        snprintf(error_msg, sizeof(error_msg), "Cannot open rule file '%s'", filename);
+        display_error(error_msg);
+        return -1;
+    }
     
-    if (stock) {
-        fprintf(file, " - %s: $%.2f (%.2f%%)", 
-                stock->symbol, stock->current_price, stock->change_percent);
+    char line[256];
+    int line_number = 0;
+    int loaded = 0;
+    
+    while (fgets(line, sizeof(line), file)) {
+        line_number++;
+        char* comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+        
+        char name[64];
+        double value;
+        char extra;
+        if (sscanf(line, " %63[a-z_] = %lf %c", name, &value, &extra) == 2) {
+            if (!rule_params_set_field(params, name, value)) {
+                fprintf(stderr, "❌ %s:%d: unknown rule parameter '%s'\n", filename, line_number, name);
+                fclose(file);
+                return -1;
+            }
+            loaded++;
+        } else if (strspn(line, " \t\r\n") != strlen(line)) {
+            fprintf(stderr, "❌ %s:%d: expected 'name = value'\n", filename, line_number);
+            fclose(file);
+            return -1;
+        }
     }
     
-    fprintf(file, "\n");
     fclose(file);
-    return 1;
-}
\ No newline at end of file
+    return loaded;
+}
+
+// Load alert rules from "SYMBOL crosses PRICE" / "SYMBOL moves PERCENT" lines
+int load_alert_rules(const char* filename, AlertEngine* engine) {
+    if (!filename || !engine) {
+        return -1;
+    }
+    
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        char error_msg[MAX_URL_LENGTH];
+        snprintf(error_msg, sizeof(error_msg), "Cannot open alert file '%s'", filename);
+        display_error(error_msg);
+        return -1;
+    }
+    
+    char line[256];
+    int line_number = 0;
+    int loaded = 0;
+    
+    while (fgets(line, sizeof(line), file)) {
+        line_number++;
+        char* comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+        
+        char symbol[MAX_SYMBOL_LENGTH];
+        char kind_name[16];
+        double threshold;
+        char extra;
+        AlertKind kind;
+        if (sscanf(line, " %9s %15s %lf %c", symbol, kind_name, &threshold, &extra) == 3 &&
+            parse_alert_kind(kind_name, &kind)) {
+            char clean[MAX_SYMBOL_LENGTH];
+            const char* target = strcmp(symbol, "*") == 0 ? NULL : clean;
+            if (target && !validate_stock_symbol(symbol, clean, sizeof(clean))) {
+                fprintf(stderr, "❌ %s:%d: invalid symbol '%s'\n", filename, line_number, symbol);
+                fclose(file);
+                return -1;
+            }
+            if (alert_engine_add(engine, target, kind, threshold) < 0) {
+                fprintf(stderr, "❌ %s:%d: invalid alert threshold %.2f\n", filename, line_number, threshold);
+                fclose(file);
+                return -1;
+            }
+            loaded++;
+        } else if (strspn(line, " \t\r\n") != strlen(line)) {
+            fprintf(stderr, "❌ %s:%d: expected 'SYMBOL crosses PRICE' or 'SYMBOL moves PERCENT'\n",
+                    filename, line_number);
+            fclose(file);
+            return -1;
+        }
+    }
+    
+    fclose(file);
+    return loaded;
+}
@@ -0,0 +1,770 @@
+/*
+ * Smart Stock Tracker - History Codec
+ * Compressed columnar segments of OHLCV bar history
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * A segment file holds every series of a HistoryStore in blocks of up to
+ * HISTORY_BLOCK_BARS bars, each block encoded column by column:
+ *
+ *   timestamps  delta-of-delta, zigzag varints (regular bars cost a byte)
+ *   prices      scaled integers when every price in the block has at most
+ *               HISTORY_MAX_DECIMALS decimals: the close as deltas, open,
+ *               high and low as offsets from the close, all zigzag varints;
+ *               otherwise Gorilla-style XOR against the previous value
+ *   volume      whole numbers as varints with run lengths for repeats,
+ *               otherwise XOR like prices
+ *
+ * Both paths are lossless. Blocks decode independently into fixed arrays:
+ * the byte-wise varint pass only fills an integer scratch column, and the
+ * prefix sums and int-to-double scaling run as separate flat loops the
+ * compiler can vectorize. Multi-byte header fields are native byte order.
+ */
+
+#include "stock_tracker.h"
+#include <fcntl.h>
+#include <math.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SEGMENT_MAGIC "STKHSEG1"
+#define SEGMENT_MAGIC_LENGTH 8
+#define PRICES_SCALED 0
+#define PRICES_XOR 1
+#define VOLUME_RUNS 0
+#define VOLUME_XOR 1
+#define EXACT_INTEGER_LIMIT 9007199254740992.0  // 2^53
+
+static const double DECIMAL_SCALES[] = {1.0, 10.0, 100.0, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+
+// Growable output buffer
+typedef struct {
+    unsigned char* data;
+    size_t length;
+    size_t capacity;
+} ByteBuffer;
+
+// Bit-level writer for the XOR columns, most significant bit first
+typedef struct {
+    ByteBuffer* out;
+    unsigned long long bits;
+    int pending;
+} BitWriter;
+
+typedef struct {
+    const unsigned char* data;
+    size_t length;
+    size_t position;          // Next byte
+    unsigned long long bits;
+    int available;
+} BitReader;
+
+// Block header as written to the file
+typedef struct {
+    int count;
+    unsigned char price_mode;
+    unsigned char decimals;
+    unsigned char volume_mode;
+    unsigned char reserved;
+    int length;               // Payload bytes that follow
+} BlockHeader;
+
+static int buffer_reserve(ByteBuffer* buffer, size_t extra) {
+    if (buffer->length + extra <= buffer->capacity) {
+        return 1;
+    }
+    size_t new_capacity = buffer->capacity ? buffer->capacity : 4096;
+    while (new_capacity < buffer->length + extra) {
+        new_capacity *= 2;
+    }
+    unsigned char* grown = realloc(buffer->data, new_capacity);
+    if (!grown) {
+        return 0;
+    }
+    buffer->data = grown;
+    buffer->capacity = new_capacity;
+    return 1;
+}
+
+static unsigned long long zigzag(long long value) {
+    return ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63);
+}
+
+static long long unzigzag(unsigned long long value) {
+    return (long long)(value >> 1) ^ -(long long)(value & 1);
+}
+
+// Unsigned LEB128; capacity is reserved per block, so this never allocates
+static void put_varint(ByteBuffer* buffer, unsigned long long value) {
+    while (value >= 0x80) {
+        buffer->data[buffer->length++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    buffer->data[buffer->length++] = (unsigned char)value;
+}
+
+static int get_varint(const unsigned char* data, size_t length, size_t* position, unsigned long long* value) {
+    unsigned long long result = 0;
+    for (int shift = 0; shift < 64 && *position < length; shift += 7) {
+        unsigned char byte = data[(*position)++];
+        result |= (unsigned long long)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void put_bits(BitWriter* writer, unsigned long long value, int count) {
+    while (count > 0) {
+        int take = count < 32 ? count : 32;
+        count -= take;
+        writer->bits = (writer->bits << take) | ((value >> count) & ((1ULL << take) - 1));
+        writer->pending += take;
+        while (writer->pending >= 8) {
+            writer->pending -= 8;
+            writer->out->data[writer->out->length++] = (unsigned char)(writer->bits >> writer->pending);
+        }
+    }
+}
+
+// Pad the last byte with zeros so the next column starts byte-aligned
+static void flush_bits(BitWriter* writer) {
+    if (writer->pending > 0) {
+        writer->out->data[writer->out->length++] = (unsigned char)(writer->bits << (8 - writer->pending));
+    }
+    writer->bits = 0;
+    writer->pending = 0;
+}
+
+// Top up the bit window to at least 57 bits while input remains
+static void refill_bits(BitReader* reader) {
+    while (reader->available <= 56 && reader->position < reader->length) {
+        reader->bits = (reader->bits << 8) | reader->data[reader->position++];
+        reader->available += 8;
+    }
+}
+
+static int get_bits(BitReader* reader, int count, unsigned long long* value) {
+    if (count > 32) {
+        unsigned long long high, low;
+        if (!get_bits(reader, count - 32, &high) || !get_bits(reader, 32, &low)) {
+            return 0;
+        }
+        *value = (high << 32) | low;
+        return 1;
+    }
+    if (reader->available < count) {
+        refill_bits(reader);
+        if (reader->available < count) {
+            return 0;
+        }
+    }
+    reader->available -= count;
+    *value = (reader->bits >> reader->available) & ((1ULL << count) - 1);
+    return 1;
+}
+
+static unsigned long long double_bits(double value) {
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static double bits_double(unsigned long long bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Gorilla XOR: 0 = repeat, 10 = fits the previous window, 11 = new window
+static void encode_xor(ByteBuffer* out, const double* values, int count) {
+    BitWriter writer = {out, 0, 0};
+    unsigned long long previous = double_bits(values[0]);
+    int window_leading = -1, window_trailing = 0;
+    put_bits(&writer, previous, 64);
+    for (int i = 1; i < count; i++) {
+        unsigned long long current = double_bits(values[i]);
+        unsigned long long x = current ^ previous;
+        previous = current;
+        if (x == 0) {
+            put_bits(&writer, 0, 1);
+            continue;
+        }
+        int leading = __builtin_clzll(x);
+        int trailing = __builtin_ctzll(x);
+        if (leading > 31) {
+            leading = 31;
+        }
+        if (window_leading >= 0 && leading >= window_leading && trailing >= window_trailing) {
+            put_bits(&writer, 2, 2);
+            put_bits(&writer, x >> window_trailing, 64 - window_leading - window_trailing);
+        } else {
+            int significant = 64 - leading - trailing;
+            put_bits(&writer, 3, 2);
+            put_bits(&writer, (unsigned long long)leading, 5);
+            put_bits(&writer, (unsigned long long)(significant - 1), 6);
+            put_bits(&writer, x >> trailing, significant);
+            window_leading = leading;
+            window_trailing = trailing;
+        }
+    }
+    flush_bits(&writer);
+}
+
+static int decode_xor(const unsigned char* data, size_t length, size_t* position, double* values, int count) {
+    BitReader reader = {data, length, *position, 0, 0};
+    unsigned long long previous, flag, field;
+    int window_leading = 0, window_trailing = 0;
+    if (!get_bits(&reader, 64, &previous)) {
+        return 0;
+    }
+    values[0] = bits_double(previous);
+    for (int i = 1; i < count; i++) {
+        if (!get_bits(&reader, 1, &flag)) {
+            return 0;
+        }
+        if (flag) {
+            if (!get_bits(&reader, 1, &flag)) {
+                return 0;
+            }
+            if (flag) {
+                unsigned long long leading, significant;
+                if (!get_bits(&reader, 5, &leading) || !get_bits(&reader, 6, &significant)) {
+                    return 0;
+                }
+                window_leading = (int)leading;
+                window_trailing = 64 - window_leading - (int)(significant + 1);
+                if (window_trailing < 0) {
+                    return 0;
+                }
+            }
+            if (!get_bits(&reader, 64 - window_leading - window_trailing, &field)) {
+                return 0;
+            }
+            previous ^= field << window_trailing;
+        }
+        values[i] = bits_double(previous);
+    }
+    // Whole bytes still in the window were read ahead; hand them back
+    *position = reader.position - (size_t)(reader.available / 8);
+    return 1;
+}
+
+// Fewest decimals that represent every value exactly, -1 if none do
+static int exact_decimals(const double* const columns[], int column_count, int count) {
+    for (int d = 0; d <= HISTORY_MAX_DECIMALS; d++) {
+        double scale = DECIMAL_SCALES[d];
+        int exact = 1;
+        for (int c = 0; c < column_count && exact; c++) {
+            for (int i = 0; i < count; i++) {
+                double scaled = columns[c][i] * scale;
+                if (!(fabs(scaled) < EXACT_INTEGER_LIMIT) || (double)llround(scaled) / scale != columns[c][i]) {
+                    exact = 0;
+                    break;
+                }
+            }
+        }
+        if (exact) {
+            return d;
+        }
+    }
+    return -1;
+}
+
+// Encode bars [first, first + count) of a series as one block
+static int encode_block(ByteBuffer* out, const PriceSeries* series, int first, int count,
+                        HistorySegmentStats* stats) {
+    // Worst case: 10-byte varints everywhere or ~77 bits per XOR value, plus run lengths
+    if (!buffer_reserve(out, sizeof(BlockHeader) + (size_t)count * 96 + 64)) {
+        return 0;
+    }
+    size_t header_at = out->length;
+    out->length += sizeof(BlockHeader);
+    BlockHeader header;
+    memset(&header, 0, sizeof(header));
+    header.count = count;
+
+    const long long* times = &series->timestamps[first];
+    put_varint(out, zigzag(times[0]));
+    long long previous_delta = 0;
+    for (int i = 1; i < count; i++) {
+        long long delta = times[i] - times[i - 1];
+        put_varint(out, zigzag(delta - previous_delta));
+        previous_delta = delta;
+    }
+
+    const double* open = &series->open[first];
+    const double* high = &series->high[first];
+    const double* low = &series->low[first];
+    const double* close = &series->close[first];
+    const double* prices[] = {close, open, high, low};
+    int decimals = exact_decimals(prices, 4, count);
+    if (decimals >= 0) {
+        double scale = DECIMAL_SCALES[decimals];
+        header.price_mode = PRICES_SCALED;
+        header.decimals = (unsigned char)decimals;
+        long long previous = 0;
+        for (int i = 0; i < count; i++) {
+            long long c = llround(close[i] * scale);
+            put_varint(out, zigzag(c - previous));
+            previous = c;
+        }
+        for (int p = 1; p < 4; p++) {
+            for (int i = 0; i < count; i++) {
+                put_varint(out, zigzag(llround(prices[p][i] * scale) - llround(close[i] * scale)));
+            }
+        }
+        stats->scaled_blocks++;
+    } else {
+        header.price_mode = PRICES_XOR;
+        for (int p = 0; p < 4; p++) {
+            encode_xor(out, prices[p], count);
+        }
+        stats->xor_blocks++;
+    }
+
+    const double* volume = &series->volume[first];
+    const double* volumes[] = {volume};
+    int whole = exact_decimals(volumes, 1, count) == 0;
+    for (int i = 0; i < count && whole; i++) {
+        whole = volume[i] >= 0;
+    }
+    if (whole) {
+        // Each run is varint(value * 2 + repeated), then varint(length - 2) if repeated
+        header.volume_mode = VOLUME_RUNS;
+        for (int i = 0; i < count; ) {
+            int run = 1;
+            while (i + run < count && volume[i + run] == volume[i]) {
+                run++;
+            }
+            put_varint(out, (unsigned long long)llround(volume[i]) * 2 + (run > 1));
+            if (run > 1) {
+                put_varint(out, (unsigned long long)(run - 2));
+            }
+            i += run;
+        }
+    } else {
+        header.volume_mode = VOLUME_XOR;
+        encode_xor(out, volume, count);
+    }
+
+    header.length = (int)(out->length - header_at - sizeof(BlockHeader));
+    memcpy(&out->data[header_at], &header, sizeof(header));
+    return 1;
+}
+
+// Write every series of a store as a compressed segment
+int history_segment_write(const HistoryStore* store, const char* filename, HistorySegmentStats* stats) {
+    if (!store || !filename) {
+        return -1;
+    }
+    HistorySegmentStats local;
+    if (!stats) {
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(*stats));
+
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        display_error("Cannot write history segment");
+        return -1;
+    }
+    int block_bars = HISTORY_BLOCK_BARS;
+    int ok = fwrite(SEGMENT_MAGIC, 1, SEGMENT_MAGIC_LENGTH, file) == SEGMENT_MAGIC_LENGTH &&
+             fwrite(&store->count, sizeof(int), 1, file) == 1 &&
+             fwrite(&block_bars, sizeof(int), 1, file) == 1;
+
+    ByteBuffer buffer = {NULL, 0, 0};
+    for (int s = 0; s < store->count && ok; s++) {
+        const PriceSeries* series = &store->series[s];
+        int blocks = (series->count + HISTORY_BLOCK_BARS - 1) / HISTORY_BLOCK_BARS;
+        buffer.length = 0;
+        for (int first = 0; first < series->count && ok; first += HISTORY_BLOCK_BARS) {
+            int count = series->count - first < HISTORY_BLOCK_BARS ? series->count - first : HISTORY_BLOCK_BARS;
+            ok = encode_block(&buffer, series, first, count, stats);
+        }
+        ok = ok && fwrite(series->symbol, 1, MAX_SYMBOL_LENGTH, file) == MAX_SYMBOL_LENGTH &&
+             fwrite(&series->count, sizeof(int), 1, file) == 1 &&
+             fwrite(&blocks, sizeof(int), 1, file) == 1 &&
+             fwrite(buffer.data, 1, buffer.length, file) == buffer.length;
+        stats->bars += series->count;
+        stats->blocks += blocks;
+    }
+    free(buffer.data);
+
+    long size = ok ? ftell(file) : -1;
+    if (fclose(file) != 0 || !ok || size < 0) {
+        display_error("Cannot write history segment");
+        return -1;
+    }
+    stats->raw_bytes = (size_t)stats->bars * (sizeof(long long) + 5 * sizeof(double));
+    stats->encoded_bytes = (size_t)size;
+    return (int)stats->bars;
+}
+
+// Map a segment file and index its blocks
+int history_segment_open(HistorySegment* segment, const char* filename) {
+    if (!segment || !filename) {
+        return 0;
+    }
+    memset(segment, 0, sizeof(*segment));
+    int fd = open(filename, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        display_error("Cannot open history segment");
+        if (fd >= 0) close(fd);
+        return 0;
+    }
+
+    // Mapped rather than read: queries touch each block once, and only the
+    // pages of the blocks they decode are ever faulted in
+    void* mapped = info.st_size > 0 ? mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    int ok = mapped != MAP_FAILED;
+    if (ok) {
+        segment->data = mapped;
+        segment->size = (size_t)info.st_size;
+    }
+
+    // Header, then per series: symbol, bars, blocks, and the blocks themselves
+    size_t position = SEGMENT_MAGIC_LENGTH + 2 * sizeof(int);
+    int series_count = 0, block_bars = 0;
+    ok = ok && segment->size >= position && memcmp(segment->data, SEGMENT_MAGIC, SEGMENT_MAGIC_LENGTH) == 0;
+    if (ok) {
+        memcpy(&series_count, segment->data + SEGMENT_MAGIC_LENGTH, sizeof(int));
+        memcpy(&block_bars, segment->data + SEGMENT_MAGIC_LENGTH + sizeof(int), sizeof(int));
+        ok = series_count >= 0 && block_bars == HISTORY_BLOCK_BARS;
+    }
+    if (ok) {
+        segment->names = calloc((size_t)(series_count > 0 ? series_count : 1), MAX_SYMBOL_LENGTH);
+        ok = segment->names != NULL;
+    }
+    int block_capacity = 0;
+    for (int s = 0; s < series_count && ok; s++) {
+        int bars, blocks;
+        if (position + MAX_SYMBOL_LENGTH + 2 * sizeof(int) > segment->size) {
+            ok = 0;
+            break;
+        }
+        memcpy(segment->names[s], segment->data + position, MAX_SYMBOL_LENGTH);
+        segment->names[s][MAX_SYMBOL_LENGTH - 1] = '\0';
+        position += MAX_SYMBOL_LENGTH;
+        memcpy(&bars, segment->data + position, sizeof(int));
+        memcpy(&blocks, segment->data + position + sizeof(int), sizeof(int));
+        position += 2 * sizeof(int);
+        ok = bars >= 0 && blocks >= 0;
+        segment->series_count = s + 1;
+
+        for (int b = 0; b < blocks && ok; b++) {
+            BlockHeader header;
+            if (position + sizeof(header) > segment->size) {
+                ok = 0;
+                break;
+            }
+            memcpy(&header, segment->data + position, sizeof(header));
+            if (header.count <= 0 || header.count > HISTORY_BLOCK_BARS || header.length < 0 ||
+                position + sizeof(header) + (size_t)header.length > segment->size) {
+                ok = 0;
+                break;
+            }
+            if (segment->block_count == block_capacity) {
+                block_capacity = block_capacity ? block_capacity * 2 : 256;
+                HistorySegmentBlock* grown = realloc(segment->blocks, (size_t)block_capacity * sizeof(HistorySegmentBlock));
+                if (!grown) {
+                    ok = 0;
+                    break;
+                }
+                segment->blocks = grown;
+            }
+            HistorySegmentBlock* block = &segment->blocks[segment->block_count++];
+            block->series = s;
+            block->count = header.count;
+            block->offset = position;
+            position += sizeof(header) + (size_t)header.length;
+            segment->bars += header.count;
+        }
+    }
+    if (!ok || position != segment->size) {
+        fprintf(stderr, "❌ %s: not a valid history segment\n", filename);
+        history_segment_close(segment);
+        return 0;
+    }
+    return 1;
+}
+
+// Release a segment
+void history_segment_close(HistorySegment* segment) {
+    if (!segment) {
+        return;
+    }
+    if (segment->data) {
+        munmap((void*)segment->data, segment->size);
+    }
+    free(segment->names);
+    free(segment->blocks);
+    memset(segment, 0, sizeof(*segment));
+}
+
+// Varint column into integers; the only byte-serial loop of a block decode
+static int decode_varints(const unsigned char* data, size_t length, size_t* position, long long* values, int count) {
+    size_t p = *position;
+    for (int i = 0; i < count; i++) {
+        unsigned long long raw = 0;
+        unsigned char byte;
+        int shift = 0;
+        do {
+            if (p >= length || shift > 63) {
+                return 0;
+            }
+            byte = data[p++];
+            raw |= (unsigned long long)(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        values[i] = unzigzag(raw);
+    }
+    *position = p;
+    return 1;
+}
+
+// Decode one block into flat columns
+int history_segment_decode(const HistorySegment* segment, int block, HistoryBlock* out) {
+    if (!segment || !out || block < 0 || block >= segment->block_count) {
+        return 0;
+    }
+    const HistorySegmentBlock* index = &segment->blocks[block];
+    BlockHeader header;
+    memcpy(&header, segment->data + index->offset, sizeof(header));
+    const unsigned char* data = segment->data + index->offset + sizeof(header);
+    size_t length = (size_t)header.length;
+    size_t position = 0;
+    int count = header.count;
+    long long scaled_close[HISTORY_BLOCK_BARS];
+    long long scratch[HISTORY_BLOCK_BARS];
+
+    out->symbol = segment->names[index->series];
+    out->count = count;
+
+    // Timestamps: two prefix sums over the delta-of-deltas
+    if (!decode_varints(data, length, &position, scratch, count)) {
+        return 0;
+    }
+    long long delta = 0;
+    out->timestamps[0] = scratch[0];
+    for (int i = 1; i < count; i++) {
+        delta += scratch[i];
+        out->timestamps[i] = out->timestamps[i - 1] + delta;
+    }
+
+    double* prices[] = {out->close, out->open, out->high, out->low};
+    if (header.price_mode == PRICES_SCALED && header.decimals <= HISTORY_MAX_DECIMALS) {
+        double scale = DECIMAL_SCALES[header.decimals];
+        if (!decode_varints(data, length, &position, scaled_close, count)) {
+            return 0;
+        }
+        for (int i = 1; i < count; i++) {
+            scaled_close[i] += scaled_close[i - 1];
+        }
+        for (int i = 0; i < count; i++) {
+            out->close[i] = (double)scaled_close[i] / scale;
+        }
+        for (int p = 1; p < 4; p++) {
+            if (!decode_varints(data, length, &position, scratch, count)) {
+                return 0;
+            }
+            double* column = prices[p];
+            for (int i = 0; i < count; i++) {
+                column[i] = (double)(scaled_close[i] + scratch[i]) / scale;
+            }
+        }
+    } else if (header.price_mode == PRICES_XOR) {
+        for (int p = 0; p < 4; p++) {
+            if (!decode_xor(data, length, &position, prices[p], count)) {
+                return 0;
+            }
+        }
+    } else {
+        return 0;
+    }
+
+    if (header.volume_mode == VOLUME_RUNS) {
+        for (int i = 0; i < count; ) {
+            unsigned long long token, extra = 0;
+            if (!get_varint(data, length, &position, &token) ||
+                ((token & 1) && !get_varint(data, length, &position, &extra))) {
+                return 0;
+            }
+            int run = (token & 1) ? (int)extra + 2 : 1;
+            if (run > count - i) {
+                return 0;
+            }
+            double value = (double)(token >> 1);
+            for (int r = 0; r < run; r++) {
+                out->volume[i++] = value;
+            }
+        }
+    } else if (header.volume_mode == VOLUME_XOR) {
+        if (!decode_xor(data, length, &position, out->volume, count)) {
+            return 0;
+        }
+    } else {
+        return 0;
+    }
+    return position == length;
+}
+
+// Decode a whole segment into a store
+int history_segment_load(HistoryStore* store, const char* filename) {
+    if (!store || !filename) {
+        return -1;
+    }
+    HistorySegment segment;
+    if (!history_segment_open(&segment, filename)) {
+        return -1;
+    }
+    HistoryBlock* block = malloc(sizeof(HistoryBlock));
+    int loaded = block ? 0 : -1;
+    for (int b = 0; b < segment.block_count && loaded >= 0; b++) {
+        if (!history_segment_decode(&segment, b, block)) {
+            fprintf(stderr, "❌ %s: block %d is corrupt\n", filename, b);
+            loaded = -1;
+            break;
+        }
+        PriceSeries* series = history_store_series(store, block->symbol, 1);
+        for (int i = 0; i < block->count && loaded >= 0; i++) {
+            if (!series || !price_series_append(series, block->timestamps[i], block->open[i], block->high[i],
+                                                block->low[i], block->close[i], block->volume[i])) {
+                display_error("Out of memory loading history");
+                loaded = -1;
+            }
+        }
+        if (loaded >= 0) {
+            loaded += block->count;
+        }
+    }
+    free(block);
+    history_segment_close(&segment);
+    return loaded;
+}
+
+// Same bar in the store and a decoded block, bit for bit
+static int same_value(double a, double b) {
+    return double_bits(a) == double_bits(b) || (a == 0.0 && b == 0.0);
+}
+
+// Command line entry:
+// compress <history.csv|.seg> | --synthetic SYMBOLS BARS  [--output file] [--threads N]
+int run_compress_command(int argc, char* argv[]) {
+    const char* filename = NULL;
+    const char* output = HISTORY_SEGMENT_FILE;
+    int synthetic_symbols = 0, synthetic_bars = 0;
+    int threads = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--synthetic") == 0 && i + 2 < argc) {
+            synthetic_symbols = atoi(argv[++i]);
+            synthetic_bars = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && !filename) {
+            filename = argv[i];
+        } else {
+            fprintf(stderr, "❌ Unknown compress option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (!filename && synthetic_symbols <= 0) {
+        fprintf(stderr, "usage: stock_tracker compress <history.csv|%s> | --synthetic SYMBOLS BARS "
+                        "[--output file] [--threads N]\n", HISTORY_SEGMENT_EXTENSION);
+        return 1;
+    }
+
+    HistoryStore store;
+    long long load_start = metrics_now_ns();
+    if (!history_store_open(&store, filename, synthetic_symbols, synthetic_bars, threads)) {
+        return 1;
+    }
+    long long load_ns = metrics_now_ns() - load_start;
+
+    HistorySegmentStats stats;
+    long long encode_start = metrics_now_ns();
+    if (history_segment_write(&store, output, &stats) < 0) {
+        history_store_free(&store);
+        return 1;
+    }
+    long long encode_ns = metrics_now_ns() - encode_start;
+
+    // Decode every block until enough time has passed for a stable rate
+    HistorySegment segment;
+    HistoryBlock* block = malloc(sizeof(HistoryBlock));
+    if (!block || !history_segment_open(&segment, output)) {
+        free(block);
+        history_store_free(&store);
+        return 1;
+    }
+    int mismatches = 0;
+    int passes = 0;
+    long long decode_ns = 0;
+    do {
+        long long pass_start = metrics_now_ns();
+        for (int b = 0; b < segment.block_count; b++) {
+            if (!history_segment_decode(&segment, b, block)) {
+                mismatches++;
+            }
+        }
+        decode_ns += metrics_now_ns() - pass_start;
+        passes++;
+    } while (decode_ns < 200000000LL && passes < 1000);
+
+    // Round trip check against the source
+    int series = -1, offset = 0;
+    for (int b = 0; b < segment.block_count; b++) {
+        if (!history_segment_decode(&segment, b, block)) {
+            continue;
+        }
+        if (segment.blocks[b].series != series) {
+            series = segment.blocks[b].series;
+            offset = 0;
+        }
+        const PriceSeries* source = &store.series[series];
+        for (int i = 0; i < block->count; i++) {
+            int j = offset + i;
+            if (block->timestamps[i] != source->timestamps[j] || !same_value(block->open[i], source->open[j]) ||
+                !same_value(block->high[i], source->high[j]) || !same_value(block->low[i], source->low[j]) ||
+                !same_value(block->close[i], source->close[j]) || !same_value(block->volume[i], source->volume[j])) {
+                mismatches++;
+            }
+        }
+        offset += block->count;
+    }
+    long long segment_start = metrics_now_ns();
+    HistoryStore reloaded;
+    int reload_ok = history_store_init(&reloaded) && history_segment_load(&reloaded, output) >= 0;
+    long long segment_load_ns = metrics_now_ns() - segment_start;
+    history_store_free(&reloaded);
+
+    printf("🗜️  HISTORY SEGMENT\n");
+    printf("══════════════════════════════\n");
+    printf("• Symbols: %d, bars: %lld in %d blocks (%d scaled-integer, %d XOR)\n",
+           store.count, stats.bars, stats.blocks, stats.scaled_blocks, stats.xor_blocks);
+    printf("• Raw columns: %.1f MB, segment: %.1f MB -> %.2fx (%.1f bits per bar)\n",
+           stats.raw_bytes / 1048576.0, stats.encoded_bytes / 1048576.0,
+           stats.encoded_bytes > 0 ? (double)stats.raw_bytes / stats.encoded_bytes : 0.0,
+           stats.bars > 0 ? stats.encoded_bytes * 8.0 / stats.bars : 0.0);
+    printf("• Encode: %.3fs, decode: %.2f GB/s of raw columns (%.0fM bars/s, %d passes)\n",
+           encode_ns / 1e9, decode_ns > 0 ? (double)stats.raw_bytes * passes / decode_ns : 0.0,
+           decode_ns > 0 ? stats.bars * passes * 1e3 / decode_ns : 0.0, passes);
+    printf("• Load into a store: %.3fs from %s, %.3fs from the segment\n",
+           load_ns / 1e9, filename ? filename : "the generator", reload_ok ? segment_load_ns / 1e9 : 0.0);
+    printf("• Round trip: %s\n", mismatches == 0 && reload_ok ? "✅ lossless" : "❌ mismatched bars");
+    printf("• Written to %s\n", output);
+
+    free(block);
+    history_segment_close(&segment);
+    history_store_free(&store);
+    return mismatches == 0 && reload_ok ? 0 : 1;
+}
@@ -0,0 +1,665 @@
+/*
+ * Smart Stock Tracker - Bulk History Ingest
+ * Parallel loading of large bar history CSV files
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * The file is memory mapped and cut into chunks that start and end on line
+ * boundaries. Two passes run over the chunks in parallel:
+ *   1. count: each chunk counts its rows per symbol (symbols only),
+ *   2. parse: each chunk parses its rows straight into the store's columns.
+ * Between the passes every series is grown once, and each chunk is given
+ * the slots its rows go to, in file order; chunks never write to the same
+ * slot, so the parse pass needs no locks and allocates nothing. Numbers and
+ * dates are parsed by hand on the mapped bytes. Rows are the same as for
+ * history_store_load_csv(): "symbol,timestamp,open,high,low,close,volume"
+ * with any further fields ignored, a first line that is not a row by that
+ * loader's test taken as the header, and '#' comments and blank lines skipped.
+ */
+
+#include "stock_tracker.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define INGEST_MAX_FIELD 64          // Longest number handed to strtod()
+
+// One chunk of the file and what the passes learned about it
+typedef struct {
+    const char* begin;
+    const char* end;
+    SymbolMap symbols;        // Symbols seen in the chunk, local ids
+    int* counts;              // Rows per local id
+    int* targets;             // Store series of each local id
+    int* cursors;             // Next slot to fill per local id
+    int capacity;
+    long long rows;
+    const char* error;        // First malformed row, NULL if none
+    const char* error_at;
+} IngestChunk;
+
+// Shared state of one ingest
+typedef struct {
+    HistoryStore* store;
+    IngestChunk* chunks;
+} IngestJob;
+
+// Exact powers of ten; a mantissa up to 2^53 divided by one is correctly rounded
+static const double POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static int is_digit(char c) {
+    return (unsigned char)(c - '0') < 10;
+}
+
+// Fields end at a comma or the end of the line; the byte after the last
+// line is a line end too ('\0'), so parsers never need the end pointer
+static int is_field_end(char c) {
+    return c == ',' || c == '\n' || c == '\r' || c == '\0';
+}
+
+// Slow path for numbers the fast path cannot round exactly (exponents,
+// more than 19 digits, nan, inf); copies the field so strtod() stops at it
+static const char* parse_number_slow(const char* p, double* out) {
+    char field[INGEST_MAX_FIELD];
+    size_t length = 0;
+    while (!is_field_end(p[length])) {
+        if (++length == sizeof(field)) {
+            return NULL;
+        }
+    }
+    memcpy(field, p, length);
+    field[length] = '\0';
+    char* stop;
+    *out = strtod(field, &stop);
+    return (length > 0 && stop == field + length) ? p + length : NULL;
+}
+
+// Decimal number; returns the position after it, NULL if malformed
+static const char* parse_number(const char* p, double* out) {
+    const char* start = p;
+    int negative = *p == '-';
+    p += (*p == '-' || *p == '+');
+
+    // Leading zeros count as digits too; numbers that long take the slow path
+    unsigned long long mantissa = 0;
+    const char* digits = p;
+    for (; is_digit(*p); p++) {
+        mantissa = mantissa * 10 + (unsigned)(*p - '0');
+    }
+    long long length = p - digits;
+    long long fraction = 0;
+    if (*p == '.') {
+        const char* point = ++p;
+        for (; is_digit(*p); p++) {
+            mantissa = mantissa * 10 + (unsigned)(*p - '0');
+        }
+        fraction = p - point;
+        length += fraction;
+    }
+    if (length == 0 || length > 19 || mantissa > (1ULL << 53) || fraction > 22 || !is_field_end(*p)) {
+        return parse_number_slow(start, out);
+    }
+    double value = (double)mantissa / POWERS_OF_TEN[fraction];
+    *out = negative ? -value : value;
+    return p;
+}
+
+// Unsigned decimal integer of at most 18 digits
+static const char* parse_digits(const char* p, long long* out) {
+    long long value = 0;
+    const char* start = p;
+    for (; is_digit(*p) && p - start < 18; p++) {
+        value = value * 10 + (*p - '0');
+    }
+    *out = value;
+    return p > start ? p : NULL;
+}
+
+// "YYYY-MM-DD[( |T)HH[:MM[:SS]]][Z]" (UTC) or Unix seconds, as parse_history_timestamp() reads them
+static const char* parse_timestamp(const char* p, long long* out) {
+    int negative = *p == '-';
+    long long year, month, day, hour = 0, minute = 0, second = 0;
+    p = parse_digits(p + negative, &year);
+    if (!p) {
+        return NULL;
+    }
+    if (negative || *p != '-') {
+        *out = negative ? -year : year;   // Plain epoch seconds
+        return is_field_end(*p) ? p : NULL;
+    }
+
+    p = parse_digits(p + 1, &month);
+    if (!p || *p != '-') return NULL;
+    p = parse_digits(p + 1, &day);
+    if (!p) return NULL;
+    if (*p == ' ' || *p == 'T') {
+        p = parse_digits(p + 1, &hour);
+        if (!p) return NULL;
+        if (*p == ':') {
+            p = parse_digits(p + 1, &minute);
+            if (!p) return NULL;
+            if (*p == ':') {
+                p = parse_digits(p + 1, &second);
+                if (!p) return NULL;
+            }
+        }
+    }
+    p += *p == 'Z';
+    if (!is_field_end(*p) || month < 1 || month > 12 || day < 1 || day > 31) {
+        return NULL;
+    }
+    *out = history_days_from_civil((int)year, (int)month, (int)day) * 86400LL
+         + hour * 3600LL + minute * 60LL + second;
+    return p;
+}
+
+// Symbol field copied into a NUL-terminated buffer; returns its comma
+static const char* parse_symbol(const char* p, char symbol[MAX_SYMBOL_LENGTH]) {
+    size_t length = 0;
+    while (!is_field_end(p[length])) {
+        if (length == MAX_SYMBOL_LENGTH - 1) {
+            return NULL;
+        }
+        symbol[length] = p[length];
+        length++;
+    }
+    symbol[length] = '\0';
+    return (length > 0 && p[length] == ',') ? p + length : NULL;
+}
+
+// Does the line start with this symbol and its comma
+static const char* same_symbol(const char* p, const char* symbol) {
+    for (; *symbol; p++, symbol++) {
+        if (*p != *symbol) {
+            return NULL;
+        }
+    }
+    return *p == ',' ? p : NULL;
+}
+
+// Parse the fields after the symbol's comma; returns the start of the next
+// line (or the end of the file), NULL if malformed
+static const char* parse_fields(const char* p, long long* timestamp, double values[5], const char** error) {
+    p = parse_timestamp(p + 1, timestamp);
+    if (!p) {
+        *error = "expected a YYYY-MM-DD[ HH[:MM[:SS]]] date or Unix seconds";
+        return NULL;
+    }
+    for (int f = 0; f < 5; f++) {
+        if (*p != ',') {
+            *error = "expected symbol,timestamp,open,high,low,close,volume";
+            return NULL;
+        }
+        p = parse_number(p + 1, &values[f]);
+        if (!p) {
+            *error = "expected a number";
+            return NULL;
+        }
+    }
+    // Further fields are ignored, as history_store_load_csv() ignores them
+    if (*p == ',') {
+        while (*p != '\n' && *p != '\0') p++;
+    }
+    p += *p == '\r';
+    if (*p != '\n' && *p != '\0') {
+        *error = "expected symbol,timestamp,open,high,low,close,volume";
+        return NULL;
+    }
+    return p + (*p == '\n');
+}
+
+// Start of the line after p
+static const char* next_line(const char* p, const char* end) {
+    const char* newline = memchr(p, '\n', (size_t)(end - p));
+    return newline ? newline + 1 : end;
+}
+
+// Blank lines and '#' comments carry no rows
+static int is_skipped_line(const char* p) {
+    return *p == '#' || *p == '\n' || (*p == '\r' && (p[1] == '\n' || p[1] == '\0'));
+}
+
+// Local id of a symbol, growing the chunk's per-symbol arrays
+static int chunk_symbol(IngestChunk* chunk, const char* symbol) {
+    int id = symbol_map_insert(&chunk->symbols, symbol);
+    if (id < 0) {
+        return -1;
+    }
+    if (id >= chunk->capacity) {
+        int new_capacity = chunk->capacity ? chunk->capacity * 2 : 16;
+        int* counts = realloc(chunk->counts, (size_t)new_capacity * sizeof(int));
+        if (!counts) {
+            return -1;
+        }
+        chunk->counts = counts;
+        memset(&counts[chunk->capacity], 0, (size_t)(new_capacity - chunk->capacity) * sizeof(int));
+        chunk->capacity = new_capacity;
+    }
+    return id;
+}
+
+// Pass 1: rows per symbol; files grouped by symbol mostly reuse the previous id
+static void count_task(int begin, int end, int worker, void* context) {
+    (void)worker;
+    IngestJob* job = context;
+    for (int c = begin; c < end; c++) {
+        IngestChunk* chunk = &job->chunks[c];
+        char symbol[MAX_SYMBOL_LENGTH], previous[MAX_SYMBOL_LENGTH] = "";
+        int id = -1;
+        for (const char* p = chunk->begin; p < chunk->end; p = next_line(p, chunk->end)) {
+            if (is_skipped_line(p)) {
+                continue;
+            }
+            if (!parse_symbol(p, symbol)) {
+                chunk->error = "expected a symbol of 1-9 characters before the first comma";
+                chunk->error_at = p;
+                break;
+            }
+            if (id < 0 || strcmp(symbol, previous) != 0) {
+                id = chunk_symbol(chunk, symbol);
+                if (id < 0) {
+                    chunk->error = "out of memory";
+                    chunk->error_at = p;
+                    break;
+                }
+                strcpy(previous, symbol);
+            }
+            chunk->counts[id]++;
+            chunk->rows++;
+        }
+    }
+}
+
+// Pass 2: parse rows into the slots the merge assigned
+static void parse_task(int begin, int end, int worker, void* context) {
+    (void)worker;
+    IngestJob* job = context;
+    for (int c = begin; c < end; c++) {
+        IngestChunk* chunk = &job->chunks[c];
+        char symbol[MAX_SYMBOL_LENGTH] = "";
+        PriceSeries* series = NULL;
+        int* cursor = NULL;
+        const char* p = chunk->begin;
+        while (p < chunk->end) {
+            if (is_skipped_line(p)) {
+                p = next_line(p, chunk->end);
+                continue;
+            }
+            // Rows of one symbol usually follow each other
+            const char* comma = series ? same_symbol(p, symbol) : NULL;
+            if (!comma) {
+                comma = parse_symbol(p, symbol);
+                int id = comma ? symbol_map_find(&chunk->symbols, symbol) : -1;
+                if (id < 0) {
+                    chunk->error = "expected a symbol of 1-9 characters before the first comma";
+                    chunk->error_at = p;
+                    break;
+                }
+                series = &job->store->series[chunk->targets[id]];
+                cursor = &chunk->cursors[id];
+            }
+            long long timestamp;
+            double values[5];
+            const char* next = parse_fields(comma, &timestamp, values, &chunk->error);
+            if (!next) {
+                chunk->error_at = p;
+                break;
+            }
+            int slot = (*cursor)++;
+            series->timestamps[slot] = timestamp;
+            series->open[slot] = values[0];
+            series->high[slot] = values[1];
+            series->low[slot] = values[2];
+            series->close[slot] = values[3];
+            series->volume[slot] = values[4];
+            p = next;
+        }
+    }
+}
+
+// Give every chunk its series and slots, growing each series once
+static int assign_slots(HistoryStore* store, IngestChunk* chunks, int chunk_count) {
+    int* filled = NULL;   // Bars per store series, existing plus assigned
+    int filled_capacity = 0;
+    int ok = 1;
+
+    for (int c = 0; c < chunk_count && ok; c++) {
+        IngestChunk* chunk = &chunks[c];
+        int symbols = chunk->symbols.count;
+        chunk->targets = malloc((size_t)(symbols > 0 ? symbols : 1) * sizeof(int));
+        chunk->cursors = malloc((size_t)(symbols > 0 ? symbols : 1) * sizeof(int));
+        if (!chunk->targets || !chunk->cursors) {
+            ok = 0;
+            break;
+        }
+        for (int id = 0; id < symbols && ok; id++) {
+            PriceSeries* series = history_store_series(store, symbol_map_name(&chunk->symbols, id), 1);
+            if (!series) {
+                ok = 0;
+                break;
+            }
+            int target = (int)(series - store->series);
+            if (target >= filled_capacity) {
+                int new_capacity = filled_capacity ? filled_capacity * 2 : 64;
+                while (new_capacity <= target) new_capacity *= 2;
+                int* grown = realloc(filled, (size_t)new_capacity * sizeof(int));
+                if (!grown) {
+                    ok = 0;
+                    break;
+                }
+                filled = grown;
+                for (int s = filled_capacity; s < new_capacity; s++) {
+                    filled[s] = s < store->count ? store->series[s].count : 0;
+                }
+                filled_capacity = new_capacity;
+            }
+            chunk->targets[id] = target;
+            chunk->cursors[id] = filled[target];
+            if (chunk->counts[id] > INT_MAX - filled[target]) {
+                fprintf(stderr, "❌ Too many bars for %s\n", series->symbol);
+                ok = 0;
+                break;
+            }
+            filled[target] += chunk->counts[id];
+        }
+    }
+
+    for (int s = 0; s < store->count && ok; s++) {
+        int bars = s < filled_capacity ? filled[s] : store->series[s].count;
+        if (!price_series_reserve(&store->series[s], bars)) {
+            ok = 0;
+        }
+    }
+    free(filled);
+    return ok;
+}
+
+// 1-based line number of a position in the file
+static long long line_number(const char* data, const char* at) {
+    long long line = 1;
+    for (const char* p = data; p < at; p++) {
+        const char* newline = memchr(p, '\n', (size_t)(at - p));
+        if (!newline) {
+            break;
+        }
+        line++;
+        p = newline;
+    }
+    return line;
+}
+
+// Bulk-load a history CSV into a store
+int history_store_ingest_csv(HistoryStore* store, const char* filename, int threads,
+                             HistoryIngestStats* stats) {
+    if (!store || !filename) {
+        return -1;
+    }
+    long long start_ns = metrics_now_ns();
+
+    int fd = open(filename, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        fprintf(stderr, "❌ Cannot open history file %s\n", filename);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    size_t size = (size_t)info.st_size;
+    if (size == 0) {
+        close(fd);
+        if (stats) {
+            memset(stats, 0, sizeof(*stats));
+        }
+        return 0;
+    }
+    const char* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "❌ Cannot map history file %s\n", filename);
+        return -1;
+    }
+    // Parsers stop at the byte after the last line: its newline, or the zero
+    // fill of the last page. A file filling its last page exactly without a
+    // final newline is read into a buffer instead, which gets a NUL
+    char* copy = NULL;
+    if (data[size - 1] != '\n' && size % (size_t)sysconf(_SC_PAGESIZE) == 0) {
+        munmap((void*)data, size);
+        data = copy = read_entire_file(filename, &size);
+        if (!copy) {
+            fprintf(stderr, "❌ Cannot read history file %s\n", filename);
+            return -1;
+        }
+    } else {
+        posix_madvise((void*)data, size, POSIX_MADV_SEQUENTIAL);
+    }
+    const char* end = data + size;
+
+    // A first line that history_store_load_csv() would not read as a row is
+    // the header; one it would read is parsed (or reported) like any other
+    const char* body = data;
+    if (!is_skipped_line(body)) {
+        char line[512];   // That loader's line buffer
+        size_t length = (size_t)(next_line(body, end) - body);
+        length = length < sizeof(line) - 1 ? length : sizeof(line) - 1;
+        memcpy(line, body, length);
+        line[length] = '\0';
+        char symbol[MAX_SYMBOL_LENGTH];
+        long long timestamp;
+        double values[5];
+        if (!history_csv_parse_row(line, symbol, &timestamp, values)) {
+            body = next_line(body, end);
+        }
+    }
+
+    // Chunks split at the first line break after each even cut
+    size_t body_size = (size_t)(end - body);
+    int chunk_count = (int)((body_size + HISTORY_INGEST_CHUNK_BYTES - 1) / HISTORY_INGEST_CHUNK_BYTES);
+    if (chunk_count < 1) {
+        chunk_count = 1;
+    }
+    IngestChunk* chunks = calloc((size_t)chunk_count, sizeof(IngestChunk));
+    if (!chunks) {
+        if (copy) {
+            free(copy);
+        } else {
+            munmap((void*)data, size);
+        }
+        return -1;
+    }
+    const char* cut = body;
+    for (int c = 0; c < chunk_count; c++) {
+        chunks[c].begin = cut;
+        if (c == chunk_count - 1) {
+            cut = end;
+        } else {
+            const char* even = body + body_size / chunk_count * (size_t)(c + 1);
+            cut = even > cut ? next_line(even - 1, end) : cut;
+        }
+        chunks[c].end = cut;
+    }
+
+    int ok = 1;
+    for (int c = 0; c < chunk_count && ok; c++) {
+        ok = symbol_map_init(&chunks[c].symbols, 16);
+    }
+
+    IngestJob job = {store, chunks};
+    int used_threads = 0;
+    if (ok) {
+        used_threads = parallel_for(chunk_count, 1, threads, count_task, &job);
+    }
+    for (int c = 0; c < chunk_count && ok; c++) {
+        ok = !chunks[c].error;
+    }
+    if (ok && !assign_slots(store, chunks, chunk_count)) {
+        display_error("Out of memory loading history");
+        ok = 0;
+    }
+    if (ok) {
+        parallel_for(chunk_count, 1, threads, parse_task, &job);
+    }
+
+    // Report the first bad row in file order
+    long long rows = 0;
+    for (int c = 0; c < chunk_count; c++) {
+        if (chunks[c].error) {
+            fprintf(stderr, "❌ %s:%lld: %s\n", filename, line_number(data, chunks[c].error_at), chunks[c].error);
+            ok = 0;
+            break;
+        }
+        rows += chunks[c].rows;
+    }
+
+    // Publish the new bars only once every row has parsed
+    if (ok) {
+        for (int c = 0; c < chunk_count; c++) {
+            for (int id = 0; id < chunks[c].symbols.count; id++) {
+                PriceSeries* series = &store->series[chunks[c].targets[id]];
+                if (chunks[c].cursors[id] > series->count) {
+                    series->count = chunks[c].cursors[id];
+                }
+            }
+        }
+        history_store_sort(store);
+    }
+
+    for (int c = 0; c < chunk_count; c++) {
+        symbol_map_free(&chunks[c].symbols);
+        free(chunks[c].counts);
+        free(chunks[c].targets);
+        free(chunks[c].cursors);
+    }
+    free(chunks);
+    if (copy) {
+        free(copy);
+    } else {
+        munmap((void*)data, size);
+    }
+
+    if (stats) {
+        stats->rows = rows;
+        stats->bytes = (long long)size;
+        stats->chunks = chunk_count;
+        stats->threads = used_threads;
+        stats->elapsed_ns = metrics_now_ns() - start_ns;
+    }
+    return ok ? (int)rows : -1;
+}
+
+// Do two stores hold the same bars, bit for bit
+static int stores_match(const HistoryStore* a, const HistoryStore* b) {
+    if (a->count != b->count) {
+        return 0;
+    }
+    for (int s = 0; s < a->count; s++) {
+        const PriceSeries* x = &a->series[s];
+        const PriceSeries* y = history_store_series((HistoryStore*)b, x->symbol, 0);
+        if (!y || x->count != y->count) {
+            return 0;
+        }
+        size_t bytes = (size_t)x->count * sizeof(double);
+        if (memcmp(x->timestamps, y->timestamps, (size_t)x->count * sizeof(long long)) != 0 ||
+            memcmp(x->open, y->open, bytes) != 0 || memcmp(x->high, y->high, bytes) != 0 ||
+            memcmp(x->low, y->low, bytes) != 0 || memcmp(x->close, y->close, bytes) != 0 ||
+            memcmp(x->volume, y->volume, bytes) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Command line entry for "stock_tracker ingest ..."
+int run_ingest_command(int argc, char* argv[]) {
+    const char* output = NULL;
+    int threads = 0;
+    int verify = 0;
+    int file_count = 0;
+    const char** files = malloc((size_t)argc * sizeof(char*));
+    if (!files) {
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            verify = 1;
+        } else if (argv[i][0] != '-') {
+            files[file_count++] = argv[i];
+        } else {
+            fprintf(stderr, "❌ Unknown ingest option: %s\n", argv[i]);
+            free(files);
+            return 1;
+        }
+    }
+    if (file_count == 0) {
+        fprintf(stderr, "usage: stock_tracker ingest <history.csv>... [--threads N] "
+                        "[--output file.csv|file%s] [--verify]\n", HISTORY_SEGMENT_EXTENSION);
+        free(files);
+        return 1;
+    }
+
+    HistoryStore store;
+    if (!history_store_init(&store)) {
+        free(files);
+        return 1;
+    }
+    printf("📥 HISTORY INGEST\n");
+    printf("══════════════════════════════\n");
+    long long total_rows = 0, total_bytes = 0, total_ns = 0;
+    for (int f = 0; f < file_count; f++) {
+        HistoryIngestStats stats;
+        if (history_store_ingest_csv(&store, files[f], threads, &stats) < 0) {
+            history_store_free(&store);
+            free(files);
+            return 1;
+        }
+        printf("• %s: %lld rows, %.1f MB in %.3fs (%.2f GB/s, %d chunks on %d threads)\n",
+               files[f], stats.rows, stats.bytes / 1048576.0, stats.elapsed_ns / 1e9,
+               stats.elapsed_ns > 0 ? (double)stats.bytes / stats.elapsed_ns : 0.0,
+               stats.chunks, stats.threads);
+        total_rows += stats.rows;
+        total_bytes += stats.bytes;
+        total_ns += stats.elapsed_ns;
+    }
+    printf("• Total: %lld rows for %d symbols, %.2f GB/s, %.1fM rows/s\n",
+           total_rows, store.count, total_ns > 0 ? (double)total_bytes / total_ns : 0.0,
+           total_ns > 0 ? total_rows * 1e3 / total_ns : 0.0);
+
+    int ok = 1;
+    if (verify) {
+        // Same files through the line-by-line loader must give the same bars
+        HistoryStore reference;
+        long long reference_start = metrics_now_ns();
+        ok = history_store_init(&reference);
+        for (int f = 0; f < file_count && ok; f++) {
+            ok = history_store_load_csv(&reference, files[f]) >= 0;
+        }
+        long long reference_ns = metrics_now_ns() - reference_start;
+        ok = ok && stores_match(&store, &reference);
+        printf("• Verify: %s (line-by-line loader took %.3fs, %.1fx slower)\n",
+               ok ? "✅ identical bars" : "❌ bars differ", reference_ns / 1e9,
+               total_ns > 0 ? (double)reference_ns / total_ns : 0.0);
+        history_store_free(&reference);
+    }
+
+    if (ok && output) {
+        size_t length = strlen(output);
+        size_t suffix = strlen(HISTORY_SEGMENT_EXTENSION);
+        int segment = length > suffix && strcmp(output + length - suffix, HISTORY_SEGMENT_EXTENSION) == 0;
+        ok = segment ? history_segment_write(&store, output, NULL) >= 0
+                     : history_store_write_csv(&store, output) >= 0;
+        if (ok) {
+            printf("• Written to %s\n", output);
+        }
+    }
+    history_store_free(&store);
+    free(files);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,388 @@
+/*
+ * Smart Stock Tracker - History Store
+ * Columnar per-symbol OHLCV bar history
+ * Author: [Your Name]
+ * Date: October 2025
+ */
+
+#include "stock_tracker.h"
+#include <errno.h>
+#include <time.h>
+
+// Grow every column of a series to hold at least capacity bars
+int price_series_reserve(PriceSeries* series, int capacity) {
+    if (capacity <= series->capacity) {
+        return 1;
+    }
+    int new_capacity = series->capacity ? series->capacity : 64;
+    while (new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+
+    long long* timestamps = realloc(series->timestamps, (size_t)new_capacity * sizeof(long long));
+    if (!timestamps) return 0;
+    series->timestamps = timestamps;
+
+    double** columns[] = {&series->open, &series->high, &series->low, &series->close, &series->volume};
+    for (size_t c = 0; c < sizeof(columns) / sizeof(columns[0]); c++) {
+        double* grown = realloc(*columns[c], (size_t)new_capacity * sizeof(double));
+        if (!grown) return 0;
+        *columns[c] = grown;
+    }
+
+    series->capacity = new_capacity;
+    return 1;
+}
+
+// Initialize an empty store
+int history_store_init(HistoryStore* store) {
+    if (!store) {
+        return 0;
+    }
+    memset(store, 0, sizeof(*store));
+    return symbol_map_init(&store->symbols, 64);
+}
+
+// Release all series and the store itself
+void history_store_free(HistoryStore* store) {
+    if (!store) {
+        return;
+    }
+    for (int i = 0; i < store->count; i++) {
+        PriceSeries* s = &store->series[i];
+        free(s->timestamps);
+        free(s->open);
+        free(s->high);
+        free(s->low);
+        free(s->close);
+        free(s->volume);
+    }
+    free(store->series);
+    symbol_map_free(&store->symbols);
+    memset(store, 0, sizeof(*store));
+}
+
+// Get a symbol's series, optionally creating it
+PriceSeries* history_store_series(HistoryStore* store, const char* symbol, int create) {
+    if (!store || !symbol) {
+        return NULL;
+    }
+    int id = symbol_map_find(&store->symbols, symbol);
+    if (id < 0 && create) {
+        // Room for the series first: an id the map hands out must always
+        // have its series, or the next new symbol's id would skip a slot
+        if (store->count == store->capacity) {
+            int new_capacity = store->capacity ? store->capacity * 2 : 64;
+            PriceSeries* grown = realloc(store->series, (size_t)new_capacity * sizeof(PriceSeries));
+            if (!grown) {
+                return NULL;
+            }
+            store->series = grown;
+            store->capacity = new_capacity;
+        }
+        // Ids are dense, so a new id is always store->count
+        id = symbol_map_insert(&store->symbols, symbol);
+        if (id < 0) {
+            return NULL;
+        }
+        PriceSeries* s = &store->series[store->count++];
+        memset(s, 0, sizeof(*s));
+        strcpy(s->symbol, symbol_map_name(&store->symbols, id));
+    }
+    return id >= 0 ? &store->series[id] : NULL;
+}
+
+// Append one bar to a series
+int price_series_append(PriceSeries* series, long long timestamp, double open, double high,
+                        double low, double close, double volume) {
+    if (!series || !price_series_reserve(series, series->count + 1)) {
+        return 0;
+    }
+    int i = series->count++;
+    series->timestamps[i] = timestamp;
+    series->open[i] = open;
+    series->high[i] = high;
+    series->low[i] = low;
+    series->close[i] = close;
+    series->volume[i] = volume;
+    return 1;
+}
+
+// Order bars by timestamp if they were appended out of order. The keys are
+// sorted as (timestamp, index) pairs, so there is no shared state and the
+// function is safe to run on different series from several threads; equal
+// timestamps keep their append order
+typedef struct {
+    long long timestamp;
+    int index;
+} BarOrder;
+
+static int compare_bar_order(const void* a, const void* b) {
+    const BarOrder* x = a;
+    const BarOrder* y = b;
+    if (x->timestamp != y->timestamp) {
+        return (x->timestamp > y->timestamp) - (x->timestamp < y->timestamp);
+    }
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+int price_series_sort(PriceSeries* series) {
+    int sorted = 1;
+    for (int i = 1; i < series->count && sorted; i++) {
+        sorted = series->timestamps[i - 1] <= series->timestamps[i];
+    }
+    if (sorted) {
+        return 1;
+    }
+
+    int n = series->count;
+    BarOrder* order = malloc((size_t)n * sizeof(BarOrder));
+    double* scratch = malloc((size_t)n * sizeof(double));
+    if (!order || !scratch) {
+        free(order);
+        free(scratch);
+        return 0;
+    }
+
+    for (int i = 0; i < n; i++) {
+        order[i].timestamp = series->timestamps[i];
+        order[i].index = i;
+    }
+    qsort(order, n, sizeof(BarOrder), compare_bar_order);
+    for (int i = 0; i < n; i++) series->timestamps[i] = order[i].timestamp;
+
+    double* columns[] = {series->open, series->high, series->low, series->close, series->volume};
+    for (size_t c = 0; c < sizeof(columns) / sizeof(columns[0]); c++) {
+        for (int i = 0; i < n; i++) scratch[i] = columns[c][order[i].index];
+        memcpy(columns[c], scratch, (size_t)n * sizeof(double));
+    }
+
+    free(order);
+    free(scratch);
+    return 1;
+}
+
+// Sort every series chronologically
+int history_store_sort(HistoryStore* store) {
+    if (!store) {
+        return 0;
+    }
+    for (int i = 0; i < store->count; i++) {
+        if (!price_series_sort(&store->series[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Total number of bars in the store
+long long history_store_bar_count(const HistoryStore* store) {
+    long long total = 0;
+    if (store) {
+        for (int i = 0; i < store->count; i++) {
+            total += store->series[i].count;
+        }
+    }
+    return total;
+}
+
+// Parse "YYYY-MM-DD[( |T)HH:MM[:SS]]" (UTC) or a plain epoch number
+long long parse_history_timestamp(const char* text) {
+    int year, month, day, hour = 0, minute = 0, second = 0;
+    if (sscanf(text, "%d-%d-%d%*1[ T]%d:%d:%d", &year, &month, &day, &hour, &minute, &second) >= 3) {
+        return history_days_from_civil(year, month, day) * 86400LL + hour * 3600LL + minute * 60LL + second;
+    }
+    return atoll(text);
+}
+
+// Exactly `count` digits
+static int read_fixed_digits(const char** text, int count, int* out) {
+    int value = 0;
+    for (int i = 0; i < count; i++) {
+        char c = (*text)[i];
+        if (c < '0' || c > '9') {
+            return 0;
+        }
+        value = value * 10 + (c - '0');
+    }
+    *text += count;
+    *out = value;
+    return 1;
+}
+
+// The same forms as parse_history_timestamp(), but nothing else: no
+// trailing text, no out-of-range fields, no garbage read as 1970
+int parse_history_timestamp_strict(const char* text, long long* out) {
+    if (!text || !out || !text[0]) {
+        return 0;
+    }
+    int year, month, day, hour = 0, minute = 0, second = 0;
+    const char* p = text;
+    if (!read_fixed_digits(&p, 4, &year) || *p != '-') {
+        // Unix seconds; strtoll() alone would also take spaces and '+'
+        if (text[0] != '-' && (text[0] < '0' || text[0] > '9')) {
+            return 0;
+        }
+        char* end;
+        errno = 0;
+        long long seconds = strtoll(text, &end, 10);
+        if (end == text || *end != '\0' || errno == ERANGE) {
+            return 0;
+        }
+        *out = seconds;
+        return 1;
+    }
+    p++;
+    if (!read_fixed_digits(&p, 2, &month) || *p++ != '-' || !read_fixed_digits(&p, 2, &day)) {
+        return 0;
+    }
+    if (*p == ' ' || *p == 'T') {
+        p++;
+        if (!read_fixed_digits(&p, 2, &hour)) {
+            return 0;
+        }
+        if (*p == ':') {
+            p++;
+            if (!read_fixed_digits(&p, 2, &minute)) {
+                return 0;
+            }
+            if (*p == ':') {
+                p++;
+                if (!read_fixed_digits(&p, 2, &second)) {
+                    return 0;
+                }
+            }
+        }
+    }
+    p += *p == 'Z';
+    if (*p != '\0' || month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour > 23 || minute > 59 || second > 60) {
+        return 0;
+    }
+    *out = history_days_from_civil(year, month, day) * 86400LL + hour * 3600LL + minute * 60LL + second;
+    return 1;
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date; avoids timegm()
+long long history_days_from_civil(int year, int month, int day) {
+    year -= month <= 2;
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    long long yoe = year - era * 400;
+    long long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// One "symbol,timestamp,open,high,low,close,volume" row; the ingester uses the
+// same test to tell a header from a first row
+int history_csv_parse_row(const char* line, char symbol[MAX_SYMBOL_LENGTH], long long* timestamp,
+                          double values[5]) {
+    char stamp[32];
+    if (sscanf(line, "%9[^,],%31[^,],%lf,%lf,%lf,%lf,%lf", symbol, stamp,
+               &values[0], &values[1], &values[2], &values[3], &values[4]) != 7) {
+        return 0;
+    }
+    *timestamp = parse_history_timestamp(stamp);
+    return 1;
+}
+
+// Load "symbol,timestamp,open,high,low,close,volume" rows (header optional)
+int history_store_load_csv(HistoryStore* store, const char* filename) {
+    if (!store || !filename) {
+        return -1;
+    }
+
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        display_error("Cannot open history file");
+        return -1;
+    }
+
+    char line[512];
+    int line_number = 0;
+    int loaded = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+        line_number++;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+            continue;
+        }
+
+        char symbol[MAX_SYMBOL_LENGTH];
+        long long timestamp;
+        double values[5];
+        if (!history_csv_parse_row(line, symbol, &timestamp, values)) {
+            if (line_number == 1) {
+                continue;  // Header row
+            }
+            fprintf(stderr, "❌ %s:%d: expected symbol,timestamp,open,high,low,close,volume\n",
+                    filename, line_number);
+            fclose(file);
+            return -1;
+        }
+
+        PriceSeries* series = history_store_series(store, symbol, 1);
+        if (!series || !price_series_append(series, timestamp, values[0], values[1],
+                                            values[2], values[3], values[4])) {
+            display_error("Out of memory loading history");
+            fclose(file);
+            return -1;
+        }
+        loaded++;
+    }
+
+    fclose(file);
+    history_store_sort(store);
+    return loaded;
+}
+
+// Write "symbol,timestamp,open,high,low,close,volume" rows, Unix-second timestamps
+int history_store_write_csv(const HistoryStore* store, const char* filename) {
+    if (!store || !filename) {
+        return -1;
+    }
+
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        display_error("Cannot write history file");
+        return -1;
+    }
+
+    int written = 0;
+    fprintf(file, "symbol,timestamp,open,high,low,close,volume\n");
+    for (int s = 0; s < store->count; s++) {
+        const PriceSeries* series = &store->series[s];
+        for (int i = 0; i < series->count; i++) {
+            fprintf(file, "%s,%lld,%.4f,%.4f,%.4f,%.4f,%.0f\n", series->symbol, series->timestamps[i],
+                    series->open[i], series->high[i], series->low[i], series->close[i], series->volume[i]);
+            written++;
+        }
+    }
+
+    if (fclose(file) != 0) {
+        display_error("Cannot write history file");
+        return -1;
+    }
+    return written;
+}
+
+// Is the file a compressed segment rather than a CSV
+static int is_segment_file(const char* filename) {
+    size_t length = strlen(filename);
+    size_t suffix = strlen(HISTORY_SEGMENT_EXTENSION);
+    return length > suffix && strcmp(filename + length - suffix, HISTORY_SEGMENT_EXTENSION) == 0;
+}
+
+// Load history from a CSV or segment, or generate it when filename is NULL
+int history_store_open(HistoryStore* store, const char* filename, int symbols, int bars, int threads) {
+    if (!history_store_init(store)) {
+        return 0;
+    }
+    int ok = !filename ? sim_generate_history(store, symbols, bars, SIM_DEFAULT_SEED, threads)
+           : is_segment_file(filename) ? history_segment_load(store, filename) >= 0
+                                       : history_store_ingest_csv(store, filename, threads, NULL) >= 0;
+    if (!ok) {
+        history_store_free(store);
+    }
+    return ok;
+}
@@ -10,6 +10,7 @@
 #include <string.h>
 #include <unistd.h>
 #include <time.h>
+#include <math.h>
 #include "stock_tracker.h"
 
 // Popular stocks to track
@@ -67,7 +68,7 @@ void display_best_stock(Stock* best_stock) {
     printf("║ Change: %s%-6.2f%%                                    ║\n", 
            best_stock->change_percent >= 0 ? "📈 +" : "📉 ", 
            best_stock->change_percent);
-    printf("║ Status: %-45s        ║\n", best_stock->status);
+    printf("║ Status: %-45s        ║\n", stock_status_label(best_stock->status));
     printf("╚═══════════════════════════════════════════════════════════╝\n\n");
 }
 
@@ -87,37 +88,28 @@ void display_stock_table(Stock stocks[], int count) {
                    stocks[i].change_percent >= 0 ? "+" : "",
                    stocks[i].change_percent,
                    stocks[i].volume,
-                   stocks[i].status);
+                   stock_status_label(stocks[i].status));
         }
     }
     
     printf("╚══════════════════════════════════════════════════════════════════════════╝\n\n");
 }
 
-void display_trending_stocks(Stock stocks[], int count) {
+void display_trending_stocks(const RankIndex* ranks) {
     printf("🔥 TRENDING NOW (Top Gainers):\n");
     printf("═══════════════════════════════\n");
     
-    // Sort stocks by change percentage (simple bubble sort)
-    for(int i = 0; i < count - 1; i++) {
-        for(int j = 0; j < count - i - 1; j++) {
-            if(stocks[j].change_percent < stocks[j + 1].change_percent) {
-                Stock temp = stocks[j];
-                stocks[j] = stocks[j + 1];
-                stocks[j + 1] = temp;
-            }
-        }
-    }
-    
-    for(int i = 0; i < 5 && i < count; i++) {
-        if(stocks[i].current_price > 0) {
-            printf("%d. %s %s %.2f%% ($%.2f)\n", 
-                   i + 1, 
-                   stocks[i].symbol,
-                   stocks[i].change_percent >= 0 ? "📈" : "📉",
-                   stocks[i].change_percent,
-                   stocks[i].current_price);
-        }
+    // Top gainers come straight off the rank index; the stock array is left in place
+    int top[5];
+    int count = rank_index_range(ranks, RANK_BY_CHANGE, 1, 0, 5, top);
+    for(int i = 0; i < count; i++) {
+        double change = rank_index_value(ranks, RANK_BY_CHANGE, top[i]);
+        printf("%d. %s %s %.2f%% ($%.2f)\n", 
+               i + 1, 
+               rank_index_name(ranks, top[i]),
+               change >= 0 ? "📈" : "📉",
+               change,
+               rank_index_value(ranks, RANK_BY_PRICE, top[i]));
     }
     printf("\n");
 }
@@ -133,14 +125,138 @@ void show_menu() {
     printf("Enter your choice (1-5): ");
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     Stock stocks[STOCK_COUNT];
+    unsigned char fetched[STOCK_COUNT];
+    AlertEngine alerts;
+    Portfolio portfolio;
+    int has_portfolio = 0;
+    BreadthEngine breadth;
+    RankIndex ranks;
+    VolumeProfile volumes;
+    BarBuilder bars;
+    HistoryStore minute_bars;
     int choice;
     int data_loaded = 0;
     
+    // Non-interactive commands
+    if(argc > 1 && strcmp(argv[1], "replay") == 0) {
+        return run_replay_command(argc - 1, argv + 1);
+    }
+    if(argc > 1 && strcmp(argv[1], "backtest") == 0) {
+        return run_backtest_command(argc - 1, argv + 1);
+    }
+    if(argc > 1 && strcmp(argv[1], "sweep") == 0) {
+        return run_sweep_command(argc - 1, argv + 1);
+    }
+    if(argc > 1 && strcmp(argv[1], "correlation") == 0) {
+        return run_correlation_command(argc - 1, argv + 1);
+    }
+    if(argc > 1 && strcmp(argv[1], "risk") == 0) {
+        return run_risk_command(argc - 1, argv + 1);
+    }
+    if(argc > 1 && strcmp(argv[1], "compress") == 0) {
+        return run_compress_command(argc - 1, argv + 1);
+    }
+    if(argc > 1 && strcmp(argv[1], "ingest") == 0) {
+        return run_ingest_command(argc - 1, argv + 1);
+    }
+    if(argc > 1 && strcmp(argv[1], "history") == 0) {
+        return run_history_command(argc - 1, argv + 1);
+    }
+    if(argc > 1 && strcmp(argv[1], "query") == 0) {
+        return run_query_command(argc - 1, argv + 1);
+    }
+    
+    // Optional: record raw API responses for later replay, and pick where quotes come from
+    const char* source_spec = DATA_SOURCE_DEFAULT;
+    for(int i = 1; i + 1 < argc; i += 2) {
+        if(strcmp(argv[i], "--record") == 0) {
+            if(!recorder_open(argv[i + 1])) {
+                return 1;
+            }
+        } else if(strcmp(argv[i], "--source") == 0) {
+            source_spec = argv[i + 1];
+        } else {
+            printf("Usage: %s [--source http|demo|file:PATH|sim[:SEED]] [--record FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+    DataSource* source = data_source_open(source_spec);
+    if(!source) {
+        return 1;
+    }
+    
     print_header();
     
-    printf("🚀 Initializing Smart Stock Tracker...\n\n");
+    printf("🚀 Initializing Smart Stock Tracker...\n");
+    printf("📡 Data source: %s\n\n", source_spec);
+    
+    // Rule thresholds can be tuned without a rebuild
+    if(access(CONFIG_FILE, R_OK) == 0) {
+        RuleParams rules = *rule_params_active();
+        if(load_rule_params(CONFIG_FILE, &rules) < 0 || !rule_params_set_active(&rules)) {
+            printf("⚠️  Ignoring invalid rule settings in %s\n\n", CONFIG_FILE);
+        }
+    }
+    
+    // Price alerts are optional; without ALERTS_FILE the engine stays empty
+    if(!alert_engine_init(&alerts)) {
+        printf("❌ Out of memory.\n");
+        return 1;
+    }
+    if(access(ALERTS_FILE, R_OK) == 0) {
+        int rule_count = load_alert_rules(ALERTS_FILE, &alerts);
+        if(rule_count < 0) {
+            printf("⚠️  Ignoring invalid alert rules in %s\n\n", ALERTS_FILE);
+            alert_engine_free(&alerts);
+            alert_engine_init(&alerts);
+        } else {
+            printf("🔔 Loaded %d alert rules from %s\n\n", rule_count, ALERTS_FILE);
+        }
+    }
+    
+    // Holdings for the analysis view; without PORTFOLIO_FILE only prices are shown
+    if(access(PORTFOLIO_FILE, R_OK) == 0 && portfolio_init(&portfolio)) {
+        int position_count = portfolio_load_csv(&portfolio, PORTFOLIO_FILE);
+        if(position_count < 0) {
+            printf("⚠️  Ignoring invalid portfolio in %s\n\n", PORTFOLIO_FILE);
+            portfolio_free(&portfolio);
+        } else {
+            has_portfolio = 1;
+            printf("💼 Loaded %d positions in %d accounts from %s\n\n",
+                   position_count, portfolio.account_count, PORTFOLIO_FILE);
+        }
+    }
+    
+    // Breadth always covers the whole market; BREADTH_FILE adds sectors, industries and indexes
+    if(!breadth_init(&breadth)) {
+        printf("❌ Out of memory.\n");
+        return 1;
+    }
+    if(access(BREADTH_FILE, R_OK) == 0) {
+        int symbol_count = breadth_load_groups(&breadth, BREADTH_FILE);
+        if(symbol_count < 0) {
+            printf("⚠️  Ignoring invalid breadth groups in %s\n\n", BREADTH_FILE);
+            breadth_free(&breadth);
+            breadth_init(&breadth);
+        } else {
+            printf("🧭 Loaded %d symbols in %d breadth groups from %s\n\n",
+                   symbol_count, breadth.group_count - 1, BREADTH_FILE);
+        }
+    }
+    
+    if(!rank_index_init(&ranks, STOCK_COUNT) || !volume_profile_init(&volumes, STOCK_COUNT) ||
+       !bar_builder_init(&bars, STOCK_COUNT, BAR_RING_CAPACITY) || !history_store_init(&minute_bars)) {
+        printf("❌ Out of memory.\n");
+        return 1;
+    }
+    bar_builder_set_sink(&bars, BAR_1M, &minute_bars);
+    
+    // Trading log writes happen on a background thread
+    if(!logger_start(NULL)) {
+        printf("⚠️  Background logger unavailable, logging synchronously.\n\n");
+    }
     
     // Initialize stock array
     for(int i = 0; i < STOCK_COUNT; i++) {
@@ -149,7 +265,7 @@ int main() {
         stocks[i].change_percent = 0.0;
         stocks[i].volume = 0.0;
         strcpy(stocks[i].name, "Loading...");
-        strcpy(stocks[i].status, "FETCHING");
+        stocks[i].status = STATUS_PENDING;
     }
     
     do {
@@ -159,15 +275,29 @@ int main() {
         switch(choice) {
             case 1:
                 print_header();
-                print_loading_animation("🔄 Fetching real-time stock data");
-                print_loading_animation("📡 Connecting to market APIs");
-                print_loading_animation("📊 Processing market data");
+                if(!data_source_has(source, DATA_SOURCE_OFFLINE)) {
+                    print_loading_animation("🔄 Fetching real-time stock data");
+                    print_loading_animation("📡 Connecting to market APIs");
+                    print_loading_animation("📊 Processing market data");
+                }
                 
                 // Fetch stock data
+                data_source_fetch(source, stocks, STOCK_COUNT, fetched);
                 int successful_fetches = 0;
+                int alerts_fired = 0;
                 for(int i = 0; i < STOCK_COUNT; i++) {
-                    if(fetch_stock_data(stocks[i].symbol, &stocks[i])) {
+                    if(fetched[i]) {
+                        long long analyze_start = metrics_now_ns();
                         analyze_stock_performance(&stocks[i]);
+                        metrics_record_stage(METRIC_ANALYZE, metrics_now_ns() - analyze_start);
+                        alerts_fired += alert_engine_check(&alerts, &stocks[i]);
+                        breadth_update(&breadth, &stocks[i]);
+                        rank_index_update(&ranks, &stocks[i]);
+                        volume_profile_update(&volumes, &stocks[i], NULL);
+                        bar_builder_update(&bars, &stocks[i]);
+                        if(has_portfolio) {
+                            portfolio_apply_quote(&portfolio, &stocks[i]);
+                        }
                         successful_fetches++;
                     }
                 }
@@ -186,16 +316,34 @@ int main() {
                     display_stock_table(stocks, STOCK_COUNT);
                     
                     // Show trending stocks
-                    display_trending_stocks(stocks, STOCK_COUNT);
+                    display_trending_stocks(&ranks);
 
                     write_all_stocks_json(stocks, STOCK_COUNT);
                     write_best_stock_json(stocks, STOCK_COUNT);
-                    write_trending_json(stocks, STOCK_COUNT);
+                    write_ranked_trending_json(&ranks);
+                    write_breadth_json(&breadth);
+                    write_unusual_volume_json(&volumes);
+                    bar_builder_flush(&bars);
+                    
+                    AlertEvent recent[ALERT_RECENT_EVENTS];
+                    int recent_count = alert_engine_recent(&alerts, recent, ALERT_RECENT_EVENTS);
+                    write_alerts_json(recent, recent_count);
+                    int shown = alerts_fired < recent_count ? alerts_fired : recent_count;
+                    for(int i = shown - 1; i >= 0; i--) {
+                        printf("🔔 %s %s %.2f%s\n", recent[i].symbol,
+                               recent[i].kind == ALERT_CROSSES
+                                   ? (recent[i].direction > 0 ? "crossed above" : "crossed below")
+                                   : "moved more than",
+                               recent[i].threshold, recent[i].kind == ALERT_MOVES ? "%" : "");
+                    }
                     
                     printf("✅ Successfully loaded %d stocks!\n\n", successful_fetches);
                 } else {
                     printf("❌ Failed to fetch stock data. Please check your internet connection.\n\n");
                 }
+                
+                metrics_write_prometheus(METRICS_FILE);
+                metrics_maybe_print_summary(METRICS_SUMMARY_INTERVAL);
                 break;
                 
             case 2:
@@ -206,17 +354,63 @@ int main() {
                     printf("📊 DETAILED MARKET ANALYSIS\n");
                     printf("══════════════════════════════\n\n");
                     
-                    double total_market_cap = calculate_total_value(stocks, STOCK_COUNT);
-                    printf("💰 Total Portfolio Value: $%.2f\n", total_market_cap);
+                    if(has_portfolio) {
+                        PortfolioTotals totals;
+                        portfolio_firm_totals(&portfolio, &totals);
+                        printf("💰 Total Portfolio Value: $%.2f (%d positions, %d accounts)\n",
+                               totals.market_value, totals.positions, portfolio.account_count);
+                        printf("📅 Day P&L: %s$%.2f\n", totals.day_pnl >= 0 ? "+" : "-", fabs(totals.day_pnl));
+                        printf("📊 Unrealized P&L: %s$%.2f\n", totals.unrealized_pnl >= 0 ? "+" : "-",
+                               fabs(totals.unrealized_pnl));
+                    } else {
+                        double price_sum = calculate_total_value(stocks, STOCK_COUNT);
+                        printf("💰 One Share of Each: $%.2f (add %s for real holdings)\n",
+                               price_sum, PORTFOLIO_FILE);
+                    }
                     
-                    int bullish_count = count_bullish_stocks(stocks, STOCK_COUNT);
-                    printf("📈 Bullish Stocks: %d/%d\n", bullish_count, STOCK_COUNT);
+                    // Breadth is kept current by each refresh, so nothing is rescanned here
+                    const BreadthGroup* market = breadth_group(&breadth, 0);
+                    printf("📈 Bullish Stocks: %d/%d (%d declining, %d new highs, %d new lows)\n",
+                           market->advancers, STOCK_COUNT, market->decliners,
+                           market->new_highs, market->new_lows);
+                    int shown_groups = 0;
+                    for(int g = 1; g < breadth.group_count && shown_groups < BREADTH_SHOWN_GROUPS; g++) {
+                        const BreadthGroup* group = breadth_group(&breadth, g);
+                        if(group->quoted > 0) {
+                            printf("   • %-8s %-24s %3d▲ %3d▼  avg %+.2f%%  cap-wtd %+.2f%%\n",
+                                   breadth_kind_name(group->kind), group->name, group->advancers,
+                                   group->decliners, breadth_average_change(group),
+                                   breadth_weighted_change(group));
+                            shown_groups++;
+                        }
+                    }
                     
                     Stock* most_volatile = find_most_volatile_stock(stocks, STOCK_COUNT);
                     if(most_volatile != NULL) {
                         printf("⚡ Most Volatile: %s (%.2f%%)\n", 
                                most_volatile->symbol, most_volatile->change_percent);
                     }
+                    
+                    // Unusual for the symbol at this time of day, not just the biggest volume
+                    int unusual;
+                    if(volume_profile_top(&volumes, 1, &unusual) == 1 &&
+                       volume_profile_score(&volumes, unusual)->z_score > 0) {
+                        const VolumeScore* score = volume_profile_score(&volumes, unusual);
+                        printf("🔊 Unusual Volume: %s (%.1f sigma, %.0f shares/min vs %.0f expected)\n",
+                               volume_profile_name(&volumes, unusual), score->z_score,
+                               score->rate, score->expected);
+                    } else {
+                        printf("🔊 Unusual Volume: none yet (baselines need %d refreshes per half hour)\n",
+                               VOLUME_MIN_SAMPLES);
+                    }
+                    
+                    Stock* leader = find_best_performing_stock(stocks, STOCK_COUNT);
+                    const OhlcvBar* hour_bar = leader ? bar_builder_current(&bars, leader->symbol, BAR_1H) : NULL;
+                    if(hour_bar != NULL) {
+                        printf("🕯️  %s this hour: O %.2f H %.2f L %.2f C %.2f, VWAP %.2f over %d quotes\n",
+                               leader->symbol, hour_bar->open, hour_bar->high, hour_bar->low,
+                               hour_bar->close, bar_vwap(hour_bar), hour_bar->trades);
+                    }
                     printf("\n");
                 }
                 break;
@@ -265,5 +459,27 @@ int main() {
         
     } while(choice != 5);
     
+    alert_engine_free(&alerts);
+    breadth_free(&breadth);
+    rank_index_free(&ranks);
+    volume_profile_free(&volumes);
+    
+    // Close the open bars and keep the session's minute bars
+    bar_builder_close(&bars, 0);
+    if(bar_builder_flush(&bars) >= 0 && minute_bars.count > 0) {
+        if(history_store_write_csv(&minute_bars, BARS_FILE) >= 0) {
+            printf("🕯️  Saved 1-minute bars to %s\n", BARS_FILE);
+        } else {
+            printf("⚠️  Could not write %s\n", BARS_FILE);
+        }
+    }
+    bar_builder_free(&bars);
+    history_store_free(&minute_bars);
+    if(has_portfolio) {
+        portfolio_free(&portfolio);
+    }
+    data_source_close(source);
+    recorder_close();
+    logger_stop();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,356 @@
+/*
+ * Smart Stock Tracker - Synthetic Market Data
+ * Deterministic, counter-based generator of correlated GBM price paths
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * Every random draw is a pure function of (seed, stream, counter), so a
+ * symbol's path depends only on the seed and its own name: it is the same
+ * regardless of thread count, universe order or wall-clock time. Market and
+ * sector shocks use shared streams, which is what makes symbols correlated.
+ */
+
+#include "stock_tracker.h"
+#include <math.h>
+
+#define TRADING_DAYS_PER_YEAR 252.0
+#define SESSION_SECONDS 23400.0            // 9:30 - 16:00
+#define MARKET_STREAM 0x4D41524B45544D4BULL
+#define SECTOR_STREAM 0x534543544F525321ULL
+#define DEMO_TICKS_PER_SESSION 78          // Five-minute steps for demo quotes
+#define HISTORY_TICKS_PER_SESSION 13       // Half-hour steps for daily history bars
+#define HISTORY_SYMBOLS_PER_CHUNK 16
+
+// Known starting prices so demo quotes look familiar
+static const struct {
+    const char* symbol;
+    double price;
+} BASE_PRICES[] = {
+    {"AAPL", 175.0}, {"TSLA", 250.0}, {"NVDA", 450.0}, {"MSFT", 350.0},
+    {"GOOGL", 140.0}, {"AMZN", 145.0}, {"META", 320.0}, {"NFLX", 450.0},
+    {"AMD", 110.0}, {"INTC", 35.0}
+};
+
+// Seed used by the demo fallback path
+static unsigned long long demo_seed = SIM_DEFAULT_SEED;
+
+// SplitMix64 finalizer: a strong 64-bit mixing function
+static unsigned long long mix64(unsigned long long x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Counter-based generator: random bits for (seed, stream, counter)
+unsigned long long sim_random_bits(unsigned long long seed, unsigned long long stream,
+                                   unsigned long long counter) {
+    return mix64(seed ^ mix64(stream + 0x9E3779B97F4A7C15ULL * (counter + 1)));
+}
+
+// Uniform double in (0, 1)
+static double random_unit(unsigned long long seed, unsigned long long stream,
+                          unsigned long long counter) {
+    return ((sim_random_bits(seed, stream, counter) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+// Standard normal draw (Box-Muller on two counter-derived uniforms)
+double sim_random_normal(unsigned long long seed, unsigned long long stream,
+                         unsigned long long counter) {
+    double u1 = random_unit(seed, stream, counter * 2);
+    double u2 = random_unit(seed, stream, counter * 2 + 1);
+    return sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+}
+
+// Stable 64-bit hash of a symbol (FNV-1a)
+unsigned long long sim_symbol_hash(const char* symbol) {
+    unsigned long long hash = 0xCBF29CE484222325ULL;
+    for (const char* p = symbol; *p; p++) {
+        hash ^= (unsigned char)*p;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+// Separate stream per static parameter so no draw is reused
+static unsigned long long param_stream(const SimSymbol* state, unsigned long long parameter) {
+    return state->stream ^ mix64(0x5041524100000000ULL + parameter);
+}
+
+// Fill a config with the defaults
+void sim_default_config(SimConfig* config) {
+    if (!config) {
+        return;
+    }
+    config->seed = SIM_DEFAULT_SEED;
+    config->start_time = 1759757400;       // 2025-10-06 13:30 UTC (NYSE open)
+    config->tick_seconds = 1.0;
+    config->ticks_per_session = (int)SESSION_SECONDS;
+    config->sector_count = 11;
+    config->market_weight = 0.45;
+    config->sector_weight = 0.35;
+}
+
+// Initialize a symbol's state; parameters are derived from its name
+void sim_init_symbol(const SimConfig* config, SimSymbol* state, const char* symbol, int sector) {
+    if (!config || !state || !symbol) {
+        return;
+    }
+    memset(state, 0, sizeof(*state));
+    strncpy(state->symbol, symbol, MAX_SYMBOL_LENGTH - 1);
+    state->stream = sim_symbol_hash(symbol);
+
+    int sector_count = config->sector_count > 0 ? config->sector_count : 1;
+    state->sector = sector >= 0 ? sector % sector_count : (int)(state->stream % (unsigned long long)sector_count);
+
+    double base_price = 0.0;
+    for (size_t i = 0; i < sizeof(BASE_PRICES) / sizeof(BASE_PRICES[0]); i++) {
+        if (strcmp(symbol, BASE_PRICES[i].symbol) == 0) {
+            base_price = BASE_PRICES[i].price;
+            break;
+        }
+    }
+    if (base_price <= 0.0) {
+        // Log-normal around $60, clipped to a sensible range
+        base_price = 60.0 * exp(0.9 * sim_random_normal(config->seed, param_stream(state, 0), 0));
+        if (base_price < 2.0) base_price = 2.0;
+        if (base_price > 2000.0) base_price = 2000.0;
+    }
+
+    state->price = base_price;
+    state->previous_close = base_price;
+    state->day_high = base_price;
+    state->day_low = base_price;
+    state->annual_drift = 0.02 + 0.10 * random_unit(config->seed, param_stream(state, 1), 0);
+    state->annual_volatility = 0.18 + 0.42 * random_unit(config->seed, param_stream(state, 2), 0);
+    state->daily_volume = 5e5 * exp(1.2 * sim_random_normal(config->seed, param_stream(state, 3), 0));
+    state->shares_outstanding = 1e8 * exp(1.0 * sim_random_normal(config->seed, param_stream(state, 4), 0));
+}
+
+// Advance a symbol by one tick
+void sim_next_tick(const SimConfig* config, SimSymbol* state, SimTick* tick) {
+    int per_session = config->ticks_per_session > 0 ? config->ticks_per_session : 1;
+    unsigned long long t = state->tick;
+    int slot = (int)(t % (unsigned long long)per_session);
+
+    // New session: yesterday's last price becomes the previous close
+    if (slot == 0 && t > 0) {
+        state->previous_close = state->price;
+        state->day_high = state->price;
+        state->day_low = state->price;
+        state->cumulative_volume = 0.0;
+    }
+
+    // Correlated shock: market + sector + idiosyncratic factors
+    double idio_weight = sqrt(fmax(0.0, 1.0 - config->market_weight * config->market_weight
+                                            - config->sector_weight * config->sector_weight));
+    double z_market = sim_random_normal(config->seed, MARKET_STREAM, t);
+    double z_sector = sim_random_normal(config->seed, SECTOR_STREAM + (unsigned long long)state->sector, t);
+    double z_idio = sim_random_normal(config->seed, state->stream, t);
+    double z = config->market_weight * z_market + config->sector_weight * z_sector + idio_weight * z_idio;
+
+    // Geometric Brownian motion step
+    double dt = config->tick_seconds / (TRADING_DAYS_PER_YEAR * SESSION_SECONDS);
+    double sigma = state->annual_volatility;
+    state->price *= exp((state->annual_drift - 0.5 * sigma * sigma) * dt + sigma * sqrt(dt) * z);
+
+    if (state->price > state->day_high) state->day_high = state->price;
+    if (state->price < state->day_low) state->day_low = state->price;
+
+    // Volume: intraday U-shape, log-normal noise, more trading on big moves
+    double x = 2.0 * slot / per_session - 1.0;
+    double u_shape = 0.55 + 1.35 * x * x;
+    double noise = exp(0.5 * sim_random_normal(config->seed, param_stream(state, 5), t) - 0.125);
+    double volume = state->daily_volume / per_session * u_shape * noise * (1.0 + 0.5 * fabs(z));
+    state->cumulative_volume += volume;
+
+    if (tick) {
+        tick->timestamp = config->start_time
+                        + (long long)(t / (unsigned long long)per_session) * 86400LL
+                        + (long long)(slot * config->tick_seconds);
+        tick->price = state->price;
+        tick->volume = volume;
+        tick->cumulative_volume = state->cumulative_volume;
+    }
+    state->tick = t + 1;
+}
+
+// Copy a symbol's current state into a Stock record
+void sim_fill_stock(const SimSymbol* state, Stock* stock) {
+    if (!state || !stock) {
+        return;
+    }
+    strncpy(stock->symbol, state->symbol, MAX_SYMBOL_LENGTH - 1);
+    stock->symbol[MAX_SYMBOL_LENGTH - 1] = '\0';
+    strcpy(stock->name, get_company_name(state->symbol));
+    stock->current_price = state->price;
+    stock->previous_close = state->previous_close;
+    stock->change_percent = state->previous_close > 0
+                          ? (state->price - state->previous_close) / state->previous_close * 100.0
+                          : 0.0;
+    stock->volume = floor(state->cumulative_volume);
+    stock->day_high = state->day_high;
+    stock->day_low = state->day_low;
+    stock->market_cap = state->price * state->shares_outstanding;
+    time(&stock->last_update);
+}
+
+// Set the seed used by the demo fallback path
+void sim_set_demo_seed(unsigned long long seed) {
+    demo_seed = seed;
+}
+
+// Reproducible demo quote: the symbol's simulated session on the day of
+// `when`, advanced to the five-minute step matching the time into the
+// session (SESSION_OPEN_UTC..SESSION_CLOSE_UTC); before the open the quote
+// is the previous close, after the close it is the closing price
+int sim_demo_stock(const char* symbol, time_t when, Stock* stock) {
+    if (!symbol || !stock) {
+        return 0;
+    }
+
+    SimConfig config;
+    sim_default_config(&config);
+    config.seed = demo_seed ^ mix64((unsigned long long)(when / 86400));
+    config.tick_seconds = SESSION_SECONDS / DEMO_TICKS_PER_SESSION;
+    config.ticks_per_session = DEMO_TICKS_PER_SESSION;
+
+    SimSymbol state;
+    sim_init_symbol(&config, &state, symbol, -1);
+
+    long long into_session = (long long)(when % 86400) - SESSION_OPEN_UTC;
+    int steps = 0;
+    if (into_session >= 0) {
+        steps = (int)(into_session / (long long)config.tick_seconds) + 1;
+        if (steps > DEMO_TICKS_PER_SESSION) {
+            steps = DEMO_TICKS_PER_SESSION;
+        }
+    }
+    for (int i = 0; i < steps; i++) {
+        sim_next_tick(&config, &state, NULL);
+    }
+
+    sim_fill_stock(&state, stock);
+    stock->last_update = when;
+    return 1;
+}
+
+// Work description for sim_generate_parallel
+typedef struct {
+    const SimConfig* config;
+    SimSymbol* symbols;
+    int ticks;
+    SimTickSink sink;
+    void* sink_context;
+} SimJob;
+
+static void sim_generate_range(int begin, int end, int worker, void* context) {
+    SimJob* job = (SimJob*)context;
+    SimTick tick;
+
+    // Tick-major inside the chunk so a sink sees a time-ordered stream per chunk
+    for (int t = 0; t < job->ticks; t++) {
+        for (int i = begin; i < end; i++) {
+            sim_next_tick(job->config, &job->symbols[i], &tick);
+            if (job->sink) {
+                tick.symbol_index = i;
+                job->sink(&tick, worker, job->sink_context);
+            }
+        }
+    }
+}
+
+// Advance every symbol by ticks steps, spreading symbols across threads
+long long sim_generate_parallel(const SimConfig* config, SimSymbol symbols[], int count,
+                                int ticks, int threads, SimTickSink sink, void* sink_context) {
+    if (!config || !symbols || count <= 0 || ticks <= 0) {
+        return 0;
+    }
+
+    SimJob job;
+    job.config = config;
+    job.symbols = symbols;
+    job.ticks = ticks;
+    job.sink = sink;
+    job.sink_context = sink_context;
+
+    parallel_for(count, SIM_SYMBOLS_PER_CHUNK, threads, sim_generate_range, &job);
+    return (long long)count * ticks;
+}
+
+// Work description for sim_generate_history
+typedef struct {
+    const SimConfig* config;
+    PriceSeries* series;
+    int days;
+} HistoryJob;
+
+static void sim_history_range(int begin, int end, int worker, void* context) {
+    (void)worker;
+    HistoryJob* job = (HistoryJob*)context;
+    const SimConfig* config = job->config;
+
+    for (int i = begin; i < end; i++) {
+        PriceSeries* series = &job->series[i];
+        SimSymbol state;
+        SimTick tick;
+        sim_init_symbol(config, &state, series->symbol, -1);
+
+        for (int day = 0; day < job->days; day++) {
+            double open = 0.0, high = 0.0, low = 0.0, volume = 0.0;
+            long long timestamp = 0;
+            for (int t = 0; t < config->ticks_per_session; t++) {
+                sim_next_tick(config, &state, &tick);
+                if (t == 0) {
+                    open = high = low = tick.price;
+                    timestamp = tick.timestamp;
+                }
+                if (tick.price > high) high = tick.price;
+                if (tick.price < low) low = tick.price;
+                volume += tick.volume;
+            }
+            if (!price_series_append(series, timestamp, open, high, low, state.price, floor(volume))) {
+                return;
+            }
+        }
+    }
+}
+
+// Daily bars built from a coarse intraday path, one series per symbol
+int sim_generate_history(HistoryStore* store, int symbol_count, int days,
+                         unsigned long long seed, int threads) {
+    if (!store || symbol_count <= 0 || days <= 0) {
+        return 0;
+    }
+
+    SimConfig config;
+    sim_default_config(&config);
+    config.seed = seed;
+    config.tick_seconds = SESSION_SECONDS / HISTORY_TICKS_PER_SESSION;
+    config.ticks_per_session = HISTORY_TICKS_PER_SESSION;
+
+    // Create the series up front so workers never touch the symbol map
+    int first = store->count;
+    char symbol[MAX_SYMBOL_LENGTH];
+    for (int i = 0; i < symbol_count; i++) {
+        snprintf(symbol, sizeof(symbol), "SYM%d", i % 1000000);
+        if (!history_store_series(store, symbol, 1)) {
+            return 0;
+        }
+    }
+
+    HistoryJob job;
+    job.config = &config;
+    job.series = store->series + first;
+    job.days = days;
+    parallel_for(store->count - first, HISTORY_SYMBOLS_PER_CHUNK, threads, sim_history_range, &job);
+
+    for (int i = first; i < store->count; i++) {
+        if (store->series[i].count < days) {
+            return 0;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,307 @@
+/*
+ * Smart Stock Tracker - Metrics
+ * Latency histograms and counters for every refresh stage
+ * Author: [Your Name]
+ * Date: October 2025
+ */
+
+#include "stock_tracker.h"
+#include <time.h>
+
+// Log-linear (HDR-style) bucket layout: values below 2^SUB_BITS get exact
+// buckets, larger values keep SUB_BITS significant bits (~3% precision).
+#define SUB_BITS 5
+#define SUB_COUNT (1 << SUB_BITS)
+#define HALF_COUNT (SUB_COUNT / 2)
+
+// Stage names used in the Prometheus labels and the summary line
+static const char* STAGE_NAMES[METRIC_STAGE_COUNT] = {
+    "dns", "connect", "tls", "transfer", "fetch", "parse", "analyze", "serialize", "publish"
+};
+
+// Counter names used in the Prometheus output
+static const char* COUNTER_NAMES[METRIC_COUNTER_COUNT] = {
+    "fetch_success", "fetch_failure", "cache_hit", "demo_fallback", "alert_fired", "alert_suppressed",
+    "fetch_retry", "fetch_hedged", "breaker_rejected", "connection_new", "connection_reused"
+};
+
+// Upper bounds (seconds) of the exported Prometheus buckets
+static const double EXPORT_BOUNDS[] = {
+    0.00001, 0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+    0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0
+};
+#define EXPORT_BOUND_COUNT (int)(sizeof(EXPORT_BOUNDS) / sizeof(EXPORT_BOUNDS[0]))
+
+// Process-wide metrics registry
+static LatencyHistogram stage_histograms[METRIC_STAGE_COUNT];
+static unsigned long long counters[METRIC_COUNTER_COUNT];
+static unsigned long long http_codes[METRICS_MAX_HTTP_CODE];
+static long long last_summary_ns = 0;
+
+// Map a value to its bucket index
+static int bucket_index(unsigned long long value) {
+    if (value < SUB_COUNT) {
+        return (int)value;
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int group = msb - SUB_BITS + 1;
+    int mantissa = (int)(value >> group);
+    return SUB_COUNT + (group - 1) * HALF_COUNT + (mantissa - HALF_COUNT);
+}
+
+// Highest value that maps to a bucket
+static unsigned long long bucket_upper_bound(int index) {
+    if (index < SUB_COUNT) {
+        return (unsigned long long)index;
+    }
+    int k = index - SUB_COUNT;
+    int group = k / HALF_COUNT + 1;
+    unsigned long long mantissa = (unsigned long long)(k % HALF_COUNT + HALF_COUNT);
+    return ((mantissa + 1) << group) - 1;
+}
+
+// Current monotonic time in nanoseconds
+long long metrics_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Reset a histogram to empty
+void histogram_reset(LatencyHistogram* histogram) {
+    if (histogram) {
+        memset(histogram, 0, sizeof(*histogram));
+    }
+}
+
+// Record one value (thread-safe, lock-free)
+void histogram_record(LatencyHistogram* histogram, long long value_ns) {
+    if (!histogram) {
+        return;
+    }
+    unsigned long long value = value_ns > 0 ? (unsigned long long)value_ns : 0;
+
+    __atomic_add_fetch(&histogram->buckets[bucket_index(value)], 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&histogram->count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&histogram->sum_ns, value, __ATOMIC_RELAXED);
+
+    unsigned long long seen = __atomic_load_n(&histogram->max_ns, __ATOMIC_RELAXED);
+    while (value > seen &&
+           !__atomic_compare_exchange_n(&histogram->max_ns, &seen, value, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        // seen was refreshed by the failed exchange
+    }
+}
+
+// Value at a percentile (0-100), accurate to the bucket width
+long long histogram_percentile(const LatencyHistogram* histogram, double percentile) {
+    if (!histogram || histogram->count == 0) {
+        return 0;
+    }
+
+    unsigned long long total = histogram->count;
+    unsigned long long target = (unsigned long long)(percentile / 100.0 * total + 0.5);
+    if (target < 1) target = 1;
+    if (target > total) target = total;
+
+    unsigned long long seen = 0;
+    for (int i = 0; i < METRICS_HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= target) {
+            unsigned long long upper = bucket_upper_bound(i);
+            return (long long)(upper < histogram->max_ns ? upper : histogram->max_ns);
+        }
+    }
+    return (long long)histogram->max_ns;
+}
+
+// Merge one histogram into another
+void histogram_merge(LatencyHistogram* into, const LatencyHistogram* from) {
+    if (!into || !from) {
+        return;
+    }
+    for (int i = 0; i < METRICS_HISTOGRAM_BUCKETS; i++) {
+        into->buckets[i] += from->buckets[i];
+    }
+    into->count += from->count;
+    into->sum_ns += from->sum_ns;
+    if (from->max_ns > into->max_ns) {
+        into->max_ns = from->max_ns;
+    }
+}
+
+// Record a stage latency in the global registry
+void metrics_record_stage(MetricStage stage, long long elapsed_ns) {
+    if (stage < 0 || stage >= METRIC_STAGE_COUNT) {
+        return;
+    }
+    histogram_record(&stage_histograms[stage], elapsed_ns);
+}
+
+// Bump a global counter
+void metrics_increment(MetricCounter counter) {
+    if (counter < 0 || counter >= METRIC_COUNTER_COUNT) {
+        return;
+    }
+    __atomic_add_fetch(&counters[counter], 1, __ATOMIC_RELAXED);
+}
+
+// Count one HTTP response code
+void metrics_record_http_code(long code) {
+    if (code < 0 || code >= METRICS_MAX_HTTP_CODE) {
+        code = 0;  // Bucket for out-of-range codes
+    }
+    __atomic_add_fetch(&http_codes[code], 1, __ATOMIC_RELAXED);
+}
+
+// Read a counter value
+unsigned long long metrics_counter_value(MetricCounter counter) {
+    if (counter < 0 || counter >= METRIC_COUNTER_COUNT) {
+        return 0;
+    }
+    return __atomic_load_n(&counters[counter], __ATOMIC_RELAXED);
+}
+
+// Access the histogram for a stage
+const LatencyHistogram* metrics_stage_histogram(MetricStage stage) {
+    if (stage < 0 || stage >= METRIC_STAGE_COUNT) {
+        return NULL;
+    }
+    return &stage_histograms[stage];
+}
+
+// Clear every histogram and counter
+void metrics_reset() {
+    memset(stage_histograms, 0, sizeof(stage_histograms));
+    memset(counters, 0, sizeof(counters));
+    memset(http_codes, 0, sizeof(http_codes));
+}
+
+// Share of responses that reused a pooled connection (0 before any response)
+static double connection_reuse_ratio() {
+    unsigned long long reused = metrics_counter_value(METRIC_CONNECTION_REUSED);
+    unsigned long long total = reused + metrics_counter_value(METRIC_CONNECTION_NEW);
+    return total > 0 ? (double)reused / total : 0.0;
+}
+
+// Write all metrics in Prometheus text exposition format.
+// The file is written to a temporary name and renamed so scrapers
+// (e.g. the node_exporter textfile collector) never see a partial file.
+int metrics_write_prometheus(const char* filename) {
+    if (!filename) {
+        return 0;
+    }
+
+    char temp_name[MAX_URL_LENGTH + 8];
+    snprintf(temp_name, sizeof(temp_name), "%s.tmp", filename);
+
+    FILE* file = fopen(temp_name, "w");
+    if (!file) {
+        display_error("Cannot create metrics file");
+        return 0;
+    }
+
+    fprintf(file, "# HELP stock_tracker_stage_latency_seconds Latency of each refresh stage\n");
+    fprintf(file, "# TYPE stock_tracker_stage_latency_seconds histogram\n");
+    for (int s = 0; s < METRIC_STAGE_COUNT; s++) {
+        const LatencyHistogram* h = &stage_histograms[s];
+        unsigned long long cumulative = 0;
+        int bucket = 0;
+
+        for (int b = 0; b < EXPORT_BOUND_COUNT; b++) {
+            unsigned long long bound_ns = (unsigned long long)(EXPORT_BOUNDS[b] * 1e9);
+            while (bucket < METRICS_HISTOGRAM_BUCKETS && bucket_upper_bound(bucket) <= bound_ns) {
+                cumulative += h->buckets[bucket];
+                bucket++;
+            }
+            fprintf(file, "stock_tracker_stage_latency_seconds_bucket{stage=\"%s\",le=\"%g\"} %llu\n",
+                    STAGE_NAMES[s], EXPORT_BOUNDS[b], cumulative);
+        }
+        fprintf(file, "stock_tracker_stage_latency_seconds_bucket{stage=\"%s\",le=\"+Inf\"} %llu\n",
+                STAGE_NAMES[s], h->count);
+        fprintf(file, "stock_tracker_stage_latency_seconds_sum{stage=\"%s\"} %.9f\n",
+                STAGE_NAMES[s], h->sum_ns / 1e9);
+        fprintf(file, "stock_tracker_stage_latency_seconds_count{stage=\"%s\"} %llu\n",
+                STAGE_NAMES[s], h->count);
+    }
+
+    fprintf(file, "# HELP stock_tracker_events_total Fetch outcomes, data sources and alert deliveries\n");
+    fprintf(file, "# TYPE stock_tracker_events_total counter\n");
+    for (int c = 0; c < METRIC_COUNTER_COUNT; c++) {
+        fprintf(file, "stock_tracker_events_total{event=\"%s\"} %llu\n",
+                COUNTER_NAMES[c], metrics_counter_value((MetricCounter)c));
+    }
+
+    fprintf(file, "# HELP stock_tracker_connection_reuse_ratio Share of responses served over a pooled connection\n");
+    fprintf(file, "# TYPE stock_tracker_connection_reuse_ratio gauge\n");
+    fprintf(file, "stock_tracker_connection_reuse_ratio %.4f\n", connection_reuse_ratio());
+
+    fprintf(file, "# HELP stock_tracker_http_responses_total HTTP responses by status code\n");
+    fprintf(file, "# TYPE stock_tracker_http_responses_total counter\n");
+    for (int code = 0; code < METRICS_MAX_HTTP_CODE; code++) {
+        if (http_codes[code] > 0) {
+            fprintf(file, "stock_tracker_http_responses_total{code=\"%d\"} %llu\n",
+                    code, http_codes[code]);
+        }
+    }
+
+    fprintf(file, "# HELP stock_tracker_log_dropped_total Trading log records dropped (ring full)\n");
+    fprintf(file, "# TYPE stock_tracker_log_dropped_total counter\n");
+    fprintf(file, "stock_tracker_log_dropped_total %llu\n", logger_dropped_count());
+
+    fclose(file);
+
+    if (rename(temp_name, filename) != 0) {
+        display_error("Cannot publish metrics file");
+        return 0;
+    }
+    return 1;
+}
+
+// One-line summary: counters plus p50/p99 per stage that saw traffic
+void metrics_format_summary(char* buffer, size_t size) {
+    if (!buffer || size == 0) {
+        return;
+    }
+
+    int used = snprintf(buffer, size, "ok=%llu fail=%llu demo=%llu cache=%llu retry=%llu hedge=%llu reuse=%.0f%%",
+                        metrics_counter_value(METRIC_FETCH_SUCCESS),
+                        metrics_counter_value(METRIC_FETCH_FAILURE),
+                        metrics_counter_value(METRIC_DEMO_FALLBACK),
+                        metrics_counter_value(METRIC_CACHE_HIT),
+                        metrics_counter_value(METRIC_FETCH_RETRY),
+                        metrics_counter_value(METRIC_FETCH_HEDGED),
+                        connection_reuse_ratio() * 100.0);
+
+    for (int s = 0; s < METRIC_STAGE_COUNT && used > 0 && (size_t)used < size; s++) {
+        const LatencyHistogram* h = &stage_histograms[s];
+        if (h->count == 0) {
+            continue;
+        }
+        used += snprintf(buffer + used, size - used, " | %s p50=%.2fms p99=%.2fms",
+                         STAGE_NAMES[s],
+                         histogram_percentile(h, 50.0) / 1e6,
+                         histogram_percentile(h, 99.0) / 1e6);
+    }
+}
+
+// Print the summary line if at least interval_seconds passed since the last one
+void metrics_maybe_print_summary(int interval_seconds) {
+    long long now = metrics_now_ns();
+    if (last_summary_ns != 0 && now - last_summary_ns < (long long)interval_seconds * 1000000000LL) {
+        return;
+    }
+    last_summary_ns = now;
+
+    char line[1024];
+    metrics_format_summary(line, sizeof(line));
+    printf("📏 [%s] METRICS: %s\n", logger_cached_timestamp(), line);
+}
+
+// Name of a stage, for reports
+const char* metrics_stage_name(MetricStage stage) {
+    if (stage < 0 || stage >= METRIC_STAGE_COUNT) {
+        return "unknown";
+    }
+    return STAGE_NAMES[stage];
+}
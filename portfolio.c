@@ -0,0 +1,385 @@
+/*
+ * Smart Stock Tracker - Portfolio
+ * Positions for many accounts with incrementally maintained P&L
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * Positions are stored grouped by symbol (CSR: symbol_start[s] ..
+ * symbol_start[s + 1]), sorted by account inside each group. A quote for
+ * one symbol walks only that symbol's positions and adds quantity x price
+ * delta to each account's running totals, so a refresh touches only
+ * positions in symbols whose price actually changed. Firm-wide totals move
+ * in O(1) per symbol from the symbol's total quantity.
+ */
+
+#include "stock_tracker.h"
+
+// Day P&L per share; zero until the previous close is known
+static double day_move(double price, double previous_close) {
+    return (price > 0 && previous_close > 0) ? price - previous_close : 0.0;
+}
+
+// Grow a double array, zeroing the new tail
+static int grow_doubles(double** array, int old_count, int new_count) {
+    double* grown = realloc(*array, (size_t)new_count * sizeof(double));
+    if (!grown) {
+        return 0;
+    }
+    memset(&grown[old_count], 0, (size_t)(new_count - old_count) * sizeof(double));
+    *array = grown;
+    return 1;
+}
+
+// Initialize an empty portfolio
+int portfolio_init(Portfolio* portfolio) {
+    if (!portfolio) {
+        return 0;
+    }
+    memset(portfolio, 0, sizeof(*portfolio));
+    if (!symbol_map_init(&portfolio->symbols, 64) || !symbol_map_init(&portfolio->accounts, 64)) {
+        portfolio_free(portfolio);
+        return 0;
+    }
+    return 1;
+}
+
+// Release the portfolio's memory
+void portfolio_free(Portfolio* portfolio) {
+    if (!portfolio) {
+        return;
+    }
+    free(portfolio->staged);
+    free(portfolio->symbol_start);
+    free(portfolio->position_account);
+    free(portfolio->position_quantity);
+    free(portfolio->position_cost);
+    free(portfolio->last_price);
+    free(portfolio->last_previous_close);
+    free(portfolio->symbol_quantity);
+    free(portfolio->symbol_cost);
+    free(portfolio->market_value);
+    free(portfolio->day_pnl);
+    free(portfolio->priced_cost);
+    free(portfolio->cost_basis);
+    free(portfolio->position_counts);
+    symbol_map_free(&portfolio->symbols);
+    symbol_map_free(&portfolio->accounts);
+    memset(portfolio, 0, sizeof(*portfolio));
+}
+
+// Stage a position; it takes effect at the next portfolio_build()
+int portfolio_add_position(Portfolio* portfolio, const char* account, const char* symbol,
+                           double quantity, double average_cost) {
+    if (!portfolio || !account || !symbol || strlen(account) >= MAX_SYMBOL_LENGTH ||
+        strlen(symbol) >= MAX_SYMBOL_LENGTH) {
+        return 0;
+    }
+    int account_id = symbol_map_insert(&portfolio->accounts, account);
+    int symbol_id = symbol_map_insert(&portfolio->symbols, symbol);
+    if (account_id < 0 || symbol_id < 0) {
+        return 0;
+    }
+
+    if (portfolio->staged_count == portfolio->staged_capacity) {
+        int new_capacity = portfolio->staged_capacity ? portfolio->staged_capacity * 2 : 256;
+        StagedPosition* grown = realloc(portfolio->staged, (size_t)new_capacity * sizeof(StagedPosition));
+        if (!grown) {
+            return 0;
+        }
+        portfolio->staged = grown;
+        portfolio->staged_capacity = new_capacity;
+    }
+    StagedPosition* p = &portfolio->staged[portfolio->staged_count++];
+    p->account = account_id;
+    p->symbol = symbol_id;
+    p->quantity = quantity;
+    p->cost = quantity * average_cost;
+    return 1;
+}
+
+// Stable counting sort of staged positions by one key
+static int sort_staged(StagedPosition* positions, StagedPosition* scratch, int count,
+                       int key_count, int by_symbol) {
+    int* offsets = calloc((size_t)key_count + 1, sizeof(int));
+    if (!offsets) {
+        return 0;
+    }
+    for (int i = 0; i < count; i++) {
+        offsets[(by_symbol ? positions[i].symbol : positions[i].account) + 1]++;
+    }
+    for (int k = 0; k < key_count; k++) {
+        offsets[k + 1] += offsets[k];
+    }
+    for (int i = 0; i < count; i++) {
+        int key = by_symbol ? positions[i].symbol : positions[i].account;
+        scratch[offsets[key]++] = positions[i];
+    }
+    memcpy(positions, scratch, (size_t)count * sizeof(StagedPosition));
+    free(offsets);
+    return 1;
+}
+
+// Rebuild the symbol-grouped position arrays from the staged positions
+int portfolio_build(Portfolio* portfolio) {
+    if (!portfolio) {
+        return 0;
+    }
+    int n = portfolio->staged_count;
+    int symbol_count = portfolio->symbols.count;
+    int account_count = portfolio->accounts.count;
+
+    // Sort by (symbol, account): account pass first, then a stable symbol pass
+    StagedPosition* scratch = malloc((size_t)(n > 0 ? n : 1) * sizeof(StagedPosition));
+    if (!scratch ||
+        !sort_staged(portfolio->staged, scratch, n, account_count, 0) ||
+        !sort_staged(portfolio->staged, scratch, n, symbol_count, 1)) {
+        free(scratch);
+        return 0;
+    }
+    free(scratch);
+
+    // Merge repeated (account, symbol) rows, which are now adjacent
+    int merged = 0;
+    for (int i = 0; i < n; i++) {
+        StagedPosition* p = &portfolio->staged[i];
+        if (merged > 0 && portfolio->staged[merged - 1].symbol == p->symbol &&
+            portfolio->staged[merged - 1].account == p->account) {
+            portfolio->staged[merged - 1].quantity += p->quantity;
+            portfolio->staged[merged - 1].cost += p->cost;
+        } else {
+            portfolio->staged[merged++] = *p;
+        }
+    }
+    portfolio->staged_count = merged;
+
+    int* symbol_start = calloc((size_t)symbol_count + 1, sizeof(int));
+    int* position_account = malloc((size_t)(merged > 0 ? merged : 1) * sizeof(int));
+    double* position_quantity = malloc((size_t)(merged > 0 ? merged : 1) * sizeof(double));
+    double* position_cost = malloc((size_t)(merged > 0 ? merged : 1) * sizeof(double));
+    if (!symbol_start || !position_account || !position_quantity || !position_cost) {
+        free(symbol_start);
+        free(position_account);
+        free(position_quantity);
+        free(position_cost);
+        return 0;
+    }
+    for (int i = 0; i < merged; i++) {
+        const StagedPosition* p = &portfolio->staged[i];
+        symbol_start[p->symbol + 1]++;
+        position_account[i] = p->account;
+        position_quantity[i] = p->quantity;
+        position_cost[i] = p->cost;
+    }
+    for (int s = 0; s < symbol_count; s++) {
+        symbol_start[s + 1] += symbol_start[s];
+    }
+
+    free(portfolio->symbol_start);
+    free(portfolio->position_account);
+    free(portfolio->position_quantity);
+    free(portfolio->position_cost);
+    portfolio->symbol_start = symbol_start;
+    portfolio->position_account = position_account;
+    portfolio->position_quantity = position_quantity;
+    portfolio->position_cost = position_cost;
+    portfolio->position_count = merged;
+
+    // Prices already seen survive a rebuild; new symbols and accounts start empty
+    if (!grow_doubles(&portfolio->last_price, portfolio->symbol_count, symbol_count) ||
+        !grow_doubles(&portfolio->last_previous_close, portfolio->symbol_count, symbol_count) ||
+        !grow_doubles(&portfolio->symbol_quantity, portfolio->symbol_count, symbol_count) ||
+        !grow_doubles(&portfolio->symbol_cost, portfolio->symbol_count, symbol_count)) {
+        return 0;
+    }
+    portfolio->symbol_count = symbol_count;
+
+    if (!grow_doubles(&portfolio->market_value, portfolio->account_count, account_count) ||
+        !grow_doubles(&portfolio->day_pnl, portfolio->account_count, account_count) ||
+        !grow_doubles(&portfolio->priced_cost, portfolio->account_count, account_count) ||
+        !grow_doubles(&portfolio->cost_basis, portfolio->account_count, account_count)) {
+        return 0;
+    }
+    int* counts = realloc(portfolio->position_counts, (size_t)(account_count > 0 ? account_count : 1) * sizeof(int));
+    if (!counts) {
+        return 0;
+    }
+    portfolio->position_counts = counts;
+    portfolio->account_count = account_count;
+
+    portfolio_recompute(portfolio);
+    return 1;
+}
+
+// Recompute every total from the positions and last prices (clears float drift)
+void portfolio_recompute(Portfolio* portfolio) {
+    if (!portfolio) {
+        return;
+    }
+    int accounts = portfolio->account_count;
+    memset(portfolio->market_value, 0, (size_t)accounts * sizeof(double));
+    memset(portfolio->day_pnl, 0, (size_t)accounts * sizeof(double));
+    memset(portfolio->priced_cost, 0, (size_t)accounts * sizeof(double));
+    memset(portfolio->cost_basis, 0, (size_t)accounts * sizeof(double));
+    memset(portfolio->position_counts, 0, (size_t)accounts * sizeof(int));
+    memset(&portfolio->firm, 0, sizeof(portfolio->firm));
+
+    for (int s = 0; s < portfolio->symbol_count; s++) {
+        double price = portfolio->last_price[s];
+        double move = day_move(price, portfolio->last_previous_close[s]);
+        double quantity = 0.0, cost = 0.0;
+
+        for (int k = portfolio->symbol_start[s]; k < portfolio->symbol_start[s + 1]; k++) {
+            int a = portfolio->position_account[k];
+            double q = portfolio->position_quantity[k];
+            portfolio->market_value[a] += q * price;
+            portfolio->day_pnl[a] += q * move;
+            portfolio->cost_basis[a] += portfolio->position_cost[k];
+            if (price > 0) {
+                portfolio->priced_cost[a] += portfolio->position_cost[k];
+            }
+            portfolio->position_counts[a]++;
+            quantity += q;
+            cost += portfolio->position_cost[k];
+        }
+
+        portfolio->symbol_quantity[s] = quantity;
+        portfolio->symbol_cost[s] = cost;
+        portfolio->firm.market_value += quantity * price;
+        portfolio->firm.day_pnl += quantity * move;
+        portfolio->firm.cost_basis += cost;
+        if (price > 0) {
+            portfolio->firm.unrealized_pnl += quantity * price - cost;
+        }
+    }
+    portfolio->firm.positions = portfolio->position_count;
+}
+
+// Apply a new price to every position in one symbol; returns positions touched
+int portfolio_apply_price(Portfolio* portfolio, int symbol_id, double price, double previous_close) {
+    if (!portfolio || symbol_id < 0 || symbol_id >= portfolio->symbol_count || !(price > 0)) {
+        return 0;
+    }
+    double old_price = portfolio->last_price[symbol_id];
+    double old_move = day_move(old_price, portfolio->last_previous_close[symbol_id]);
+    double new_move = day_move(price, previous_close);
+    if (price == old_price && new_move == old_move) {
+        return 0;
+    }
+
+    double price_delta = price - old_price;
+    double day_delta = new_move - old_move;
+    int first_price = old_price <= 0;
+
+    int begin = portfolio->symbol_start[symbol_id];
+    int end = portfolio->symbol_start[symbol_id + 1];
+    const int* restrict accounts = portfolio->position_account;
+    const double* restrict quantities = portfolio->position_quantity;
+    double* restrict market_value = portfolio->market_value;
+    double* restrict day_pnl = portfolio->day_pnl;
+    for (int k = begin; k < end; k++) {
+        market_value[accounts[k]] += quantities[k] * price_delta;
+        day_pnl[accounts[k]] += quantities[k] * day_delta;
+    }
+    if (first_price) {
+        for (int k = begin; k < end; k++) {
+            portfolio->priced_cost[accounts[k]] += portfolio->position_cost[k];
+        }
+    }
+
+    double quantity = portfolio->symbol_quantity[symbol_id];
+    portfolio->firm.market_value += quantity * price_delta;
+    portfolio->firm.day_pnl += quantity * day_delta;
+    portfolio->firm.unrealized_pnl += quantity * price_delta - (first_price ? portfolio->symbol_cost[symbol_id] : 0.0);
+
+    portfolio->last_price[symbol_id] = price;
+    portfolio->last_previous_close[symbol_id] = previous_close;
+    portfolio->positions_touched += end - begin;
+    return end - begin;
+}
+
+// Apply a quote; symbols nobody holds are ignored
+int portfolio_apply_quote(Portfolio* portfolio, const Stock* stock) {
+    if (!portfolio || !stock) {
+        return 0;
+    }
+    int symbol_id = symbol_map_find(&portfolio->symbols, stock->symbol);
+    return portfolio_apply_price(portfolio, symbol_id, stock->current_price, stock->previous_close);
+}
+
+// Totals for one account
+int portfolio_account_totals(const Portfolio* portfolio, int account_id, PortfolioTotals* totals) {
+    if (!portfolio || !totals || account_id < 0 || account_id >= portfolio->account_count) {
+        return 0;
+    }
+    totals->market_value = portfolio->market_value[account_id];
+    totals->cost_basis = portfolio->cost_basis[account_id];
+    totals->day_pnl = portfolio->day_pnl[account_id];
+    totals->unrealized_pnl = portfolio->market_value[account_id] - portfolio->priced_cost[account_id];
+    totals->positions = portfolio->position_counts[account_id];
+    return 1;
+}
+
+// Totals across every account
+void portfolio_firm_totals(const Portfolio* portfolio, PortfolioTotals* totals) {
+    if (!portfolio || !totals) {
+        return;
+    }
+    *totals = portfolio->firm;
+}
+
+// Account id for a name, -1 if absent
+int portfolio_find_account(const Portfolio* portfolio, const char* account) {
+    return portfolio ? symbol_map_find(&portfolio->accounts, account) : -1;
+}
+
+// Load "account,symbol,quantity,average_cost" rows (header optional) and build
+int portfolio_load_csv(Portfolio* portfolio, const char* filename) {
+    if (!portfolio || !filename) {
+        return -1;
+    }
+
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        display_error("Cannot open portfolio file");
+        return -1;
+    }
+
+    char line[256];
+    int line_number = 0;
+    int loaded = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+        line_number++;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+            continue;
+        }
+
+        char account[MAX_SYMBOL_LENGTH];
+        char symbol[MAX_SYMBOL_LENGTH];
+        char clean[MAX_SYMBOL_LENGTH];
+        double quantity, average_cost;
+        if (sscanf(line, " %9[^,],%9[^,],%lf,%lf", account, symbol, &quantity, &average_cost) != 4) {
+            if (line_number == 1) {
+                continue;  // Header row
+            }
+            fprintf(stderr, "❌ %s:%d: expected account,symbol,quantity,average_cost\n",
+                    filename, line_number);
+            fclose(file);
+            return -1;
+        }
+        if (!validate_stock_symbol(symbol, clean, sizeof(clean)) ||
+            !portfolio_add_position(portfolio, account, clean, quantity, average_cost)) {
+            fprintf(stderr, "❌ %s:%d: invalid position\n", filename, line_number);
+            fclose(file);
+            return -1;
+        }
+        loaded++;
+    }
+
+    fclose(file);
+    if (!portfolio_build(portfolio)) {
+        display_error("Out of memory building portfolio");
+        return -1;
+    }
+    return loaded;
+}
@@ -0,0 +1,1063 @@
+/*
+ * Smart Stock Tracker - Analytical Queries
+ * Batch screens, aggregations, rankings and indicator lookups over history
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * "stock_tracker query" reads a history CSV, a compressed segment or the
+ * synthetic market. It produces one row per symbol, or per symbol and
+ * day/week/month with --by. Rows can be filtered with --where, ranked
+ * with --sort/--limit, joined with live quotes from a data source and
+ * written as CSV or JSON.
+ *
+ * Each series is cut into units of QUERY_UNIT_BARS bars (store) or
+ * QUERY_UNIT_BLOCKS blocks (segment, decoded straight from the mapped
+ * file), and the units are scanned in parallel. A unit produces partial
+ * spans: counts, extremes, sums of volume, turnover and returns, and
+ * drawdown. These merge exactly when the spans are adjacent. Merging
+ * happens afterwards in unit order, so results do not depend on the thread
+ * count. Indicators (SMA 20/50/200, Wilder RSI 14) are taken at the end of
+ * each span from the last QUERY_TAIL_BARS closes. Every unit first replays
+ * the bars just before it, so this window never depends on where the
+ * unit boundaries fall.
+ */
+
+#include "stock_tracker.h"
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+
+#define QUERY_TAIL_BARS 250          // Closes the indicators are computed over
+#define QUERY_MAX_CONDITIONS 16
+#define QUERY_MAX_COLUMNS 32
+#define RSI_PERIOD 14
+
+// Row grouping
+enum {
+    QUERY_BY_SYMBOL,
+    QUERY_BY_DAY,
+    QUERY_BY_WEEK,
+    QUERY_BY_MONTH
+};
+
+// Columns a query can select, filter and sort on
+typedef enum {
+    FIELD_SYMBOL,
+    FIELD_PERIOD,             // Start of the --by period
+    FIELD_START,              // First bar in the row
+    FIELD_END,                // Last bar in the row
+    FIELD_BARS,
+    FIELD_OPEN,
+    FIELD_HIGH,
+    FIELD_LOW,
+    FIELD_CLOSE,
+    FIELD_VOLUME,
+    FIELD_VWAP,               // Typical price weighted by volume
+    FIELD_RETURN,             // Close over open, percent
+    FIELD_VOLATILITY,         // Standard deviation of bar-to-bar returns, percent
+    FIELD_DRAWDOWN,           // Largest close-to-close peak-to-trough fall, percent
+    FIELD_SMA20,
+    FIELD_SMA50,
+    FIELD_SMA200,
+    FIELD_RSI14,
+    FIELD_PRICE,              // Quote fields, with --quotes
+    FIELD_CHANGE,
+    FIELD_STATUS,
+    FIELD_RECOMMENDATION,
+    FIELD_COUNT
+} QueryField;
+
+// How a field is compared and printed
+enum {
+    KIND_NUMBER,
+    KIND_TIME,
+    KIND_TEXT,
+    KIND_STATUS,
+    KIND_RECOMMENDATION
+};
+
+static const struct {
+    const char* name;
+    int kind;
+} FIELDS[FIELD_COUNT] = {
+    {"symbol", KIND_TEXT}, {"period", KIND_TIME}, {"start", KIND_TIME}, {"end", KIND_TIME},
+    {"bars", KIND_NUMBER}, {"open", KIND_NUMBER}, {"high", KIND_NUMBER}, {"low", KIND_NUMBER},
+    {"close", KIND_NUMBER}, {"volume", KIND_NUMBER}, {"vwap", KIND_NUMBER}, {"return", KIND_NUMBER},
+    {"volatility", KIND_NUMBER}, {"drawdown", KIND_NUMBER}, {"sma20", KIND_NUMBER}, {"sma50", KIND_NUMBER},
+    {"sma200", KIND_NUMBER}, {"rsi14", KIND_NUMBER}, {"price", KIND_NUMBER}, {"change", KIND_NUMBER},
+    {"status", KIND_STATUS}, {"recommendation", KIND_RECOMMENDATION}
+};
+
+// Machine-readable names, indexed by StockStatus and Recommendation
+static const char* STATUS_NAMES[] = {
+    "avoid", "bearish", "watch", "neutral", "positive", "bullish", "strong_buy", "invalid", "pending"
+};
+static const char* RECOMMENDATION_NAMES[] = {
+    "strong_sell", "sell", "watch", "hold_flat", "hold_up", "buy", "strong_buy", "invalid"
+};
+
+static const QueryField SYMBOL_COLUMNS[] = {
+    FIELD_SYMBOL, FIELD_BARS, FIELD_END, FIELD_CLOSE, FIELD_RETURN, FIELD_HIGH, FIELD_LOW, FIELD_VOLUME,
+    FIELD_VWAP, FIELD_VOLATILITY, FIELD_DRAWDOWN, FIELD_SMA20, FIELD_SMA50, FIELD_SMA200, FIELD_RSI14
+};
+static const QueryField PERIOD_COLUMNS[] = {
+    FIELD_SYMBOL, FIELD_PERIOD, FIELD_BARS, FIELD_OPEN, FIELD_HIGH, FIELD_LOW, FIELD_CLOSE,
+    FIELD_VOLUME, FIELD_VWAP, FIELD_RETURN, FIELD_VOLATILITY
+};
+static const QueryField QUOTE_COLUMNS[] = {FIELD_PRICE, FIELD_CHANGE, FIELD_STATUS, FIELD_RECOMMENDATION};
+
+// Aggregates of consecutive bars of one series in one period
+typedef struct {
+    long long period;
+    long long first_time;
+    long long last_time;
+    long long bars;
+    double open, high, low, close;
+    double first_close;
+    double volume;
+    double turnover;
+    double return_sum;
+    double return_squares;
+    long long returns;
+    double peak;              // Highest close
+    double trough;            // Lowest close
+    double drawdown;          // Largest fall from an earlier peak, as a fraction
+    double sma[3];            // Indicators as of the last bar
+    double rsi;
+} QuerySpan;
+
+// A slice of one series, scanned by one worker
+typedef struct {
+    int series;
+    int begin;                // First bar (store) or block (segment)
+    int end;
+    int warmup;               // Bars (store) or blocks (segment) replayed before begin for the indicators
+    QuerySpan* spans;
+    int span_count;
+    int span_capacity;
+    int failed;
+} QueryUnit;
+
+// Per-worker state
+typedef struct {
+    HistoryBlock* block;      // Decode buffer for segment units
+    double ring[QUERY_TAIL_BARS];
+    int ring_head;
+    int ring_count;
+    long long bucket_begin;   // Cached period of the last bar
+    long long bucket_end;
+} QueryScratch;
+
+// A filter on one field
+typedef struct {
+    QueryField field;
+    char op[3];
+    double value;
+    char text[MAX_SYMBOL_LENGTH];
+} QueryCondition;
+
+// One output row
+typedef struct {
+    int series;
+    double values[FIELD_COUNT];
+} QueryRow;
+
+typedef struct {
+    HistoryStore* store;      // Exactly one of store and segment is set
+    HistorySegment* segment;
+    long long from;
+    long long to;
+    int by;
+    QueryUnit* units;
+    int unit_count;
+    QueryScratch* scratch;    // One per worker
+} Query;
+
+// Ranking key of a row
+typedef struct {
+    double key;
+    const char* symbol;       // For sorting by symbol
+    int descending;
+    int row;
+} QuerySortKey;
+
+static const char* query_symbol(const Query* query, int series) {
+    return query->segment ? query->segment->names[series] : query->store->series[series].symbol;
+}
+
+// Floor division for possibly negative times
+static long long floor_div(long long a, long long b) {
+    long long q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+// Year and month of a day count since 1970-01-01 (inverse of history_days_from_civil)
+static void civil_from_days(long long days, int* year, int* month) {
+    days += 719468;
+    long long era = (days >= 0 ? days : days - 146096) / 146097;
+    long long doe = days - era * 146097;
+    long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long mp = (5 * doy + 2) / 153;
+    *month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    *year = (int)(yoe + era * 400 + (*month <= 2));
+}
+
+// Period containing `when`, cached per worker since bars arrive in order
+static long long query_period(const Query* query, QueryScratch* scratch, long long when) {
+    if (query->by == QUERY_BY_SYMBOL) {
+        return 0;
+    }
+    if (when >= scratch->bucket_begin && when < scratch->bucket_end) {
+        return scratch->bucket_begin;
+    }
+    long long day = floor_div(when, 86400);
+    long long first = day, next = day + 1;
+    if (query->by == QUERY_BY_WEEK) {
+        first = day - (((day + 3) % 7) + 7) % 7;  // Mondays; day 0 was a Thursday
+        next = first + 7;
+    } else if (query->by == QUERY_BY_MONTH) {
+        int year, month;
+        civil_from_days(day, &year, &month);
+        first = history_days_from_civil(year, month, 1);
+        next = month == 12 ? history_days_from_civil(year + 1, 1, 1) : history_days_from_civil(year, month + 1, 1);
+    }
+    scratch->bucket_begin = first * 86400;
+    scratch->bucket_end = next * 86400;
+    return scratch->bucket_begin;
+}
+
+// SMAs and RSI over the closes in the worker's ring
+static void take_indicators(const QueryScratch* scratch, QuerySpan* span) {
+    static const int SMA_PERIODS[3] = {20, 50, 200};
+    int n = scratch->ring_count;
+    double closes[QUERY_TAIL_BARS];
+    for (int i = 0; i < n; i++) {
+        closes[i] = scratch->ring[(scratch->ring_head - n + i + QUERY_TAIL_BARS) % QUERY_TAIL_BARS];
+    }
+    for (int k = 0; k < 3; k++) {
+        int period = SMA_PERIODS[k];
+        double sum = 0.0;
+        for (int i = n - period; i >= 0 && i < n; i++) {
+            sum += closes[i];
+        }
+        span->sma[k] = n >= period ? sum / period : NAN;
+    }
+
+    // Wilder smoothing, seeded with the mean of the first RSI_PERIOD changes
+    span->rsi = NAN;
+    if (n > RSI_PERIOD) {
+        double gain = 0.0, loss = 0.0;
+        for (int i = 1; i < n; i++) {
+            double change = closes[i] - closes[i - 1];
+            double up = change > 0 ? change : 0.0;
+            double down = change < 0 ? -change : 0.0;
+            if (i <= RSI_PERIOD) {
+                gain += up / RSI_PERIOD;
+                loss += down / RSI_PERIOD;
+            } else {
+                gain = (gain * (RSI_PERIOD - 1) + up) / RSI_PERIOD;
+                loss = (loss * (RSI_PERIOD - 1) + down) / RSI_PERIOD;
+            }
+        }
+        span->rsi = loss > 0 ? 100.0 - 100.0 / (1.0 + gain / loss) : (gain > 0 ? 100.0 : 50.0);
+    }
+}
+
+static QuerySpan* start_span(QueryUnit* unit, long long period) {
+    if (unit->span_count == unit->span_capacity) {
+        int capacity = unit->span_capacity ? unit->span_capacity * 2 : 1;
+        QuerySpan* spans = realloc(unit->spans, (size_t)capacity * sizeof(QuerySpan));
+        if (!spans) {
+            unit->failed = 1;
+            return NULL;
+        }
+        unit->spans = spans;
+        unit->span_capacity = capacity;
+    }
+    QuerySpan* span = &unit->spans[unit->span_count++];
+    memset(span, 0, sizeof(*span));
+    span->period = period;
+    return span;
+}
+
+// Fold bars into the unit's spans; the first `warmup` bars only feed the
+// indicator window. Returns 1 once a bar after query->to is seen
+static int scan_bars(const Query* query, QueryUnit* unit, QueryScratch* scratch,
+                     const long long* times, const double* open, const double* high, const double* low,
+                     const double* close, const double* volume, int count, int warmup) {
+    QuerySpan* span = unit->span_count ? &unit->spans[unit->span_count - 1] : NULL;
+    for (int i = 0; i < count; i++) {
+        long long when = times[i];
+        if (when > query->to) {
+            return 1;
+        }
+        double price = close[i];
+        if (i >= warmup && when >= query->from) {
+            long long period = query_period(query, scratch, when);
+            if (!span || span->period != period) {
+                if (span) {
+                    take_indicators(scratch, span);
+                }
+                span = start_span(unit, period);
+                if (!span) {
+                    return 1;
+                }
+            }
+            if (span->bars == 0) {
+                span->first_time = when;
+                span->open = open[i];
+                span->high = high[i];
+                span->low = low[i];
+                span->first_close = span->peak = span->trough = price;
+            } else {
+                double change = price / span->close - 1.0;
+                span->return_sum += change;
+                span->return_squares += change * change;
+                span->returns++;
+                if (high[i] > span->high) span->high = high[i];
+                if (low[i] < span->low) span->low = low[i];
+                if (price > span->peak) {
+                    span->peak = price;
+                } else if (price < span->peak * (1.0 - span->drawdown)) {
+                    span->drawdown = 1.0 - price / span->peak;
+                }
+                if (price < span->trough) span->trough = price;
+            }
+            span->close = price;
+            span->last_time = when;
+            span->bars++;
+            span->volume += volume[i];
+            span->turnover += volume[i] * (high[i] + low[i] + price) / 3.0;
+        }
+        scratch->ring[scratch->ring_head] = price;
+        if (++scratch->ring_head == QUERY_TAIL_BARS) {
+            scratch->ring_head = 0;
+        }
+        if (scratch->ring_count < QUERY_TAIL_BARS) {
+            scratch->ring_count++;
+        }
+    }
+    return 0;
+}
+
+// Scan a range of units; workers reuse their scratch across units
+static void query_task(int begin, int end, int worker, void* context) {
+    Query* query = (Query*)context;
+    QueryScratch* scratch = &query->scratch[worker];
+    for (int u = begin; u < end; u++) {
+        QueryUnit* unit = &query->units[u];
+        scratch->ring_head = scratch->ring_count = 0;
+        scratch->bucket_begin = LLONG_MAX;
+        scratch->bucket_end = LLONG_MIN;
+
+        if (query->store) {
+            const PriceSeries* series = &query->store->series[unit->series];
+            int first = unit->begin - unit->warmup;
+            scan_bars(query, unit, scratch, series->timestamps + first, series->open + first,
+                      series->high + first, series->low + first, series->close + first,
+                      series->volume + first, unit->end - first, unit->warmup);
+        } else {
+            for (int b = unit->begin - unit->warmup; b < unit->end && !unit->failed; b++) {
+                HistoryBlock* block = scratch->block;
+                if (!history_segment_decode(query->segment, b, block)) {
+                    unit->failed = 1;
+                    break;
+                }
+                if (scan_bars(query, unit, scratch, block->timestamps, block->open, block->high, block->low,
+                              block->close, block->volume, block->count, b < unit->begin ? block->count : 0)) {
+                    break;
+                }
+            }
+        }
+        if (unit->span_count > 0) {
+            take_indicators(scratch, &unit->spans[unit->span_count - 1]);
+        }
+    }
+}
+
+// First index of a sorted series with a time at or after `when` (after it if `after`)
+static int series_search(const PriceSeries* series, long long when, int after) {
+    int low = 0, high = series->count;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (series->timestamps[middle] < when || (after && series->timestamps[middle] == when)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static int add_unit(Query* query, int* capacity, int series, int begin, int end, int warmup) {
+    if (query->unit_count == *capacity) {
+        int grown_capacity = *capacity ? *capacity * 2 : 256;
+        QueryUnit* grown = realloc(query->units, (size_t)grown_capacity * sizeof(QueryUnit));
+        if (!grown) {
+            return 0;
+        }
+        query->units = grown;
+        *capacity = grown_capacity;
+    }
+    QueryUnit* unit = &query->units[query->unit_count++];
+    memset(unit, 0, sizeof(*unit));
+    unit->series = series;
+    unit->begin = begin;
+    unit->end = end;
+    unit->warmup = warmup;
+    return 1;
+}
+
+// Cut the selected series into units, in series and time order
+static int build_units(Query* query, const unsigned char* selected) {
+    int capacity = 0;
+    if (query->store) {
+        for (int s = 0; s < query->store->count; s++) {
+            const PriceSeries* series = &query->store->series[s];
+            if (!selected[s]) {
+                continue;
+            }
+            int low = series_search(series, query->from, 0);
+            int high = series_search(series, query->to, 1);
+            for (int begin = low; begin < high; begin += QUERY_UNIT_BARS) {
+                int end = high - begin > QUERY_UNIT_BARS ? begin + QUERY_UNIT_BARS : high;
+                if (!add_unit(query, &capacity, s, begin, end, begin < QUERY_TAIL_BARS ? begin : QUERY_TAIL_BARS)) {
+                    return 0;
+                }
+            }
+        }
+        return 1;
+    }
+
+    // A series' blocks are consecutive; one block (>= QUERY_TAIL_BARS bars) of warmup
+    const HistorySegment* segment = query->segment;
+    for (int b = 0; b < segment->block_count;) {
+        int series = segment->blocks[b].series;
+        int end = b;
+        while (end < segment->block_count && end - b < QUERY_UNIT_BLOCKS && segment->blocks[end].series == series) {
+            end++;
+        }
+        int warmup = b > 0 && segment->blocks[b - 1].series == series;
+        if (selected[series] && !add_unit(query, &capacity, series, b, end, warmup)) {
+            return 0;
+        }
+        b = end;
+    }
+    return 1;
+}
+
+// Append a later adjacent span of the same period
+static void merge_span(QuerySpan* into, const QuerySpan* next) {
+    double change = next->first_close / into->close - 1.0;
+    into->return_sum += next->return_sum + change;
+    into->return_squares += next->return_squares + change * change;
+    into->returns += next->returns + 1;
+    double fall = 1.0 - next->trough / into->peak;
+    if (next->drawdown > into->drawdown) into->drawdown = next->drawdown;
+    if (fall > into->drawdown) into->drawdown = fall;
+    if (next->peak > into->peak) into->peak = next->peak;
+    if (next->trough < into->trough) into->trough = next->trough;
+    if (next->high > into->high) into->high = next->high;
+    if (next->low < into->low) into->low = next->low;
+    into->close = next->close;
+    into->last_time = next->last_time;
+    into->bars += next->bars;
+    into->volume += next->volume;
+    into->turnover += next->turnover;
+    memcpy(into->sma, next->sma, sizeof(into->sma));
+    into->rsi = next->rsi;
+}
+
+static void span_to_row(const Query* query, const QuerySpan* span, int series, QueryRow* row) {
+    row->series = series;
+    for (int f = 0; f < FIELD_COUNT; f++) {
+        row->values[f] = NAN;
+    }
+    double* v = row->values;
+    if (query->by != QUERY_BY_SYMBOL) {
+        v[FIELD_PERIOD] = (double)span->period;
+    }
+    v[FIELD_START] = (double)span->first_time;
+    v[FIELD_END] = (double)span->last_time;
+    v[FIELD_BARS] = (double)span->bars;
+    v[FIELD_OPEN] = span->open;
+    v[FIELD_HIGH] = span->high;
+    v[FIELD_LOW] = span->low;
+    v[FIELD_CLOSE] = span->close;
+    v[FIELD_VOLUME] = span->volume;
+    v[FIELD_VWAP] = span->volume > 0 ? span->turnover / span->volume : span->close;
+    v[FIELD_RETURN] = span->open != 0 ? (span->close / span->open - 1.0) * 100.0 : NAN;
+    if (span->returns > 1) {
+        double mean = span->return_sum / span->returns;
+        double variance = (span->return_squares - mean * span->return_sum) / (span->returns - 1);
+        v[FIELD_VOLATILITY] = sqrt(variance > 0 ? variance : 0.0) * 100.0;
+    }
+    v[FIELD_DRAWDOWN] = span->drawdown * 100.0;
+    v[FIELD_SMA20] = span->sma[0];
+    v[FIELD_SMA50] = span->sma[1];
+    v[FIELD_SMA200] = span->sma[2];
+    v[FIELD_RSI14] = span->rsi;
+}
+
+// Merge the units' spans into rows, in unit order
+static QueryRow* collect_rows(const Query* query, int* row_count) {
+    long long total = 0;
+    for (int u = 0; u < query->unit_count; u++) {
+        total += query->units[u].span_count;
+    }
+    QueryRow* rows = malloc((size_t)(total > 0 ? total : 1) * sizeof(QueryRow));
+    if (!rows) {
+        return NULL;
+    }
+    int count = 0;
+    QuerySpan current;
+    int current_series = -1;
+    for (int u = 0; u < query->unit_count; u++) {
+        const QueryUnit* unit = &query->units[u];
+        for (int k = 0; k < unit->span_count; k++) {
+            const QuerySpan* span = &unit->spans[k];
+            if (unit->series == current_series && span->period == current.period) {
+                merge_span(&current, span);
+                continue;
+            }
+            if (current_series >= 0) {
+                span_to_row(query, &current, current_series, &rows[count++]);
+            }
+            current = *span;
+            current_series = unit->series;
+        }
+    }
+    if (current_series >= 0) {
+        span_to_row(query, &current, current_series, &rows[count++]);
+    }
+    *row_count = count;
+    return rows;
+}
+
+// Fill the quote fields from a data source, classified by the active rules
+static int join_quotes(const Query* query, QueryRow* rows, int row_count, const char* spec) {
+    DataSource* source = data_source_open(spec);
+    if (!source) {
+        return 0;
+    }
+    // Rows of a symbol are consecutive
+    Stock* stocks = calloc((size_t)(row_count > 0 ? row_count : 1), sizeof(Stock));
+    unsigned char* fetched = calloc((size_t)(row_count > 0 ? row_count : 1), 1);
+    QuoteStore quotes;
+    int ok = stocks && fetched && quote_store_init(&quotes, row_count);
+    int count = 0;
+    for (int r = 0; ok && r < row_count; r++) {
+        if (r == 0 || rows[r].series != rows[r - 1].series) {
+            strcpy(stocks[count++].symbol, query_symbol(query, rows[r].series));
+        }
+    }
+    if (ok) {
+        data_source_fetch(source, stocks, count, fetched);
+        for (int i = 0; i < count; i++) {
+            if (fetched[i] && quote_store_put(&quotes, &stocks[i]) < 0) {
+                ok = 0;
+            }
+        }
+        quote_store_analyze(&quotes);
+        for (int r = 0; ok && r < row_count; r++) {
+            int id = quote_store_find(&quotes, query_symbol(query, rows[r].series));
+            Stock stock;
+            if (id >= 0 && quote_store_get(&quotes, id, &stock)) {
+                rows[r].values[FIELD_PRICE] = stock.current_price;
+                rows[r].values[FIELD_CHANGE] = stock.change_percent;
+                rows[r].values[FIELD_STATUS] = quotes.quotes[id].status;
+                rows[r].values[FIELD_RECOMMENDATION] = classify_recommendation_with(&stock, compiled_rules_active());
+            }
+        }
+        quote_store_free(&quotes);
+    }
+    free(stocks);
+    free(fetched);
+    data_source_close(source);
+    return ok;
+}
+
+static int find_field(const char* name, size_t length) {
+    for (int f = 0; f < FIELD_COUNT; f++) {
+        if (strlen(FIELDS[f].name) == length && strncmp(FIELDS[f].name, name, length) == 0) {
+            return f;
+        }
+    }
+    return -1;
+}
+
+static int find_name(const char* const names[], int count, const char* text) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(names[i], text) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Parse "FIELD<op>VALUE" with op one of < <= > >= = !=
+static int parse_condition(const char* text, QueryCondition* condition) {
+    size_t length = strcspn(text, "<>=!");
+    int field = find_field(text, length);
+    const char* op = text + length;
+    size_t op_length = (op[0] && op[1] == '=') ? 2 : 1;
+    if (field < 0 || !op[0] || (op[0] == '!' && op_length != 2)) {
+        fprintf(stderr, "❌ Bad condition '%s' (FIELD<op>VALUE, op one of < <= > >= = !=)\n", text);
+        return 0;
+    }
+    memset(condition, 0, sizeof(*condition));
+    condition->field = (QueryField)field;
+    memcpy(condition->op, op, op_length);
+    const char* value = op + op_length;
+    int kind = FIELDS[field].kind;
+    int numeric = kind == KIND_NUMBER || kind == KIND_TIME;
+    if (!numeric && strcmp(condition->op, "=") != 0 && strcmp(condition->op, "!=") != 0) {
+        fprintf(stderr, "❌ %s only supports = and !=\n", FIELDS[field].name);
+        return 0;
+    }
+
+    char* end = NULL;
+    if (kind == KIND_NUMBER) {
+        condition->value = strtod(value, &end);
+    } else if (kind == KIND_TIME) {
+        long long when;
+        if (parse_history_timestamp_strict(value, &when)) {
+            condition->value = (double)when;
+            end = (char*)value + strlen(value);
+        }
+    } else if (kind == KIND_STATUS) {
+        condition->value = find_name(STATUS_NAMES, STATUS_PENDING + 1, value);
+        end = condition->value < 0 ? (char*)value : (char*)value + strlen(value);
+    } else if (kind == KIND_RECOMMENDATION) {
+        condition->value = find_name(RECOMMENDATION_NAMES, RECOMMEND_INVALID + 1, value);
+        end = condition->value < 0 ? (char*)value : (char*)value + strlen(value);
+    } else if (strlen(value) < MAX_SYMBOL_LENGTH) {
+        strcpy(condition->text, value);
+        end = (char*)value + strlen(value);
+    }
+    if (!end || end == value || *end != '\0') {
+        fprintf(stderr, "❌ Bad value in condition '%s'\n", text);
+        return 0;
+    }
+    return 1;
+}
+
+// Missing values never match
+static int row_matches(const Query* query, const QueryRow* row, const QueryCondition* conditions, int count) {
+    for (int c = 0; c < count; c++) {
+        const QueryCondition* condition = &conditions[c];
+        int order;
+        if (condition->field == FIELD_SYMBOL) {
+            order = strcmp(query_symbol(query, row->series), condition->text);
+        } else {
+            double value = row->values[condition->field];
+            if (isnan(value)) {
+                return 0;
+            }
+            order = (value > condition->value) - (value < condition->value);
+        }
+        const char* op = condition->op;
+        int match = strcmp(op, "<") == 0 ? order < 0 : strcmp(op, "<=") == 0 ? order <= 0
+                  : strcmp(op, ">") == 0 ? order > 0 : strcmp(op, ">=") == 0 ? order >= 0
+                  : strcmp(op, "=") == 0 ? order == 0 : order != 0;
+        if (!match) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Missing values last in either direction, ties in scan order
+static int compare_sort_keys(const void* a, const void* b) {
+    const QuerySortKey* x = (const QuerySortKey*)a;
+    const QuerySortKey* y = (const QuerySortKey*)b;
+    if (x->symbol) {
+        int order = strcmp(x->symbol, y->symbol);
+        if (order != 0) {
+            return x->descending ? -order : order;
+        }
+    } else if (x->key != y->key) {
+        return x->key < y->key ? -1 : 1;
+    }
+    return (x->row > y->row) - (x->row < y->row);
+}
+
+// Apply the conditions, ranking and limit; returns the kept row indexes in order
+static int select_rows(const Query* query, const QueryRow* rows, int row_count,
+                       const QueryCondition* conditions, int condition_count,
+                       int sort_field, int descending, int limit, int* order) {
+    QuerySortKey* keys = malloc((size_t)(row_count > 0 ? row_count : 1) * sizeof(QuerySortKey));
+    if (!keys) {
+        return -1;
+    }
+    int kept = 0;
+    for (int r = 0; r < row_count; r++) {
+        if (!row_matches(query, &rows[r], conditions, condition_count)) {
+            continue;
+        }
+        QuerySortKey* key = &keys[kept++];
+        key->row = r;
+        key->descending = descending;
+        key->symbol = sort_field == FIELD_SYMBOL ? query_symbol(query, rows[r].series) : NULL;
+        key->key = 0.0;
+        if (sort_field > FIELD_SYMBOL) {
+            double value = rows[r].values[sort_field];
+            key->key = isnan(value) ? INFINITY : descending ? -value : value;
+        }
+    }
+    if (sort_field >= 0) {
+        qsort(keys, kept, sizeof(QuerySortKey), compare_sort_keys);
+    }
+    if (limit > 0 && kept > limit) {
+        kept = limit;
+    }
+    for (int i = 0; i < kept; i++) {
+        order[i] = keys[i].row;
+    }
+    free(keys);
+    return kept;
+}
+
+// One value as text; returns 0 when missing
+static int format_value(const Query* query, const QueryRow* row, QueryField field, char* buffer, size_t size) {
+    if (field == FIELD_SYMBOL) {
+        snprintf(buffer, size, "%s", query_symbol(query, row->series));
+        return 1;
+    }
+    double value = row->values[field];
+    if (isnan(value)) {
+        return 0;
+    }
+    switch (FIELDS[field].kind) {
+        case KIND_TIME: {
+            long long when = (long long)value;
+            long long day = floor_div(when, 86400), seconds = when - day * 86400;
+            int year, month;
+            civil_from_days(day, &year, &month);
+            snprintf(buffer, size, "%04d-%02d-%02dT%02d:%02d:%02dZ", year, month,
+                     (int)(day - history_days_from_civil(year, month, 1) + 1),
+                     (int)(seconds / 3600), (int)(seconds / 60 % 60), (int)(seconds % 60));
+            break;
+        }
+        case KIND_STATUS:
+            snprintf(buffer, size, "%s", STATUS_NAMES[(int)value]);
+            break;
+        case KIND_RECOMMENDATION:
+            snprintf(buffer, size, "%s", RECOMMENDATION_NAMES[(int)value]);
+            break;
+        default:
+            snprintf(buffer, size, "%.15g", value);
+            break;
+    }
+    return 1;
+}
+
+static void write_rows(FILE* out, const Query* query, const QueryRow* rows, const int* order, int count,
+                       const QueryField* columns, int column_count, int json) {
+    char value[64];
+    if (json) {
+        fprintf(out, "[");
+    } else {
+        for (int c = 0; c < column_count; c++) {
+            fprintf(out, "%s%s", c ? "," : "", FIELDS[columns[c]].name);
+        }
+        fprintf(out, "\n");
+    }
+    for (int i = 0; i < count; i++) {
+        const QueryRow* row = &rows[order[i]];
+        if (json) {
+            fprintf(out, "%s\n  {", i ? "," : "");
+        }
+        for (int c = 0; c < column_count; c++) {
+            QueryField field = columns[c];
+            int present = format_value(query, row, field, value, sizeof(value));
+            if (!json) {
+                fprintf(out, "%s%s", c ? "," : "", present ? value : "");
+            } else if (!present) {
+                fprintf(out, "%s\"%s\": null", c ? ", " : "", FIELDS[field].name);
+            } else {
+                const char* quote = FIELDS[field].kind == KIND_NUMBER ? "" : "\"";
+                fprintf(out, "%s\"%s\": %s%s%s", c ? ", " : "", FIELDS[field].name, quote, value, quote);
+            }
+        }
+        fprintf(out, json ? "}" : "\n");
+    }
+    if (json) {
+        fprintf(out, "%s]\n", count ? "\n" : "");
+    }
+}
+
+// Parse "a,b,c" into columns
+static int parse_columns(const char* text, QueryField* columns) {
+    int count = 0;
+    while (*text) {
+        size_t length = strcspn(text, ",");
+        int field = find_field(text, length);
+        if (field < 0 || count == QUERY_MAX_COLUMNS) {
+            fprintf(stderr, "❌ Unknown or too many columns in '%s'\n", text);
+            return -1;
+        }
+        columns[count++] = (QueryField)field;
+        text += length;
+        if (*text == ',') {
+            text++;
+        }
+    }
+    return count;
+}
+
+// Mark the series named in "A,B,C" (every series when list is NULL)
+static int select_series(const Query* query, int series_count, const char* list, unsigned char* selected) {
+    if (!list) {
+        memset(selected, 1, (size_t)series_count);
+        return 1;
+    }
+    SymbolMap wanted;
+    if (!symbol_map_init(&wanted, 16)) {
+        return 0;
+    }
+    while (*list) {
+        size_t length = strcspn(list, ",");
+        char symbol[MAX_SYMBOL_LENGTH];
+        if (length > 0 && length < MAX_SYMBOL_LENGTH) {
+            memcpy(symbol, list, length);
+            symbol[length] = '\0';
+            symbol_map_insert(&wanted, symbol);
+        }
+        list += length;
+        if (*list == ',') {
+            list++;
+        }
+    }
+    for (int s = 0; s < series_count; s++) {
+        selected[s] = symbol_map_find(&wanted, query_symbol(query, s)) >= 0;
+    }
+    symbol_map_free(&wanted);
+    return 1;
+}
+
+// Command line entry:
+// query <history.csv|.seg> | --synthetic SYMBOLS BARS [--by day|week|month] [--from T] [--to T]
+//       [--symbols A,B] [--where COND]... [--sort FIELD] [--desc] [--limit N] [--columns a,b]
+//       [--quotes SOURCE] [--format csv|json] [--output FILE] [--threads N]
+// Whole number of at least `minimum`, nothing else in the text
+static int parse_count(const char* option, const char* text, int minimum, int* out) {
+    char* end;
+    errno = 0;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || value < minimum || value > INT_MAX) {
+        fprintf(stderr, "❌ Bad %s value '%s' (a whole number of at least %d)\n", option, text, minimum);
+        return 0;
+    }
+    *out = (int)value;
+    return 1;
+}
+
+// Timestamp option value
+static int parse_time_option(const char* option, const char* text, long long* out) {
+    if (!parse_history_timestamp_strict(text, out)) {
+        fprintf(stderr, "❌ Bad %s value '%s' (YYYY-MM-DD[ HH[:MM[:SS]]] or Unix seconds)\n", option, text);
+        return 0;
+    }
+    return 1;
+}
+
+int run_query_command(int argc, char* argv[]) {
+    const char* filename = NULL;
+    const char* symbols = NULL;
+    const char* columns_text = NULL;
+    const char* quotes = NULL;
+    const char* output = NULL;
+    int synthetic_symbols = 0, synthetic_bars = 0;
+    int threads = 0, limit = 0, descending = 0, json = 0, sort_field = -1;
+    QueryCondition conditions[QUERY_MAX_CONDITIONS];
+    int condition_count = 0;
+    Query query;
+    memset(&query, 0, sizeof(query));
+    query.from = LLONG_MIN;
+    query.to = LLONG_MAX;
+    int ok = 1;
+
+    for (int i = 1; i < argc && ok; i++) {
+        if (strcmp(argv[i], "--synthetic") == 0 && i + 2 < argc) {
+            ok = parse_count("--synthetic", argv[i + 1], 1, &synthetic_symbols) &&
+                 parse_count("--synthetic", argv[i + 2], 1, &synthetic_bars);
+            i += 2;
+        } else if (strcmp(argv[i], "--by") == 0 && i + 1 < argc) {
+            const char* by = argv[++i];
+            query.by = strcmp(by, "day") == 0 ? QUERY_BY_DAY : strcmp(by, "week") == 0 ? QUERY_BY_WEEK
+                     : strcmp(by, "month") == 0 ? QUERY_BY_MONTH : -1;
+            ok = query.by >= 0;
+        } else if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+            ok = parse_time_option("--from", argv[++i], &query.from);
+        } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            // A bare date includes that whole day
+            const char* to = argv[++i];
+            ok = parse_time_option("--to", to, &query.to);
+            query.to += ok && strlen(to) == 10 && to[4] == '-' ? 86399 : 0;
+        } else if (strcmp(argv[i], "--symbols") == 0 && i + 1 < argc) {
+            symbols = argv[++i];
+        } else if (strcmp(argv[i], "--where") == 0 && i + 1 < argc && condition_count < QUERY_MAX_CONDITIONS) {
+            ok = parse_condition(argv[++i], &conditions[condition_count++]);
+        } else if (strcmp(argv[i], "--sort") == 0 && i + 1 < argc) {
+            sort_field = find_field(argv[i + 1], strlen(argv[i + 1]));
+            ok = sort_field >= 0;
+            i++;
+        } else if (strcmp(argv[i], "--desc") == 0) {
+            descending = 1;
+        } else if (strcmp(argv[i], "--limit") == 0 && i + 1 < argc) {
+            ok = parse_count("--limit", argv[++i], 1, &limit);
+        } else if (strcmp(argv[i], "--columns") == 0 && i + 1 < argc) {
+            columns_text = argv[++i];
+        } else if (strcmp(argv[i], "--quotes") == 0 && i + 1 < argc) {
+            quotes = argv[++i];
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            json = strcmp(argv[++i], "json") == 0;
+            ok = json || strcmp(argv[i], "csv") == 0;
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            ok = parse_count("--threads", argv[++i], 0, &threads);
+        } else if (argv[i][0] != '-' && !filename) {
+            filename = argv[i];
+        } else {
+            fprintf(stderr, "❌ Unknown query option: %s\n", argv[i]);
+            ok = 0;
+        }
+    }
+    QueryField columns[QUERY_MAX_COLUMNS];
+    int column_count = 0;
+    if (ok && columns_text) {
+        column_count = parse_columns(columns_text, columns);
+        ok = column_count > 0;
+    } else if (ok) {
+        const QueryField* defaults = query.by == QUERY_BY_SYMBOL ? SYMBOL_COLUMNS : PERIOD_COLUMNS;
+        int default_count = query.by == QUERY_BY_SYMBOL ? (int)(sizeof(SYMBOL_COLUMNS) / sizeof(QueryField))
+                                                        : (int)(sizeof(PERIOD_COLUMNS) / sizeof(QueryField));
+        memcpy(columns, defaults, (size_t)default_count * sizeof(QueryField));
+        column_count = default_count;
+        if (quotes) {
+            memcpy(columns + column_count, QUOTE_COLUMNS, sizeof(QUOTE_COLUMNS));
+            column_count += (int)(sizeof(QUOTE_COLUMNS) / sizeof(QueryField));
+        }
+    }
+    if (!ok || (!filename && synthetic_symbols <= 0)) {
+        fprintf(stderr, "usage: stock_tracker query <history.csv|%s> | --synthetic SYMBOLS BARS\n"
+                        "       [--by day|week|month] [--from TIME] [--to TIME] [--symbols A,B]\n"
+                        "       [--where FIELD<op>VALUE]... [--sort FIELD] [--desc] [--limit N]\n"
+                        "       [--columns a,b,c] [--quotes SOURCE] [--format csv|json] [--output FILE] [--threads N]\n"
+                        "fields:", HISTORY_SEGMENT_EXTENSION);
+        for (int f = 0; f < FIELD_COUNT; f++) {
+            fprintf(stderr, " %s", FIELDS[f].name);
+        }
+        fprintf(stderr, "\n");
+        return 1;
+    }
+
+    // Segments are scanned in place; anything else is loaded into a store
+    HistoryStore store;
+    HistorySegment segment;
+    size_t name_length = filename ? strlen(filename) : 0;
+    size_t suffix = strlen(HISTORY_SEGMENT_EXTENSION);
+    long long load_start = metrics_now_ns();
+    if (filename && name_length > suffix && strcmp(filename + name_length - suffix, HISTORY_SEGMENT_EXTENSION) == 0) {
+        if (!history_segment_open(&segment, filename)) {
+            return 1;
+        }
+        query.segment = &segment;
+    } else {
+        if (!history_store_open(&store, filename, synthetic_symbols, synthetic_bars, threads)) {
+            return 1;
+        }
+        query.store = &store;
+    }
+    long long load_ns = metrics_now_ns() - load_start;
+    int series_count = query.segment ? segment.series_count : store.count;
+
+    if (threads <= 0) {
+        threads = parallel_default_threads();
+    }
+    if (threads > PARALLEL_MAX_THREADS) {
+        threads = PARALLEL_MAX_THREADS;
+    }
+    unsigned char* selected = malloc((size_t)(series_count > 0 ? series_count : 1));
+    query.scratch = calloc((size_t)threads, sizeof(QueryScratch));
+    ok = selected && query.scratch && select_series(&query, series_count, symbols, selected) &&
+         build_units(&query, selected);
+    for (int t = 0; ok && query.segment && t < threads; t++) {
+        query.scratch[t].block = malloc(sizeof(HistoryBlock));
+        ok = query.scratch[t].block != NULL;
+    }
+
+    QueryRow* rows = NULL;
+    int* order = NULL;
+    int row_count = 0, kept = 0, used = 0;
+    long long bars = 0;
+    long long scan_start = metrics_now_ns();
+    if (ok) {
+        used = parallel_for(query.unit_count, 1, threads, query_task, &query);
+        for (int u = 0; u < query.unit_count; u++) {
+            if (query.units[u].failed) {
+                fprintf(stderr, "❌ Query failed on %s (corrupt block or out of memory)\n",
+                        query_symbol(&query, query.units[u].series));
+                ok = 0;
+                break;
+            }
+        }
+    }
+    if (ok) {
+        rows = collect_rows(&query, &row_count);
+        ok = rows != NULL;
+    }
+    long long scan_ns = metrics_now_ns() - scan_start;
+    for (int r = 0; r < row_count; r++) {
+        bars += (long long)rows[r].values[FIELD_BARS];
+    }
+    if (ok && quotes) {
+        ok = join_quotes(&query, rows, row_count, quotes);
+    }
+    if (ok) {
+        order = malloc((size_t)(row_count > 0 ? row_count : 1) * sizeof(int));
+        kept = order ? select_rows(&query, rows, row_count, conditions, condition_count,
+                                   sort_field, descending, limit, order) : -1;
+        ok = kept >= 0;
+    }
+    if (ok) {
+        FILE* out = output ? fopen(output, "w") : stdout;
+        if (!out) {
+            fprintf(stderr, "❌ Cannot write %s\n", output);
+            ok = 0;
+        } else {
+            write_rows(out, &query, rows, order, kept, columns, column_count, json);
+            if (output) {
+                ok = fclose(out) == 0;
+            }
+        }
+    }
+    if (ok) {
+        // Timings go to stderr so stdout stays clean CSV or JSON
+        fprintf(stderr, "⚡ %lld bars of %d symbols scanned in %.3fs (%.1fM bars/s, %d threads), "
+                        "loaded in %.3fs, %d of %d rows\n",
+                bars, series_count, scan_ns / 1e9, scan_ns > 0 ? bars / (scan_ns / 1e3) : 0.0,
+                used, load_ns / 1e9, kept, row_count);
+    }
+
+    for (int u = 0; u < query.unit_count; u++) {
+        free(query.units[u].spans);
+    }
+    for (int t = 0; query.scratch && t < threads; t++) {
+        free(query.scratch[t].block);
+    }
+    free(query.units);
+    free(query.scratch);
+    free(selected);
+    free(rows);
+    free(order);
+    if (query.segment) {
+        history_segment_close(&segment);
+    } else {
+        history_store_free(&store);
+    }
+    return ok ? 0 : 1;
+}
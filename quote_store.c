@@ -0,0 +1,269 @@
+/*
+ * Smart Stock Tracker - Quote Store
+ * Cache-line-sized hot quote records with cold metadata kept apart
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * A Stock mixes ~40 bytes of numbers the analytics read with 110 bytes of
+ * text they never touch. The store keeps the numbers in a 64-byte aligned
+ * StockQuote per symbol (one cache line, eight per 512 bytes) and the
+ * symbol and company name in a parallel StockMeta array indexed by the
+ * same symbol id. Stock stays the public API type: quote_store_put() and
+ * quote_store_get() convert at the edges.
+ */
+
+#include "stock_tracker.h"
+
+// Compile-time check that a hot record is exactly one cache line
+typedef char stock_quote_is_one_cache_line[sizeof(StockQuote) == QUOTE_ALIGNMENT ? 1 : -1];
+
+// Grow both arrays to hold at least capacity records
+static int quote_store_reserve(QuoteStore* store, int capacity) {
+    if (capacity <= store->capacity) {
+        return 1;
+    }
+    int new_capacity = store->capacity ? store->capacity : 64;
+    while (new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+
+    // realloc() does not keep the cache-line alignment, so copy by hand
+    void* quotes = NULL;
+    if (posix_memalign(&quotes, QUOTE_ALIGNMENT, (size_t)new_capacity * sizeof(StockQuote)) != 0) {
+        return 0;
+    }
+    StockMeta* meta = realloc(store->meta, (size_t)new_capacity * sizeof(StockMeta));
+    if (!meta) {
+        free(quotes);
+        return 0;
+    }
+    if (store->count > 0) {
+        memcpy(quotes, store->quotes, (size_t)store->count * sizeof(StockQuote));
+    }
+    free(store->quotes);
+    store->quotes = quotes;
+    store->meta = meta;
+    store->capacity = new_capacity;
+    return 1;
+}
+
+// Initialize an empty store
+int quote_store_init(QuoteStore* store, int expected_symbols) {
+    if (!store) {
+        return 0;
+    }
+    memset(store, 0, sizeof(*store));
+    if (!symbol_map_init(&store->symbols, expected_symbols) ||
+        !quote_store_reserve(store, expected_symbols)) {
+        quote_store_free(store);
+        return 0;
+    }
+    return 1;
+}
+
+// Release the store's memory
+void quote_store_free(QuoteStore* store) {
+    if (!store) {
+        return;
+    }
+    free(store->quotes);
+    free(store->meta);
+    symbol_map_free(&store->symbols);
+    memset(store, 0, sizeof(*store));
+}
+
+// Id for a symbol, adding an empty record if it is new
+int quote_store_add(QuoteStore* store, const char* symbol) {
+    if (!store || !symbol) {
+        return -1;
+    }
+    int id = symbol_map_find(&store->symbols, symbol);
+    if (id >= 0) {
+        return id;
+    }
+
+    // Room first, so every id in the map has its records; ids are dense,
+    // so a new id is always store->count
+    if (!quote_store_reserve(store, store->count + 1)) {
+        return -1;
+    }
+    id = symbol_map_insert(&store->symbols, symbol);
+    if (id < 0) {
+        return -1;
+    }
+    StockQuote* quote = &store->quotes[id];
+    memset(quote, 0, sizeof(*quote));
+    quote->symbol_id = id;
+    quote->status = STATUS_PENDING;
+
+    StockMeta* meta = &store->meta[id];
+    memset(meta, 0, sizeof(*meta));
+    strcpy(meta->symbol, symbol_map_name(&store->symbols, id));
+    strcpy(meta->name, get_company_name(meta->symbol));
+    store->count++;
+    return id;
+}
+
+// Id for a symbol, -1 if absent
+int quote_store_find(const QuoteStore* store, const char* symbol) {
+    return store ? symbol_map_find(&store->symbols, symbol) : -1;
+}
+
+// Copy a Stock's numbers into a hot record (symbol_id is left alone)
+void stock_to_quote(const Stock* stock, StockQuote* quote) {
+    quote->current_price = stock->current_price;
+    quote->change_percent = stock->change_percent;
+    quote->volume = stock->volume;
+    quote->previous_close = stock->previous_close;
+    quote->day_high = stock->day_high;
+    quote->day_low = stock->day_low;
+    quote->last_update = (long long)stock->last_update;
+    quote->status = (unsigned char)stock->status;
+}
+
+// Rebuild a full Stock from a hot record and its metadata
+void quote_to_stock(const StockQuote* quote, const StockMeta* meta, Stock* stock) {
+    strcpy(stock->symbol, meta->symbol);
+    strcpy(stock->name, meta->name);
+    stock->current_price = quote->current_price;
+    stock->change_percent = quote->change_percent;
+    stock->volume = quote->volume;
+    stock->status = (StockStatus)quote->status;
+    stock->previous_close = quote->previous_close;
+    stock->day_high = quote->day_high;
+    stock->day_low = quote->day_low;
+    stock->market_cap = meta->market_cap;
+    stock->last_update = (time_t)quote->last_update;
+}
+
+// Store a Stock; only the hot record is written unless the metadata changed
+int quote_store_put(QuoteStore* store, const Stock* stock) {
+    if (!store || !stock) {
+        return -1;
+    }
+    int id = quote_store_add(store, stock->symbol);
+    if (id < 0) {
+        return -1;
+    }
+    stock_to_quote(stock, &store->quotes[id]);
+
+    StockMeta* meta = &store->meta[id];
+    meta->market_cap = stock->market_cap;
+    if (stock->name[0] && strcmp(meta->name, stock->name) != 0) {
+        strncpy(meta->name, stock->name, MAX_NAME_LENGTH - 1);
+        meta->name[MAX_NAME_LENGTH - 1] = '\0';
+    }
+    return id;
+}
+
+// Materialize one record as a Stock
+int quote_store_get(const QuoteStore* store, int id, Stock* stock) {
+    if (!store || !stock || id < 0 || id >= store->count) {
+        return 0;
+    }
+    quote_to_stock(&store->quotes[id], &store->meta[id], stock);
+    return 1;
+}
+
+// Materialize every record into a Stock array for the existing writers
+int quote_store_export(const QuoteStore* store, Stock stocks[], int max_count) {
+    if (!store || !stocks) {
+        return 0;
+    }
+    int count = store->count < max_count ? store->count : max_count;
+    for (int i = 0; i < count; i++) {
+        quote_to_stock(&store->quotes[i], &store->meta[i], &stocks[i]);
+    }
+    return count;
+}
+
+// Set every record's status under the live rules
+void quote_store_analyze(QuoteStore* store) {
+    if (store) {
+        classify_quotes(compiled_rules_active(), store->quotes, store->count);
+    }
+}
+
+// Same result as find_best_performing_stock(): id of the highest change, -1 if none
+int quote_store_best_performer(const QuoteStore* store) {
+    if (!store) {
+        return -1;
+    }
+    int best = -1;
+    double best_performance = -1000.0;
+    for (int i = 0; i < store->count; i++) {
+        const StockQuote* q = &store->quotes[i];
+        if (q->current_price > 0 && q->change_percent > best_performance) {
+            best = i;
+            best_performance = q->change_percent;
+        }
+    }
+    return best;
+}
+
+// Same result as count_bullish_stocks()
+int quote_store_count_bullish(const QuoteStore* store) {
+    if (!store) {
+        return 0;
+    }
+    int bullish = 0;
+    for (int i = 0; i < store->count; i++) {
+        bullish += store->quotes[i].current_price > 0 && store->quotes[i].change_percent > 0;
+    }
+    return bullish;
+}
+
+// Same result as calculate_average_change()
+double quote_store_average_change(const QuoteStore* store) {
+    if (!store) {
+        return 0.0;
+    }
+    double total_change = 0.0;
+    int valid = 0;
+    for (int begin = 0; begin < store->count; begin += ANALYSIS_CHUNK_STOCKS) {
+        int end = store->count - begin > ANALYSIS_CHUNK_STOCKS ? begin + ANALYSIS_CHUNK_STOCKS : store->count;
+        double chunk_change = 0.0;  // Same summation order as calculate_average_change()
+        for (int i = begin; i < end; i++) {
+            if (store->quotes[i].current_price > 0) {
+                chunk_change += store->quotes[i].change_percent;
+                valid++;
+            }
+        }
+        total_change += chunk_change;
+    }
+    return valid > 0 ? total_change / valid : 0.0;
+}
+
+// Same result as calculate_total_value()
+double quote_store_total_value(const QuoteStore* store) {
+    if (!store) {
+        return 0.0;
+    }
+    double total = 0.0;
+    for (int begin = 0; begin < store->count; begin += ANALYSIS_CHUNK_STOCKS) {
+        int end = store->count - begin > ANALYSIS_CHUNK_STOCKS ? begin + ANALYSIS_CHUNK_STOCKS : store->count;
+        double chunk_total = 0.0;
+        for (int i = begin; i < end; i++) {
+            if (store->quotes[i].current_price > 0) {
+                chunk_total += store->quotes[i].current_price;
+            }
+        }
+        total += chunk_total;
+    }
+    return total;
+}
+
+// Bytes held by the store (hot, cold and the symbol index)
+size_t quote_store_footprint(const QuoteStore* store, size_t* hot_bytes) {
+    if (!store) {
+        return 0;
+    }
+    size_t hot = (size_t)store->capacity * sizeof(StockQuote);
+    size_t cold = (size_t)store->capacity * sizeof(StockMeta);
+    size_t index = (size_t)store->symbols.slot_capacity * sizeof(int)
+                 + (size_t)store->symbols.symbol_capacity * MAX_SYMBOL_LENGTH;
+    if (hot_bytes) {
+        *hot_bytes = hot;
+    }
+    return hot + cold + index;
+}
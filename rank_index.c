@@ -0,0 +1,394 @@
+/*
+ * Smart Stock Tracker - Rank Index
+ * Order-statistics trees for leaderboards, ranks and percentiles
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * write_trending_json() and display_trending_stocks() sort a copy of the
+ * universe for every query. The index keeps one treap per key (change,
+ * volume, price) with subtree sizes, so a quote change re-ranks a symbol
+ * in O(log n), a rank or percentile is one root-to-leaf walk, and a page of
+ * K leaderboard entries skips whole subtrees to reach its offset and then
+ * costs O(K). Node i of every tree is symbol id i, so the trees are plain
+ * parallel arrays with no per-node allocation.
+ */
+
+#include "stock_tracker.h"
+
+// Deterministic heap priority for a symbol id (splitmix64 finalizer)
+static unsigned int rank_priority(int id) {
+    unsigned long long x = (unsigned long long)id + 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return (unsigned int)((x ^ (x >> 31)) >> 32);
+}
+
+// Tree order: by value, ties broken by higher id first so pages are stable
+static int rank_less(const RankTree* tree, int a, int b) {
+    double va = tree->values[a];
+    double vb = tree->values[b];
+    return va < vb || (va == vb && a > b);
+}
+
+static int subtree_size(const RankTree* tree, int node) {
+    return node < 0 ? 0 : tree->size[node];
+}
+
+static void update_size(RankTree* tree, int node) {
+    tree->size[node] = 1 + subtree_size(tree, tree->left[node]) + subtree_size(tree, tree->right[node]);
+}
+
+// Split a subtree into nodes ordered before `pivot` and the rest
+static void tree_split(RankTree* tree, int root, int pivot, int* before, int* after) {
+    if (root < 0) {
+        *before = -1;
+        *after = -1;
+    } else if (rank_less(tree, root, pivot)) {
+        tree_split(tree, tree->right[root], pivot, &tree->right[root], after);
+        update_size(tree, root);
+        *before = root;
+    } else {
+        tree_split(tree, tree->left[root], pivot, before, &tree->left[root]);
+        update_size(tree, root);
+        *after = root;
+    }
+}
+
+// Join two subtrees where every node of `a` orders before every node of `b`
+static int tree_merge(RankTree* tree, const unsigned int* priority, int a, int b) {
+    if (a < 0) {
+        return b;
+    }
+    if (b < 0) {
+        return a;
+    }
+    if (priority[a] > priority[b]) {
+        tree->right[a] = tree_merge(tree, priority, tree->right[a], b);
+        update_size(tree, a);
+        return a;
+    }
+    tree->left[b] = tree_merge(tree, priority, a, tree->left[b]);
+    update_size(tree, b);
+    return b;
+}
+
+static int tree_insert(RankTree* tree, const unsigned int* priority, int root, int node) {
+    if (root < 0) {
+        return node;
+    }
+    if (priority[node] > priority[root]) {
+        tree_split(tree, root, node, &tree->left[node], &tree->right[node]);
+        update_size(tree, node);
+        return node;
+    }
+    if (rank_less(tree, node, root)) {
+        tree->left[root] = tree_insert(tree, priority, tree->left[root], node);
+    } else {
+        tree->right[root] = tree_insert(tree, priority, tree->right[root], node);
+    }
+    update_size(tree, root);
+    return root;
+}
+
+static int tree_erase(RankTree* tree, const unsigned int* priority, int root, int node) {
+    if (root < 0) {
+        return -1;
+    }
+    if (root == node) {
+        int merged = tree_merge(tree, priority, tree->left[node], tree->right[node]);
+        tree->left[node] = -1;
+        tree->right[node] = -1;
+        tree->size[node] = 1;
+        return merged;
+    }
+    if (rank_less(tree, node, root)) {
+        tree->left[root] = tree_erase(tree, priority, tree->left[root], node);
+    } else {
+        tree->right[root] = tree_erase(tree, priority, tree->right[root], node);
+    }
+    update_size(tree, root);
+    return root;
+}
+
+// Nodes ordered before `node` (its 0-based ascending position)
+static int tree_position(const RankTree* tree, int node) {
+    int position = 0;
+    int cursor = tree->root;
+    while (cursor >= 0 && cursor != node) {
+        if (rank_less(tree, node, cursor)) {
+            cursor = tree->left[cursor];
+        } else {
+            position += subtree_size(tree, tree->left[cursor]) + 1;
+            cursor = tree->right[cursor];
+        }
+    }
+    return position + (cursor >= 0 ? subtree_size(tree, tree->left[cursor]) : 0);
+}
+
+// Node at a 0-based ascending position
+static int tree_select(const RankTree* tree, int position) {
+    int cursor = tree->root;
+    while (cursor >= 0) {
+        int left_size = subtree_size(tree, tree->left[cursor]);
+        if (position < left_size) {
+            cursor = tree->left[cursor];
+        } else if (position == left_size) {
+            return cursor;
+        } else {
+            position -= left_size + 1;
+            cursor = tree->right[cursor];
+        }
+    }
+    return -1;
+}
+
+// In-order walk that skips whole subtrees lying before the requested page
+static void tree_collect(const RankTree* tree, int node, int descending, int* skip,
+                         int* remaining, int ids[], int* written) {
+    if (node < 0 || *remaining == 0) {
+        return;
+    }
+    if (subtree_size(tree, node) <= *skip) {
+        *skip -= subtree_size(tree, node);
+        return;
+    }
+    int first = descending ? tree->right[node] : tree->left[node];
+    int second = descending ? tree->left[node] : tree->right[node];
+    tree_collect(tree, first, descending, skip, remaining, ids, written);
+    if (*remaining == 0) {
+        return;
+    }
+    if (*skip > 0) {
+        (*skip)--;
+    } else {
+        ids[(*written)++] = node;
+        (*remaining)--;
+    }
+    tree_collect(tree, second, descending, skip, remaining, ids, written);
+}
+
+// Grow every per-symbol array to at least capacity entries
+static int rank_index_reserve(RankIndex* index, int capacity) {
+    if (capacity <= index->capacity) {
+        return 1;
+    }
+    int new_capacity = index->capacity ? index->capacity : 64;
+    while (new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+    size_t n = (size_t)new_capacity;
+
+    unsigned int* priority = realloc(index->priority, n * sizeof(unsigned int));
+    if (!priority) {
+        return 0;
+    }
+    index->priority = priority;
+    unsigned char* ranked = realloc(index->ranked, n);
+    if (!ranked) {
+        return 0;
+    }
+    index->ranked = ranked;
+    for (int k = 0; k < RANK_KEY_COUNT; k++) {
+        RankTree* tree = &index->trees[k];
+        double* values = realloc(tree->values, n * sizeof(double));
+        if (values) tree->values = values;
+        int* left = realloc(tree->left, n * sizeof(int));
+        if (left) tree->left = left;
+        int* right = realloc(tree->right, n * sizeof(int));
+        if (right) tree->right = right;
+        int* size = realloc(tree->size, n * sizeof(int));
+        if (size) tree->size = size;
+        if (!values || !left || !right || !size) {
+            return 0;
+        }
+    }
+
+    for (int i = index->capacity; i < new_capacity; i++) {
+        index->priority[i] = rank_priority(i);
+        index->ranked[i] = 0;
+        for (int k = 0; k < RANK_KEY_COUNT; k++) {
+            index->trees[k].values[i] = 0.0;
+            index->trees[k].left[i] = -1;
+            index->trees[k].right[i] = -1;
+            index->trees[k].size[i] = 1;
+        }
+    }
+    index->capacity = new_capacity;
+    return 1;
+}
+
+// Initialize an empty index
+int rank_index_init(RankIndex* index, int expected_symbols) {
+    if (!index) {
+        return 0;
+    }
+    memset(index, 0, sizeof(*index));
+    for (int k = 0; k < RANK_KEY_COUNT; k++) {
+        index->trees[k].root = -1;
+    }
+    if (!symbol_map_init(&index->symbols, expected_symbols) ||
+        !rank_index_reserve(index, expected_symbols > 0 ? expected_symbols : 1)) {
+        rank_index_free(index);
+        return 0;
+    }
+    return 1;
+}
+
+// Release the index's memory
+void rank_index_free(RankIndex* index) {
+    if (!index) {
+        return;
+    }
+    for (int k = 0; k < RANK_KEY_COUNT; k++) {
+        free(index->trees[k].values);
+        free(index->trees[k].left);
+        free(index->trees[k].right);
+        free(index->trees[k].size);
+    }
+    free(index->priority);
+    free(index->ranked);
+    symbol_map_free(&index->symbols);
+    memset(index, 0, sizeof(*index));
+}
+
+// Take a symbol id out of every tree
+static void rank_index_unlink(RankIndex* index, int id) {
+    for (int k = 0; k < RANK_KEY_COUNT; k++) {
+        RankTree* tree = &index->trees[k];
+        tree->root = tree_erase(tree, index->priority, tree->root, id);
+    }
+    index->ranked[id] = 0;
+    index->count--;
+}
+
+// Re-rank a symbol after a quote change
+int rank_index_update(RankIndex* index, const Stock* stock) {
+    if (!index || !stock) {
+        return 0;
+    }
+    if (stock->current_price <= 0) {
+        rank_index_remove(index, stock->symbol);
+        return 1;
+    }
+    if (strlen(stock->symbol) >= MAX_SYMBOL_LENGTH) {
+        return 0;
+    }
+    int id = symbol_map_insert(&index->symbols, stock->symbol);
+    if (id < 0 || !rank_index_reserve(index, id + 1)) {
+        return 0;
+    }
+
+    double values[RANK_KEY_COUNT];
+    values[RANK_BY_CHANGE] = stock->change_percent;
+    values[RANK_BY_VOLUME] = stock->volume;
+    values[RANK_BY_PRICE] = stock->current_price;
+
+    int was_ranked = index->ranked[id];
+    for (int k = 0; k < RANK_KEY_COUNT; k++) {
+        RankTree* tree = &index->trees[k];
+        if (was_ranked && tree->values[id] == values[k]) {
+            continue;  // Position in this tree is unchanged
+        }
+        if (was_ranked) {
+            tree->root = tree_erase(tree, index->priority, tree->root, id);
+        }
+        tree->values[id] = values[k];
+        tree->root = tree_insert(tree, index->priority, tree->root, id);
+    }
+    if (!was_ranked) {
+        index->ranked[id] = 1;
+        index->count++;
+    }
+    return 1;
+}
+
+// Stop ranking a symbol
+int rank_index_remove(RankIndex* index, const char* symbol) {
+    if (!index) {
+        return 0;
+    }
+    int id = symbol_map_find(&index->symbols, symbol);
+    if (id < 0 || !index->ranked[id]) {
+        return 0;
+    }
+    rank_index_unlink(index, id);
+    return 1;
+}
+
+// One page of a leaderboard
+int rank_index_range(const RankIndex* index, RankKey key, int descending, int offset, int count, int ids[]) {
+    if (!index || key < 0 || key >= RANK_KEY_COUNT || !ids || offset < 0 || count <= 0) {
+        return 0;
+    }
+    int skip = offset;
+    int remaining = count;
+    int written = 0;
+    const RankTree* tree = &index->trees[key];
+    tree_collect(tree, tree->root, descending, &skip, &remaining, ids, &written);
+    return written;
+}
+
+// Ranked symbol id, -1 if absent
+static int ranked_id(const RankIndex* index, RankKey key, const char* symbol) {
+    if (!index || key < 0 || key >= RANK_KEY_COUNT) {
+        return -1;
+    }
+    int id = symbol_map_find(&index->symbols, symbol);
+    return (id >= 0 && index->ranked[id]) ? id : -1;
+}
+
+// Leaderboard position, highest value first
+int rank_index_rank(const RankIndex* index, RankKey key, const char* symbol) {
+    int id = ranked_id(index, key, symbol);
+    if (id < 0) {
+        return 0;
+    }
+    return index->count - tree_position(&index->trees[key], id);
+}
+
+// Share of ranked symbols with a lower value
+double rank_index_percentile(const RankIndex* index, RankKey key, const char* symbol) {
+    int id = ranked_id(index, key, symbol);
+    if (id < 0) {
+        return -1.0;
+    }
+    // Ties are ordered by id, so count by value rather than by position
+    const RankTree* tree = &index->trees[key];
+    double value = tree->values[id];
+    int below = 0;
+    int cursor = tree->root;
+    while (cursor >= 0) {
+        if (tree->values[cursor] < value) {
+            below += subtree_size(tree, tree->left[cursor]) + 1;
+            cursor = tree->right[cursor];
+        } else {
+            cursor = tree->left[cursor];
+        }
+    }
+    return 100.0 * below / index->count;
+}
+
+// Value at a percentile (nearest rank)
+double rank_index_value_at(const RankIndex* index, RankKey key, double percentile) {
+    if (!index || key < 0 || key >= RANK_KEY_COUNT || index->count == 0) {
+        return 0.0;
+    }
+    if (percentile < 0) percentile = 0;
+    if (percentile > 100) percentile = 100;
+    int position = (int)(percentile / 100.0 * (index->count - 1) + 0.5);
+    const RankTree* tree = &index->trees[key];
+    return tree->values[tree_select(tree, position)];
+}
+
+// Symbol for an id
+const char* rank_index_name(const RankIndex* index, int id) {
+    return index ? symbol_map_name(&index->symbols, id) : NULL;
+}
+
+// Latest key value of a symbol id
+double rank_index_value(const RankIndex* index, RankKey key, int id) {
+    if (!index || key < 0 || key >= RANK_KEY_COUNT || id < 0 || id >= index->symbols.count) {
+        return 0.0;
+    }
+    return index->trees[key].values[id];
+}
@@ -0,0 +1,631 @@
+/*
+ * Smart Stock Tracker - Recording and Replay
+ * Records raw API responses and replays them (or tick history) through
+ * the real parse -> analyze -> publish path at 1x, Nx or maximum speed
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * Recording format (one entry per response):
+ *   #REC <epoch_ms> <symbol> <length>\n<raw response bytes>\n
+ *
+ * Tick history format (CSV, optional header):
+ *   timestamp,symbol,price,change_percent,volume
+ */
+
+#include "stock_tracker.h"
+#include <pthread.h>
+#include <sys/time.h>
+#include <time.h>
+
+// One replay input event
+typedef struct {
+    long long timestamp_ms;
+    int symbol_index;
+    char* payload;            // Raw API response (NUL-terminated), NULL for ticks
+    double price;
+    double change_percent;
+    double volume;
+} ReplayEvent;
+
+// Response recorder state
+static FILE* record_file = NULL;
+static pthread_mutex_t record_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// =============================================================================
+// RECORDING
+// =============================================================================
+
+// Start appending raw responses to a recording file
+int recorder_open(const char* filename) {
+    if (!filename) {
+        return 0;
+    }
+    pthread_mutex_lock(&record_lock);
+    if (record_file) {
+        fclose(record_file);
+    }
+    record_file = fopen(filename, "ab");
+    pthread_mutex_unlock(&record_lock);
+
+    if (!record_file) {
+        display_error("Cannot open recording file");
+        return 0;
+    }
+    return 1;
+}
+
+// Stop recording
+void recorder_close() {
+    pthread_mutex_lock(&record_lock);
+    if (record_file) {
+        fclose(record_file);
+        record_file = NULL;
+    }
+    pthread_mutex_unlock(&record_lock);
+}
+
+// Append one raw response (no-op when not recording)
+void recorder_write(const char* symbol, const char* data, size_t size) {
+    if (!record_file || !symbol || !data) {
+        return;
+    }
+
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    long long epoch_ms = (long long)now.tv_sec * 1000LL + now.tv_usec / 1000;
+
+    pthread_mutex_lock(&record_lock);
+    if (record_file) {
+        fprintf(record_file, RECORD_MAGIC "%lld %s %zu\n", epoch_ms, symbol, size);
+        fwrite(data, 1, size, record_file);
+        fputc('\n', record_file);
+        fflush(record_file);
+    }
+    pthread_mutex_unlock(&record_lock);
+}
+
+// =============================================================================
+// LOADING
+// =============================================================================
+
+// Small open-addressing map from symbol to universe index
+typedef struct {
+    int* slots;               // -1 = empty, otherwise index into stocks
+    int capacity;             // Power of two
+    Stock* stocks;
+    int count;
+    int stock_capacity;
+} ReplayUniverse;
+
+static int universe_init(ReplayUniverse* universe) {
+    universe->capacity = 1024;
+    universe->slots = malloc(universe->capacity * sizeof(int));
+    universe->stock_capacity = 256;
+    universe->stocks = malloc(universe->stock_capacity * sizeof(Stock));
+    universe->count = 0;
+    if (!universe->slots || !universe->stocks) {
+        return 0;
+    }
+    memset(universe->slots, -1, universe->capacity * sizeof(int));
+    return 1;
+}
+
+static void universe_free(ReplayUniverse* universe) {
+    free(universe->slots);
+    free(universe->stocks);
+}
+
+static int universe_grow(ReplayUniverse* universe) {
+    int new_capacity = universe->capacity * 2;
+    int* slots = malloc(new_capacity * sizeof(int));
+    if (!slots) {
+        return 0;
+    }
+    memset(slots, -1, new_capacity * sizeof(int));
+    for (int i = 0; i < universe->count; i++) {
+        unsigned long long h = sim_symbol_hash(universe->stocks[i].symbol);
+        int pos = (int)(h & (unsigned long long)(new_capacity - 1));
+        while (slots[pos] >= 0) {
+            pos = (pos + 1) & (new_capacity - 1);
+        }
+        slots[pos] = i;
+    }
+    free(universe->slots);
+    universe->slots = slots;
+    universe->capacity = new_capacity;
+    return 1;
+}
+
+// Find or add a symbol; returns its index or -1 on failure
+static int universe_lookup(ReplayUniverse* universe, const char* symbol) {
+    unsigned long long h = sim_symbol_hash(symbol);
+    int pos = (int)(h & (unsigned long long)(universe->capacity - 1));
+    while (universe->slots[pos] >= 0) {
+        if (strcmp(universe->stocks[universe->slots[pos]].symbol, symbol) == 0) {
+            return universe->slots[pos];
+        }
+        pos = (pos + 1) & (universe->capacity - 1);
+    }
+
+    // New symbol
+    if (universe->count == universe->stock_capacity) {
+        Stock* grown = realloc(universe->stocks, universe->stock_capacity * 2 * sizeof(Stock));
+        if (!grown) {
+            return -1;
+        }
+        universe->stocks = grown;
+        universe->stock_capacity *= 2;
+    }
+    int index = universe->count++;
+    Stock* stock = &universe->stocks[index];
+    memset(stock, 0, sizeof(*stock));
+    strncpy(stock->symbol, symbol, MAX_SYMBOL_LENGTH - 1);
+    strcpy(stock->name, get_company_name(stock->symbol));
+    stock->status = STATUS_PENDING;
+    universe->slots[pos] = index;
+
+    if (universe->count * 2 > universe->capacity) {
+        universe_grow(universe);
+    }
+    return index;
+}
+
+// Append an event, growing the array as needed
+static ReplayEvent* push_event(ReplayEvent** events, int* count, int* capacity) {
+    if (*count == *capacity) {
+        int new_capacity = *capacity ? *capacity * 2 : 1024;
+        ReplayEvent* grown = realloc(*events, (size_t)new_capacity * sizeof(ReplayEvent));
+        if (!grown) {
+            return NULL;
+        }
+        *events = grown;
+        *capacity = new_capacity;
+    }
+    ReplayEvent* event = &(*events)[(*count)++];
+    memset(event, 0, sizeof(*event));
+    return event;
+}
+
+// Parse a recording: payloads are NUL-terminated in place inside buffer
+static int load_recorded_responses(char* buffer, size_t size, ReplayUniverse* universe,
+                                   ReplayEvent** events, int* count) {
+    int capacity = 0;
+    size_t pos = 0;
+
+    while (pos < size) {
+        if (strncmp(buffer + pos, RECORD_MAGIC, strlen(RECORD_MAGIC)) != 0) {
+            fprintf(stderr, "❌ Malformed recording at byte %zu\n", pos);
+            return 0;
+        }
+
+        long long epoch_ms;
+        char symbol[MAX_SYMBOL_LENGTH];
+        size_t length;
+        int consumed = 0;
+        if (sscanf(buffer + pos, RECORD_MAGIC "%lld %9s %zu%n", &epoch_ms, symbol, &length, &consumed) != 3) {
+            fprintf(stderr, "❌ Malformed recording header at byte %zu\n", pos);
+            return 0;
+        }
+        pos += (size_t)consumed + 1;  // Skip header and its newline
+        if (pos + length > size) {
+            fprintf(stderr, "❌ Truncated recording for %s at byte %zu\n", symbol, pos);
+            return 0;
+        }
+
+        ReplayEvent* event = push_event(events, count, &capacity);
+        if (!event) {
+            return 0;
+        }
+        event->timestamp_ms = epoch_ms;
+        event->symbol_index = universe_lookup(universe, symbol);
+        event->payload = buffer + pos;
+        pos += length;
+        buffer[pos] = '\0';   // Overwrites the separator newline
+        pos += 1;
+
+        if (event->symbol_index < 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Parse tick history CSV
+static int load_tick_history(char* buffer, ReplayUniverse* universe,
+                             ReplayEvent** events, int* count) {
+    int capacity = 0;
+    int line_number = 0;
+    char* line = buffer;
+
+    while (line && *line) {
+        char* next = strchr(line, '\n');
+        if (next) {
+            *next++ = '\0';
+        }
+        line_number++;
+
+        // Skip header, comments and blank lines
+        if (*line == '\0' || *line == '#' || (line_number == 1 && !(*line >= '0' && *line <= '9'))) {
+            line = next;
+            continue;
+        }
+
+        double timestamp, price, change, volume;
+        char symbol[MAX_SYMBOL_LENGTH];
+        if (sscanf(line, "%lf,%9[^,],%lf,%lf,%lf", &timestamp, symbol, &price, &change, &volume) != 5) {
+            fprintf(stderr, "❌ Bad tick on line %d: %s\n", line_number, line);
+            return 0;
+        }
+
+        ReplayEvent* event = push_event(events, count, &capacity);
+        if (!event) {
+            return 0;
+        }
+        event->timestamp_ms = (long long)(timestamp * 1000.0);
+        event->symbol_index = universe_lookup(universe, symbol);
+        event->price = price;
+        event->change_percent = change;
+        event->volume = volume;
+        if (event->symbol_index < 0) {
+            return 0;
+        }
+        line = next;
+    }
+    return 1;
+}
+
+// =============================================================================
+// REPLAY
+// =============================================================================
+
+static void sleep_until(long long target_ns) {
+    long long now = metrics_now_ns();
+    if (target_ns <= now) {
+        return;
+    }
+    struct timespec ts;
+    long long wait = target_ns - now;
+    ts.tv_sec = wait / 1000000000LL;
+    ts.tv_nsec = wait % 1000000000LL;
+    nanosleep(&ts, NULL);
+}
+
+static void publish_universe(ReplayUniverse* universe, const AlertEngine* alerts,
+                             const BreadthEngine* breadth, const RankIndex* ranks,
+                             const VolumeProfile* volumes) {
+    write_all_stocks_json(universe->stocks, universe->count);
+    write_best_stock_json(universe->stocks, universe->count);
+    write_ranked_trending_json(ranks);
+    write_breadth_json(breadth);
+    write_unusual_volume_json(volumes);
+    if (alerts) {
+        AlertEvent recent[ALERT_RECENT_EVENTS];
+        write_alerts_json(recent, alert_engine_recent(alerts, recent, ALERT_RECENT_EVENTS));
+    }
+}
+
+// Fill defaults for replay options
+void replay_default_options(ReplayOptions* options) {
+    if (!options) {
+        return;
+    }
+    options->speed = 1.0;
+    options->output_dir = REPLAY_OUTPUT_DIR;
+    options->publish = 1;
+    options->alerts_file = NULL;
+    options->groups_file = NULL;
+    options->bars_file = NULL;
+}
+
+// Replay a recording or tick history file through the pipeline
+int replay_file(const char* filename, const ReplayOptions* options, ReplayReport* report) {
+    if (!filename || !options || !report) {
+        return 0;
+    }
+    memset(report, 0, sizeof(*report));
+
+    size_t size = 0;
+    char* buffer = read_entire_file(filename, &size);
+    if (!buffer) {
+        display_error("Cannot read replay file");
+        return 0;
+    }
+
+    ReplayUniverse universe;
+    ReplayEvent* events = NULL;
+    int event_count = 0;
+    if (!universe_init(&universe)) {
+        free(buffer);
+        return 0;
+    }
+
+    int loaded = (strncmp(buffer, RECORD_MAGIC, strlen(RECORD_MAGIC)) == 0)
+               ? load_recorded_responses(buffer, size, &universe, &events, &event_count)
+               : load_tick_history(buffer, &universe, &events, &event_count);
+    if (!loaded || event_count == 0) {
+        if (loaded) display_error("Replay file contains no events");
+        free(events);
+        universe_free(&universe);
+        free(buffer);
+        return 0;
+    }
+
+    // Cycle tracking: a refresh cycle ends when a symbol repeats
+    int* last_cycle = malloc((size_t)universe.count * sizeof(int));
+    if (!last_cycle) {
+        free(events);
+        universe_free(&universe);
+        free(buffer);
+        return 0;
+    }
+    for (int i = 0; i < universe.count; i++) {
+        last_cycle[i] = -1;
+    }
+
+    AlertEngine alert_engine;
+    AlertEngine* alerts = NULL;
+    if (options->alerts_file) {
+        if (!alert_engine_init(&alert_engine) || load_alert_rules(options->alerts_file, &alert_engine) < 0) {
+            alert_engine_free(&alert_engine);
+            free(last_cycle);
+            free(events);
+            universe_free(&universe);
+            free(buffer);
+            return 0;
+        }
+        alerts = &alert_engine;
+    }
+
+    BreadthEngine breadth;
+    RankIndex ranks;
+    VolumeProfile volumes;
+    BarBuilder bars;
+    HistoryStore minute_bars;
+    int ranks_ready = rank_index_init(&ranks, universe.count);
+    int volumes_ready = volume_profile_init(&volumes, universe.count);
+    int bars_ready = bar_builder_init(&bars, universe.count, BAR_RING_CAPACITY);
+    int store_ready = history_store_init(&minute_bars);
+    if (!breadth_init(&breadth) || !ranks_ready || !volumes_ready || !bars_ready || !store_ready ||
+        (options->groups_file && breadth_load_groups(&breadth, options->groups_file) < 0)) {
+        breadth_free(&breadth);
+        rank_index_free(&ranks);
+        volume_profile_free(&volumes);
+        bar_builder_free(&bars);
+        history_store_free(&minute_bars);
+        if (alerts) {
+            alert_engine_free(alerts);
+        }
+        free(last_cycle);
+        free(events);
+        universe_free(&universe);
+        free(buffer);
+        return 0;
+    }
+
+    if (options->output_dir) {
+        create_directory(options->output_dir);
+        set_public_data_dir(options->output_dir);
+    }
+    if (options->bars_file) {
+        bar_builder_set_sink(&bars, BAR_1M, &minute_bars);
+    }
+    metrics_reset();
+
+    long long first_ms = events[0].timestamp_ms;
+    long long wall_start = metrics_now_ns();
+    int cycle = 0;
+
+    for (int e = 0; e < event_count; e++) {
+        ReplayEvent* event = &events[e];
+        Stock* stock = &universe.stocks[event->symbol_index];
+
+        // Pace against the recorded timeline (speed 0 = as fast as possible)
+        long long arrival = metrics_now_ns();
+        if (options->speed > 0) {
+            long long target = wall_start + (long long)((event->timestamp_ms - first_ms) * 1e6 / options->speed);
+            sleep_until(target);
+            arrival = target;
+            long long lag = metrics_now_ns() - target;
+            if (lag > report->max_lag_ns) {
+                report->max_lag_ns = lag;
+            }
+        }
+
+        if (last_cycle[event->symbol_index] == cycle) {
+            if (options->publish) {
+                publish_universe(&universe, alerts, &breadth, &ranks, &volumes);
+            }
+            // Bars whose period ended are drained between cycles, off the event path
+            bar_builder_close(&bars, event->timestamp_ms / 1000);
+            bar_builder_flush(&bars);
+            cycle++;
+        }
+        last_cycle[event->symbol_index] = cycle;
+
+        // Recorded time drives every timestamp so the replay is deterministic
+        set_quote_clock((time_t)(event->timestamp_ms / 1000));
+
+        if (event->payload) {
+            long long parse_start = metrics_now_ns();
+            int parsed = parse_stock_json(event->payload, stock);
+            metrics_record_stage(METRIC_PARSE, metrics_now_ns() - parse_start);
+            if (!parsed) {
+                report->parse_failures++;
+                continue;
+            }
+        } else {
+            stock->current_price = event->price;
+            stock->change_percent = event->change_percent;
+            stock->volume = event->volume;
+            stock->previous_close = event->price / (1.0 + event->change_percent / 100.0);
+            if (event->price > stock->day_high) stock->day_high = event->price;
+            if (stock->day_low <= 0 || event->price < stock->day_low) stock->day_low = event->price;
+            stock->last_update = (time_t)(event->timestamp_ms / 1000);
+        }
+
+        long long analyze_start = metrics_now_ns();
+        analyze_stock_performance(stock);
+        long long analyzed = metrics_now_ns();
+        metrics_record_stage(METRIC_ANALYZE, analyzed - analyze_start);
+        if (alerts) {
+            alert_engine_check(alerts, stock);
+        }
+        breadth_update(&breadth, stock);
+        rank_index_update(&ranks, stock);
+        volume_profile_update(&volumes, stock, NULL);
+        bar_builder_update(&bars, stock);
+        histogram_record(&report->end_to_end, metrics_now_ns() - arrival);
+    }
+
+    if (options->publish) {
+        publish_universe(&universe, alerts, &breadth, &ranks, &volumes);
+    }
+    set_quote_clock(0);
+
+    report->wall_ns = metrics_now_ns() - wall_start;
+    report->events = event_count;
+    report->symbols = universe.count;
+    report->cycles = cycle + 1;
+    report->recorded_span_ms = events[event_count - 1].timestamp_ms - first_ms;
+    report->events_per_second = report->wall_ns > 0 ? event_count * 1e9 / report->wall_ns : 0.0;
+    if (alerts) {
+        report->alert_rules = alerts->active_rules;
+        report->alerts_fired = alerts->fired;
+        report->alerts_suppressed = alerts->suppressed;
+        alert_engine_free(alerts);
+    }
+    report->breadth_groups = breadth.group_count - 1;
+    report->advancers = breadth.groups[0].advancers;
+    report->decliners = breadth.groups[0].decliners;
+    breadth_free(&breadth);
+    int unusual;
+    if (volume_profile_top(&volumes, 1, &unusual) == 1) {
+        strcpy(report->unusual_symbol, volume_profile_name(&volumes, unusual));
+        report->unusual_z_score = volume_profile_score(&volumes, unusual)->z_score;
+    }
+    rank_index_free(&ranks);
+    volume_profile_free(&volumes);
+    bar_builder_close(&bars, 0);
+    if (bar_builder_flush(&bars) >= 0 && options->bars_file) {
+        report->bars_written = history_store_write_csv(&minute_bars, options->bars_file);
+        if (report->bars_written < 0) {
+            fprintf(stderr, "❌ Could not write bars to %s\n", options->bars_file);
+            report->bars_written = 0;
+        }
+    }
+    report->bars_closed = bars.bars_closed;
+    report->bars_dropped = bars.bars_dropped;
+    bar_builder_free(&bars);
+    history_store_free(&minute_bars);
+
+    free(last_cycle);
+    free(events);
+    universe_free(&universe);
+    free(buffer);
+    return 1;
+}
+
+static void print_stage_row(const char* name, const LatencyHistogram* h) {
+    if (!h || h->count == 0) {
+        return;
+    }
+    printf("  %-10s %10llu %10.2f %10.2f %10.2f %10.2f\n", name, h->count,
+           h->sum_ns / 1e3 / h->count,
+           histogram_percentile(h, 50.0) / 1e3,
+           histogram_percentile(h, 99.0) / 1e3,
+           h->max_ns / 1e3);
+}
+
+// Print a replay report
+void replay_print_report(const ReplayReport* report) {
+    printf("🎬 Replay: %d events, %d symbols, %d refresh cycles\n",
+           report->events, report->symbols, report->cycles);
+    printf("⏱️  Wall time %.3fs for %.3fs of recorded time (%.1fx), %.0f events/s\n",
+           report->wall_ns / 1e9, report->recorded_span_ms / 1e3,
+           report->wall_ns > 0 ? report->recorded_span_ms * 1e6 / report->wall_ns : 0.0,
+           report->events_per_second);
+    if (report->parse_failures > 0) {
+        printf("⚠️  %d responses failed to parse\n", report->parse_failures);
+    }
+    if (report->alert_rules > 0) {
+        printf("🔔 %d alert rules: %llu fired, %llu suppressed\n",
+               report->alert_rules, report->alerts_fired, report->alerts_suppressed);
+    }
+    printf("🧭 Breadth: %d advancing, %d declining", report->advancers, report->decliners);
+    if (report->breadth_groups > 0) {
+        printf(" across %d groups", report->breadth_groups);
+    }
+    printf("\n");
+    if (report->unusual_symbol[0]) {
+        printf("🔊 Most unusual volume: %s (%.1f sigma)\n", report->unusual_symbol, report->unusual_z_score);
+    }
+    if (report->bars_closed > 0) {
+        printf("🕯️  Bars: %lld closed, %lld dropped", report->bars_closed, report->bars_dropped);
+        if (report->bars_written > 0) {
+            printf(", %d one-minute bars written", report->bars_written);
+        }
+        printf("\n");
+    }
+    if (report->max_lag_ns > 0) {
+        printf("🐢 Max lag behind schedule: %.2fms\n", report->max_lag_ns / 1e6);
+    }
+
+    printf("  %-10s %10s %10s %10s %10s %10s\n", "stage", "count", "mean_us", "p50_us", "p99_us", "max_us");
+    for (int s = METRIC_PARSE; s < METRIC_STAGE_COUNT; s++) {
+        print_stage_row(metrics_stage_name((MetricStage)s), metrics_stage_histogram((MetricStage)s));
+    }
+    print_stage_row("end2end", &report->end_to_end);
+}
+
+static void print_replay_usage() {
+    fprintf(stderr, "usage: stock_tracker replay <file> [--speed N|max] [--output dir] [--no-publish] [--alerts file] [--groups file] [--bars file]\n");
+}
+
+// Command line entry: replay <file> [--speed N|max] [--output dir] [--no-publish] [--alerts file] [--groups file] [--bars file]
+int run_replay_command(int argc, char* argv[]) {
+    if (argc < 2) {
+        print_replay_usage();
+        return 1;
+    }
+
+    ReplayOptions options;
+    replay_default_options(&options);
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            i++;
+            // Speed 0 means "max", so a typo must not quietly become 0
+            if (strcmp(argv[i], "max") == 0) {
+                options.speed = 0.0;
+            } else {
+                char* end;
+                options.speed = strtod(argv[i], &end);
+                if (end == argv[i] || *end != '\0' || !(options.speed > 0)) {
+                    fprintf(stderr, "❌ Invalid replay speed: %s (a number above 0, or max)\n", argv[i]);
+                    print_replay_usage();
+                    return 1;
+                }
+            }
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            options.output_dir = argv[++i];
+        } else if (strcmp(argv[i], "--no-publish") == 0) {
+            options.publish = 0;
+        } else if (strcmp(argv[i], "--alerts") == 0 && i + 1 < argc) {
+            options.alerts_file = argv[++i];
+        } else if (strcmp(argv[i], "--groups") == 0 && i + 1 < argc) {
+            options.groups_file = argv[++i];
+        } else if (strcmp(argv[i], "--bars") == 0 && i + 1 < argc) {
+            options.bars_file = argv[++i];
+        } else {
+            fprintf(stderr, "❌ Unknown replay option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    ReplayReport report;
+    if (!replay_file(argv[1], &options, &report)) {
+        return 1;
+    }
+    replay_print_report(&report);
+    return 0;
+}
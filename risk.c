@@ -0,0 +1,492 @@
+/*
+ * Smart Stock Tracker - Risk Engine
+ * Rolling volatility, beta, drawdown and value at risk from return history
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * Every symbol, the index proxy and the portfolio each have a RiskState:
+ * a ring of the last `window` (return, index return) pairs with running
+ * sums, the same returns kept sorted for historical VaR, and a wealth
+ * index for drawdowns. A new bar is one push per state (O(log W) search
+ * plus a short memmove). A full recompute replays the history through the
+ * same push in parallel across symbols, so both paths give identical numbers.
+ */
+
+#include "stock_tracker.h"
+#include <math.h>
+
+// =============================================================================
+// PER-SERIES STATE
+// =============================================================================
+
+// Point a state at its slice of the engine's buffers and reset it
+static void risk_state_reset(RiskState* state, double* buffer, int window) {
+    memset(state, 0, sizeof(*state));
+    state->returns = buffer;
+    state->index_returns = buffer + window;
+    state->sorted = buffer + 2 * (size_t)window;
+    state->window = window;
+    state->wealth = 1.0;
+    state->peak = 1.0;
+}
+
+// Recompute the running sums from the ring (bounds floating-point drift)
+static void risk_state_resum(RiskState* state) {
+    state->sum = state->sum_squares = 0.0;
+    state->sum_index = state->sum_index_squares = state->sum_cross = 0.0;
+    for (int k = 0; k < state->count; k++) {
+        double r = state->returns[k], m = state->index_returns[k];
+        state->sum += r;
+        state->sum_squares += r * r;
+        state->sum_index += m;
+        state->sum_index_squares += m * m;
+        state->sum_cross += r * m;
+    }
+}
+
+// First sorted position holding a value >= value
+static int sorted_position(const double* sorted, int count, double value) {
+    int lo = 0, hi = count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (sorted[mid] < value) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Add one bar's return (and the index return for the same bar)
+static void risk_state_push(RiskState* state, double r, double m) {
+    int window = state->window;
+    if (state->count == window) {
+        // Drop the oldest pair from the sums and the sorted copy
+        double old_r = state->returns[state->next];
+        double old_m = state->index_returns[state->next];
+        state->sum -= old_r;
+        state->sum_squares -= old_r * old_r;
+        state->sum_index -= old_m;
+        state->sum_index_squares -= old_m * old_m;
+        state->sum_cross -= old_r * old_m;
+
+        int pos = sorted_position(state->sorted, window, old_r);
+        memmove(&state->sorted[pos], &state->sorted[pos + 1], (size_t)(window - pos - 1) * sizeof(double));
+        state->count--;
+    }
+
+    int pos = sorted_position(state->sorted, state->count, r);
+    memmove(&state->sorted[pos + 1], &state->sorted[pos], (size_t)(state->count - pos) * sizeof(double));
+    state->sorted[pos] = r;
+
+    state->returns[state->next] = r;
+    state->index_returns[state->next] = m;
+    state->count++;
+    state->next = (state->next + 1) % window;
+    if (state->next == 0) {
+        risk_state_resum(state);
+    } else {
+        state->sum += r;
+        state->sum_squares += r * r;
+        state->sum_index += m;
+        state->sum_index_squares += m * m;
+        state->sum_cross += r * m;
+    }
+
+    // Drawdown runs over the whole history, not just the window
+    state->wealth *= 1.0 + r;
+    if (state->wealth > state->peak) {
+        state->peak = state->wealth;
+    }
+    double drawdown = 1.0 - state->wealth / state->peak;
+    if (drawdown > state->max_drawdown) {
+        state->max_drawdown = drawdown;
+    }
+    state->bars++;
+}
+
+// Read the metrics of one state
+static void risk_state_metrics(const RiskState* state, RiskMetrics* metrics) {
+    memset(metrics, 0, sizeof(*metrics));
+    int n = state->count;
+    metrics->observations = n;
+    metrics->drawdown = state->peak > 0 ? 1.0 - state->wealth / state->peak : 0.0;
+    metrics->max_drawdown = state->max_drawdown;
+    if (n < 2) {
+        return;
+    }
+
+    double mean = state->sum / n;
+    double variance = (state->sum_squares - state->sum * mean) / (n - 1);
+    double std = variance > 0 ? sqrt(variance) : 0.0;
+    double index_variance = (state->sum_index_squares - state->sum_index * state->sum_index / n) / (n - 1);
+    double covariance = (state->sum_cross - state->sum * state->sum_index / n) / (n - 1);
+
+    metrics->volatility = std * sqrt(RISK_PERIODS_PER_YEAR);
+    metrics->beta = index_variance > 0 ? covariance / index_variance : 0.0;
+
+    int tail = (int)((1.0 - RISK_CONFIDENCE) * n);
+    double historical = -state->sorted[tail < n ? tail : n - 1];
+    double parametric = -(mean - RISK_Z_SCORE * std);
+    metrics->var_historical = historical > 0 ? historical : 0.0;
+    metrics->var_parametric = parametric > 0 ? parametric : 0.0;
+}
+
+// =============================================================================
+// ENGINE
+// =============================================================================
+
+// Initialize an engine for a fixed set of symbols
+int risk_engine_init(RiskEngine* engine, int symbols, int window, int threads) {
+    if (!engine || symbols <= 0 || window < 2) {
+        return 0;
+    }
+    memset(engine, 0, sizeof(*engine));
+    engine->symbols = symbols;
+    engine->window = window;
+    engine->threads = threads;
+    engine->index_symbol = -1;
+
+    size_t per_state = 3 * (size_t)window;
+    engine->states = malloc((size_t)symbols * sizeof(RiskState));
+    engine->buffers = malloc(((size_t)symbols + 2) * per_state * sizeof(double));
+    engine->weights = malloc((size_t)symbols * sizeof(double));
+    if (!engine->states || !engine->buffers || !engine->weights) {
+        risk_engine_free(engine);
+        return 0;
+    }
+    for (int i = 0; i < symbols; i++) {
+        engine->weights[i] = 1.0 / symbols;
+    }
+    risk_engine_reset(engine);
+    return 1;
+}
+
+// Release the engine's memory
+void risk_engine_free(RiskEngine* engine) {
+    if (!engine) {
+        return;
+    }
+    free(engine->states);
+    free(engine->buffers);
+    free(engine->weights);
+    memset(engine, 0, sizeof(*engine));
+}
+
+// Forget all history, keeping the weights and index choice
+void risk_engine_reset(RiskEngine* engine) {
+    size_t per_state = 3 * (size_t)engine->window;
+    for (int i = 0; i < engine->symbols; i++) {
+        risk_state_reset(&engine->states[i], engine->buffers + (size_t)i * per_state, engine->window);
+    }
+    risk_state_reset(&engine->index, engine->buffers + (size_t)engine->symbols * per_state, engine->window);
+    risk_state_reset(&engine->portfolio, engine->buffers + ((size_t)engine->symbols + 1) * per_state,
+                     engine->window);
+}
+
+// Portfolio weights (normalized to sum to 1 by absolute value)
+int risk_engine_set_weights(RiskEngine* engine, const double* weights) {
+    if (!engine || !weights) {
+        return 0;
+    }
+    double total = 0.0;
+    for (int i = 0; i < engine->symbols; i++) {
+        total += fabs(weights[i]);
+    }
+    if (total <= 0) {
+        return 0;
+    }
+    for (int i = 0; i < engine->symbols; i++) {
+        engine->weights[i] = weights[i] / total;
+    }
+    return 1;
+}
+
+// Index proxy return for a bar: one symbol, or the equal-weighted universe
+static double index_return(const RiskEngine* engine, const double* returns) {
+    if (engine->index_symbol >= 0) {
+        return returns[engine->index_symbol];
+    }
+    double total = 0.0;
+    for (int i = 0; i < engine->symbols; i++) {
+        total += returns[i];
+    }
+    return total / engine->symbols;
+}
+
+static double portfolio_return(const RiskEngine* engine, const double* returns) {
+    double total = 0.0;
+    for (int i = 0; i < engine->symbols; i++) {
+        total += engine->weights[i] * returns[i];
+    }
+    return total;
+}
+
+// Add one bar: a return for every symbol (0 for a symbol without a bar)
+void risk_engine_push(RiskEngine* engine, const double* returns) {
+    if (!engine || !returns) {
+        return;
+    }
+    double m = index_return(engine, returns);
+    for (int i = 0; i < engine->symbols; i++) {
+        risk_state_push(&engine->states[i], returns[i], m);
+    }
+    risk_state_push(&engine->index, m, m);
+    risk_state_push(&engine->portfolio, portfolio_return(engine, returns), m);
+}
+
+// Work description for the parallel replay
+typedef struct {
+    RiskEngine* engine;
+    const double* rows;
+    const double* index;      // Index return per row
+    int count;
+} RiskReplayJob;
+
+static void replay_range(int begin, int end, int worker, void* context) {
+    (void)worker;
+    RiskReplayJob* job = (RiskReplayJob*)context;
+    int n = job->engine->symbols;
+    for (int i = begin; i < end; i++) {
+        RiskState* state = &job->engine->states[i];
+        for (int t = 0; t < job->count; t++) {
+            risk_state_push(state, job->rows[(size_t)t * n + i], job->index[t]);
+        }
+    }
+}
+
+// Rebuild every state from a time-major return matrix, symbols in parallel
+int risk_engine_load(RiskEngine* engine, const double* rows, int count) {
+    if (!engine || !rows || count < 0) {
+        return 0;
+    }
+    double* index = malloc((size_t)(count > 0 ? count : 1) * sizeof(double));
+    if (!index) {
+        return 0;
+    }
+    risk_engine_reset(engine);
+
+    int n = engine->symbols;
+    for (int t = 0; t < count; t++) {
+        const double* row = &rows[(size_t)t * n];
+        index[t] = index_return(engine, row);
+        risk_state_push(&engine->index, index[t], index[t]);
+        risk_state_push(&engine->portfolio, portfolio_return(engine, row), index[t]);
+    }
+
+    RiskReplayJob job = {engine, rows, index, count};
+    parallel_for(n, RISK_SYMBOLS_PER_CHUNK, engine->threads, replay_range, &job);
+    free(index);
+    return 1;
+}
+
+// Metrics for one symbol
+int risk_engine_symbol(const RiskEngine* engine, int symbol, RiskMetrics* metrics) {
+    if (!engine || !metrics || symbol < 0 || symbol >= engine->symbols) {
+        return 0;
+    }
+    risk_state_metrics(&engine->states[symbol], metrics);
+    return 1;
+}
+
+// Metrics for the weighted portfolio
+void risk_engine_portfolio(const RiskEngine* engine, RiskMetrics* metrics) {
+    if (engine && metrics) {
+        risk_state_metrics(&engine->portfolio, metrics);
+    }
+}
+
+// Metrics for the index proxy
+void risk_engine_index(const RiskEngine* engine, RiskMetrics* metrics) {
+    if (engine && metrics) {
+        risk_state_metrics(&engine->index, metrics);
+    }
+}
+
+// Risk label from realized volatility instead of one day's move
+const char* risk_level_from_metrics(const RiskMetrics* metrics) {
+    if (!metrics || metrics->observations < 2) {
+        return "UNKNOWN";
+    }
+    if (metrics->volatility >= RISK_HIGH_VOLATILITY) {
+        return "🔴 HIGH RISK";
+    } else if (metrics->volatility >= RISK_MEDIUM_VOLATILITY) {
+        return "🟡 MEDIUM RISK";
+    }
+    return "🟢 LOW RISK";
+}
+
+// =============================================================================
+// COMMAND LINE
+// =============================================================================
+
+typedef struct {
+    int symbol;
+    RiskMetrics metrics;
+} RiskRow;
+
+static int compare_risk_volatility(const void* a, const void* b) {
+    double va = ((const RiskRow*)a)->metrics.volatility;
+    double vb = ((const RiskRow*)b)->metrics.volatility;
+    return (vb > va) - (vb < va);
+}
+
+static void print_risk_row(const char* name, const RiskMetrics* m) {
+    printf("%-9s %7.1f %6.2f %7.1f %8.1f %7.2f %7.2f  %s\n", name, m->volatility * 100.0, m->beta,
+           m->drawdown * 100.0, m->max_drawdown * 100.0, m->var_historical * 100.0,
+           m->var_parametric * 100.0, risk_level_from_metrics(m));
+}
+
+// Weight symbols by portfolio market value (quantity x last close in the history)
+static int weights_from_portfolio(RiskEngine* engine, const HistoryStore* store, const char* filename) {
+    Portfolio portfolio;
+    if (!portfolio_init(&portfolio)) {
+        return 0;
+    }
+    if (portfolio_load_csv(&portfolio, filename) < 0) {
+        portfolio_free(&portfolio);
+        return 0;
+    }
+    double* weights = calloc((size_t)engine->symbols, sizeof(double));
+    int ok = weights != NULL;
+    for (int s = 0; ok && s < store->count; s++) {
+        const PriceSeries* series = &store->series[s];
+        int id = symbol_map_find(&portfolio.symbols, series->symbol);
+        if (id >= 0 && series->count > 0) {
+            weights[s] = portfolio.symbol_quantity[id] * series->close[series->count - 1];
+        }
+    }
+    if (ok && !risk_engine_set_weights(engine, weights)) {
+        display_error("No portfolio holdings found in the history");
+        ok = 0;
+    }
+    free(weights);
+    portfolio_free(&portfolio);
+    return ok;
+}
+
+// Print the report for a loaded engine
+static void report_risk(const RiskEngine* engine, const HistoryStore* store, int top) {
+    RiskRow* rows = malloc((size_t)engine->symbols * sizeof(RiskRow));
+    if (rows) {
+        for (int s = 0; s < engine->symbols; s++) {
+            rows[s].symbol = s;
+            risk_engine_symbol(engine, s, &rows[s].metrics);
+        }
+        qsort(rows, engine->symbols, sizeof(RiskRow), compare_risk_volatility);
+    }
+
+    printf("\n%-9s %7s %6s %7s %8s %7s %7s  %s\n", "SYMBOL", "VOL %", "BETA", "DD %", "MAXDD %",
+           "HVaR %", "PVaR %", "RISK");
+    for (int k = 0; rows && k < engine->symbols && k < top; k++) {
+        print_risk_row(store->series[rows[k].symbol].symbol, &rows[k].metrics);
+    }
+
+    RiskMetrics metrics;
+    risk_engine_index(engine, &metrics);
+    print_risk_row("INDEX", &metrics);
+    risk_engine_portfolio(engine, &metrics);
+    print_risk_row("PORTFOLIO", &metrics);
+    free(rows);
+}
+
+// Command line entry:
+// risk <history.csv> | --synthetic SYMBOLS BARS  [--window N] [--index SYMBOL]
+//      [--portfolio file] [--roll N] [--threads N] [--top N]
+int run_risk_command(int argc, char* argv[]) {
+    const char* filename = NULL;
+    const char* index_symbol = NULL;
+    const char* portfolio_file = NULL;
+    int synthetic_symbols = 0, synthetic_bars = 0;
+    int window = RISK_DEFAULT_WINDOW;
+    int roll = 0;
+    int threads = 0;
+    int top = 10;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--synthetic") == 0 && i + 2 < argc) {
+            synthetic_symbols = atoi(argv[++i]);
+            synthetic_bars = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+            window = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--index") == 0 && i + 1 < argc) {
+            index_symbol = argv[++i];
+        } else if (strcmp(argv[i], "--portfolio") == 0 && i + 1 < argc) {
+            portfolio_file = argv[++i];
+        } else if (strcmp(argv[i], "--roll") == 0 && i + 1 < argc) {
+            roll = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            top = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && !filename) {
+            filename = argv[i];
+        } else {
+            fprintf(stderr, "❌ Unknown risk option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if ((!filename && synthetic_symbols <= 0) || window < 2 || roll < 0) {
+        fprintf(stderr, "usage: stock_tracker risk <history.csv> | --synthetic SYMBOLS BARS [--window N] "
+                        "[--index SYMBOL] [--portfolio file] [--roll N] [--threads N] [--top N]\n");
+        return 1;
+    }
+
+    HistoryStore store;
+    if (!history_store_open(&store, filename, synthetic_symbols, synthetic_bars, threads)) {
+        return 1;
+    }
+
+    // Drawdowns use the whole history, so align every bar rather than just the window
+    int longest = 0;
+    for (int s = 0; s < store.count; s++) {
+        if (store.series[s].count > longest) longest = store.series[s].count;
+    }
+    double* matrix = NULL;
+    int rows = history_aligned_returns(&store, longest, &matrix);
+    RiskEngine engine;
+    int ok = rows > roll + 1 && risk_engine_init(&engine, store.count, window, threads);
+    if (!ok) {
+        display_error(rows > roll + 1 ? "Out of memory for the risk engine" : "Not enough history");
+        free(matrix);
+        history_store_free(&store);
+        return 1;
+    }
+
+    if (index_symbol) {
+        engine.index_symbol = symbol_map_find(&store.symbols, index_symbol);
+        if (engine.index_symbol < 0) {
+            fprintf(stderr, "⚠️  Index symbol %s not in history, using the equal-weighted universe\n",
+                    index_symbol);
+        }
+    }
+    if (portfolio_file && !weights_from_portfolio(&engine, &store, portfolio_file)) {
+        ok = 0;
+    }
+
+    if (ok) {
+        long long start = metrics_now_ns();
+        risk_engine_load(&engine, matrix, rows - roll);
+        long long load_ns = metrics_now_ns() - start;
+
+        printf("📉 RISK REPORT\n");
+        printf("══════════════════════════════\n");
+        printf("• Symbols: %d, bars: %d, window: %d\n", engine.symbols, rows, engine.window);
+        printf("• Full recompute: %.3fs\n", load_ns / 1e9);
+
+        if (roll > 0) {
+            start = metrics_now_ns();
+            for (int t = rows - roll; t < rows; t++) {
+                risk_engine_push(&engine, &matrix[(size_t)t * engine.symbols]);
+            }
+            long long push_ns = metrics_now_ns() - start;
+            printf("• Incremental: %d bars in %.3fs (%.2fms per universe bar)\n",
+                   roll, push_ns / 1e9, push_ns / 1e6 / roll);
+        }
+        printf("• Volatility annualized, VaR is a 1-day loss at %.0f%% confidence\n", RISK_CONFIDENCE * 100.0);
+        report_risk(&engine, &store, top);
+    }
+
+    risk_engine_free(&engine);
+    free(matrix);
+    history_store_free(&store);
+    return ok ? 0 : 1;
+}
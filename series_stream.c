@@ -0,0 +1,417 @@
+/*
+ * Smart Stock Tracker - Time Series Streaming
+ * Incremental parsing of Alpha Vantage time-series responses
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * TIME_SERIES_INTRADAY and TIME_SERIES_DAILY with outputsize=full return
+ * multi-megabyte documents:
+ *   {"Meta Data": {"2. Symbol": "IBM", ..., "6. Time Zone": "US/Eastern"},
+ *    "Time Series (5min)": {"2024-01-05 19:55:00": {"1. open": "161.2", ...
+ *                                                   "5. volume": "123"}, ...}}
+ * Instead of buffering the body and building a DOM, the curl write callback
+ * feeds each received block to a byte-at-a-time JSON tokenizer with a fixed
+ * token buffer and container stack. Every bar object that closes is
+ * appended to the history store right away, so memory does not grow with
+ * the response. A failed or refused download is rolled back to the bars
+ * the series had before it started.
+ */
+
+#include "stock_tracker.h"
+#include <limits.h>
+#include <unistd.h>
+
+// Tokenizer states
+enum {
+    STREAM_BETWEEN,           // Between tokens
+    STREAM_STRING,
+    STREAM_ESCAPE,            // After a backslash in a string
+    STREAM_LITERAL            // Number, true, false or null
+};
+
+// What the current top-level key holds
+enum {
+    SECTION_OTHER,
+    SECTION_META,
+    SECTION_SERIES
+};
+
+static const char* BAR_FIELDS[5] = {"open", "high", "low", "close", "volume"};
+
+// Initialize a stream that appends to a symbol's series
+int series_stream_init(SeriesStream* stream, HistoryStore* store, const char* symbol) {
+    if (!stream || !store || !symbol || !symbol[0] || strlen(symbol) >= MAX_SYMBOL_LENGTH) {
+        return 0;
+    }
+    memset(stream, 0, sizeof(*stream));
+    stream->store = store;
+    strcpy(stream->symbol, symbol);
+
+    // Bars up to the newest one already stored are not added again
+    const PriceSeries* series = history_store_series(store, symbol, 0);
+    stream->start_count = series ? series->count : 0;
+    stream->known_until = LLONG_MIN;
+    for (int i = 0; series && i < series->count; i++) {
+        if (series->timestamps[i] > stream->known_until) {
+            stream->known_until = series->timestamps[i];
+        }
+    }
+    return 1;
+}
+
+// Seconds to add to US Eastern wall-clock time to get UTC (DST rules since 2007)
+static long long eastern_to_utc_offset(long long local) {
+    long long day = local / 86400;
+    long long seconds = local % 86400;
+    int year = 1970 + (int)(day / 365);
+    while (history_days_from_civil(year, 1, 1) > day) year--;
+    while (history_days_from_civil(year + 1, 1, 1) <= day) year++;
+
+    // Second Sunday of March and first Sunday of November, 2:00 local; the
+    // repeated 1:00-2:00 hour in November is read as its first (daylight) pass
+    long long march = history_days_from_civil(year, 3, 1);
+    long long november = history_days_from_civil(year, 11, 1);
+    long long dst_start = march + (7 - (march + 4) % 7) % 7 + 7;
+    long long dst_end = november + (7 - (november + 4) % 7) % 7;
+    int summer = (day > dst_start || (day == dst_start && seconds >= 7200)) &&
+                 (day < dst_end || (day == dst_end && seconds < 7200));
+    return summer ? 4 * 3600 : 5 * 3600;
+}
+
+// A bar object closed: append it unless it is incomplete or already stored
+static void stream_emit_bar(SeriesStream* stream) {
+    if (stream->field_mask != 0x1f || stream->bar_time == LLONG_MIN) {
+        stream->bars_invalid++;
+        return;
+    }
+    if (stream->bar_time <= stream->known_until) {
+        stream->bars_skipped++;
+        return;
+    }
+    if (!stream->series) {
+        stream->series = history_store_series(stream->store, stream->symbol, 1);
+    }
+    if (!stream->series || !price_series_append(stream->series, stream->bar_time, stream->fields[0],
+                                                stream->fields[1], stream->fields[2],
+                                                stream->fields[3], stream->fields[4])) {
+        stream->failed = "out of memory";
+        return;
+    }
+    stream->bars_added++;
+}
+
+// An object opened at the current depth
+static void stream_object_start(SeriesStream* stream) {
+    int depth = stream->depth;
+    if (depth == 2) {
+        const char* key = stream->keys[1];
+        stream->section = strncmp(key, "Time Series", 11) == 0 ? SECTION_SERIES
+                        : strcmp(key, "Meta Data") == 0 ? SECTION_META : SECTION_OTHER;
+    } else if (depth == 3 && stream->section == SECTION_SERIES) {
+        // The key is the bar time: "YYYY-MM-DD" or "YYYY-MM-DD HH:MM:SS"
+        const char* key = stream->keys[2];
+        stream->field_mask = 0;
+        stream->bar_time = LLONG_MIN;
+        if (key[0] >= '0' && key[0] <= '9') {
+            long long when = parse_history_timestamp(key);
+            if (stream->eastern && strlen(key) > 10) {
+                when += eastern_to_utc_offset(when);
+            }
+            stream->bar_time = when;
+        }
+    }
+}
+
+// A string or literal value arrived for the current key
+static void stream_value(SeriesStream* stream, const char* value) {
+    int depth = stream->depth;
+    const char* key = stream->keys[depth];
+    if (depth == 1 && (strcmp(key, "Note") == 0 || strcmp(key, "Information") == 0 ||
+                       strcmp(key, "Error Message") == 0)) {
+        // Rate limit notices and errors come back as 200s with a message
+        strcpy(stream->message, value);
+    } else if (depth == 2 && stream->section == SECTION_META) {
+        if (strstr(key, "Time Zone")) {
+            stream->eastern = strcmp(value, "US/Eastern") == 0;
+        }
+    } else if (depth == 3 && stream->section == SECTION_SERIES) {
+        // "1. open" ... "5. volume"; other fields (adjusted close) are ignored
+        const char* name = strchr(key, ' ');
+        name = name ? name + 1 : key;
+        for (int f = 0; f < 5; f++) {
+            if (strcmp(name, BAR_FIELDS[f]) == 0) {
+                char* end;
+                stream->fields[f] = strtod(value, &end);
+                if (end != value && *end == '\0') {
+                    stream->field_mask |= 1u << f;
+                }
+                break;
+            }
+        }
+    }
+}
+
+// A complete string or literal token
+static void stream_token_done(SeriesStream* stream, int is_string) {
+    stream->token[stream->token_length] = '\0';
+    int depth = stream->depth;
+    if (is_string && depth > 0 && stream->is_object[depth] && stream->expect_key) {
+        strcpy(stream->keys[depth], stream->token);
+        stream->expect_key = 0;
+    } else {
+        stream_value(stream, stream->token);
+    }
+    stream->token_length = 0;
+}
+
+// Append to the token; longer tokens are truncated (no key or number we use is that long)
+static void stream_token_add(SeriesStream* stream, char c) {
+    if (stream->token_length < SERIES_STREAM_TOKEN - 1) {
+        stream->token[stream->token_length++] = c;
+    }
+}
+
+// Structure and whitespace between tokens
+static void stream_between(SeriesStream* stream, char c) {
+    switch (c) {
+        case ' ': case '\t': case '\n': case '\r': case ':':
+            break;
+        case '{':
+        case '[':
+            if (stream->depth == SERIES_STREAM_MAX_DEPTH - 1) {
+                stream->failed = "nested too deeply";
+                return;
+            }
+            stream->depth++;
+            stream->is_object[stream->depth] = c == '{';
+            stream->expect_key = c == '{';
+            stream->keys[stream->depth][0] = '\0';
+            if (c == '{') {
+                stream_object_start(stream);
+            }
+            break;
+        case '}':
+        case ']':
+            if (stream->depth == 0 || stream->is_object[stream->depth] != (c == '}')) {
+                stream->failed = "mismatched bracket";
+                return;
+            }
+            if (stream->depth == 3 && stream->section == SECTION_SERIES) {
+                stream_emit_bar(stream);
+            }
+            stream->depth--;
+            if (stream->depth == 0) {
+                stream->complete = 1;
+            }
+            break;
+        case ',':
+            stream->expect_key = stream->is_object[stream->depth];
+            break;
+        case '"':
+            stream->state = STREAM_STRING;
+            break;
+        default:
+            stream_token_add(stream, c);
+            stream->state = STREAM_LITERAL;
+            break;
+    }
+}
+
+// Feed the next bytes of a response
+int series_stream_feed(SeriesStream* stream, const char* data, size_t size) {
+    if (!stream || stream->failed) {
+        return 0;
+    }
+    stream->bytes += (long long)size;
+    for (size_t i = 0; i < size && !stream->failed; i++) {
+        char c = data[i];
+        switch (stream->state) {
+            case STREAM_BETWEEN:
+                stream_between(stream, c);
+                break;
+            case STREAM_STRING:
+                if (c == '\\') {
+                    stream->state = STREAM_ESCAPE;
+                } else if (c == '"') {
+                    stream->state = STREAM_BETWEEN;
+                    stream_token_done(stream, 1);
+                } else {
+                    stream_token_add(stream, c);
+                }
+                break;
+            case STREAM_ESCAPE:
+                stream_token_add(stream, c == 'n' ? '\n' : c == 't' ? '\t' : c);
+                stream->state = STREAM_STRING;
+                break;
+            case STREAM_LITERAL:
+                if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '.' || c == '-' ||
+                    c == '+' || c == 'E') {
+                    stream_token_add(stream, c);
+                } else {
+                    stream->state = STREAM_BETWEEN;
+                    stream_token_done(stream, 0);
+                    stream_between(stream, c);
+                }
+                break;
+        }
+    }
+    return !stream->failed;
+}
+
+// Undo every bar the stream added
+void series_stream_abort(SeriesStream* stream) {
+    if (!stream) {
+        return;
+    }
+    if (stream->series) {
+        stream->series->count = stream->start_count;
+    }
+    stream->bars_added = 0;
+}
+
+// Check the response was a complete time series and put its bars in order
+int series_stream_finish(SeriesStream* stream) {
+    if (!stream) {
+        return -1;
+    }
+    if (!stream->failed && !stream->complete) {
+        stream->failed = "response ended early";
+    }
+    if (!stream->failed && stream->bars_added == 0 && stream->bars_skipped == 0) {
+        stream->failed = stream->message[0] ? stream->message : "no time series in the response";
+    }
+    if (stream->failed) {
+        series_stream_abort(stream);
+        return -1;
+    }
+    // Responses list the newest bar first
+    if (stream->series && !price_series_sort(stream->series)) {
+        stream->failed = "out of memory";
+        series_stream_abort(stream);
+        return -1;
+    }
+    return (int)stream->bars_added;
+}
+
+// Stream a saved response from disk in network-sized blocks
+static int stream_file(SeriesStream* stream, const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        fprintf(stderr, "❌ Cannot open %s\n", filename);
+        return 0;
+    }
+    char block[16384];
+    size_t length;
+    int ok = 1;
+    while (ok && (length = fread(block, 1, sizeof(block), file)) > 0) {
+        ok = series_stream_feed(stream, block, length);
+    }
+    if (ferror(file)) {
+        fprintf(stderr, "❌ Cannot read %s\n", filename);
+        ok = 0;
+    }
+    fclose(file);
+    return ok;
+}
+
+// Command line entry for "stock_tracker history ..."
+int run_history_command(int argc, char* argv[]) {
+    const char* interval = "daily";
+    const char* input = NULL;
+    const char* output = NULL;
+    int symbol_count = 0;
+    char (*symbols)[MAX_SYMBOL_LENGTH] = malloc((size_t)argc * sizeof(*symbols));
+    if (!symbols) {
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            interval = argv[++i];
+        } else if (strcmp(argv[i], "--input") == 0 && i + 1 < argc) {
+            input = argv[++i];
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (argv[i][0] != '-') {
+            if (!validate_stock_symbol(argv[i], symbols[symbol_count], sizeof(symbols[symbol_count]))) {
+                fprintf(stderr, "❌ Invalid symbol: %s (1-%d letters, digits, '.' or '-')\n",
+                        argv[i], MAX_SYMBOL_LENGTH - 1);
+                free(symbols);
+                return 1;
+            }
+            symbol_count++;
+        } else {
+            fprintf(stderr, "❌ Unknown history option: %s\n", argv[i]);
+            free(symbols);
+            return 1;
+        }
+    }
+    if (symbol_count == 0 || (input && symbol_count != 1)) {
+        fprintf(stderr, "usage: stock_tracker history SYMBOL... [--interval 1min|5min|15min|30min|60min|daily] "
+                        "[--input saved_response.json] [--output file.csv|file%s]\n", HISTORY_SEGMENT_EXTENSION);
+        free(symbols);
+        return 1;
+    }
+
+    // New bars are merged into an existing output file
+    HistoryStore store;
+    int opened = output && access(output, R_OK) == 0 ? history_store_open(&store, output, 0, 0, 0)
+                                                      : history_store_init(&store);
+    if (!opened) {
+        free(symbols);
+        return 1;
+    }
+
+    printf("📜 TIME SERIES DOWNLOAD (%s)\n", interval);
+    printf("══════════════════════════════\n");
+    int failures = 0;
+    for (int s = 0; s < symbol_count; s++) {
+        long long start = metrics_now_ns();
+        int added;
+        if (input) {
+            SeriesStream stream;
+            if (!series_stream_init(&stream, &store, symbols[s])) {
+                fprintf(stderr, "❌ Invalid symbol: %s (1-%d characters)\n", symbols[s], MAX_SYMBOL_LENGTH - 1);
+                added = -1;
+            } else if (!stream_file(&stream, input)) {
+                // Bars parsed before a bad token or read error are rolled back
+                series_stream_abort(&stream);
+                if (stream.failed) {
+                    fprintf(stderr, "❌ %s: %s\n", input, stream.failed);
+                }
+                added = -1;
+            } else {
+                added = series_stream_finish(&stream);
+                if (added < 0) {
+                    fprintf(stderr, "❌ %s: %s\n", input, stream.failed);
+                }
+            }
+        } else {
+            added = fetch_stock_history(symbols[s], interval, &store);
+        }
+        double seconds = (metrics_now_ns() - start) / 1e9;
+        const PriceSeries* series = history_store_series(&store, symbols[s], 0);
+        if (added < 0) {
+            failures++;
+        } else {
+            printf("• %s: %d new bars in %.3fs, %d stored\n", symbols[s], added, seconds,
+                   series ? series->count : 0);
+        }
+    }
+
+    int ok = failures == 0;
+    if (output && history_store_bar_count(&store) > 0) {
+        size_t length = strlen(output);
+        size_t suffix = strlen(HISTORY_SEGMENT_EXTENSION);
+        int segment = length > suffix && strcmp(output + length - suffix, HISTORY_SEGMENT_EXTENSION) == 0;
+        if (segment ? history_segment_write(&store, output, NULL) >= 0
+                    : history_store_write_csv(&store, output) >= 0) {
+            printf("• Written to %s\n", output);
+        } else {
+            ok = 0;
+        }
+    }
+    history_store_free(&store);
+    free(symbols);
+    return ok ? 0 : 1;
+}
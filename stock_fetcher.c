@@ -7,9 +7,59 @@
 
 #include "stock_tracker.h"
 #include <ctype.h>
+#include <pthread.h>
+#include <time.h>
 
-// Global curl handle for reuse
+// Global curl handle for reuse, plus a second one for hedged duplicates
 static CURL *curl_handle = NULL;
+static CURL *hedge_handle = NULL;
+
+// Every fetcher transfer runs on this multi handle, which owns the
+// keep-alive connection pool (used from the calling thread only)
+static CURLM *fetch_multi = NULL;
+
+// DNS cache and TLS sessions, shared by every fetch handle on any thread.
+// Connections are not shared: libcurl does not support a shared connection
+// pool across threads, even with locking
+static CURLSH *fetch_share = NULL;
+static pthread_mutex_t share_locks[CURL_LOCK_DATA_LAST];
+
+// Circuit breaker states
+#define BREAKER_CLOSED 0
+#define BREAKER_OPEN 1
+#define BREAKER_HALF_OPEN 2
+
+// Per-host circuit breaker
+typedef struct {
+    char host[MAX_NAME_LENGTH];
+    int state;
+    int failures;             // Consecutive failed attempts
+    long long opened_ns;
+} HostBreaker;
+
+static HostBreaker breakers[FETCH_MAX_HOSTS];
+static int breaker_count = 0;
+
+// Latencies of recent successful requests, for the hedge delay
+static long long recent_latency_ns[FETCH_LATENCY_WINDOW];
+static int latency_samples = 0;
+
+// Last good quote per symbol, served while the API is failing
+static SymbolMap last_good_symbols;
+static Stock* last_good = NULL;
+static int last_good_capacity = 0;
+static unsigned long long jitter_state = 0;
+
+// Fixed quote clock for deterministic replays (0 = use the wall clock)
+static time_t quote_clock_override = 0;
+
+// HTTP requests started (hedges and retries included), and whether quote
+// fetches are limited to one request each for a rate-limited API key
+static long long requests_sent = 0;
+static int single_request = 0;
+
+// Directory the dashboard JSON files are published to
+static char public_data_dir[MAX_URL_LENGTH] = PUBLIC_DATA_DIR;
 
 // Company names mapping for popular stocks
 const char* get_company_name(const char* symbol) {
@@ -26,6 +76,26 @@ const char* get_company_name(const char* symbol) {
     return "Unknown Company";
 }
 
+// Pin the time stamped on parsed quotes (replays use the recorded time)
+void set_quote_clock(time_t when) {
+    quote_clock_override = when;
+}
+
+// Time stamped on parsed quotes
+time_t current_quote_time() {
+    return quote_clock_override != 0 ? quote_clock_override : time(NULL);
+}
+
+// One request per quote: no retries and no hedged duplicate
+void set_fetch_single_request(int enabled) {
+    single_request = enabled;
+}
+
+// HTTP requests started so far
+long long fetch_request_count() {
+    return requests_sent;
+}
+
 // Callback function to write API response data
 size_t WriteCallback(void *contents, size_t size, size_t nmemb, APIResponse *response) {
     size_t total_size = size * nmemb;
@@ -45,31 +115,122 @@ size_t WriteCallback(void *contents, size_t size, size_t nmemb, APIResponse *res
     return total_size;
 }
 
+// Callback function for time-series downloads: bars are parsed and stored
+// as the bytes arrive instead of buffering the whole body
+static size_t SeriesStreamCallback(void *contents, size_t size, size_t nmemb, SeriesStream *stream) {
+    size_t total_size = size * nmemb;
+    return series_stream_feed(stream, contents, total_size) ? total_size : 0;
+}
+
+// Share-interface locking: one mutex per kind of shared data
+static void share_lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* user) {
+    (void)handle;
+    (void)access;
+    (void)user;
+    pthread_mutex_lock(&share_locks[data]);
+}
+
+static void share_unlock(CURL* handle, curl_lock_data data, void* user) {
+    (void)handle;
+    (void)user;
+    pthread_mutex_unlock(&share_locks[data]);
+}
+
+// Create a fetch handle on the shared DNS and TLS session caches
+CURL* fetch_handle_create() {
+    if (!fetch_share) {
+        return NULL;
+    }
+    CURL* handle = curl_easy_init();
+    if (!handle) {
+        return NULL;
+    }
+    
+    // Fail fast on connect and on stalled transfers instead of one flat
+    // timeout, and let retries and hedges absorb the slow tail
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, (long)FETCH_CONNECT_TIMEOUT_MS);
+    curl_easy_setopt(handle, CURLOPT_LOW_SPEED_LIMIT, (long)FETCH_LOW_SPEED_BYTES);
+    curl_easy_setopt(handle, CURLOPT_LOW_SPEED_TIME, (long)FETCH_LOW_SPEED_SECONDS);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, (long)FETCH_TIMEOUT_MS);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(handle, CURLOPT_USERAGENT, FETCH_USER_AGENT);
+    
+    // Verified TLS; the handshake is paid once per connection and resumed
+    // from the shared session cache after that
+    curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 1L);
+    curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 2L);
+    
+    // Keep-alive connections (pooled by the multi or easy handle that runs
+    // the transfer), multiplexed over HTTP/2 where the server offers it
+    curl_easy_setopt(handle, CURLOPT_SHARE, fetch_share);
+    curl_easy_setopt(handle, CURLOPT_DNS_CACHE_TIMEOUT, (long)FETCH_DNS_CACHE_SECONDS);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    return handle;
+}
+
 // Initialize libcurl
 int initialize_curl() {
     curl_global_init(CURL_GLOBAL_DEFAULT);
-    curl_handle = curl_easy_init();
     
-    if (!curl_handle) {
+    fetch_share = curl_share_init();
+    if (!fetch_share) {
         printf("❌ Failed to initialize curl!\n");
         return 0;
     }
+    for (int i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+        pthread_mutex_init(&share_locks[i], NULL);
+    }
+    curl_share_setopt(fetch_share, CURLSHOPT_LOCKFUNC, share_lock);
+    curl_share_setopt(fetch_share, CURLSHOPT_UNLOCKFUNC, share_unlock);
+    curl_share_setopt(fetch_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(fetch_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
     
-    // Set common curl options
-    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, 30L);  // 30 second timeout
-    curl_easy_setopt(curl_handle, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl_handle, CURLOPT_SSL_VERIFYPEER, 0L);  // Skip SSL verification for simplicity
+    curl_handle = fetch_handle_create();
+    hedge_handle = fetch_handle_create();
+    fetch_multi = curl_multi_init();
+    if (!curl_handle || !hedge_handle || !fetch_multi || !symbol_map_init(&last_good_symbols, 64)) {
+        printf("❌ Failed to initialize curl!\n");
+        cleanup_curl();
+        return 0;
+    }
+    curl_multi_setopt(fetch_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(fetch_multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)FETCH_MAX_HOST_CONNECTIONS);
+    jitter_state = (unsigned long long)metrics_now_ns() | 1;
     
     return 1;
 }
 
 // Cleanup curl
 void cleanup_curl() {
+    if (fetch_multi) {
+        curl_multi_cleanup(fetch_multi);
+        fetch_multi = NULL;
+    }
     if (curl_handle) {
         curl_easy_cleanup(curl_handle);
         curl_handle = NULL;
     }
+    if (hedge_handle) {
+        curl_easy_cleanup(hedge_handle);
+        hedge_handle = NULL;
+    }
+    
+    // The share goes last; handles using it must be gone
+    if (fetch_share) {
+        curl_share_cleanup(fetch_share);
+        fetch_share = NULL;
+        for (int i = 0; i < CURL_LOCK_DATA_LAST; i++) {
+            pthread_mutex_destroy(&share_locks[i]);
+        }
+    }
+    free(last_good);
+    last_good = NULL;
+    last_good_capacity = 0;
+    symbol_map_free(&last_good_symbols);
     curl_global_cleanup();
 }
 
@@ -84,38 +245,10 @@ int parse_stock_json(const char* json_string, Stock* stock) {
     // Navigate through the JSON structure
     json_object *global_quote;
     if (!json_object_object_get_ex(root, "Global Quote", &global_quote)) {
-        // Try alternative structure or create demo data
-        printf("⚠️  Using demo data for %s (API limit reached)\n", stock->symbol);
-        
-        // Generate realistic demo data based on stock symbol
-        srand(time(NULL) + strlen(stock->symbol));
-        
-        if(strcmp(stock->symbol, "AAPL") == 0) {
-            stock->current_price = 175.0 + (rand() % 20) - 10;  // $165-185
-            stock->change_percent = ((rand() % 600) - 300) / 100.0;  // -3% to +3%
-        } else if(strcmp(stock->symbol, "TSLA") == 0) {
-            stock->current_price = 250.0 + (rand() % 50) - 25;  // $225-275
-            stock->change_percent = ((rand() % 800) - 400) / 100.0;  // -4% to +4%
-        } else if(strcmp(stock->symbol, "NVDA") == 0) {
-            stock->current_price = 450.0 + (rand() % 100) - 50;  // $400-500
-            stock->change_percent = ((rand() % 600) - 300) / 100.0;  // -3% to +3%
-        } else {
-            // Generic demo data for other stocks
-            stock->current_price = 100.0 + (rand() % 200);  // $100-300
-            stock->change_percent = ((rand() % 600) - 300) / 100.0;  // -3% to +3%
-        }
-        
-        stock->volume = 1000000 + (rand() % 5000000);  // 1M-6M volume
-        stock->previous_close = stock->current_price - (stock->current_price * stock->change_percent / 100.0);
-        stock->day_high = stock->current_price + (rand() % 5);
-        stock->day_low = stock->current_price - (rand() % 5);
-        stock->market_cap = stock->current_price * 1000000000;  // Simplified market cap
-        
-        strcpy(stock->name, get_company_name(stock->symbol));
-        time(&stock->last_update);
-        
+        // Rate limit notices and errors arrive as 200s with a message instead
+        printf("⚠️  No quote in response for %s (API limit reached?)\n", stock->symbol);
         json_object_put(root);
-        return 1;
+        return 0;
     }
     
     // Extract data from JSON
@@ -168,13 +301,255 @@ int parse_stock_json(const char* json_string, Stock* stock) {
     
     // Set company name and update time
     strcpy(stock->name, get_company_name(stock->symbol));
-    time(&stock->last_update);
+    stock->last_update = current_quote_time();
     
     json_object_put(root);
     return 1;
 }
 
-// Fetch stock data from Alpha Vantage API
+// Record curl's connection phase timings (cumulative microseconds from request start)
+static void record_transfer_timings(CURL* handle) {
+    curl_off_t dns = 0, connect = 0, tls = 0, pretransfer = 0, total = 0;
+    long new_connections = 0;
+    
+    curl_easy_getinfo(handle, CURLINFO_NAMELOOKUP_TIME_T, &dns);
+    curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME_T, &connect);
+    curl_easy_getinfo(handle, CURLINFO_APPCONNECT_TIME_T, &tls);
+    curl_easy_getinfo(handle, CURLINFO_PRETRANSFER_TIME_T, &pretransfer);
+    curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME_T, &total);
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &new_connections);
+    
+    // Reused connections skip DNS/connect/TLS, so only sample them for new ones
+    metrics_increment(new_connections > 0 ? METRIC_CONNECTION_NEW : METRIC_CONNECTION_REUSED);
+    if (new_connections > 0) {
+        metrics_record_stage(METRIC_DNS, (long long)dns * 1000);
+        metrics_record_stage(METRIC_CONNECT, (long long)(connect - dns) * 1000);
+        if (tls > 0) {
+            metrics_record_stage(METRIC_TLS, (long long)(tls - connect) * 1000);
+        }
+    }
+    metrics_record_stage(METRIC_TRANSFER, (long long)(total - pretransfer) * 1000);
+}
+
+// Breaker for the host part of a URL (hosts past FETCH_MAX_HOSTS share the last slot)
+static HostBreaker* breaker_for(const char* url) {
+    char host[MAX_NAME_LENGTH];
+    const char* begin = strstr(url, "://");
+    begin = begin ? begin + 3 : url;
+    size_t length = strcspn(begin, "/:?");
+    if (length >= sizeof(host)) {
+        length = sizeof(host) - 1;
+    }
+    memcpy(host, begin, length);
+    host[length] = '\0';
+
+    for (int i = 0; i < breaker_count; i++) {
+        if (strcmp(breakers[i].host, host) == 0) {
+            return &breakers[i];
+        }
+    }
+    if (breaker_count == FETCH_MAX_HOSTS) {
+        return &breakers[FETCH_MAX_HOSTS - 1];
+    }
+    HostBreaker* breaker = &breakers[breaker_count++];
+    memset(breaker, 0, sizeof(*breaker));
+    strcpy(breaker->host, host);
+    return breaker;
+}
+
+// Open breakers reject requests until the cooldown ends, then let one trial through
+static int breaker_allows(HostBreaker* breaker) {
+    if (breaker->state == BREAKER_OPEN &&
+        metrics_now_ns() - breaker->opened_ns >= FETCH_BREAKER_COOLDOWN_SECONDS * 1000000000LL) {
+        breaker->state = BREAKER_HALF_OPEN;
+    }
+    return breaker->state != BREAKER_OPEN;
+}
+
+static void breaker_record(HostBreaker* breaker, int success) {
+    if (success) {
+        if (breaker->state != BREAKER_CLOSED) {
+            printf("🔌 Circuit closed for %s\n", breaker->host);
+        }
+        breaker->state = BREAKER_CLOSED;
+        breaker->failures = 0;
+        return;
+    }
+    breaker->failures++;
+    if (breaker->state == BREAKER_HALF_OPEN || breaker->failures >= FETCH_BREAKER_FAILURES) {
+        if (breaker->state != BREAKER_OPEN) {
+            printf("🚧 Circuit open for %s after %d failures, retrying in %ds\n",
+                   breaker->host, breaker->failures, FETCH_BREAKER_COOLDOWN_SECONDS);
+        }
+        breaker->state = BREAKER_OPEN;
+        breaker->opened_ns = metrics_now_ns();
+    }
+}
+
+static int compare_latency(const void* a, const void* b) {
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+// Rolling percentile of recent successful requests, -1 until there are enough
+static long long hedge_delay_ns() {
+    int count = latency_samples < FETCH_LATENCY_WINDOW ? latency_samples : FETCH_LATENCY_WINDOW;
+    if (count < FETCH_HEDGE_MIN_SAMPLES) {
+        return -1;
+    }
+    long long sorted[FETCH_LATENCY_WINDOW];
+    memcpy(sorted, recent_latency_ns, (size_t)count * sizeof(long long));
+    qsort(sorted, count, sizeof(long long), compare_latency);
+    return sorted[(int)(FETCH_HEDGE_PERCENTILE / 100.0 * (count - 1))];
+}
+
+// Full-jitter exponential backoff: uniform in [0, min(max, base * 2^retry)]
+static void backoff_sleep(int retry) {
+    long long ceiling = (long long)FETCH_BACKOFF_BASE_MS << (retry < 16 ? retry : 16);
+    if (ceiling > FETCH_BACKOFF_MAX_MS) {
+        ceiling = FETCH_BACKOFF_MAX_MS;
+    }
+    jitter_state ^= jitter_state << 13;
+    jitter_state ^= jitter_state >> 7;
+    jitter_state ^= jitter_state << 17;
+    long long delay_ms = (long long)(jitter_state % (unsigned long long)(ceiling + 1));
+    struct timespec pause = {(time_t)(delay_ms / 1000), (long)(delay_ms % 1000) * 1000000L};
+    nanosleep(&pause, NULL);
+}
+
+static int response_ok(CURL* handle, CURLcode result) {
+    long code = 0;
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &code);
+    return result == CURLE_OK && code == 200;
+}
+
+// One attempt: the primary request, plus a duplicate on the second handle if
+// the primary is still running at the rolling p95. The first good response
+// wins and the other transfer is abandoned.
+static CURLcode perform_hedged(const char* url, APIResponse* response, long* response_code) {
+    APIResponse bodies[2] = {{NULL, 0}, {NULL, 0}};
+    response->data = NULL;
+    response->size = 0;
+    CURL* handles[2] = {curl_handle, hedge_handle};
+    CURLcode results[2] = {CURLE_OK, CURLE_OK};
+    int active[2] = {0, 0};
+    int done[2] = {0, 0};
+    int winner = -1;
+    long long hedge_after = single_request ? -1 : hedge_delay_ns();
+    long long start = metrics_now_ns();
+
+    for (int h = 0; h < 2; h++) {
+        bodies[h].data = malloc(1);
+        if (!bodies[h].data) {
+            free(bodies[0].data);
+            return CURLE_OUT_OF_MEMORY;
+        }
+        bodies[h].data[0] = '\0';
+        curl_easy_setopt(handles[h], CURLOPT_URL, url);
+        curl_easy_setopt(handles[h], CURLOPT_WRITEDATA, &bodies[h]);
+    }
+    curl_multi_add_handle(fetch_multi, handles[0]);
+    active[0] = 1;
+    requests_sent++;
+
+    while (winner < 0 && (active[0] || active[1])) {
+        int running = 0;
+        curl_multi_perform(fetch_multi, &running);
+
+        CURLMsg* message;
+        int queued;
+        while ((message = curl_multi_info_read(fetch_multi, &queued)) != NULL) {
+            if (message->msg != CURLMSG_DONE) {
+                continue;
+            }
+            int h = message->easy_handle == handles[0] ? 0 : 1;
+            results[h] = message->data.result;
+            done[h] = 1;
+            curl_multi_remove_handle(fetch_multi, handles[h]);
+            active[h] = 0;
+            if (winner < 0 && response_ok(handles[h], results[h])) {
+                winner = h;
+            }
+        }
+        if (winner >= 0) {
+            break;
+        }
+
+        long long elapsed = metrics_now_ns() - start;
+        if (!active[1] && !done[1] && !done[0] && hedge_after >= 0 && elapsed >= hedge_after) {
+            curl_multi_add_handle(fetch_multi, handles[1]);
+            active[1] = 1;
+            requests_sent++;
+            metrics_increment(METRIC_FETCH_HEDGED);
+            continue;
+        }
+        if (active[0] || active[1]) {
+            int wait_ms = 100;
+            if (!active[1] && !done[1] && hedge_after >= 0) {
+                long long until_hedge = (hedge_after - elapsed) / 1000000 + 1;
+                wait_ms = until_hedge < wait_ms ? (int)until_hedge : wait_ms;
+            }
+            curl_multi_poll(fetch_multi, NULL, 0, wait_ms, NULL);
+        }
+    }
+
+    // Abandon whichever transfer lost
+    for (int h = 0; h < 2; h++) {
+        if (active[h]) {
+            curl_multi_remove_handle(fetch_multi, handles[h]);
+        }
+    }
+
+    int reported = winner >= 0 ? winner : (done[1] && !done[0] ? 1 : 0);
+    *response = bodies[reported];
+    free(bodies[1 - reported].data);
+    curl_easy_getinfo(handles[reported], CURLINFO_RESPONSE_CODE, response_code);
+    if (winner >= 0) {
+        record_transfer_timings(handles[winner]);
+        recent_latency_ns[latency_samples++ % FETCH_LATENCY_WINDOW] = metrics_now_ns() - start;
+    }
+    return results[reported];
+}
+
+// Remember a good quote for outages
+static void remember_good_quote(const Stock* stock) {
+    int id = symbol_map_find(&last_good_symbols, stock->symbol);
+    if (id < 0) {
+        // Room first, so every symbol in the map has a stored quote
+        if (last_good_symbols.count >= last_good_capacity) {
+            int new_capacity = last_good_capacity ? last_good_capacity * 2 : 64;
+            Stock* grown = realloc(last_good, (size_t)new_capacity * sizeof(Stock));
+            if (!grown) {
+                return;
+            }
+            last_good = grown;
+            last_good_capacity = new_capacity;
+        }
+        id = symbol_map_insert(&last_good_symbols, stock->symbol);
+        if (id < 0) {
+            return;
+        }
+    }
+    last_good[id] = *stock;
+}
+
+// Serve the last good quote if it is recent enough
+static int serve_last_good(const char* symbol, Stock* stock) {
+    int id = symbol_map_find(&last_good_symbols, symbol);
+    if (id < 0 || id >= last_good_capacity) {
+        return 0;
+    }
+    long age = (long)(time(NULL) - last_good[id].last_update);
+    if (age > FETCH_STALE_SECONDS) {
+        return 0;
+    }
+    *stock = last_good[id];
+    metrics_increment(METRIC_CACHE_HIT);
+    printf("♻️  Using last good data for %s ($%.2f, %lds old)\n", symbol, stock->current_price, age);
+    return 1;
+}
+
+// Fetch stock data from Alpha Vantage API, with retries, hedging and a circuit breaker
 int fetch_stock_data(const char* symbol, Stock* stock) {
     if (!curl_handle && !initialize_curl()) {
         return 0;
@@ -186,83 +561,219 @@ int fetch_stock_data(const char* symbol, Stock* stock) {
              "%s?function=GLOBAL_QUOTE&symbol=%s&apikey=%s",
              ALPHA_VANTAGE_BASE_URL, symbol, API_KEY);
     
-    // Initialize response structure
-    APIResponse response;
-    response.data = malloc(1);
-    response.size = 0;
+    long long fetch_start = metrics_now_ns();
+    HostBreaker* breaker = breaker_for(url);
+    int success = 0;
+    int attempts = single_request ? 1 : FETCH_MAX_ATTEMPTS;
     
-    if (!response.data) {
-        printf("❌ Memory allocation failed for %s\n", symbol);
-        return 0;
+    for (int attempt = 0; attempt < attempts && !success; attempt++) {
+        if (!breaker_allows(breaker)) {
+            metrics_increment(METRIC_BREAKER_REJECTED);
+            break;
+        }
+        if (attempt > 0) {
+            metrics_increment(METRIC_FETCH_RETRY);
+            backoff_sleep(attempt - 1);
+        }
+        
+        APIResponse response;
+        long response_code = 0;
+        CURLcode res = perform_hedged(url, &response, &response_code);
+        if (res == CURLE_OUT_OF_MEMORY && !response.data) {
+            printf("❌ Memory allocation failed for %s\n", symbol);
+            break;
+        }
+        
+        if (res != CURLE_OK) {
+            printf("❌ API request failed for %s: %s\n", symbol, curl_easy_strerror(res));
+            breaker_record(breaker, 0);
+            free(response.data);
+            continue;  // Timeouts and connection errors are worth another try
+        }
+        
+        // Check HTTP response code
+        metrics_record_http_code(response_code);
+        if (response_code != 200) {
+            printf("❌ HTTP error %ld for %s\n", response_code, symbol);
+            free(response.data);
+            if (response_code == 429 || response_code >= 500) {
+                breaker_record(breaker, 0);
+                continue;
+            }
+            break;  // Other client errors will not change on a retry
+        }
+        breaker_record(breaker, 1);
+        
+        // Keep the raw response when a recording is active
+        recorder_write(symbol, response.data, response.size);
+        
+        // Parse the JSON response
+        long long parse_start = metrics_now_ns();
+        success = parse_stock_json(response.data, stock);
+        metrics_record_stage(METRIC_PARSE, metrics_now_ns() - parse_start);
+        
+        // Cleanup
+        free(response.data);
+        if (!success) {
+            break;  // The same body would come back; not worth a retry
+        }
     }
     
-    // Set curl options for this request
-    curl_easy_setopt(curl_handle, CURLOPT_URL, url);
-    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &response);
-    
-    // Perform the request
-    CURLcode res = curl_easy_perform(curl_handle);
+    metrics_record_stage(METRIC_FETCH, metrics_now_ns() - fetch_start);
+    if (success) {
+        printf("✅ Fetched data for %s: $%.2f (%.2f%%)\n", 
+               symbol, stock->current_price, stock->change_percent);
+        metrics_increment(METRIC_FETCH_SUCCESS);
+        remember_good_quote(stock);
+        return 1;
+    }
+    metrics_increment(METRIC_FETCH_FAILURE);
     
-    if (res != CURLE_OK) {
-        printf("❌ API request failed for %s: %s\n", symbol, curl_easy_strerror(res));
-        free(response.data);
-        return 0;
+    // Stale but valid beats showing zeros during an outage
+    return serve_last_good(symbol, stock);
+}
+
+// Run one transfer to completion on the fetcher's multi handle, so it
+// reuses the quote fetches' pooled connections
+static CURLcode perform_on_multi(CURL* handle) {
+    CURLcode result = CURLE_OK;
+    int finished = 0;
+    curl_multi_add_handle(fetch_multi, handle);
+    requests_sent++;
+    while (!finished) {
+        int running = 0;
+        if (curl_multi_perform(fetch_multi, &running) != CURLM_OK) {
+            result = CURLE_FAILED_INIT;
+            break;
+        }
+        CURLMsg* message;
+        int queued;
+        while ((message = curl_multi_info_read(fetch_multi, &queued)) != NULL) {
+            if (message->msg == CURLMSG_DONE && message->easy_handle == handle) {
+                result = message->data.result;
+                finished = 1;
+            }
+        }
+        if (!finished) {
+            curl_multi_poll(fetch_multi, NULL, 0, 100, NULL);
+        }
+    }
+    curl_multi_remove_handle(fetch_multi, handle);
+    return result;
+}
+
+// Download a full intraday or daily time series straight into a history store
+int fetch_stock_history(const char* symbol, const char* interval, HistoryStore* store) {
+    static const char* INTERVALS[] = {"1min", "5min", "15min", "30min", "60min", "daily"};
+    if (!symbol || !interval || !store) {
+        return -1;
     }
     
-    // Check HTTP response code
-    long response_code;
-    curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &response_code);
+    // Both go into the URL, so nothing outside the known values gets through
+    char clean[MAX_SYMBOL_LENGTH];
+    if (!validate_stock_symbol(symbol, clean, sizeof(clean)) || strcmp(clean, symbol) != 0) {
+        printf("❌ Invalid symbol: %s\n", symbol);
+        return -1;
+    }
+    int known_interval = 0;
+    for (size_t i = 0; i < sizeof(INTERVALS) / sizeof(INTERVALS[0]); i++) {
+        known_interval |= strcmp(interval, INTERVALS[i]) == 0;
+    }
+    if (!known_interval) {
+        printf("❌ Invalid interval: %s (1min, 5min, 15min, 30min, 60min or daily)\n", interval);
+        return -1;
+    }
+    if (!curl_handle && !initialize_curl()) {
+        return -1;
+    }
     
-    if (response_code != 200) {
-        printf("❌ HTTP error %ld for %s\n", response_code, symbol);
-        free(response.data);
-        return 0;
+    // Build API URL
+    char url[MAX_URL_LENGTH];
+    if (strcmp(interval, "daily") == 0) {
+        snprintf(url, sizeof(url),
+                 "%s?function=TIME_SERIES_DAILY&symbol=%s&outputsize=full&apikey=%s",
+                 ALPHA_VANTAGE_BASE_URL, symbol, API_KEY);
+    } else {
+        snprintf(url, sizeof(url),
+                 "%s?function=TIME_SERIES_INTRADAY&symbol=%s&interval=%s&outputsize=full&apikey=%s",
+                 ALPHA_VANTAGE_BASE_URL, symbol, interval, API_KEY);
     }
     
-    // Parse the JSON response
-    int success = parse_stock_json(response.data, stock);
+    CURL* handle = fetch_handle_create();
+    if (!handle) {
+        return -1;
+    }
+    curl_easy_setopt(handle, CURLOPT_URL, url);
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, SeriesStreamCallback);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, (long)FETCH_HISTORY_TIMEOUT_MS);
     
-    // Cleanup
-    free(response.data);
+    long long fetch_start = metrics_now_ns();
+    HostBreaker* breaker = breaker_for(url);
+    SeriesStream stream;
+    int added = -1;
     
-    if (success) {
-        printf("✅ Fetched data for %s: $%.2f (%.2f%%)\n", 
-               symbol, stock->current_price, stock->change_percent);
+    for (int attempt = 0; attempt < FETCH_MAX_ATTEMPTS && added < 0; attempt++) {
+        if (!breaker_allows(breaker)) {
+            metrics_increment(METRIC_BREAKER_REJECTED);
+            break;
+        }
+        if (attempt > 0) {
+            metrics_increment(METRIC_FETCH_RETRY);
+            backoff_sleep(attempt - 1);
+        }
+        if (!series_stream_init(&stream, store, symbol)) {
+            break;
+        }
+        curl_easy_setopt(handle, CURLOPT_WRITEDATA, &stream);
+        
+        CURLcode res = perform_on_multi(handle);
+        long response_code = 0;
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response_code);
+        if (stream.failed) {
+            // The same body would come back; not worth a retry
+            printf("❌ Bad time series for %s: %s\n", symbol, stream.failed);
+            series_stream_abort(&stream);
+            break;
+        }
+        if (res != CURLE_OK) {
+            // Drop the partial download; the retry starts over
+            printf("❌ API request failed for %s: %s\n", symbol, curl_easy_strerror(res));
+            series_stream_abort(&stream);
+            breaker_record(breaker, 0);
+            continue;
+        }
+        record_transfer_timings(handle);
+        metrics_record_http_code(response_code);
+        if (response_code != 200) {
+            printf("❌ HTTP error %ld for %s\n", response_code, symbol);
+            series_stream_abort(&stream);
+            if (response_code == 429 || response_code >= 500) {
+                breaker_record(breaker, 0);
+                continue;
+            }
+            break;
+        }
+        breaker_record(breaker, 1);
+        
+        added = series_stream_finish(&stream);
+        if (added < 0) {
+            printf("❌ No time series for %s: %s\n", symbol, stream.failed);
+            break;
+        }
     }
     
-    return success;
+    curl_easy_cleanup(handle);
+    metrics_record_stage(METRIC_FETCH, metrics_now_ns() - fetch_start);
+    metrics_increment(added >= 0 ? METRIC_FETCH_SUCCESS : METRIC_FETCH_FAILURE);
+    return added;
 }
 
 // Alternative simple stock data fetcher (for demo purposes when API fails)
 int fetch_demo_stock_data(const char* symbol, Stock* stock) {
-    strcpy(stock->symbol, symbol);
-    strcpy(stock->name, get_company_name(symbol));
-    
-    // Generate realistic demo data
-    srand(time(NULL) + strlen(symbol));
-    
-    // Base prices for popular stocks
-    double base_price = 100.0;
-    if(strcmp(symbol, "AAPL") == 0) base_price = 175.0;
-    else if(strcmp(symbol, "TSLA") == 0) base_price = 250.0;
-    else if(strcmp(symbol, "NVDA") == 0) base_price = 450.0;
-    else if(strcmp(symbol, "MSFT") == 0) base_price = 350.0;
-    else if(strcmp(symbol, "GOOGL") == 0) base_price = 140.0;
-    else if(strcmp(symbol, "AMZN") == 0) base_price = 145.0;
-    else if(strcmp(symbol, "META") == 0) base_price = 320.0;
-    
-    // Add some realistic variation
-    stock->current_price = base_price + ((rand() % 20) - 10);
-    stock->change_percent = ((rand() % 600) - 300) / 100.0;  // -3% to +3%
-    stock->volume = 1000000 + (rand() % 5000000);
-    stock->previous_close = stock->current_price - (stock->current_price * stock->change_percent / 100.0);
-    stock->day_high = stock->current_price + (rand() % 5);
-    stock->day_low = stock->current_price - (rand() % 5);
-    stock->market_cap = stock->current_price * 1000000000;
-    
-    time(&stock->last_update);
-    
-    return 1;
+    if (!symbol || !stock) {
+        return 0;
+    }
+    return sim_demo_stock(symbol, time(NULL), stock);
 }
 
 // Validate stock symbol
@@ -271,12 +782,21 @@ int validate_stock_symbol(const char* symbol, char* clean_symbol, size_t size) {
         return 0;
     }
     
-    // Convert to uppercase and remove spaces
-    int j = 0;
-    for (int i = 0; symbol[i] && j < size - 1; i++) {
-        if (symbol[i] != ' ') {
-            clean_symbol[j++] = toupper(symbol[i]);
+    // Convert to uppercase and remove spaces. Symbols go into request URLs,
+    // so only ticker characters (BRK.B, RDS-A) are allowed, and a symbol
+    // that does not fit is rejected rather than cut short
+    size_t j = 0;
+    clean_symbol[0] = '\0';
+    for (int i = 0; symbol[i]; i++) {
+        unsigned char c = (unsigned char)symbol[i];
+        if (c == ' ') {
+            continue;
         }
+        if ((!isalnum(c) && c != '.' && c != '-') || j + 1 >= size) {
+            clean_symbol[0] = '\0';
+            return 0;
+        }
+        clean_symbol[j++] = (char)toupper(c);
     }
     clean_symbol[j] = '\0';
     
@@ -349,9 +869,62 @@ void format_percentage(double percentage, char* buffer, size_t size) {
     }
 }
 
+// Change the directory dashboard JSON files are published to
+void set_public_data_dir(const char* directory) {
+    if (!directory) {
+        return;
+    }
+    strncpy(public_data_dir, directory, sizeof(public_data_dir) - 1);
+    public_data_dir[sizeof(public_data_dir) - 1] = '\0';
+}
+
+// Build the full path of a published file
+static void public_path(const char* filename, char* path, size_t size) {
+    snprintf(path, size, "%s/%s", public_data_dir, filename);
+}
+
+// Write a serialized document to its public path.
+// Goes through a temporary file and rename() so readers never see a partial file.
+static int publish_json(const char* path, const char* buffer, size_t length) {
+    long long start = metrics_now_ns();
+    
+    char temp_path[MAX_URL_LENGTH * 2 + 8];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    
+    FILE* fp = fopen(temp_path, "w");
+    if (!fp) return 0;
+    
+    size_t written = fwrite(buffer, 1, length, fp);
+    int ok = (fclose(fp) == 0 && written == length);
+    if (ok) {
+        ok = (rename(temp_path, path) == 0);
+    } else {
+        remove(temp_path);
+    }
+    
+    metrics_record_stage(METRIC_PUBLISH, metrics_now_ns() - start);
+    return ok;
+}
+
+// Finish an in-memory document, record its serialize time and publish it
+static int finish_and_publish(FILE* fp, char** buffer, size_t* length,
+                              long long serialize_start, const char* filename) {
+    fclose(fp);
+    metrics_record_stage(METRIC_SERIALIZE, metrics_now_ns() - serialize_start);
+    
+    char path[MAX_URL_LENGTH * 2];
+    public_path(filename, path, sizeof(path));
+    int ok = (*buffer != NULL) && publish_json(path, *buffer, *length);
+    free(*buffer);
+    return ok;
+}
+
 // Write all stocks to JSON file (stocks.json)
 int write_all_stocks_json(Stock stocks[], int count) {
-    FILE* fp = fopen("/mnt/c/Users/LENOVO/OneDrive/Desktop/SmartStockTrackerUpdate/stock_market/public/stock.json", "w");
+    char* buffer = NULL;
+    size_t length = 0;
+    long long start = metrics_now_ns();
+    FILE* fp = open_memstream(&buffer, &length);
     if (!fp) return 0;
 
     fprintf(fp, "[\n");
@@ -365,14 +938,13 @@ int write_all_stocks_json(Stock stocks[], int count) {
         fprintf(fp, "  \"price\": %.2f,\n", stocks[i].current_price);
         fprintf(fp, "  \"change\": %.2f,\n", stocks[i].change_percent);
         fprintf(fp, "  \"volume\": %.0f,\n", stocks[i].volume);
-        fprintf(fp, "  \"status\": \"%s\"\n", stocks[i].status);
+        fprintf(fp, "  \"status\": \"%s\"\n", stock_status_label(stocks[i].status));
         fprintf(fp, " }");
         valid++;
     }
     fprintf(fp, "\n]\n");
 
-    fclose(fp);
-    return 1;
+    return finish_and_publish(fp, &buffer, &length, start, "stock.json");
 }
 
 
@@ -380,7 +952,11 @@ int write_all_stocks_json(Stock stocks[], int count) {
 int write_best_stock_json(Stock stocks[], int count) {
     Stock* best = find_best_performing_stock(stocks, count);
     if (!best) return 0;
-    FILE* fp = fopen("/mnt/c/Users/LENOVO/OneDrive/Desktop/SmartStockTrackerUpdate/stock_market/public/stock_of_the_day.json", "w");
+
+    char* buffer = NULL;
+    size_t length = 0;
+    long long start = metrics_now_ns();
+    FILE* fp = open_memstream(&buffer, &length);
     if (!fp) return 0;
 
     fprintf(fp, "{\n");
@@ -388,23 +964,32 @@ int write_best_stock_json(Stock stocks[], int count) {
     fprintf(fp, "  \"name\": \"%s\",\n", best->name);
     fprintf(fp, "  \"price\": %.2f,\n", best->current_price);
     fprintf(fp, "  \"change\": %.2f,\n", best->change_percent);
-    fprintf(fp, "  \"status\": \"%s\"\n", best->status);
+    fprintf(fp, "  \"status\": \"%s\"\n", stock_status_label(best->status));
     fprintf(fp, "}\n");
 
-    fclose(fp);
-    return 1;
+    return finish_and_publish(fp, &buffer, &length, start, "stock_of_the_day.json");
 }
 
 
 // Write top 5 trending gainers to JSON (trending_now.json)
 int write_trending_json(Stock stocks[], int count) {
+    if (!stocks || count <= 0) return 0;
+
     // Copy stocks to sort to avoid modifying original array
-    Stock sorted[count];
-    memcpy(sorted, stocks, count * sizeof(Stock));
+    // (heap copy: a stack array overflows for large universes)
+    Stock* sorted = malloc((size_t)count * sizeof(Stock));
+    if (!sorted) return 0;
+    memcpy(sorted, stocks, (size_t)count * sizeof(Stock));
     qsort(sorted, count, sizeof(Stock), compare_stock_change);
 
-    FILE* fp = fopen("/mnt/c/Users/LENOVO/OneDrive/Desktop/SmartStockTrackerUpdate/stock_market/public/trending_now.json", "w");
-    if (!fp) return 0;
+    char* buffer = NULL;
+    size_t length = 0;
+    long long start = metrics_now_ns();
+    FILE* fp = open_memstream(&buffer, &length);
+    if (!fp) {
+        free(sorted);
+        return 0;
+    }
 
     fprintf(fp, "[\n");
     int written = 0;
@@ -419,9 +1004,131 @@ int write_trending_json(Stock stocks[], int count) {
         written++;
     }
     fprintf(fp, "\n]\n");
+    free(sorted);
 
-    fclose(fp);
-    return 1;
+    return finish_and_publish(fp, &buffer, &length, start, "trending_now.json");
+}
+
+// Same file from the rank index: the top 5 are read off the change tree, no sort
+int write_ranked_trending_json(const RankIndex* index) {
+    if (!index) return 0;
+
+    int top[5];
+    int count = rank_index_range(index, RANK_BY_CHANGE, 1, 0, 5, top);
+
+    char* buffer = NULL;
+    size_t length = 0;
+    long long start = metrics_now_ns();
+    FILE* fp = open_memstream(&buffer, &length);
+    if (!fp) return 0;
+
+    fprintf(fp, "[\n");
+    for (int i = 0; i < count; i++) {
+        if (i > 0) fprintf(fp, ",\n");
+        fprintf(fp, " {\n");
+        fprintf(fp, "  \"symbol\": \"%s\",\n", rank_index_name(index, top[i]));
+        fprintf(fp, "  \"change\": %.2f,\n", rank_index_value(index, RANK_BY_CHANGE, top[i]));
+        fprintf(fp, "  \"price\": %.2f\n", rank_index_value(index, RANK_BY_PRICE, top[i]));
+        fprintf(fp, " }");
+    }
+    fprintf(fp, "\n]\n");
+
+    return finish_and_publish(fp, &buffer, &length, start, "trending_now.json");
+}
+
+// Write recently delivered alerts, newest first (alerts.json)
+int write_alerts_json(const AlertEvent events[], int count) {
+    if (!events || count < 0) return 0;
+
+    char* buffer = NULL;
+    size_t length = 0;
+    long long start = metrics_now_ns();
+    FILE* fp = open_memstream(&buffer, &length);
+    if (!fp) return 0;
+
+    fprintf(fp, "[\n");
+    for (int i = 0; i < count; i++) {
+        const AlertEvent* e = &events[i];
+        if (i > 0) fprintf(fp, ",\n");
+        fprintf(fp, " {\n");
+        fprintf(fp, "  \"symbol\": \"%s\",\n", e->symbol);
+        fprintf(fp, "  \"rule\": %d,\n", e->rule);
+        fprintf(fp, "  \"type\": \"%s\",\n", e->kind == ALERT_CROSSES ? "crosses" : "moves");
+        fprintf(fp, "  \"direction\": \"%s\",\n", e->direction > 0 ? "up" : "down");
+        fprintf(fp, "  \"threshold\": %.2f,\n", e->threshold);
+        fprintf(fp, "  \"price\": %.2f,\n", e->price);
+        fprintf(fp, "  \"change\": %.2f,\n", e->change_percent);
+        fprintf(fp, "  \"time\": %lld\n", e->time);
+        fprintf(fp, " }");
+    }
+    fprintf(fp, "\n]\n");
+
+    return finish_and_publish(fp, &buffer, &length, start, "alerts.json");
+}
+
+// Write the symbols whose latest volume is most unusual (unusual_volume.json)
+int write_unusual_volume_json(const VolumeProfile* profile) {
+    if (!profile) return 0;
+
+    int top[VOLUME_TOP_SYMBOLS];
+    int count = volume_profile_top(profile, VOLUME_TOP_SYMBOLS, top);
+
+    char* buffer = NULL;
+    size_t length = 0;
+    long long start = metrics_now_ns();
+    FILE* fp = open_memstream(&buffer, &length);
+    if (!fp) return 0;
+
+    fprintf(fp, "[\n");
+    for (int i = 0; i < count; i++) {
+        const VolumeScore* score = volume_profile_score(profile, top[i]);
+        if (i > 0) fprintf(fp, ",\n");
+        fprintf(fp, " {\n");
+        fprintf(fp, "  \"symbol\": \"%s\",\n", volume_profile_name(profile, top[i]));
+        fprintf(fp, "  \"z_score\": %.2f,\n", score->z_score);
+        fprintf(fp, "  \"percentile\": %.1f,\n", score->percentile);
+        fprintf(fp, "  \"rate\": %.0f,\n", score->rate);
+        fprintf(fp, "  \"expected\": %.0f,\n", score->expected);
+        fprintf(fp, "  \"time\": %lld\n", score->time);
+        fprintf(fp, " }");
+    }
+    fprintf(fp, "\n]\n");
+
+    return finish_and_publish(fp, &buffer, &length, start, "unusual_volume.json");
+}
+
+// Write breadth of the market and every sector, industry and index (breadth.json)
+int write_breadth_json(const BreadthEngine* engine) {
+    if (!engine) return 0;
+
+    char* buffer = NULL;
+    size_t length = 0;
+    long long start = metrics_now_ns();
+    FILE* fp = open_memstream(&buffer, &length);
+    if (!fp) return 0;
+
+    fprintf(fp, "[\n");
+    for (int g = 0; g < engine->group_count; g++) {
+        const BreadthGroup* group = &engine->groups[g];
+        if (g > 0) fprintf(fp, ",\n");
+        fprintf(fp, " {\n");
+        fprintf(fp, "  \"name\": \"%s\",\n", group->name);
+        fprintf(fp, "  \"type\": \"%s\",\n", breadth_kind_name(group->kind));
+        fprintf(fp, "  \"members\": %d,\n", group->members);
+        fprintf(fp, "  \"quoted\": %d,\n", group->quoted);
+        fprintf(fp, "  \"advancers\": %d,\n", group->advancers);
+        fprintf(fp, "  \"decliners\": %d,\n", group->decliners);
+        fprintf(fp, "  \"unchanged\": %d,\n", group->unchanged);
+        fprintf(fp, "  \"new_highs\": %d,\n", group->new_highs);
+        fprintf(fp, "  \"new_lows\": %d,\n", group->new_lows);
+        fprintf(fp, "  \"average_change\": %.2f,\n", breadth_average_change(group));
+        fprintf(fp, "  \"weighted_change\": %.2f,\n", breadth_weighted_change(group));
+        fprintf(fp, "  \"volume\": %.0f\n", group->volume);
+        fprintf(fp, " }");
+    }
+    fprintf(fp, "\n]\n");
+
+    return finish_and_publish(fp, &buffer, &length, start, "breadth.json");
 }
 
 int compare_stock_change(const void* a, const void* b) {
@@ -18,9 +18,50 @@
 // Constants
 #define MAX_SYMBOL_LENGTH 10
 #define MAX_NAME_LENGTH 100
-#define MAX_STATUS_LENGTH 50
 #define MAX_URL_LENGTH 512
 #define MAX_RESPONSE_SIZE 10000
+#define LOG_RECORD_SIZE 256
+#define METRICS_HISTOGRAM_BUCKETS 976   // Log-linear buckets covering 1ns..2^64ns
+#define METRICS_MAX_HTTP_CODE 600
+#define PARALLEL_MAX_THREADS 64
+#define RULE_STATUS_CUTS 3
+#define RULE_RECOMMEND_CUTS 6
+#define QUOTE_ALIGNMENT 64              // Cache line size; one StockQuote per line
+#define ALERT_RECENT_EVENTS 64          // Delivered alerts kept for publishing
+#define BREADTH_NAME_LENGTH 48          // Sector, industry or index name
+#define BREADTH_MAX_MEMBERSHIPS 8       // Groups per symbol besides the market
+#define VOLUME_BUCKETS 13               // Half-hour slots of the 9:30-16:00 session
+#define VOLUME_SKETCH_BINS 96           // Log-spaced volume-rate bins per symbol
+#define BAR_RING_CAPACITY 16            // Closed bars kept per symbol and interval
+#define HISTORY_BLOCK_BARS 1024         // Bars per independently decoded segment block
+#define RECORD_MAGIC "#REC "            // Starts each entry of a response recording
+#define SERIES_STREAM_MAX_DEPTH 8       // JSON nesting tracked by the time-series parser
+#define SERIES_STREAM_TOKEN 128         // Longest key or value kept (longer ones are cut)
+
+// Performance status, ordered from worst to best
+typedef enum {
+    STATUS_AVOID,
+    STATUS_BEARISH,
+    STATUS_WATCH,
+    STATUS_NEUTRAL,
+    STATUS_POSITIVE,
+    STATUS_BULLISH,
+    STATUS_STRONG_BUY,
+    STATUS_INVALID,
+    STATUS_PENDING            // Quote not fetched yet
+} StockStatus;
+
+// Trading recommendation, ordered from most bearish to most bullish
+typedef enum {
+    RECOMMEND_STRONG_SELL,
+    RECOMMEND_SELL,
+    RECOMMEND_WATCH,
+    RECOMMEND_HOLD_FLAT,
+    RECOMMEND_HOLD_UP,
+    RECOMMEND_BUY,
+    RECOMMEND_STRONG_BUY,
+    RECOMMEND_INVALID
+} Recommendation;
 
 // Stock data structure
 typedef struct {
@@ -29,7 +70,7 @@ typedef struct {
     double current_price;                    // Current stock price
     double change_percent;                   // Percentage change from previous close
     double volume;                           // Trading volume
-    char status[MAX_STATUS_LENGTH];          // Status (e.g., "🚀 STRONG BUY")
+    StockStatus status;                      // Status code (label via stock_status_label())
     double previous_close;                   // Previous closing price
     double day_high;                        // Day's high price
     double day_low;                         // Day's low price
@@ -37,157 +78,2884 @@ typedef struct {
     time_t last_update;                     // Last update timestamp
 } Stock;
 
-// API response structure
-typedef struct {
-    char *data;
-    size_t size;
-} APIResponse;
+// API response structure
+typedef struct {
+    char *data;
+    size_t size;
+} APIResponse;
+
+// Web data structure for JSON generation
+typedef struct {
+    Stock* stocks;
+    int count;
+    Stock* best_stock;
+    int bullish_count;
+    double total_value;
+    time_t last_update;
+} WebData;
+
+// Fsync policy for the background trading logger
+typedef enum {
+    LOG_FSYNC_NEVER,          // Leave flushing to the OS
+    LOG_FSYNC_EVERY_BATCH,    // fsync after every batched write
+    LOG_FSYNC_INTERVAL        // fsync at most once per fsync_interval_ms
+} LogFsyncPolicy;
+
+// Background trading logger configuration
+typedef struct {
+    const char* filename;     // Log file (appended to)
+    size_t ring_capacity;     // Ring slots, rounded up to a power of two
+    int flush_interval_ms;    // Writer sleep when the ring is empty
+    int fsync_policy;         // One of LogFsyncPolicy
+    int fsync_interval_ms;    // Used by LOG_FSYNC_INTERVAL
+} LoggerConfig;
+
+// Instrumented refresh stages
+typedef enum {
+    METRIC_DNS,               // Name lookup (curl timing)
+    METRIC_CONNECT,           // TCP connect (curl timing)
+    METRIC_TLS,               // TLS handshake (curl timing)
+    METRIC_TRANSFER,          // Request sent to last byte received (curl timing)
+    METRIC_FETCH,             // fetch_stock_data() end to end, retries and hedges included
+    METRIC_PARSE,             // parse_stock_json()
+    METRIC_ANALYZE,           // analyze_stock_performance()
+    METRIC_SERIALIZE,         // Building JSON output in memory
+    METRIC_PUBLISH,           // Writing JSON output files
+    METRIC_STAGE_COUNT
+} MetricStage;
+
+// Event counters
+typedef enum {
+    METRIC_FETCH_SUCCESS,
+    METRIC_FETCH_FAILURE,
+    METRIC_CACHE_HIT,
+    METRIC_DEMO_FALLBACK,
+    METRIC_ALERT_FIRED,
+    METRIC_ALERT_SUPPRESSED,      // Dropped as a duplicate or by the rate limit
+    METRIC_FETCH_RETRY,           // Attempts after the first
+    METRIC_FETCH_HEDGED,          // Duplicate requests sent past the rolling p95
+    METRIC_BREAKER_REJECTED,      // Attempts skipped because the host's circuit was open
+    METRIC_CONNECTION_NEW,        // Responses that needed a new connection
+    METRIC_CONNECTION_REUSED,     // Responses sent over a pooled keep-alive connection
+    METRIC_COUNTER_COUNT
+} MetricCounter;
+
+// Synthetic market generator configuration
+typedef struct {
+    unsigned long long seed;  // Same seed => same paths
+    long long start_time;     // Unix time of the first tick
+    double tick_seconds;      // Simulated seconds per tick
+    int ticks_per_session;    // Ticks per trading day
+    int sector_count;         // Number of correlated sector factors
+    double market_weight;     // Loading on the market factor
+    double sector_weight;     // Loading on the sector factor
+} SimConfig;
+
+// Per-symbol generator state
+typedef struct {
+    char symbol[MAX_SYMBOL_LENGTH];
+    unsigned long long stream;     // Hash of the symbol (random stream id)
+    unsigned long long tick;       // Ticks generated so far
+    int sector;
+    double price;
+    double previous_close;
+    double day_high;
+    double day_low;
+    double cumulative_volume;
+    double annual_drift;
+    double annual_volatility;
+    double daily_volume;
+    double shares_outstanding;
+} SimSymbol;
+
+// One generated tick
+typedef struct {
+    int symbol_index;
+    long long timestamp;
+    double price;
+    double volume;            // Volume traded during this tick
+    double cumulative_volume; // Session volume so far
+} SimTick;
+
+// Receives generated ticks (called from worker threads)
+typedef void (*SimTickSink)(const SimTick* tick, int worker, void* context);
+
+// Body of a parallel loop: processes items [begin, end)
+typedef void (*ParallelTask)(int begin, int end, int worker, void* context);
+
+// HDR-style latency histogram (nanoseconds, log-linear buckets)
+typedef struct {
+    unsigned long long buckets[METRICS_HISTOGRAM_BUCKETS];
+    unsigned long long count;
+    unsigned long long sum_ns;
+    unsigned long long max_ns;
+} LatencyHistogram;
+
+// Replay settings
+typedef struct {
+    double speed;             // 1.0 = real time, N = N times faster, 0 = max speed
+    const char* output_dir;   // Where published JSON goes (NULL keeps the current dir)
+    int publish;              // Run the publish stage at the end of each cycle
+    const char* alerts_file;  // Alert rules checked on every event (NULL for none)
+    const char* groups_file;  // Breadth groups (NULL for the market only)
+    const char* bars_file;    // Closed 1-minute bars written here at the end (NULL for none)
+} ReplayOptions;
+
+// Replay results
+typedef struct {
+    int events;
+    int symbols;
+    int cycles;               // Refresh cycles (a cycle ends when a symbol repeats)
+    int parse_failures;
+    long long wall_ns;
+    long long recorded_span_ms;
+    long long max_lag_ns;     // Worst delay behind the paced schedule
+    double events_per_second;
+    int alert_rules;
+    unsigned long long alerts_fired;
+    unsigned long long alerts_suppressed;
+    int breadth_groups;       // Besides the market
+    int advancers;            // Market breadth after the last event
+    int decliners;
+    char unusual_symbol[MAX_SYMBOL_LENGTH];  // Highest volume z-score at the end, "" if none
+    double unusual_z_score;
+    long long bars_closed;    // Intraday bars closed across all intervals
+    long long bars_dropped;   // Closed bars overwritten before they were flushed
+    int bars_written;         // 1-minute bars written to bars_file
+    LatencyHistogram end_to_end;  // Event arrival to an analyzed, alert-checked and counted quote
+} ReplayReport;
+
+// Tunable thresholds for the status and recommendation rules (percent change, shares)
+typedef struct {
+    double strong_buy_threshold;   // Status: STRONG BUY at or above
+    double buy_threshold;          // Status: BULLISH at or above
+    double sell_threshold;         // Status: BEARISH at or below
+    double strong_sell_threshold;  // Status: AVOID at or below
+    double strong_buy_change;      // Recommendation: STRONG BUY needs this change...
+    double strong_buy_volume;      // ...and more volume than this
+    double buy_change;             // Recommendation: BUY needs this change...
+    double buy_volume;             // ...and more volume than this
+    double hold_up_change;         // HOLD (up) at or above
+    double hold_flat_change;       // HOLD (flat) at or above
+    double watch_change;           // WATCH at or above
+    double sell_change;            // SELL at or above, STRONG SELL below
+} RuleParams;
+
+// RuleParams compiled into ascending threshold tables; a classification is
+// the number of cuts the change clears, so no branches are needed
+typedef struct {
+    double status_above[RULE_STATUS_CUTS];        // One step up when change > cut
+    double status_at_least[RULE_STATUS_CUTS];     // One step up when change >= cut
+    double recommend_at_least[RULE_RECOMMEND_CUTS];
+    double strong_buy_volume;                     // STRONG BUY needs volume above this
+    double buy_volume;                            // BUY needs volume above this
+} CompiledRules;
+
+// Hash map from symbol to a dense id (0, 1, 2, ... in insertion order)
+typedef struct {
+    int* slots;                          // Open-addressing table of ids, -1 = empty
+    int slot_capacity;                   // Power of two
+    char (*symbols)[MAX_SYMBOL_LENGTH];  // Symbol for each id
+    int count;
+    int symbol_capacity;
+} SymbolMap;
+
+// Hot part of a quote: the numbers analytics read, one 64-byte cache line
+typedef struct {
+    double current_price;
+    double change_percent;
+    double volume;
+    double previous_close;
+    double day_high;
+    double day_low;
+    long long last_update;    // Unix seconds
+    int symbol_id;            // Index into QuoteStore.meta and the symbol map
+    unsigned char status;     // StockStatus code
+    unsigned char reserved[3];
+} StockQuote;
+
+// Cold part of a quote: text and rarely read fields
+typedef struct {
+    char symbol[MAX_SYMBOL_LENGTH];
+    char name[MAX_NAME_LENGTH];
+    double market_cap;
+} StockMeta;
+
+// Quotes split into hot records and cold metadata, both indexed by symbol id
+typedef struct {
+    StockQuote* quotes;       // QUOTE_ALIGNMENT-aligned
+    StockMeta* meta;
+    int count;
+    int capacity;
+    SymbolMap symbols;
+} QuoteStore;
+
+// One symbol's bar history, stored column by column
+typedef struct {
+    char symbol[MAX_SYMBOL_LENGTH];
+    int count;
+    int capacity;
+    long long* timestamps;    // Unix seconds, ascending after history_store_sort()
+    double* open;
+    double* high;
+    double* low;
+    double* close;
+    double* volume;
+} PriceSeries;
+
+// Bar history for many symbols
+typedef struct {
+    PriceSeries* series;      // Indexed by symbol id
+    int count;
+    int capacity;
+    SymbolMap symbols;
+} HistoryStore;
+
+// Backtest settings
+typedef struct {
+    double initial_cash;      // Starting capital per symbol
+    double commission_bps;    // Charged on each fill
+    double slippage_bps;      // Fill price penalty against the trade
+    int threads;              // 0 for the default
+    const RuleParams* rules;  // NULL for the live rules
+} BacktestConfig;
+
+// Backtest results for one symbol
+typedef struct {
+    char symbol[MAX_SYMBOL_LENGTH];
+    int bars;
+    int trades;               // Round trips, including one still open at the end
+    int winning_trades;
+    double final_equity;
+    double total_return;      // Fraction, 0.05 = +5%
+    double buy_and_hold_return;
+    double max_drawdown;      // Fraction of peak equity
+    double hit_rate;          // winning_trades / trades
+    double exposure;          // Fraction of bars holding a position
+} BacktestResult;
+
+// Backtest results across all symbols
+typedef struct {
+    int symbols;
+    long long bars;
+    long long trades;
+    long long winning_trades;
+    double average_return;    // Equal-weight mean of per-symbol returns
+    double worst_drawdown;
+    double hit_rate;
+    long long elapsed_ns;
+} BacktestSummary;
+
+// One parameter set's results in a sweep
+typedef struct {
+    RuleParams rules;
+    BacktestSummary summary;
+} SweepResult;
+
+// Alert rule kinds
+typedef enum {
+    ALERT_CROSSES,            // Price crosses a level in either direction
+    ALERT_MOVES               // |change percent| rises past a level
+} AlertKind;
+
+// Alert levels for one symbol and kind, sorted ascending
+typedef struct {
+    double* levels;
+    int* rules;               // Rule id for each level
+    int count;
+    int capacity;
+} AlertBook;
+
+// One user alert
+typedef struct {
+    AlertKind kind;
+    int symbol_id;            // -1 matches every symbol
+    double threshold;         // Price level or percent move
+    int active;
+} AlertRule;
+
+// Last values checked for a symbol
+typedef struct {
+    double price;
+    double move;              // |change percent|
+    int seen;
+} AlertSymbolState;
+
+// One delivered alert
+typedef struct {
+    int rule;
+    AlertKind kind;
+    int direction;            // +1 up, -1 down
+    char symbol[MAX_SYMBOL_LENGTH];
+    double threshold;
+    double price;
+    double change_percent;
+    long long time;           // Unix seconds of the triggering quote
+} AlertEvent;
+
+// Alert rules indexed per symbol, plus dedup and rate limit state
+typedef struct {
+    AlertRule* rules;         // Indexed by rule id
+    int rule_count;
+    int rule_capacity;
+    int active_rules;
+    SymbolMap symbols;
+    AlertBook* crosses;       // Indexed by symbol id
+    AlertBook* moves;
+    AlertSymbolState* state;
+    int symbol_capacity;
+    AlertBook any_crosses;    // Rules for every symbol
+    AlertBook any_moves;
+    unsigned long long* fired_keys;  // (rule, symbol) -> last delivery time
+    long long* fired_times;
+    int fired_count;
+    int fired_capacity;       // Power of two
+    double tokens;            // Rate limit bucket
+    long long token_time;
+    AlertEvent recent[ALERT_RECENT_EVENTS];  // Ring of delivered alerts
+    int recent_count;
+    int recent_next;
+    unsigned long long fired;
+    unsigned long long suppressed;
+} AlertEngine;
+
+// Position row waiting for portfolio_build()
+typedef struct {
+    int account;
+    int symbol;
+    double quantity;
+    double cost;              // Total cost basis (quantity x average cost)
+} StagedPosition;
+
+// Value and P&L of one account or the whole firm
+typedef struct {
+    double market_value;
+    double cost_basis;
+    double day_pnl;           // Against the previous close
+    double unrealized_pnl;    // Market value minus cost, priced positions only
+    int positions;
+} PortfolioTotals;
+
+// Positions for many accounts, grouped by symbol for incremental updates
+typedef struct {
+    SymbolMap symbols;
+    SymbolMap accounts;
+    StagedPosition* staged;   // Source rows, merged by (symbol, account)
+    int staged_count;
+    int staged_capacity;
+    int* symbol_start;        // Positions of symbol s: symbol_start[s] .. symbol_start[s + 1]
+    int* position_account;
+    double* position_quantity;
+    double* position_cost;
+    int position_count;
+    double* last_price;       // Per symbol, 0 until the first quote
+    double* last_previous_close;
+    double* symbol_quantity;  // Per symbol, summed over accounts
+    double* symbol_cost;
+    int symbol_count;
+    double* market_value;     // Per account
+    double* day_pnl;
+    double* priced_cost;      // Cost basis of positions that have a price
+    double* cost_basis;
+    int* position_counts;
+    int account_count;
+    PortfolioTotals firm;
+    long long positions_touched;  // Work done by portfolio_apply_price()
+} Portfolio;
+
+// Rolling-window co-movement of many symbols.
+// Keeps per-symbol return sums and the upper triangle of sum(r_i * r_j) over
+// the window, from which any covariance or correlation is O(1).
+typedef struct {
+    int symbols;
+    int window;               // Observations per window
+    int observations;         // Observations held (<= window)
+    char (*names)[MAX_SYMBOL_LENGTH];
+    double* returns;          // Ring of window rows, one return per symbol per row
+    int next_row;             // Ring slot of the next observation
+    double* sums;             // Per symbol sum of returns
+    double* cross;            // symbols x symbols, row-major, entries j >= i only
+    int threads;              // 0 for the default
+} CorrelationEngine;
+
+// Diversification derived from a correlation matrix
+typedef struct {
+    int symbols;
+    double average_correlation;   // Mean over pairs i < j
+    double effective_bets;        // N^2 / ||C||_F^2: N when uncorrelated, 1 when identical
+    double diversity;             // 100 * (effective_bets - 1) / (N - 1)
+} CorrelationStats;
+
+// Rolling risk state of one return series
+typedef struct {
+    double* returns;          // Ring of the last `window` returns
+    double* index_returns;    // Index proxy return for the same bars
+    double* sorted;           // Window returns in ascending order
+    int window;
+    int count;
+    int next;                 // Ring slot of the next bar
+    double sum;
+    double sum_squares;
+    double sum_index;
+    double sum_index_squares;
+    double sum_cross;         // sum(r * index)
+    double wealth;            // Growth of 1.0 since the first bar
+    double peak;
+    double max_drawdown;
+    long long bars;
+} RiskState;
+
+// Risk metrics of a symbol, the index proxy or the portfolio
+typedef struct {
+    double volatility;        // Annualized standard deviation of returns
+    double beta;              // Against the index proxy
+    double drawdown;          // Current, fraction below the peak
+    double max_drawdown;      // Worst since the first bar
+    double var_historical;    // 1-day loss fraction at RISK_CONFIDENCE, empirical
+    double var_parametric;    // Same under a normal fit
+    int observations;         // Returns in the window
+} RiskMetrics;
+
+// Risk states for a universe plus its index proxy and a weighted portfolio
+typedef struct {
+    int symbols;
+    int window;
+    int threads;              // 0 for the default
+    int index_symbol;         // Symbol used as the index, -1 for the equal-weighted universe
+    double* weights;          // Portfolio weight per symbol
+    RiskState* states;
+    RiskState index;
+    RiskState portfolio;
+    double* buffers;          // Backing store for every state's arrays
+} RiskEngine;
+
+// Kinds of breadth group
+typedef enum {
+    BREADTH_MARKET,           // Every symbol
+    BREADTH_SECTOR,
+    BREADTH_INDUSTRY,
+    BREADTH_INDEX             // Custom list such as a benchmark's members
+} BreadthKind;
+
+// What one symbol's latest quote adds to each of its groups
+typedef struct {
+    int advancing;
+    int declining;
+    int unchanged;
+    int new_high;             // Day high above the reference high
+    int new_low;
+    double change;            // Percent
+    double market_cap;
+    double cap_change;        // market_cap x change
+    double volume;
+} BreadthContribution;
+
+// Running breadth of a sector, industry, index or the whole market
+typedef struct {
+    char name[BREADTH_NAME_LENGTH];
+    BreadthKind kind;
+    int members;              // Symbols assigned
+    int quoted;               // Members with a live quote
+    int advancers;
+    int decliners;
+    int unchanged;
+    int new_highs;
+    int new_lows;
+    double change_sum;
+    double cap_sum;
+    double cap_change_sum;
+    double volume;
+} BreadthGroup;
+
+// Group memberships and the last contribution of one symbol
+typedef struct {
+    int groups[BREADTH_MAX_MEMBERSHIPS];
+    int group_count;
+    int active;               // last has been added to the groups
+    double reference_high;    // e.g. 52-week high before today, 0 if unknown
+    double reference_low;
+    double session_high;      // Highest day high seen since the last session roll
+    double session_low;
+    BreadthContribution last;
+} BreadthSymbol;
+
+// Breadth aggregates kept current with O(1) deltas per changed quote
+typedef struct {
+    SymbolMap symbols;
+    BreadthSymbol* states;    // Indexed by symbol id
+    int state_capacity;
+    BreadthGroup* groups;     // groups[0] is the whole market
+    int group_count;
+    int group_capacity;
+    long long updates;        // Quotes applied
+} BreadthEngine;
+
+// Keys the rank index orders symbols by
+typedef enum {
+    RANK_BY_CHANGE,
+    RANK_BY_VOLUME,
+    RANK_BY_PRICE,
+    RANK_KEY_COUNT
+} RankKey;
+
+// Treap over the ranked symbols ordered by one key; node i is symbol id i
+typedef struct {
+    double* values;           // Key value per symbol
+    int* left;
+    int* right;
+    int* size;                // Nodes in the subtree rooted at each node
+    int root;                 // -1 when empty
+} RankTree;
+
+// Order-statistics index over change, volume and price for live leaderboards
+typedef struct {
+    SymbolMap symbols;
+    RankTree trees[RANK_KEY_COUNT];
+    unsigned int* priority;   // Heap priority per symbol, shared by the trees
+    unsigned char* ranked;    // Symbol currently has a live quote in the trees
+    int capacity;
+    int count;                // Symbols ranked
+} RankIndex;
+
+// Exponentially weighted mean and variance of log volume rate for one time slot
+typedef struct {
+    double mean;
+    double variance;
+    unsigned int samples;
+} VolumeBaseline;
+
+// Fixed-size log-bucketed histogram of volume rates; sketches with the
+// same layout merge by adding counts
+typedef struct {
+    unsigned int counts[VOLUME_SKETCH_BINS];
+    unsigned int total;
+} VolumeSketch;
+
+// How unusual one volume observation was
+typedef struct {
+    double rate;              // Shares per minute over the interval
+    double expected;          // Baseline rate for the time slot
+    double z_score;           // Log-rate deviation from the slot baseline, 0 while warming up
+    double percentile;        // Share of the symbol's past rates below this one, -1 if none yet
+    int bucket;               // Time-of-day slot
+    long long time;
+} VolumeScore;
+
+// Streaming volume state of one symbol (fixed size)
+typedef struct {
+    VolumeBaseline buckets[VOLUME_BUCKETS];
+    VolumeSketch sketch;
+    VolumeScore last;         // Latest observation, time 0 if none
+    double last_cumulative;   // Day volume at the previous quote
+    long long last_time;
+} VolumeSymbol;
+
+// Time-of-day volume baselines and quantile sketches for a universe
+typedef struct {
+    SymbolMap symbols;
+    VolumeSymbol* states;     // Indexed by symbol id
+    int capacity;
+} VolumeProfile;
+
+// Bar lengths the bar builder aggregates into
+typedef enum {
+    BAR_1M,
+    BAR_5M,
+    BAR_15M,
+    BAR_1H,
+    BAR_INTERVAL_COUNT
+} BarInterval;
+
+// One OHLCV bar built from quotes
+typedef struct {
+    long long start;          // Unix seconds the bar's period begins
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+    double turnover;          // sum(price x volume), VWAP = turnover / volume
+    int trades;               // Quotes aggregated, 0 for no open bar
+} OhlcvBar;
+
+// Open bar and closed-bar ring of one symbol at one interval
+typedef struct {
+    OhlcvBar current;
+    int head;                 // Ring slot the next closed bar goes to
+    int count;                // Closed bars in the ring
+    int unflushed;            // Newest closed bars not yet written to the sink
+} BarSeries;
+
+// Aggregates quotes into 1m/5m/15m/1h bars in preallocated rings
+typedef struct {
+    SymbolMap symbols;
+    BarSeries* series;        // symbols x BAR_INTERVAL_COUNT
+    OhlcvBar* rings;          // symbols x BAR_INTERVAL_COUNT x ring_capacity
+    double* last_cumulative;  // Day volume at each symbol's previous quote
+    long long* last_time;     // Time of each symbol's previous quote, 0 for none
+    int capacity;             // Symbols the arrays hold
+    int ring_capacity;
+    HistoryStore* sinks[BAR_INTERVAL_COUNT];  // Closed bars are flushed here (NULL to keep them in the rings)
+    long long bars_closed;
+    long long bars_dropped;   // Overwritten in a ring before a flush
+} BarBuilder;
+
+// Where one block of a compressed history segment starts
+typedef struct {
+    int series;               // Index into HistorySegment.names
+    int count;                // Bars in the block
+    size_t offset;            // Block header position in the segment data
+} HistorySegmentBlock;
+
+// A compressed history segment, memory mapped
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    char (*names)[MAX_SYMBOL_LENGTH];  // Symbol of each series
+    int series_count;
+    HistorySegmentBlock* blocks;  // In file order, a series' blocks are consecutive
+    int block_count;
+    long long bars;
+} HistorySegment;
+
+// One decoded block, column by column
+typedef struct {
+    const char* symbol;       // Points into the segment
+    int count;
+    long long timestamps[HISTORY_BLOCK_BARS];
+    double open[HISTORY_BLOCK_BARS];
+    double high[HISTORY_BLOCK_BARS];
+    double low[HISTORY_BLOCK_BARS];
+    double close[HISTORY_BLOCK_BARS];
+    double volume[HISTORY_BLOCK_BARS];
+} HistoryBlock;
+
+// What writing a segment achieved
+typedef struct {
+    long long bars;
+    int blocks;
+    int scaled_blocks;        // Prices stored as scaled integers
+    int xor_blocks;           // Prices stored as XOR-compressed doubles
+    size_t raw_bytes;         // Same bars as a timestamp and five double columns
+    size_t encoded_bytes;     // Segment file size
+} HistorySegmentStats;
+
+// What loading one history CSV took
+typedef struct {
+    long long rows;
+    long long bytes;
+    int chunks;               // Line-aligned pieces parsed in parallel
+    int threads;
+    long long elapsed_ns;
+} HistoryIngestStats;
+
+// What a market data source can do
+typedef enum {
+    DATA_SOURCE_NETWORK = 1,        // Quotes come over the network
+    DATA_SOURCE_OFFLINE = 2,        // Local data; refreshes need no pacing
+    DATA_SOURCE_BATCH = 4,          // One request returns many symbols
+    DATA_SOURCE_QUOTA = 8,          // Requests are rate limited
+    DATA_SOURCE_RECORDED_TIME = 16  // Quotes carry the source's timestamps, not the wall clock
+} DataSourceCapability;
+
+typedef struct DataSource DataSource;
+
+// Operations of one kind of market data source
+typedef struct {
+    const char* name;
+    unsigned int capabilities;      // DataSourceCapability flags
+    int requests_per_minute;        // 0 = unlimited
+    int requests_per_day;           // 0 = unlimited
+    int (*open)(DataSource* source, const char* location);
+    // Fills stocks[i] by symbol and sets fetched[i]; returns the requests made
+    int (*fetch_batch)(DataSource* source, Stock stocks[], int count, unsigned char fetched[]);
+    void (*close)(DataSource* source);
+} DataSourceOps;
+
+// An open market data source: operations, provider state, quota use and fallback
+struct DataSource {
+    const DataSourceOps* ops;
+    void* state;                    // Owned by the provider
+    char location[256];             // Provider argument, e.g. the file path
+    int minute_used;                // Requests in the current minute
+    int day_used;                   // Requests in the current UTC day
+    long long minute;               // Minute and day the counters belong to
+    long long day;
+    int next_symbol;                // Where a quota-limited batch resumes
+    long long requested;            // Symbols asked of this source
+    long long served;               // Symbols this source filled
+    long long fallbacks;            // Symbols filled by the fallback instead
+    DataSource* fallback;           // Asked for whatever this source could not supply
+};
+
+// Incremental parser for one time-series response; fixed size, no allocation
+typedef struct {
+    HistoryStore* store;
+    PriceSeries* series;            // Created when the first new bar arrives
+    char symbol[MAX_SYMBOL_LENGTH];
+    int start_count;                // Bars the series had before, for rollback
+    long long known_until;          // Newest stored bar; older bars are skipped
+    int state;                      // Tokenizer state
+    int depth;                      // Open objects and arrays
+    int expect_key;                 // Next string in the innermost object is a key
+    unsigned char is_object[SERIES_STREAM_MAX_DEPTH];
+    char keys[SERIES_STREAM_MAX_DEPTH][SERIES_STREAM_TOKEN];  // Current key per depth
+    char token[SERIES_STREAM_TOKEN];
+    int token_length;
+    int section;                    // What the current top-level key holds
+    int eastern;                    // Intraday times are US/Eastern wall clock
+    long long bar_time;
+    double fields[5];               // Open, high, low, close, volume
+    unsigned field_mask;            // Fields seen in the current bar
+    int complete;                   // The top-level object closed
+    long long bars_added;
+    long long bars_skipped;         // Already stored
+    long long bars_invalid;         // Missing fields or unreadable time
+    long long bytes;
+    char message[SERIES_STREAM_TOKEN];  // "Note", "Information" or "Error Message" from the API
+    const char* failed;             // Why parsing stopped, NULL while fine
+} SeriesStream;
+
+// Every aggregate of the serial analysis functions, from one partitioned pass
+typedef struct {
+    int count;                // Stocks scanned
+    int valid;                // Stocks with a price
+    int best;                 // Index of the highest change, -1 if none
+    int most_volatile;        // Index of the largest absolute change, -1 if none
+    int unusual_volume;       // Index of the highest volume, -1 if none
+    double best_change;
+    double highest_volatility;
+    double highest_volume;
+    int bullish;              // Change above 0
+    int sentiment_up;         // Change above +1%
+    int sentiment_down;       // Change below -1%
+    double change_sum;
+    double value_sum;         // As calculate_total_value()
+} MarketScan;
+
+// =============================================================================
+// CORE STOCK DATA FUNCTIONS (in stock_fetcher.c)
+// =============================================================================
+
+/**
+ * Callback function for libcurl to write API response data
+ * @param contents: Raw data from API
+ * @param size: Size of each data element
+ * @param nmemb: Number of data elements
+ * @param response: Pointer to APIResponse structure
+ * @return: Number of bytes processed
+ */
+size_t WriteCallback(void *contents, size_t size, size_t nmemb, APIResponse *response);
+
+/**
+ * Fetch real-time stock data for a given symbol. Failed attempts are
+ * retried with jittered backoff, a request still running at the rolling
+ * p95 is hedged with a duplicate, and a per-host circuit breaker stops
+ * requests to a failing endpoint. When every attempt fails, the last good
+ * quote (at most FETCH_STALE_SECONDS old) is served instead.
+ * @param symbol: Stock symbol (e.g., "AAPL")
+ * @param stock: Pointer to Stock structure to populate
+ * @return: 1 on success (fresh or last good data), 0 on failure
+ */
+int fetch_stock_data(const char* symbol, Stock* stock);
+
+/**
+ * Parse JSON response from Alpha Vantage API
+ * @param json_string: Raw JSON response
+ * @param stock: Pointer to Stock structure to populate
+ * @return: 1 on success, 0 on failure (including responses without a
+ *          "Global Quote", such as rate limit notices)
+ */
+int parse_stock_json(const char* json_string, Stock* stock);
+
+/**
+ * Company name for a known symbol
+ * @param symbol: Stock symbol
+ * @return: Company name, "Unknown Company" if not known
+ */
+const char* get_company_name(const char* symbol);
+
+/**
+ * Pin the timestamp given to parsed quotes (0 restores the wall clock)
+ * @param when: Fixed time, or 0
+ */
+void set_quote_clock(time_t when);
+
+/**
+ * Time used to stamp parsed quotes
+ * @return: Pinned time if set, otherwise the current time
+ */
+time_t current_quote_time();
+
+/**
+ * Limit each fetch_stock_data() call to a single HTTP request: no retries
+ * and no hedged duplicate, so a rate-limited API key is charged exactly
+ * one request per quote
+ * @param enabled: 1 for one request per quote, 0 for retries and hedging
+ */
+void set_fetch_single_request(int enabled);
+
+/**
+ * HTTP requests the fetcher has started, retries and hedged duplicates
+ * included
+ * @return: Requests since the program started
+ */
+long long fetch_request_count();
+
+/**
+ * Initialize libcurl for HTTP requests
+ * @return: 1 on success, 0 on failure
+ */
+int initialize_curl();
+
+/**
+ * Cleanup libcurl resources
+ */
+void cleanup_curl();
+
+/**
+ * Create an easy handle on the shared DNS and TLS session caches (safe to
+ * use from any thread); TLS is verified and HTTP/2 is used when offered.
+ * Keep-alive connections are not shared between threads: the fetcher's own
+ * transfers reuse the connections of its multi handle, and a handle run on
+ * another thread with curl_easy_perform() keeps its own.
+ * @return: Handle (free with curl_easy_cleanup before cleanup_curl), NULL
+ *          if initialize_curl() has not run
+ */
+CURL* fetch_handle_create();
+
+/**
+ * Download a full TIME_SERIES_DAILY or TIME_SERIES_INTRADAY response and
+ * stream its bars into a store while it arrives (see series_stream_feed);
+ * failed attempts are rolled back before the retry
+ * @param symbol: Stock symbol, already cleaned by validate_stock_symbol()
+ * @param interval: "daily", "1min", "5min", "15min", "30min" or "60min"
+ * @param store: Store the symbol's series is merged into
+ * @return: New bars added, -1 on failure (including an invalid symbol or interval)
+ */
+int fetch_stock_history(const char* symbol, const char* interval, HistoryStore* store);
+
+// =============================================================================
+// STOCK ANALYSIS FUNCTIONS (in analyzer.c)
+// =============================================================================
+
+/**
+ * Fill rule parameters with the compiled-in defaults
+ * @param params: Parameters to fill
+ */
+void rule_params_default(RuleParams* params);
+
+/**
+ * Set one rule parameter by name (e.g. "buy_threshold")
+ * @param params: Parameters to modify
+ * @param name: Field name
+ * @param value: New value
+ * @return: 1 on success, 0 if the name is unknown
+ */
+int rule_params_set_field(RuleParams* params, const char* name, double value);
+
+/**
+ * Read one rule parameter by name
+ * @param params: Parameters to read
+ * @param name: Field name
+ * @param value: Output value
+ * @return: 1 on success, 0 if the name is unknown
+ */
+int rule_params_get_field(const RuleParams* params, const char* name, double* value);
+
+/**
+ * Check that thresholds are ordered so every band is reachable
+ * @param params: Parameters to check
+ * @return: 1 if valid, 0 if not
+ */
+int rule_params_validate(const RuleParams* params);
+
+/**
+ * Rule parameters used by classify_status() and classify_recommendation()
+ * @return: Live parameters
+ */
+const RuleParams* rule_params_active();
+
+/**
+ * Compile rule parameters into threshold tables
+ * @param params: Rule parameters
+ * @param compiled: Output tables
+ * @return: 1 on success, 0 if the parameters are invalid
+ */
+int rule_params_compile(const RuleParams* params, CompiledRules* compiled);
+
+/**
+ * Replace the live rule parameters (call before worker threads start)
+ * @param params: New parameters
+ * @return: 1 on success, 0 if the parameters are invalid
+ */
+int rule_params_set_active(const RuleParams* params);
+
+/**
+ * Compiled form of the live rule parameters
+ * @return: Live threshold tables
+ */
+const CompiledRules* compiled_rules_active();
+
+/**
+ * Classify a stock's daily performance under the given rules
+ * @param stock: Pointer to Stock structure
+ * @param rules: Compiled rules
+ * @return: Status code, STATUS_INVALID for missing data
+ */
+StockStatus classify_status_with(const Stock* stock, const CompiledRules* rules);
+
+/**
+ * Classify a stock's daily performance under the live rules
+ * @param stock: Pointer to Stock structure
+ * @return: Status code, STATUS_INVALID for missing data
+ */
+StockStatus classify_status(const Stock* stock);
+
+/**
+ * Classify a column of quotes (vectorizable, thread-safe)
+ * @param rules: Compiled rules
+ * @param prices: Price column (<= 0 gives STATUS_INVALID)
+ * @param changes: Change percent column
+ * @param count: Number of rows
+ * @param codes: Output StockStatus codes
+ */
+void classify_status_column(const CompiledRules* rules, const double prices[], const double changes[],
+                            int count, unsigned char codes[]);
+
+/**
+ * Set the status of each hot quote record
+ * @param rules: Compiled rules
+ * @param quotes: Quote records
+ * @param count: Number of records
+ */
+void classify_quotes(const CompiledRules* rules, StockQuote quotes[], int count);
+
+/**
+ * Display label for a status code
+ * @param status: Status code
+ * @return: Label such as "📈 BULLISH"
+ */
+const char* stock_status_label(StockStatus status);
+
+/**
+ * Analyze stock performance and set the status code
+ * @param stock: Pointer to Stock structure to analyze
+ */
+void analyze_stock_performance(Stock* stock);
+
+/**
+ * Find the best performing stock from an array
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Pointer to best performing stock, NULL if none found
+ */
+Stock* find_best_performing_stock(Stock stocks[], int count);
+
+/**
+ * Find the most volatile stock (highest absolute change percentage)
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Pointer to most volatile stock, NULL if none found
+ */
+Stock* find_most_volatile_stock(Stock stocks[], int count);
+
+/**
+ * Count number of bullish stocks (positive change)
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Number of bullish stocks
+ */
+int count_bullish_stocks(Stock stocks[], int count);
+
+/**
+ * Sum of current prices, i.e. the value of one share of each stock
+ * (real holdings are valued by the portfolio functions)
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Sum of valid prices
+ */
+double calculate_total_value(Stock stocks[], int count);
+
+/**
+ * Sort stocks by performance (change percentage)
+ * @param stocks: Array of Stock structures to sort
+ * @param count: Number of stocks in array
+ */
+void sort_stocks_by_performance(Stock stocks[], int count);
+
+/**
+ * Generate buy/sell/hold recommendations
+ * @param stock: Pointer to Stock structure to analyze
+ * @return: Recommendation string
+ */
+const char* generate_recommendation(Stock* stock);
+
+/**
+ * Classify a stock into a recommendation under the given rules
+ * @param stock: Pointer to Stock structure
+ * @param rules: Compiled rules
+ * @return: Recommendation code, RECOMMEND_INVALID for missing data
+ */
+Recommendation classify_recommendation_with(const Stock* stock, const CompiledRules* rules);
+
+/**
+ * Classify a stock into a recommendation under the live rules
+ * @param stock: Pointer to Stock structure
+ * @return: Recommendation code, RECOMMEND_INVALID for missing data
+ */
+Recommendation classify_recommendation(const Stock* stock);
+
+/**
+ * Classify a column of quotes into recommendations (vectorizable, thread-safe)
+ * @param rules: Compiled rules
+ * @param prices: Price column (<= 0 gives RECOMMEND_INVALID)
+ * @param changes: Change percent column
+ * @param volumes: Volume column
+ * @param count: Number of rows
+ * @param codes: Output Recommendation codes
+ */
+void classify_recommendation_column(const CompiledRules* rules, const double prices[], const double changes[],
+                                    const double volumes[], int count, unsigned char codes[]);
+
+/**
+ * Display string for a recommendation code
+ * @param recommendation: Recommendation code
+ * @return: Recommendation string
+ */
+const char* recommendation_label(Recommendation recommendation);
+
+/**
+ * Simple moving average over the last period prices
+ * @param prices: Price array (oldest first)
+ * @param count: Number of prices
+ * @param period: Averaging period
+ * @return: Average, 0.0 if not enough data
+ */
+double calculate_simple_moving_average(double prices[], int count, int period);
+
+/**
+ * Simplified RSI derived from today's change
+ * @param stock: Pointer to Stock structure
+ * @return: RSI value (50 is neutral)
+ */
+double calculate_rsi(Stock* stock);
+
+/**
+ * Detect a simple intraday price pattern
+ * @param stock: Pointer to Stock structure
+ * @return: Pattern name
+ */
+const char* detect_price_pattern(Stock* stock);
+
+/**
+ * Calculate support and resistance levels from the day range
+ * @param stock: Pointer to Stock structure
+ * @param support: Output support level
+ * @param resistance: Output resistance level
+ */
+void calculate_support_resistance(Stock* stock, double* support, double* resistance);
+
+/**
+ * Classify overall market sentiment
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Sentiment label
+ */
+const char* analyze_market_sentiment(Stock stocks[], int count);
+
+/**
+ * Label the risk of a single stock from today's move alone
+ * (risk_level_from_metrics() uses realized volatility when history exists)
+ * @param stock: Pointer to Stock structure
+ * @return: Risk label
+ */
+const char* assess_risk_level(Stock* stock);
+
+/**
+ * One-day diversity proxy: share of stocks moving against the majority (0-50%).
+ * With return history, correlation_stats() gives the correlation-based diversity.
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Diversity as a percentage
+ */
+double calculate_portfolio_diversity(Stock stocks[], int count);
+
+/**
+ * Find the stock with the largest absolute volume (see volume_profile_top()
+ * for volume that is unusual for the symbol and time of day)
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Pointer to the stock, NULL if none found
+ */
+Stock* find_unusual_volume_stock(Stock stocks[], int count);
+
+/**
+ * Average change percentage over valid stocks
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @return: Average change percentage
+ */
+double calculate_average_change(Stock stocks[], int count);
+
+/**
+ * Build a multi-line market summary
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @param summary: Output buffer
+ * @param size: Size of output buffer
+ */
+void generate_market_summary(Stock stocks[], int count, char* summary, size_t size);
+
+/**
+ * Run find_best_performing_stock(), find_most_volatile_stock(),
+ * find_unusual_volume_stock(), count_bullish_stocks(), calculate_total_value()
+ * and the inputs of the sentiment, diversity and average change functions in
+ * one pass. Partitions of ANALYSIS_CHUNK_STOCKS stocks are scanned in
+ * parallel and combined in partition order. Results equal the serial
+ * functions bit for bit, for any thread count
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks in array
+ * @param threads: Worker threads (0 for the default)
+ * @param scan: Filled with the aggregates; indexes are into stocks
+ * @return: Threads used, -1 on allocation failure
+ */
+int market_scan_parallel(const Stock stocks[], int count, int threads, MarketScan* scan);
+
+/**
+ * Average change of a scan (same value as calculate_average_change())
+ * @param scan: Completed scan
+ * @return: Average change percentage
+ */
+double market_scan_average_change(const MarketScan* scan);
+
+/**
+ * Sentiment of a scan (same label as analyze_market_sentiment())
+ * @param scan: Completed scan
+ * @return: Sentiment label
+ */
+const char* market_scan_sentiment(const MarketScan* scan);
+
+/**
+ * Diversity of a scan (same value as calculate_portfolio_diversity())
+ * @param scan: Completed scan
+ * @return: Diversity as a percentage
+ */
+double market_scan_diversity(const MarketScan* scan);
+
+// =============================================================================
+// FILE I/O FUNCTIONS (in file_handler.c)
+// =============================================================================
+
+/**
+ * Save stock data to a text file
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks
+ * @param filename: Output file name
+ * @return: 1 on success, 0 on failure
+ */
+int save_stocks_to_file(Stock stocks[], int count, const char* filename);
+
+/**
+ * Load stock data from a text file
+ * @param stocks: Array to populate with Stock structures
+ * @param max_count: Maximum number of stocks to load
+ * @param filename: Input file name
+ * @return: Number of stocks loaded, -1 on failure
+ */
+int load_stocks_from_file(Stock stocks[], int max_count, const char* filename);
+
+/**
+ * Generate JSON data for web interface
+ * @param stocks: Array of Stock structures
+ * @param count: Number of stocks
+ * @param filename: Output JSON file name
+ * @return: 1 on success, 0 on failure
+ */
+int generate_json_file(Stock stocks[], int count, const char* filename);
+
+/**
+ * Create a directory (no error if it already exists is not guaranteed)
+ * @param path: Directory path
+ * @return: 0 on success, -1 on failure
+ */
+int create_directory(const char* path);
+
+/**
+ * Read a whole file into memory
+ * @param filename: File to read
+ * @param size_out: Receives the file size
+ * @return: NUL-terminated buffer (caller frees), NULL on failure
+ */
+char* read_entire_file(const char* filename, size_t* size_out);
+
+/**
+ * Save trading log with timestamp
+ * Goes through the background logger when it is running, otherwise appends directly
+ * @param message: Log message to save
+ * @param stock: Optional stock data (can be NULL)
+ * @return: 1 on success, 0 on failure (or record dropped)
+ */
+int log_trading_activity(const char* message, Stock* stock);
+
+/**
+ * Load rule parameters from "name = value" lines (e.g. CONFIG_FILE)
+ * @param filename: Rule file
+ * @param params: Parameters to update (fields not in the file are kept)
+ * @return: Number of parameters set, -1 on error
+ */
+int load_rule_params(const char* filename, RuleParams* params);
+
+/**
+ * Load alert rules from "SYMBOL crosses PRICE" / "SYMBOL moves PERCENT" lines
+ * (SYMBOL "*" matches every symbol, '#' starts a comment; e.g. ALERTS_FILE)
+ * @param filename: Alert file
+ * @param engine: Engine to add the rules to
+ * @return: Number of rules added, -1 on error
+ */
+int load_alert_rules(const char* filename, AlertEngine* engine);
+
+// =============================================================================
+// ASYNC LOGGER FUNCTIONS (in async_logger.c)
+// =============================================================================
+
+/**
+ * Fill a logger configuration with the defaults
+ * @param config: Configuration to fill
+ */
+void logger_default_config(LoggerConfig* config);
+
+/**
+ * Open the log file and start the background writer thread
+ * @param config: Logger configuration (NULL for defaults)
+ * @return: 1 on success, 0 on failure
+ */
+int logger_start(const LoggerConfig* config);
+
+/**
+ * Flush all accepted records and stop the writer thread
+ * Call only after producers have stopped logging
+ */
+void logger_stop();
+
+/**
+ * Check whether the background logger is running
+ * @return: 1 if running, 0 otherwise
+ */
+int logger_is_running();
+
+/**
+ * Queue a preformatted record without blocking
+ * @param record: Record text (should end with a newline)
+ * @param length: Record length in bytes (truncated to LOG_RECORD_SIZE)
+ * @return: 1 if queued, 0 if dropped (ring full or logger stopped)
+ */
+int logger_submit(const char* record, size_t length);
+
+/**
+ * Number of records dropped because the ring was full
+ * @return: Drop counter
+ */
+unsigned long long logger_dropped_count();
+
+/**
+ * Number of records written to the log file
+ * @return: Write counter
+ */
+unsigned long long logger_written_count();
+
+/**
+ * Current local time as "YYYY-MM-DD HH:MM:SS", formatted once per second per thread
+ * @return: Pointer to a thread-local timestamp string
+ */
+const char* logger_cached_timestamp();
+
+// =============================================================================
+// METRICS FUNCTIONS (in metrics.c)
+// =============================================================================
+
+/**
+ * Current monotonic clock reading
+ * @return: Nanoseconds since an arbitrary fixed point
+ */
+long long metrics_now_ns();
+
+/**
+ * Clear a histogram
+ * @param histogram: Histogram to reset
+ */
+void histogram_reset(LatencyHistogram* histogram);
+
+/**
+ * Record one latency sample (thread-safe)
+ * @param histogram: Target histogram
+ * @param value_ns: Sample in nanoseconds
+ */
+void histogram_record(LatencyHistogram* histogram, long long value_ns);
+
+/**
+ * Read a percentile from a histogram
+ * @param histogram: Source histogram
+ * @param percentile: Percentile between 0 and 100
+ * @return: Value in nanoseconds (bucket upper bound), 0 if empty
+ */
+long long histogram_percentile(const LatencyHistogram* histogram, double percentile);
+
+/**
+ * Add the samples of one histogram to another
+ * @param into: Destination histogram
+ * @param from: Source histogram
+ */
+void histogram_merge(LatencyHistogram* into, const LatencyHistogram* from);
+
+/**
+ * Record a stage latency in the global registry
+ * @param stage: Stage that was timed
+ * @param elapsed_ns: Duration in nanoseconds
+ */
+void metrics_record_stage(MetricStage stage, long long elapsed_ns);
+
+/**
+ * Increment a global event counter
+ * @param counter: Counter to increment
+ */
+void metrics_increment(MetricCounter counter);
+
+/**
+ * Count an HTTP response status code
+ * @param code: HTTP status code
+ */
+void metrics_record_http_code(long code);
+
+/**
+ * Read a global event counter
+ * @param counter: Counter to read
+ * @return: Current value
+ */
+unsigned long long metrics_counter_value(MetricCounter counter);
+
+/**
+ * Access the global histogram for a stage
+ * @param stage: Stage to look up
+ * @return: Pointer to the histogram, NULL for an invalid stage
+ */
+const LatencyHistogram* metrics_stage_histogram(MetricStage stage);
+
+/**
+ * Name of a stage as used in metric labels
+ * @param stage: Stage to look up
+ * @return: Stage name
+ */
+const char* metrics_stage_name(MetricStage stage);
+
+/**
+ * Clear all global histograms and counters
+ */
+void metrics_reset();
+
+/**
+ * Write all metrics in Prometheus text format (atomic replace)
+ * @param filename: Output file, e.g. for the node_exporter textfile collector
+ * @return: 1 on success, 0 on failure
+ */
+int metrics_write_prometheus(const char* filename);
+
+/**
+ * Format a one-line metrics summary
+ * @param buffer: Output buffer
+ * @param size: Size of buffer
+ */
+void metrics_format_summary(char* buffer, size_t size);
+
+/**
+ * Print the summary line when the interval has elapsed since the last print
+ * @param interval_seconds: Minimum seconds between summary lines
+ */
+void metrics_maybe_print_summary(int interval_seconds);
+
+// =============================================================================
+// PARALLEL LOOP FUNCTIONS (in thread_pool.c)
+// =============================================================================
+
+/**
+ * Default worker count (STOCK_THREADS or the number of online CPUs)
+ * @return: Thread count
+ */
+int parallel_default_threads();
+
+/**
+ * Run task over [0, item_count) in chunks; the caller acts as worker 0
+ * @param item_count: Number of items
+ * @param chunk_size: Items per chunk
+ * @param thread_count: Worker threads (0 for the default)
+ * @param task: Function called for each chunk
+ * @param context: Passed through to task
+ * @return: Number of threads used, 0 if there was nothing to do
+ */
+int parallel_for(int item_count, int chunk_size, int thread_count,
+                 ParallelTask task, void* context);
+
+// =============================================================================
+// SYNTHETIC MARKET DATA FUNCTIONS (in market_sim.c)
+// =============================================================================
+
+/**
+ * Counter-based random bits: a pure function of its arguments
+ * @param seed: Generator seed
+ * @param stream: Independent stream id
+ * @param counter: Position in the stream
+ * @return: 64 random bits
+ */
+unsigned long long sim_random_bits(unsigned long long seed, unsigned long long stream,
+                                   unsigned long long counter);
+
+/**
+ * Counter-based standard normal draw
+ * @param seed: Generator seed
+ * @param stream: Independent stream id
+ * @param counter: Position in the stream
+ * @return: Normally distributed value
+ */
+double sim_random_normal(unsigned long long seed, unsigned long long stream,
+                         unsigned long long counter);
+
+/**
+ * Stable hash of a symbol string
+ * @param symbol: Stock symbol
+ * @return: 64-bit hash
+ */
+unsigned long long sim_symbol_hash(const char* symbol);
+
+/**
+ * Fill a generator configuration with the defaults
+ * @param config: Configuration to fill
+ */
+void sim_default_config(SimConfig* config);
+
+/**
+ * Initialize a symbol's generator state (parameters derived from the name)
+ * @param config: Generator configuration
+ * @param state: State to initialize
+ * @param symbol: Stock symbol
+ * @param sector: Sector index, or -1 to derive it from the symbol
+ */
+void sim_init_symbol(const SimConfig* config, SimSymbol* state, const char* symbol, int sector);
+
+/**
+ * Advance a symbol by one geometric-Brownian-motion tick
+ * @param config: Generator configuration
+ * @param state: Symbol state to advance
+ * @param tick: Optional output tick (can be NULL)
+ */
+void sim_next_tick(const SimConfig* config, SimSymbol* state, SimTick* tick);
+
+/**
+ * Copy a symbol's current state into a Stock record
+ * @param state: Symbol state
+ * @param stock: Output Stock structure
+ */
+void sim_fill_stock(const SimSymbol* state, Stock* stock);
+
+/**
+ * Set the seed used for demo quotes
+ * @param seed: New seed
+ */
+void sim_set_demo_seed(unsigned long long seed);
+
+/**
+ * Reproducible demo quote for a symbol at a given time
+ * @param symbol: Stock symbol
+ * @param when: Quote time
+ * @param stock: Output Stock structure
+ * @return: 1 on success, 0 on failure
+ */
+int sim_demo_stock(const char* symbol, time_t when, Stock* stock);
+
+/**
+ * Advance every symbol by a number of ticks across worker threads
+ * @param config: Generator configuration
+ * @param symbols: Symbol states
+ * @param count: Number of symbols
+ * @param ticks: Ticks per symbol
+ * @param threads: Worker threads (0 for the default)
+ * @param sink: Optional tick consumer (can be NULL)
+ * @param sink_context: Passed through to sink
+ * @return: Total ticks generated
+ */
+long long sim_generate_parallel(const SimConfig* config, SimSymbol symbols[], int count,
+                                int ticks, int threads, SimTickSink sink, void* sink_context);
+
+/**
+ * Generate daily OHLCV bars for synthetic symbols ("SYM0", "SYM1", ...)
+ * @param store: History store to add to
+ * @param symbol_count: Number of symbols
+ * @param days: Trading days per symbol
+ * @param seed: Generator seed
+ * @param threads: Worker threads (0 for the default)
+ * @return: 1 on success, 0 on failure
+ */
+int sim_generate_history(HistoryStore* store, int symbol_count, int days,
+                         unsigned long long seed, int threads);
+
+// =============================================================================
+// RECORD AND REPLAY FUNCTIONS (in replay.c)
+// =============================================================================
+
+/**
+ * Start appending raw API responses to a recording file
+ * @param filename: Recording file
+ * @return: 1 on success, 0 on failure
+ */
+int recorder_open(const char* filename);
+
+/**
+ * Stop recording
+ */
+void recorder_close();
+
+/**
+ * Append one raw response to the recording (no-op when not recording)
+ * @param symbol: Stock symbol the response is for
+ * @param data: Raw response bytes
+ * @param size: Response size
+ */
+void recorder_write(const char* symbol, const char* data, size_t size);
+
+/**
+ * Fill replay options with the defaults (1x speed, publish to REPLAY_OUTPUT_DIR)
+ * @param options: Options to fill
+ */
+void replay_default_options(ReplayOptions* options);
+
+/**
+ * Replay a recording or tick history CSV through parse, analyze and publish
+ * @param filename: Recording or tick history file
+ * @param options: Replay options
+ * @param report: Output statistics
+ * @return: 1 on success, 0 on failure
+ */
+int replay_file(const char* filename, const ReplayOptions* options, ReplayReport* report);
+
+/**
+ * Print throughput and per-stage latency of a replay
+ * @param report: Replay statistics
+ */
+void replay_print_report(const ReplayReport* report);
+
+/**
+ * Command line entry for "stock_tracker replay ..."
+ * @param argc: Argument count (argv[0] is "replay")
+ * @param argv: Arguments
+ * @return: Process exit code
+ */
+int run_replay_command(int argc, char* argv[]);
+
+// =============================================================================
+// SYMBOL MAP FUNCTIONS (in symbol_map.c)
+// =============================================================================
+
+/**
+ * Initialize an empty symbol map
+ * @param map: Map to initialize
+ * @param expected_symbols: Size hint
+ * @return: 1 on success, 0 on failure
+ */
+int symbol_map_init(SymbolMap* map, int expected_symbols);
+
+/**
+ * Release a symbol map's memory
+ * @param map: Map to free
+ */
+void symbol_map_free(SymbolMap* map);
+
+/**
+ * Look up a symbol
+ * @param map: Symbol map
+ * @param symbol: Stock symbol
+ * @return: Symbol id, -1 if absent
+ */
+int symbol_map_find(const SymbolMap* map, const char* symbol);
+
+/**
+ * Look up a symbol, adding it if absent
+ * @param map: Symbol map
+ * @param symbol: Stock symbol
+ * @return: Symbol id, -1 on allocation failure
+ */
+int symbol_map_insert(SymbolMap* map, const char* symbol);
+
+/**
+ * Symbol for an id
+ * @param map: Symbol map
+ * @param id: Symbol id
+ * @return: Symbol string, NULL if the id is out of range
+ */
+const char* symbol_map_name(const SymbolMap* map, int id);
+
+// =============================================================================
+// QUOTE STORE FUNCTIONS (in quote_store.c)
+// =============================================================================
+
+/**
+ * Initialize an empty quote store
+ * @param store: Store to initialize
+ * @param expected_symbols: Size hint
+ * @return: 1 on success, 0 on failure
+ */
+int quote_store_init(QuoteStore* store, int expected_symbols);
+
+/**
+ * Release a quote store's memory
+ * @param store: Store to free
+ */
+void quote_store_free(QuoteStore* store);
+
+/**
+ * Get a symbol's id, adding an empty record if it is new
+ * @param store: Quote store
+ * @param symbol: Stock symbol
+ * @return: Symbol id, -1 on failure
+ */
+int quote_store_add(QuoteStore* store, const char* symbol);
+
+/**
+ * Look up a symbol's id
+ * @param store: Quote store
+ * @param symbol: Stock symbol
+ * @return: Symbol id, -1 if absent
+ */
+int quote_store_find(const QuoteStore* store, const char* symbol);
+
+/**
+ * Copy a Stock's numeric fields into a hot record (symbol_id is kept)
+ * @param stock: Source stock
+ * @param quote: Target record
+ */
+void stock_to_quote(const Stock* stock, StockQuote* quote);
+
+/**
+ * Rebuild a Stock from a hot record and its metadata
+ * @param quote: Hot record
+ * @param meta: Cold metadata
+ * @param stock: Output stock
+ */
+void quote_to_stock(const StockQuote* quote, const StockMeta* meta, Stock* stock);
+
+/**
+ * Store a Stock (hot record always, metadata only when it changed)
+ * @param store: Quote store
+ * @param stock: Stock to store
+ * @return: Symbol id, -1 on failure
+ */
+int quote_store_put(QuoteStore* store, const Stock* stock);
+
+/**
+ * Materialize one record as a Stock
+ * @param store: Quote store
+ * @param id: Symbol id
+ * @param stock: Output stock
+ * @return: 1 on success, 0 if the id is out of range
+ */
+int quote_store_get(const QuoteStore* store, int id, Stock* stock);
+
+/**
+ * Materialize all records (in id order) for the Stock-based writers
+ * @param store: Quote store
+ * @param stocks: Output array
+ * @param max_count: Capacity of stocks
+ * @return: Number of stocks written
+ */
+int quote_store_export(const QuoteStore* store, Stock stocks[], int max_count);
+
+/**
+ * Set every record's status under the live rules
+ * @param store: Quote store
+ */
+void quote_store_analyze(QuoteStore* store);
+
+/**
+ * Highest change among valid quotes (as find_best_performing_stock())
+ * @param store: Quote store
+ * @return: Symbol id, -1 if none
+ */
+int quote_store_best_performer(const QuoteStore* store);
+
+/**
+ * Count valid quotes with a positive change (as count_bullish_stocks())
+ * @param store: Quote store
+ * @return: Number of bullish quotes
+ */
+int quote_store_count_bullish(const QuoteStore* store);
+
+/**
+ * Average change over valid quotes (as calculate_average_change())
+ * @param store: Quote store
+ * @return: Average change percentage
+ */
+double quote_store_average_change(const QuoteStore* store);
+
+/**
+ * Sum of valid prices (as calculate_total_value())
+ * @param store: Quote store
+ * @return: Total value
+ */
+double quote_store_total_value(const QuoteStore* store);
+
+/**
+ * Memory held by the store
+ * @param store: Quote store
+ * @param hot_bytes: Optional output, bytes in hot records
+ * @return: Total bytes (hot records, metadata and symbol index)
+ */
+size_t quote_store_footprint(const QuoteStore* store, size_t* hot_bytes);
+
+// =============================================================================
+// PRICE HISTORY FUNCTIONS (in history_store.c)
+// =============================================================================
+
+/**
+ * Initialize an empty history store
+ * @param store: Store to initialize
+ * @return: 1 on success, 0 on failure
+ */
+int history_store_init(HistoryStore* store);
+
+/**
+ * Release a history store's memory
+ * @param store: Store to free
+ */
+void history_store_free(HistoryStore* store);
+
+/**
+ * Get a symbol's series
+ * @param store: History store
+ * @param symbol: Stock symbol
+ * @param create: Add an empty series if the symbol is new
+ * @return: Series pointer (valid until the next series is created), NULL if absent
+ */
+PriceSeries* history_store_series(HistoryStore* store, const char* symbol, int create);
+
+/**
+ * Sort a series chronologically if its bars were appended out of order
+ * @param series: Series to sort
+ * @return: 1 on success, 0 on allocation failure
+ */
+int price_series_sort(PriceSeries* series);
+
+/**
+ * Grow a series' columns without changing its bar count
+ * @param series: Series to grow
+ * @param capacity: Bars the columns must hold
+ * @return: 1 on success, 0 on allocation failure
+ */
+int price_series_reserve(PriceSeries* series, int capacity);
+
+/**
+ * Append one bar to a series
+ * @param series: Target series
+ * @param timestamp: Bar time (Unix seconds)
+ * @param open: Open price
+ * @param high: High price
+ * @param low: Low price
+ * @param close: Close price
+ * @param volume: Bar volume
+ * @return: 1 on success, 0 on failure
+ */
+int price_series_append(PriceSeries* series, long long timestamp, double open, double high,
+                        double low, double close, double volume);
+
+/**
+ * Sort every series by timestamp
+ * @param store: History store
+ * @return: 1 on success, 0 on failure
+ */
+int history_store_sort(HistoryStore* store);
+
+/**
+ * Total bars across all series
+ * @param store: History store
+ * @return: Bar count
+ */
+long long history_store_bar_count(const HistoryStore* store);
+
+/**
+ * Parse "YYYY-MM-DD[( |T)HH:MM[:SS]]" (UTC) or a Unix timestamp
+ * @param text: Timestamp text
+ * @return: Unix seconds
+ */
+long long parse_history_timestamp(const char* text);
+
+/**
+ * Parse "YYYY-MM-DD[( |T)HH[:MM[:SS]]][Z]" (UTC) or Unix seconds, rejecting
+ * anything else (parse_history_timestamp() reads unknown text as 0)
+ * @param text: Timestamp text
+ * @param out: Receives Unix seconds
+ * @return: 1 on success, 0 if the text is not a timestamp
+ */
+int parse_history_timestamp_strict(const char* text, long long* out);
+
+/**
+ * Days since 1970-01-01 of a proleptic Gregorian date
+ * @param year: Year
+ * @param month: Month (1-12)
+ * @param day: Day of the month
+ * @return: Day number (negative before 1970)
+ */
+long long history_days_from_civil(int year, int month, int day);
+
+/**
+ * Parse one "symbol,timestamp,open,high,low,close,volume" CSV row; fields
+ * after the volume are ignored
+ * @param line: NUL-terminated line
+ * @param symbol: Receives the symbol
+ * @param timestamp: Receives the timestamp (see parse_history_timestamp())
+ * @param values: Receives open, high, low, close and volume
+ * @return: 1 if the line is a row, 0 otherwise (such as a header)
+ */
+int history_csv_parse_row(const char* line, char symbol[MAX_SYMBOL_LENGTH], long long* timestamp,
+                          double values[5]);
+
+/**
+ * Load bars from a "symbol,timestamp,open,high,low,close,volume" CSV
+ * @param store: History store to add to
+ * @param filename: CSV file
+ * @return: Rows loaded, -1 on error
+ */
+int history_store_load_csv(HistoryStore* store, const char* filename);
+
+/**
+ * Write every series as "symbol,timestamp,open,high,low,close,volume" rows
+ * with Unix-second timestamps, readable by history_store_load_csv()
+ * @param store: History store
+ * @param filename: Output file
+ * @return: Rows written, -1 on error
+ */
+int history_store_write_csv(const HistoryStore* store, const char* filename);
+
+/**
+ * Initialize a store from a CSV or a compressed segment (by its
+ * HISTORY_SEGMENT_EXTENSION suffix), or fill it with synthetic daily bars
+ * @param store: Uninitialized store (freed again on failure)
+ * @param filename: CSV or segment file, NULL to generate
+ * @param symbols: Synthetic symbol count (when filename is NULL)
+ * @param bars: Synthetic bars per symbol (when filename is NULL)
+ * @param threads: Generator or CSV ingest threads (0 for the default)
+ * @return: 1 on success, 0 on failure
+ */
+int history_store_open(HistoryStore* store, const char* filename, int symbols, int bars, int threads);
+
+// =============================================================================
+// BACKTESTING FUNCTIONS (in backtester.c)
+// =============================================================================
+
+/**
+ * Fill a backtest config with the defaults
+ * @param config: Config to fill
+ */
+void backtest_default_config(BacktestConfig* config);
+
+/**
+ * Apply the status and recommendation rules to one symbol's history
+ * @param series: Bar history (ascending timestamps)
+ * @param config: Backtest settings
+ * @param result: Output results
+ */
+void backtest_series(const PriceSeries* series, const BacktestConfig* config, BacktestResult* result);
+
+/**
+ * Backtest every symbol in a store, spreading symbols across threads
+ * @param store: History store
+ * @param config: Backtest settings
+ * @param results: Output array with one entry per series (store order)
+ * @param summary: Output aggregate results
+ * @return: 1 on success, 0 on failure
+ */
+int backtest_run(const HistoryStore* store, const BacktestConfig* config,
+                 BacktestResult* results, BacktestSummary* summary);
+
+/**
+ * Evaluate many rule parameter sets against the same history
+ * @param store: History store
+ * @param config: Backtest settings (config->rules is ignored)
+ * @param sets: Rule parameter sets
+ * @param set_count: Number of sets
+ * @param results: Output array with one entry per set
+ * @return: 1 on success, 0 on failure
+ */
+int backtest_sweep(const HistoryStore* store, const BacktestConfig* config,
+                   const RuleParams sets[], int set_count, SweepResult results[]);
+
+/**
+ * Command line entry for "stock_tracker backtest ..."
+ * @param argc: Argument count (argv[0] is "backtest")
+ * @param argv: Arguments
+ * @return: Process exit code
+ */
+int run_backtest_command(int argc, char* argv[]);
+
+/**
+ * Command line entry for "stock_tracker sweep ..."
+ * @param argc: Argument count (argv[0] is "sweep")
+ * @param argv: Arguments
+ * @return: Process exit code
+ */
+int run_sweep_command(int argc, char* argv[]);
+
+// =============================================================================
+// ALERT ENGINE FUNCTIONS (in alert_engine.c)
+// =============================================================================
+
+/**
+ * Initialize an empty alert engine
+ * @param engine: Engine to initialize
+ * @return: 1 on success, 0 on failure
+ */
+int alert_engine_init(AlertEngine* engine);
+
+/**
+ * Release an alert engine's memory
+ * @param engine: Engine to free
+ */
+void alert_engine_free(AlertEngine* engine);
+
+/**
+ * Add an alert rule
+ * @param engine: Alert engine
+ * @param symbol: Symbol to watch, NULL or "*" for every symbol
+ * @param kind: ALERT_CROSSES (price level) or ALERT_MOVES (percent move)
+ * @param threshold: Price level or percent, must be positive
+ * @return: Rule id, -1 on failure
+ */
+int alert_engine_add(AlertEngine* engine, const char* symbol, AlertKind kind, double threshold);
+
+/**
+ * Remove an alert rule (ids are not reused)
+ * @param engine: Alert engine
+ * @param rule_id: Id returned by alert_engine_add()
+ * @return: 1 if removed, 0 if unknown or already removed
+ */
+int alert_engine_remove(AlertEngine* engine, int rule_id);
+
+/**
+ * Check a quote update against the rules whose levels it crossed.
+ * Fired alerts go to the trading log and the recent-alerts ring;
+ * repeats within ALERT_DEDUP_SECONDS and bursts over the rate limit are dropped.
+ * @param engine: Alert engine
+ * @param stock: Updated stock
+ * @return: Number of alerts delivered
+ */
+int alert_engine_check(AlertEngine* engine, const Stock* stock);
+
+/**
+ * Copy the most recent delivered alerts
+ * @param engine: Alert engine
+ * @param events: Output array
+ * @param max_count: Capacity of events
+ * @return: Number copied, newest first
+ */
+int alert_engine_recent(const AlertEngine* engine, AlertEvent events[], int max_count);
+
+/**
+ * Parse an alert kind name
+ * @param text: "crosses" or "moves"
+ * @param kind: Output kind
+ * @return: 1 on success, 0 if unknown
+ */
+int parse_alert_kind(const char* text, AlertKind* kind);
+
+// =============================================================================
+// CORRELATION FUNCTIONS (in correlation.c)
+// =============================================================================
+
+/**
+ * Initialize an engine with an empty window
+ * @param engine: Engine to initialize
+ * @param symbols: Number of symbols
+ * @param window: Observations per window
+ * @param threads: Worker threads (0 for the default)
+ * @return: 1 on success, 0 on failure
+ */
+int correlation_init(CorrelationEngine* engine, int symbols, int window, int threads);
+
+/**
+ * Release an engine's memory
+ * @param engine: Engine to free
+ */
+void correlation_free(CorrelationEngine* engine);
+
+/**
+ * Fill the window with the last rows of a return matrix and recompute from scratch
+ * @param engine: Correlation engine
+ * @param rows: count rows of engine->symbols returns each (time-major)
+ * @param count: Number of rows
+ */
+void correlation_load(CorrelationEngine* engine, const double* rows, int count);
+
+/**
+ * Recompute the sums and cross products from the window (cache-blocked, parallel)
+ * @param engine: Correlation engine
+ */
+void correlation_compute(CorrelationEngine* engine);
+
+/**
+ * Slide the window by one observation: O(N^2) instead of O(N^2 x window)
+ * @param engine: Correlation engine
+ * @param row: One return per symbol
+ */
+void correlation_push(CorrelationEngine* engine, const double* row);
+
+/**
+ * Covariance of two symbols over the window
+ * @param engine: Correlation engine
+ * @param i: First symbol index
+ * @param j: Second symbol index
+ * @return: Sample covariance, 0 with fewer than two observations
+ */
+double correlation_covariance(const CorrelationEngine* engine, int i, int j);
+
+/**
+ * Correlation of two symbols over the window
+ * @param engine: Correlation engine
+ * @param i: First symbol index
+ * @param j: Second symbol index
+ * @return: Correlation in [-1, 1], 0 if either symbol never moved
+ */
+double correlation_value(const CorrelationEngine* engine, int i, int j);
+
+/**
+ * Average correlation and effective number of bets over the full matrix
+ * @param engine: Correlation engine
+ * @param stats: Output statistics
+ */
+void correlation_stats(const CorrelationEngine* engine, CorrelationStats* stats);
+
+/**
+ * Build an aligned time-major matrix of daily returns from a history store.
+ * Timestamps are the union across symbols; a symbol without a bar at a
+ * timestamp carries its last close forward (a zero return).
+ * @param store: History store
+ * @param observations: Returns wanted per symbol
+ * @param rows_out: Output matrix (caller frees), rows_out[t * store->count + s]
+ * @return: Rows produced (fewer if history is short), -1 on failure
+ */
+int history_aligned_returns(const HistoryStore* store, int observations, double** rows_out);
+
+/**
+ * Command line entry for "stock_tracker correlation ..."
+ * @param argc: Argument count (argv[0] is "correlation")
+ * @param argv: Arguments
+ * @return: Process exit code
+ */
+int run_correlation_command(int argc, char* argv[]);
+
+// =============================================================================
+// RISK FUNCTIONS (in risk.c)
+// =============================================================================
+
+/**
+ * Initialize a risk engine (equal weights, equal-weighted index proxy)
+ * @param engine: Engine to initialize
+ * @param symbols: Number of symbols
+ * @param window: Returns per rolling window
+ * @param threads: Worker threads for risk_engine_load() (0 for the default)
+ * @return: 1 on success, 0 on failure
+ */
+int risk_engine_init(RiskEngine* engine, int symbols, int window, int threads);
+
+/**
+ * Release a risk engine's memory
+ * @param engine: Engine to free
+ */
+void risk_engine_free(RiskEngine* engine);
+
+/**
+ * Forget all bars, keeping weights and the index choice
+ * @param engine: Risk engine
+ */
+void risk_engine_reset(RiskEngine* engine);
+
+/**
+ * Set portfolio weights (scaled so absolute weights sum to 1)
+ * @param engine: Risk engine
+ * @param weights: One weight per symbol
+ * @return: 1 on success, 0 if all weights are zero
+ */
+int risk_engine_set_weights(RiskEngine* engine, const double* weights);
+
+/**
+ * Add one bar incrementally
+ * @param engine: Risk engine
+ * @param returns: One return per symbol (0 for a symbol without a bar)
+ */
+void risk_engine_push(RiskEngine* engine, const double* returns);
+
+/**
+ * Rebuild from a time-major return matrix, symbols in parallel
+ * @param engine: Risk engine
+ * @param rows: count rows of engine->symbols returns
+ * @param count: Number of rows
+ * @return: 1 on success, 0 on failure
+ */
+int risk_engine_load(RiskEngine* engine, const double* rows, int count);
+
+/**
+ * Metrics for one symbol
+ * @param engine: Risk engine
+ * @param symbol: Symbol index
+ * @param metrics: Output metrics
+ * @return: 1 on success, 0 for an invalid index
+ */
+int risk_engine_symbol(const RiskEngine* engine, int symbol, RiskMetrics* metrics);
+
+/**
+ * Metrics for the weighted portfolio
+ * @param engine: Risk engine
+ * @param metrics: Output metrics
+ */
+void risk_engine_portfolio(const RiskEngine* engine, RiskMetrics* metrics);
+
+/**
+ * Metrics for the index proxy
+ * @param engine: Risk engine
+ * @param metrics: Output metrics
+ */
+void risk_engine_index(const RiskEngine* engine, RiskMetrics* metrics);
+
+/**
+ * Risk label from realized volatility
+ * @param metrics: Metrics from the risk engine
+ * @return: Risk label
+ */
+const char* risk_level_from_metrics(const RiskMetrics* metrics);
+
+/**
+ * Command line entry for "stock_tracker risk ..."
+ * @param argc: Argument count (argv[0] is "risk")
+ * @param argv: Arguments
+ * @return: Process exit code
+ */
+int run_risk_command(int argc, char* argv[]);
+
+// =============================================================================
+// PORTFOLIO FUNCTIONS (in portfolio.c)
+// =============================================================================
+
+/**
+ * Initialize an empty portfolio
+ * @param portfolio: Portfolio to initialize
+ * @return: 1 on success, 0 on failure
+ */
+int portfolio_init(Portfolio* portfolio);
+
+/**
+ * Release a portfolio's memory
+ * @param portfolio: Portfolio to free
+ */
+void portfolio_free(Portfolio* portfolio);
+
+/**
+ * Stage a position; it takes effect at the next portfolio_build().
+ * Repeated (account, symbol) rows are summed.
+ * @param portfolio: Portfolio
+ * @param account: Account name (shorter than MAX_SYMBOL_LENGTH)
+ * @param symbol: Stock symbol
+ * @param quantity: Shares held (negative for short)
+ * @param average_cost: Cost per share
+ * @return: 1 on success, 0 on failure
+ */
+int portfolio_add_position(Portfolio* portfolio, const char* account, const char* symbol,
+                           double quantity, double average_cost);
+
+/**
+ * Group the staged positions by symbol and recompute all totals
+ * @param portfolio: Portfolio
+ * @return: 1 on success, 0 on failure
+ */
+int portfolio_build(Portfolio* portfolio);
+
+/**
+ * Recompute every total from scratch with the last prices
+ * @param portfolio: Portfolio
+ */
+void portfolio_recompute(Portfolio* portfolio);
+
+/**
+ * Apply a new price to the positions in one symbol
+ * @param portfolio: Portfolio
+ * @param symbol_id: Symbol id in portfolio->symbols
+ * @param price: New price
+ * @param previous_close: Previous close for day P&L (0 if unknown)
+ * @return: Number of positions updated (0 if the price did not change)
+ */
+int portfolio_apply_price(Portfolio* portfolio, int symbol_id, double price, double previous_close);
+
+/**
+ * Apply a quote to the positions in its symbol
+ * @param portfolio: Portfolio
+ * @param stock: Updated stock
+ * @return: Number of positions updated
+ */
+int portfolio_apply_quote(Portfolio* portfolio, const Stock* stock);
+
+/**
+ * Totals for one account
+ * @param portfolio: Portfolio
+ * @param account_id: Account id from portfolio_find_account()
+ * @param totals: Output totals
+ * @return: 1 on success, 0 if the id is invalid
+ */
+int portfolio_account_totals(const Portfolio* portfolio, int account_id, PortfolioTotals* totals);
+
+/**
+ * Totals across every account
+ * @param portfolio: Portfolio
+ * @param totals: Output totals
+ */
+void portfolio_firm_totals(const Portfolio* portfolio, PortfolioTotals* totals);
+
+/**
+ * Look up an account
+ * @param portfolio: Portfolio
+ * @param account: Account name
+ * @return: Account id, -1 if absent
+ */
+int portfolio_find_account(const Portfolio* portfolio, const char* account);
+
+/**
+ * Load "account,symbol,quantity,average_cost" rows and build the portfolio
+ * @param portfolio: Initialized portfolio
+ * @param filename: CSV file (header row optional)
+ * @return: Number of rows loaded, -1 on error
+ */
+int portfolio_load_csv(Portfolio* portfolio, const char* filename);
+
+// =============================================================================
+// MARKET BREADTH FUNCTIONS (in breadth.c)
+// =============================================================================
+
+/**
+ * Initialize an engine holding only the market group
+ * @param engine: Engine to initialize
+ * @return: 1 on success, 0 on failure
+ */
+int breadth_init(BreadthEngine* engine);
+
+/**
+ * Release an engine's memory
+ * @param engine: Engine to free
+ */
+void breadth_free(BreadthEngine* engine);
+
+/**
+ * Id of a group, adding it if it is new
+ * @param engine: Engine
+ * @param kind: Sector, industry or index (BREADTH_MARKET returns 0)
+ * @param name: Group name (truncated to BREADTH_NAME_LENGTH - 1)
+ * @return: Group id, -1 on failure
+ */
+int breadth_group_id(BreadthEngine* engine, BreadthKind kind, const char* name);
+
+/**
+ * Id of an existing group
+ * @param engine: Engine
+ * @param kind: Group kind
+ * @param name: Group name
+ * @return: Group id, -1 if absent
+ */
+int breadth_find_group(const BreadthEngine* engine, BreadthKind kind, const char* name);
+
+/**
+ * Add a symbol to a group; a symbol already quoted is counted at once
+ * @param engine: Engine
+ * @param symbol: Stock symbol
+ * @param group: Group id from breadth_group_id()
+ * @return: 1 on success, 0 on failure (unknown group or too many memberships)
+ */
+int breadth_assign(BreadthEngine* engine, const char* symbol, int group);
+
+/**
+ * Set the highs and lows new quotes are compared against
+ * @param engine: Engine
+ * @param symbol: Stock symbol
+ * @param high: Reference high (e.g. 52-week), 0 if unknown
+ * @param low: Reference low, 0 if unknown
+ * @return: 1 on success, 0 on failure
+ */
+int breadth_set_range(BreadthEngine* engine, const char* symbol, double high, double low);
+
+/**
+ * Apply a symbol's latest quote: its old contribution is removed from each of
+ * its groups and the new one added, so the cost is O(memberships)
+ * @param engine: Engine
+ * @param stock: Quote (symbols not seen before join the market group)
+ * @return: 1 on success, 0 on failure
+ */
+int breadth_update(BreadthEngine* engine, const Stock* stock);
+
+/**
+ * Drop a symbol's contribution (e.g. a stale or halted quote)
+ * @param engine: Engine
+ * @param symbol: Stock symbol
+ * @return: 1 if it was counted, 0 otherwise
+ */
+int breadth_remove(BreadthEngine* engine, const char* symbol);
+
+/**
+ * Start a new session: fold today's highs and lows into the references and
+ * recount every group from the symbols' contributions
+ * @param engine: Engine
+ */
+void breadth_new_session(BreadthEngine* engine);
+
+/**
+ * Recount every group from the symbols' contributions; clears the rounding
+ * the running sums pick up from many add/remove deltas
+ * @param engine: Engine
+ */
+void breadth_recompute(BreadthEngine* engine);
+
+/**
+ * Get a group
+ * @param engine: Engine
+ * @param group: Group id (0 is the market)
+ * @return: Group, NULL if out of range
+ */
+const BreadthGroup* breadth_group(const BreadthEngine* engine, int group);
 
-// Web data structure for JSON generation
-typedef struct {
-    Stock* stocks;
-    int count;
-    Stock* best_stock;
-    int bullish_count;
-    double total_value;
-    time_t last_update;
-} WebData;
+/**
+ * Equal-weighted average change of a group's quoted members
+ * @param group: Group
+ * @return: Percent change, 0 if none are quoted
+ */
+double breadth_average_change(const BreadthGroup* group);
+
+/**
+ * Market-cap-weighted change of a group
+ * @param group: Group
+ * @return: Percent change, the equal-weighted average if no caps are known
+ */
+double breadth_weighted_change(const BreadthGroup* group);
+
+/**
+ * Name of a group kind for display and JSON
+ * @param kind: Group kind
+ * @return: "market", "sector", "industry" or "index"
+ */
+const char* breadth_kind_name(BreadthKind kind);
+
+/**
+ * Load group memberships from "symbol,sector,industry,index;index,high_52w,low_52w"
+ * lines; every field after the symbol may be empty or left off
+ * @param engine: Engine
+ * @param filename: Metadata file (BREADTH_FILE)
+ * @return: Symbols loaded, -1 on error
+ */
+int breadth_load_groups(BreadthEngine* engine, const char* filename);
 
 // =============================================================================
-// CORE STOCK DATA FUNCTIONS (in stock_fetcher.c)
+// RANKING FUNCTIONS (in rank_index.c)
 // =============================================================================
 
 /**
- * Callback function for libcurl to write API response data
- * @param contents: Raw data from API
- * @param size: Size of each data element
- * @param nmemb: Number of data elements
- * @param response: Pointer to APIResponse structure
- * @return: Number of bytes processed
+ * Initialize an empty rank index
+ * @param index: Index to initialize
+ * @param expected_symbols: Capacity hint
+ * @return: 1 on success, 0 on failure
  */
-size_t WriteCallback(void *contents, size_t size, size_t nmemb, APIResponse *response);
+int rank_index_init(RankIndex* index, int expected_symbols);
 
 /**
- * Fetch real-time stock data for a given symbol
- * @param symbol: Stock symbol (e.g., "AAPL")
- * @param stock: Pointer to Stock structure to populate
+ * Release a rank index's memory
+ * @param index: Index to free
+ */
+void rank_index_free(RankIndex* index);
+
+/**
+ * Re-rank a symbol after a quote change in O(log n) per key that moved;
+ * a quote without a price removes the symbol
+ * @param index: Index
+ * @param stock: Latest quote
  * @return: 1 on success, 0 on failure
  */
-int fetch_stock_data(const char* symbol, Stock* stock);
+int rank_index_update(RankIndex* index, const Stock* stock);
 
 /**
- * Parse JSON response from Alpha Vantage API
- * @param json_string: Raw JSON response
- * @param stock: Pointer to Stock structure to populate
+ * Stop ranking a symbol
+ * @param index: Index
+ * @param symbol: Stock symbol
+ * @return: 1 if it was ranked, 0 otherwise
+ */
+int rank_index_remove(RankIndex* index, const char* symbol);
+
+/**
+ * One page of a leaderboard in O(log n + count)
+ * @param index: Index
+ * @param key: Ordering key
+ * @param descending: 1 for highest first (top-K), 0 for lowest first (bottom-K)
+ * @param offset: Entries to skip
+ * @param count: Entries wanted
+ * @param ids: Output symbol ids (use rank_index_name() and rank_index_value())
+ * @return: Entries written
+ */
+int rank_index_range(const RankIndex* index, RankKey key, int descending, int offset, int count, int ids[]);
+
+/**
+ * Leaderboard position of a symbol, highest value first
+ * @param index: Index
+ * @param key: Ordering key
+ * @param symbol: Stock symbol
+ * @return: 1-based rank, 0 if the symbol is not ranked
+ */
+int rank_index_rank(const RankIndex* index, RankKey key, const char* symbol);
+
+/**
+ * Percentile rank of a symbol: share of ranked symbols with a lower value
+ * @param index: Index
+ * @param key: Ordering key
+ * @param symbol: Stock symbol
+ * @return: 0-100, -1 if the symbol is not ranked
+ */
+double rank_index_percentile(const RankIndex* index, RankKey key, const char* symbol);
+
+/**
+ * Value at a percentile of the ranked symbols (nearest rank)
+ * @param index: Index
+ * @param key: Ordering key
+ * @param percentile: 0-100
+ * @return: Key value, 0 if nothing is ranked
+ */
+double rank_index_value_at(const RankIndex* index, RankKey key, double percentile);
+
+/**
+ * Symbol for an id returned by rank_index_range()
+ * @param index: Index
+ * @param id: Symbol id
+ * @return: Symbol, NULL if out of range
+ */
+const char* rank_index_name(const RankIndex* index, int id);
+
+/**
+ * Latest key value of a symbol id
+ * @param index: Index
+ * @param key: Key
+ * @param id: Symbol id
+ * @return: Value, 0 if out of range
+ */
+double rank_index_value(const RankIndex* index, RankKey key, int id);
+
+// =============================================================================
+// VOLUME PROFILE FUNCTIONS (in volume_profile.c)
+// =============================================================================
+
+/**
+ * Initialize an empty volume profile
+ * @param profile: Profile to initialize
+ * @param expected_symbols: Capacity hint
  * @return: 1 on success, 0 on failure
  */
-int parse_stock_json(const char* json_string, Stock* stock);
+int volume_profile_init(VolumeProfile* profile, int expected_symbols);
 
 /**
- * Initialize libcurl for HTTP requests
+ * Release a volume profile's memory
+ * @param profile: Profile to free
+ */
+void volume_profile_free(VolumeProfile* profile);
+
+/**
+ * Score an interval's volume against the symbol's baseline for that time of
+ * day, then fold it into the baseline and sketch; O(1) per call
+ * @param profile: Profile
+ * @param symbol: Stock symbol
+ * @param volume: Shares traded in the interval
+ * @param seconds: Interval length
+ * @param when: End of the interval (Unix time)
+ * @param score: Output score (may be NULL)
  * @return: 1 on success, 0 on failure
  */
-int initialize_curl();
+int volume_profile_observe(VolumeProfile* profile, const char* symbol, double volume,
+                           double seconds, long long when, VolumeScore* score);
 
 /**
- * Cleanup libcurl resources
+ * Score a quote: the interval volume is the change in its day volume since
+ * the symbol's previous quote
+ * @param profile: Profile
+ * @param stock: Latest quote (volume is cumulative for the day)
+ * @param score: Output score (may be NULL)
+ * @return: 1 if an interval was scored, 0 if there was no new volume or on failure
  */
-void cleanup_curl();
+int volume_profile_update(VolumeProfile* profile, const Stock* stock, VolumeScore* score);
+
+/**
+ * Symbols whose latest volume is most unusual, highest z-score first
+ * @param profile: Profile
+ * @param count: Entries wanted
+ * @param ids: Output symbol ids
+ * @return: Entries written
+ */
+int volume_profile_top(const VolumeProfile* profile, int count, int ids[]);
+
+/**
+ * Latest score of a symbol id
+ * @param profile: Profile
+ * @param id: Symbol id
+ * @return: Score, NULL if out of range
+ */
+const VolumeScore* volume_profile_score(const VolumeProfile* profile, int id);
+
+/**
+ * Symbol for an id returned by volume_profile_top()
+ * @param profile: Profile
+ * @param id: Symbol id
+ * @return: Symbol, NULL if out of range
+ */
+const char* volume_profile_name(const VolumeProfile* profile, int id);
+
+/**
+ * Merge another shard's baselines and sketches into a profile
+ * @param into: Profile receiving the data
+ * @param from: Shard to merge
+ * @return: 1 on success, 0 on failure
+ */
+int volume_profile_merge(VolumeProfile* into, const VolumeProfile* from);
+
+/**
+ * Add a volume rate to a sketch
+ * @param sketch: Sketch
+ * @param rate: Shares per minute
+ */
+void volume_sketch_add(VolumeSketch* sketch, double rate);
+
+/**
+ * Add one sketch's counts to another
+ * @param into: Sketch receiving the counts
+ * @param from: Sketch to merge
+ */
+void volume_sketch_merge(VolumeSketch* into, const VolumeSketch* from);
+
+/**
+ * Share of a sketch's rates below a value
+ * @param sketch: Sketch
+ * @param rate: Shares per minute
+ * @return: 0-100, -1 if the sketch is empty
+ */
+double volume_sketch_percentile(const VolumeSketch* sketch, double rate);
+
+/**
+ * Approximate rate at a quantile (within one bin, about +/-12%)
+ * @param sketch: Sketch
+ * @param percentile: 0-100
+ * @return: Shares per minute, 0 if the sketch is empty
+ */
+double volume_sketch_quantile(const VolumeSketch* sketch, double percentile);
 
 // =============================================================================
-// STOCK ANALYSIS FUNCTIONS (in analyzer.c)
+// BAR BUILDER FUNCTIONS (in bar_builder.c)
 // =============================================================================
 
 /**
- * Analyze stock performance and set status
- * @param stock: Pointer to Stock structure to analyze
+ * Initialize an empty bar builder
+ * @param builder: Builder to initialize
+ * @param expected_symbols: Capacity hint
+ * @param ring_capacity: Closed bars kept per symbol and interval (BAR_RING_CAPACITY)
+ * @return: 1 on success, 0 on failure
  */
-void analyze_stock_performance(Stock* stock);
+int bar_builder_init(BarBuilder* builder, int expected_symbols, int ring_capacity);
 
 /**
- * Find the best performing stock from an array
- * @param stocks: Array of Stock structures
- * @param count: Number of stocks in array
- * @return: Pointer to best performing stock, NULL if none found
+ * Release a bar builder's memory (sinks are not freed)
+ * @param builder: Builder to free
  */
-Stock* find_best_performing_stock(Stock stocks[], int count);
+void bar_builder_free(BarBuilder* builder);
 
 /**
- * Find the most volatile stock (highest absolute change percentage)
- * @param stocks: Array of Stock structures
- * @param count: Number of stocks in array
- * @return: Pointer to most volatile stock, NULL if none found
+ * Send an interval's closed bars to a history store on bar_builder_flush()
+ * @param builder: Builder
+ * @param interval: Bar interval
+ * @param store: Initialized history store, NULL to keep bars in the rings only
  */
-Stock* find_most_volatile_stock(Stock stocks[], int count);
+void bar_builder_set_sink(BarBuilder* builder, BarInterval interval, HistoryStore* store);
 
 /**
- * Count number of bullish stocks (positive change)
- * @param stocks: Array of Stock structures
- * @param count: Number of stocks in array
- * @return: Number of bullish stocks
+ * Add a quote to every interval's open bar, closing bars whose period has
+ * passed; the volume is the change in day volume since the symbol's
+ * previous quote. Constant work, no allocation once the symbol is known.
+ * @param builder: Builder
+ * @param stock: Quote (last_update is its time)
+ * @return: 1 on success, 0 on failure
  */
-int count_bullish_stocks(Stock stocks[], int count);
+int bar_builder_update(BarBuilder* builder, const Stock* stock);
 
 /**
- * Calculate total portfolio value
- * @param stocks: Array of Stock structures
- * @param count: Number of stocks in array
- * @return: Total value of all stocks
+ * Add one trade to every interval's open bar
+ * @param builder: Builder
+ * @param symbol: Stock symbol
+ * @param when: Trade time (Unix seconds)
+ * @param price: Trade price
+ * @param volume: Shares traded
+ * @return: 1 on success, 0 on failure
  */
-double calculate_total_value(Stock stocks[], int count);
+int bar_builder_add_trade(BarBuilder* builder, const char* symbol, long long when,
+                          double price, double volume);
 
 /**
- * Sort stocks by performance (change percentage)
- * @param stocks: Array of Stock structures to sort
- * @param count: Number of stocks in array
+ * Close open bars whose period ended by a time (e.g. at the session close)
+ * @param builder: Builder
+ * @param now: Unix seconds, or 0 to close every open bar
+ * @return: Bars closed
  */
-void sort_stocks_by_performance(Stock stocks[], int count);
+int bar_builder_close(BarBuilder* builder, long long now);
 
 /**
- * Generate buy/sell/hold recommendations
- * @param stock: Pointer to Stock structure to analyze
- * @return: Recommendation string
+ * Append closed bars not yet written to each interval's sink
+ * @param builder: Builder
+ * @return: Bars written, -1 on failure
  */
-const char* generate_recommendation(Stock* stock);
+int bar_builder_flush(BarBuilder* builder);
+
+/**
+ * Open bar of a symbol
+ * @param builder: Builder
+ * @param symbol: Stock symbol
+ * @param interval: Bar interval
+ * @return: Bar, NULL if none is open
+ */
+const OhlcvBar* bar_builder_current(const BarBuilder* builder, const char* symbol, BarInterval interval);
+
+/**
+ * A recently closed bar of a symbol
+ * @param builder: Builder
+ * @param symbol: Stock symbol
+ * @param interval: Bar interval
+ * @param back: 0 for the newest closed bar, 1 for the one before, ...
+ * @return: Bar, NULL if the ring holds fewer bars
+ */
+const OhlcvBar* bar_builder_recent(const BarBuilder* builder, const char* symbol, BarInterval interval, int back);
+
+/**
+ * Volume-weighted average price of a bar
+ * @param bar: Bar
+ * @return: VWAP, the close if the bar has no volume
+ */
+double bar_vwap(const OhlcvBar* bar);
+
+/**
+ * Length of a bar interval
+ * @param interval: Bar interval
+ * @return: Seconds, 0 if invalid
+ */
+int bar_interval_seconds(BarInterval interval);
+
+/**
+ * Name of a bar interval
+ * @param interval: Bar interval
+ * @return: "1m", "5m", "15m" or "1h"
+ */
+const char* bar_interval_name(BarInterval interval);
 
 // =============================================================================
-// FILE I/O FUNCTIONS (in file_handler.c)
+// HISTORY COMPRESSION FUNCTIONS (in history_codec.c)
 // =============================================================================
 
 /**
- * Save stock data to a text file
- * @param stocks: Array of Stock structures
- * @param count: Number of stocks
- * @param filename: Output file name
+ * Write every series of a store as a compressed segment: delta-of-delta
+ * timestamps, scaled-integer or XOR prices and run-length volumes, in
+ * blocks of HISTORY_BLOCK_BARS bars. Lossless.
+ * @param store: History store (sorted)
+ * @param filename: Output file
+ * @param stats: Filled with sizes and block counts (may be NULL)
+ * @return: Bars written, -1 on error
+ */
+int history_segment_write(const HistoryStore* store, const char* filename, HistorySegmentStats* stats);
+
+/**
+ * Map a segment file into memory and index its blocks
+ * @param segment: Segment to fill
+ * @param filename: Segment file
  * @return: 1 on success, 0 on failure
  */
-int save_stocks_to_file(Stock stocks[], int count, const char* filename);
+int history_segment_open(HistorySegment* segment, const char* filename);
 
 /**
- * Load stock data from a text file
- * @param stocks: Array to populate with Stock structures
- * @param max_count: Maximum number of stocks to load
- * @param filename: Input file name
- * @return: Number of stocks loaded, -1 on failure
+ * Release a segment's memory
+ * @param segment: Segment to close
  */
-int load_stocks_from_file(Stock stocks[], int max_count, const char* filename);
+void history_segment_close(HistorySegment* segment);
 
 /**
- * Generate JSON data for web interface
- * @param stocks: Array of Stock structures
+ * Decode one block; blocks are independent, so callers may decode them in
+ * any order or in parallel with one HistoryBlock each
+ * @param segment: Open segment
+ * @param block: Block index (0 to block_count - 1)
+ * @param out: Decoded columns
+ * @return: 1 on success, 0 if the block is corrupt
+ */
+int history_segment_decode(const HistorySegment* segment, int block, HistoryBlock* out);
+
+/**
+ * Decode a whole segment into a store
+ * @param store: History store to add to
+ * @param filename: Segment file
+ * @return: Bars loaded, -1 on error
+ */
+int history_segment_load(HistoryStore* store, const char* filename);
+
+/**
+ * Command line entry for "stock_tracker compress ..."
+ * @param argc: Argument count (argv[0] is "compress")
+ * @param argv: Arguments
+ * @return: Process exit code
+ */
+int run_compress_command(int argc, char* argv[]);
+
+// =============================================================================
+// BULK HISTORY INGEST (in history_ingest.c)
+// =============================================================================
+
+/**
+ * Load a large history CSV in parallel: the file is memory mapped, split
+ * into line-aligned chunks, and parsed straight into the store's columns.
+ * The header and rows are read as history_store_load_csv() reads them and
+ * give the same bars; a row that loader only half-parses (text inside a
+ * number or timestamp) is reported as an error instead
+ * @param store: History store to add to
+ * @param filename: "symbol,timestamp,open,high,low,close,volume" file
+ * @param threads: Worker threads (0 for the default)
+ * @param stats: Optional rows, bytes and timing of the load
+ * @return: Rows loaded, -1 on error (the first bad row is reported; the
+ *          store keeps only the bars it had before)
+ */
+int history_store_ingest_csv(HistoryStore* store, const char* filename, int threads,
+                             HistoryIngestStats* stats);
+
+/**
+ * Command line entry for "stock_tracker ingest ..."
+ * @param argc: Argument count (argv[0] is "ingest")
+ * @param argv: Arguments
+ * @return: Process exit code
+ */
+int run_ingest_command(int argc, char* argv[]);
+
+// =============================================================================
+// MARKET DATA SOURCES (in data_source.c)
+// =============================================================================
+
+/**
+ * Open a market data source from a specification:
+ *   "http"        Alpha Vantage, with demo quotes as fallback
+ *   "demo"        Reproducible simulated quotes for the wall clock
+ *   "file:PATH"   A directory of SYMBOL.json responses, or a recording
+ *   "sim[:SEED]"  The synthetic market on its own clock
+ * @param spec: Source specification (NULL or "" = DATA_SOURCE_DEFAULT)
+ * @return: Source (free with data_source_close), NULL on error
+ */
+DataSource* data_source_open(const char* spec);
+
+/**
+ * Close a source and its fallback
+ * @param source: Source to close (may be NULL)
+ */
+void data_source_close(DataSource* source);
+
+/**
+ * Refresh a batch of quotes. Requests beyond the source's quota are not
+ * made and the symbols skipped rotate between calls; the fallback fills
+ * failed requests and skipped symbols that have no quote yet
+ * @param source: Data source
+ * @param stocks: Stocks to refresh, identified by symbol
  * @param count: Number of stocks
- * @param filename: Output JSON file name
- * @return: 1 on success, 0 on failure
+ * @param fetched: Set to 1 for each stock refreshed, 0 otherwise
+ * @return: Number of stocks refreshed
  */
-int generate_json_file(Stock stocks[], int count, const char* filename);
+int data_source_fetch(DataSource* source, Stock stocks[], int count, unsigned char fetched[]);
 
 /**
- * Save trading log with timestamp
- * @param message: Log message to save
- * @param stock: Optional stock data (can be NULL)
- * @return: 1 on success, 0 on failure
+ * Requests left before a source's quota is reached
+ * @param source: Data source
+ * @return: Remaining requests, -1 if unlimited
  */
-int log_trading_activity(const char* message, Stock* stock);
+int data_source_quota_remaining(DataSource* source);
+
+/**
+ * Check a source capability
+ * @param source: Data source
+ * @param capability: DataSourceCapability flag
+ * @return: 1 if the source has it, 0 otherwise
+ */
+int data_source_has(const DataSource* source, DataSourceCapability capability);
+
+/**
+ * Name of a source's provider
+ * @param source: Data source
+ * @return: Provider name ("http", "demo", "file", "sim")
+ */
+const char* data_source_name(const DataSource* source);
+
+// =============================================================================
+// TIME SERIES STREAMING (in series_stream.c)
+// =============================================================================
+
+/**
+ * Start parsing a time-series response for a symbol; bars at or before the
+ * newest bar already stored for it are skipped
+ * @param stream: Parser state
+ * @param store: Store the bars are appended to
+ * @param symbol: Stock symbol
+ * @return: 1 on success, 0 on a bad symbol
+ */
+int series_stream_init(SeriesStream* stream, HistoryStore* store, const char* symbol);
+
+/**
+ * Parse the next bytes of the response; each bar is appended as soon as its
+ * object closes, so blocks can split tokens anywhere
+ * @param stream: Parser state
+ * @param data: Received bytes
+ * @param size: Number of bytes
+ * @return: 1 to continue, 0 if parsing failed (see stream->failed)
+ */
+int series_stream_feed(SeriesStream* stream, const char* data, size_t size);
+
+/**
+ * End the response: check it was a complete time series and sort the bars
+ * (Alpha Vantage lists the newest first). Incomplete responses and API
+ * notices are rolled back
+ * @param stream: Parser state
+ * @return: New bars added, -1 on failure
+ */
+int series_stream_finish(SeriesStream* stream);
+
+/**
+ * Remove every bar the stream added
+ * @param stream: Parser state
+ */
+void series_stream_abort(SeriesStream* stream);
+
+/**
+ * Run "stock_tracker history SYMBOL... [--interval 1min|5min|15min|30min|60min|daily]
+ * [--input FILE.json] [--output FILE.csv|FILE.seg]": download full time series
+ * (or stream a saved response) and merge them into the output file
+ * @param argc: Argument count (argv[0] is "history")
+ * @param argv: Arguments
+ * @return: Process exit code
+ */
+int run_history_command(int argc, char* argv[]);
+
+// =============================================================================
+// ANALYTICAL QUERIES (in query.c)
+// =============================================================================
+
+/**
+ * Run "stock_tracker query <history.csv|FILE.seg> | --synthetic SYMBOLS BARS
+ * [--by day|week|month] [--from TIME] [--to TIME] [--symbols A,B]
+ * [--where FIELD<op>VALUE]... [--sort FIELD] [--desc] [--limit N]
+ * [--columns a,b,c] [--quotes SOURCE] [--format csv|json] [--output FILE]
+ * [--threads N]": screens, rankings, per-period aggregates and indicator
+ * values (SMA 20/50/200, RSI 14 as of each row's last bar), scanned in
+ * parallel; segments are decoded in place from the mapped file
+ * @param argc: Argument count (argv[0] is "query")
+ * @param argv: Arguments
+ * @return: Process exit code
+ */
+int run_query_command(int argc, char* argv[]);
 
 // =============================================================================
 // WEB INTERFACE FUNCTIONS (in web_generator.c)
@@ -257,11 +3025,12 @@ void format_currency(double value, char* buffer, size_t size);
 void format_percentage(double percentage, char* buffer, size_t size);
 
 /**
- * Clean up and validate stock symbol
+ * Clean up and validate stock symbol (uppercased, spaces removed)
  * @param symbol: Input symbol
  * @param clean_symbol: Output cleaned symbol
  * @param size: Size of output buffer
- * @return: 1 if valid, 0 if invalid
+ * @return: 1 if valid (letters, digits, '.' and '-', fitting the buffer),
+ *          0 if invalid
  */
 int validate_stock_symbol(const char* symbol, char* clean_symbol, size_t size);
 
@@ -283,9 +3052,19 @@ void display_error(const char* message);
  */
 void display_success(const char* message);
 
+/**
+ * Change the directory the dashboard JSON files are published to
+ * @param directory: Target directory (default PUBLIC_DATA_DIR)
+ */
+void set_public_data_dir(const char* directory);
+
 int write_all_stocks_json(Stock stocks[], int count);
 int write_best_stock_json(Stock stocks[], int count);
 int write_trending_json(Stock stocks[], int count);
+int write_alerts_json(const AlertEvent events[], int count);
+int write_breadth_json(const BreadthEngine* engine);
+int write_ranked_trending_json(const RankIndex* index);
+int write_unusual_volume_json(const VolumeProfile* profile);
 
 int compare_stock_change(const void* a, const void* b);
 
@@ -303,6 +3082,16 @@ int compare_stock_change(const void* a, const void* b);
 #define SELL_THRESHOLD -1.0         // < -1% loss
 #define STRONG_SELL_THRESHOLD -3.0  // < -3% loss
 
+// Recommendation cutoffs (defaults; override in CONFIG_FILE)
+#define RECOMMEND_STRONG_BUY_CHANGE 3.0
+#define RECOMMEND_STRONG_BUY_VOLUME 1000000.0
+#define RECOMMEND_BUY_CHANGE 1.0
+#define RECOMMEND_BUY_VOLUME 500000.0
+#define RECOMMEND_HOLD_UP_CHANGE 0.5
+#define RECOMMEND_HOLD_FLAT_CHANGE -0.5
+#define RECOMMEND_WATCH_CHANGE -2.0
+#define RECOMMEND_SELL_CHANGE -5.0
+
 // Web interface configuration
 // #define WEB_DIRECTORY "web"
 // #define JSON_DATA_FILE "web/stock_data.json"
@@ -310,9 +3099,118 @@ int compare_stock_change(const void* a, const void* b);
 // #define CSS_FILE "web/style.css"
 // #define JS_FILE "web/app.js"
 
+// Dashboard JSON output directory
+#define PUBLIC_DATA_DIR "/mnt/c/Users/LENOVO/OneDrive/Desktop/SmartStockTrackerUpdate/stock_market/public"
+
 // File paths
 #define LOG_FILE "trading_log.txt"
 #define DATA_FILE "stock_data.txt"
 #define CONFIG_FILE "config.txt"
 
+// Background logger tuning
+#define LOG_RING_CAPACITY 4096      // Records buffered before drops start
+#define LOG_FLUSH_INTERVAL_MS 20    // Writer poll interval when idle
+#define LOG_BATCH_BYTES 65536       // Bytes per batched write()
+
+// Synthetic market data
+#define SIM_DEFAULT_SEED 20251006ULL
+#define SIM_SYMBOLS_PER_CHUNK 256   // Symbols per parallel work item
+
+// Replay output
+#define REPLAY_OUTPUT_DIR "replay_out"
+
+// Backtest configuration
+#define BACKTEST_SYMBOLS_PER_CHUNK 16  // Symbols per parallel work item
+#define SWEEP_SETS_PER_CHUNK 4         // Parameter sets per parallel work item
+#define SWEEP_MAX_SETS 1000000
+
+// Correlation engine
+#define CORRELATION_BLOCK 64           // Symbols per side of a cross-product tile
+#define CORRELATION_TILES_PER_CHUNK 4  // Tiles per parallel work item
+#define CORRELATION_ROWS_PER_CHUNK 32  // Matrix rows per parallel work item in updates
+#define CORRELATION_DEFAULT_WINDOW 252 // One trading year of daily returns
+
+// Risk engine
+#define RISK_DEFAULT_WINDOW 252
+#define RISK_PERIODS_PER_YEAR 252.0    // Daily bars
+#define RISK_CONFIDENCE 0.95
+#define RISK_Z_SCORE 1.6448536         // Standard normal quantile at RISK_CONFIDENCE
+#define RISK_HIGH_VOLATILITY 0.50      // Annualized
+#define RISK_MEDIUM_VOLATILITY 0.25
+#define RISK_SYMBOLS_PER_CHUNK 16      // Symbols per parallel work item
+
+// Price alerts
+#define ALERTS_FILE "alerts.txt"
+#define ALERT_DEDUP_SECONDS 300        // Same rule and symbol fire at most once per window
+#define ALERT_RATE_PER_MINUTE 60       // Sustained delivery rate across all rules
+#define ALERT_BURST 20                 // Deliveries allowed back to back
+
+// Portfolio holdings
+#define PORTFOLIO_FILE "portfolio.csv"
+
+// Trading session (seconds after midnight UTC; 9:30-16:00 ET under daylight time)
+#define SESSION_OPEN_UTC 48600
+#define SESSION_CLOSE_UTC 72000
+
+// Intraday bars
+#define BARS_FILE "bars_1m.csv"        // Closed 1-minute bars written at exit
+
+// Fetch resilience
+#define FETCH_CONNECT_TIMEOUT_MS 2000         // TCP and TLS connect
+#define FETCH_TIMEOUT_MS 10000                // Whole attempt
+#define FETCH_LOW_SPEED_BYTES 100             // Abort transfers slower than this (bytes/s)...
+#define FETCH_LOW_SPEED_SECONDS 5             // ...for this long
+#define FETCH_MAX_ATTEMPTS 3
+#define FETCH_BACKOFF_BASE_MS 200             // Retry n waits up to base * 2^n (full jitter)
+#define FETCH_BACKOFF_MAX_MS 2000
+#define FETCH_HEDGE_PERCENTILE 95.0           // Hedge requests slower than this percentile
+#define FETCH_HEDGE_MIN_SAMPLES 20            // Successful requests seen before hedging starts
+#define FETCH_LATENCY_WINDOW 128              // Recent latencies the percentile is taken over
+#define FETCH_BREAKER_FAILURES 5              // Consecutive failures that open a host's circuit
+#define FETCH_BREAKER_COOLDOWN_SECONDS 30     // Open circuits allow a trial request after this
+#define FETCH_STALE_SECONDS 900               // Oldest last-good quote served during failures
+#define FETCH_MAX_HOSTS 8
+#define FETCH_MAX_HOST_CONNECTIONS 4          // Pooled connections per host (HTTP/2 multiplexes over one)
+#define FETCH_DNS_CACHE_SECONDS 300
+#define FETCH_USER_AGENT "smart-stock-tracker/1.0"
+#define FETCH_HISTORY_TIMEOUT_MS 120000       // Whole attempt for a full time-series download
+
+// Partitioned analytics
+#define ANALYSIS_CHUNK_STOCKS 1024            // Stocks per partition (~200 KB of Stock records, about an L2)
+
+// Analytical queries
+#define QUERY_UNIT_BARS 65536                 // Bars of an in-memory series per parallel work unit
+#define QUERY_UNIT_BLOCKS 64                  // Segment blocks per parallel work unit
+
+// Bulk history ingest
+#define HISTORY_INGEST_CHUNK_BYTES (4 << 20)  // CSV bytes per parallel parse chunk
+
+// Market data sources
+#define DATA_SOURCE_DEFAULT "http"            // Used when no --source is given
+#define DATA_SOURCE_HTTP_PER_MINUTE 5         // Alpha Vantage free tier; raise for a premium key (0 = unlimited)
+#define DATA_SOURCE_HTTP_PER_DAY 25
+#define DATA_SOURCE_SIM_TICK_SECONDS 60       // Simulated time per fetch from the sim source
+
+// Compressed history
+#define HISTORY_SEGMENT_EXTENSION ".seg"      // history_store_open() decodes files with this suffix
+#define HISTORY_SEGMENT_FILE "history.seg"    // Default output of the compress command
+#define HISTORY_MAX_DECIMALS 6                // Most decimals tried for scaled-integer prices
+
+// Unusual volume
+#define VOLUME_BUCKET_SECONDS 1800     // One baseline per half hour of the session
+#define VOLUME_EWMA_ALPHA 0.1          // Weight of the newest observation in a slot baseline
+#define VOLUME_MIN_SAMPLES 10          // Observations in a slot before z-scores are reported
+#define VOLUME_MIN_STDDEV 0.1          // Floor on the log-rate deviation
+#define VOLUME_SKETCH_GAMMA 1.25       // Ratio between sketch bin edges
+#define VOLUME_SKETCH_WINDOW 4096      // Sketch counts are halved at this total
+#define VOLUME_TOP_SYMBOLS 10          // Entries in unusual_volume.json
+
+// Market breadth
+#define BREADTH_FILE "groups.csv"     // symbol,sector,industry,index;index,high_52w,low_52w
+#define BREADTH_SHOWN_GROUPS 8        // Groups listed in the analysis view
+
+// Metrics output
+#define METRICS_FILE "metrics.prom"
+#define METRICS_SUMMARY_INTERVAL 60  // Seconds between summary lines
+
 #endif // STOCK_TRACKER_H
\ No newline at end of file
@@ -0,0 +1,120 @@
+/*
+ * Smart Stock Tracker - Symbol Map
+ * Open-addressing hash map from stock symbol to a dense integer id
+ * Author: [Your Name]
+ * Date: October 2025
+ */
+
+#include "stock_tracker.h"
+
+// Rebuild the slot table at a new capacity
+static int symbol_map_rehash(SymbolMap* map, int new_capacity) {
+    int* slots = malloc((size_t)new_capacity * sizeof(int));
+    if (!slots) {
+        return 0;
+    }
+    memset(slots, -1, (size_t)new_capacity * sizeof(int));
+
+    for (int id = 0; id < map->count; id++) {
+        unsigned long long h = sim_symbol_hash(map->symbols[id]);
+        int pos = (int)(h & (unsigned long long)(new_capacity - 1));
+        while (slots[pos] >= 0) {
+            pos = (pos + 1) & (new_capacity - 1);
+        }
+        slots[pos] = id;
+    }
+
+    free(map->slots);
+    map->slots = slots;
+    map->slot_capacity = new_capacity;
+    return 1;
+}
+
+// Initialize an empty map
+int symbol_map_init(SymbolMap* map, int expected_symbols) {
+    if (!map) {
+        return 0;
+    }
+    memset(map, 0, sizeof(*map));
+
+    int capacity = 64;
+    while (capacity < expected_symbols * 2) {
+        capacity <<= 1;
+    }
+    map->symbol_capacity = expected_symbols > 16 ? expected_symbols : 16;
+    map->symbols = malloc((size_t)map->symbol_capacity * sizeof(*map->symbols));
+    if (!map->symbols || !symbol_map_rehash(map, capacity)) {
+        symbol_map_free(map);
+        return 0;
+    }
+    return 1;
+}
+
+// Release the map's memory
+void symbol_map_free(SymbolMap* map) {
+    if (!map) {
+        return;
+    }
+    free(map->slots);
+    free(map->symbols);
+    memset(map, 0, sizeof(*map));
+}
+
+// Look up a symbol; returns its id or -1 if absent
+int symbol_map_find(const SymbolMap* map, const char* symbol) {
+    if (!map || !symbol || !map->slots) {
+        return -1;
+    }
+    unsigned long long h = sim_symbol_hash(symbol);
+    int pos = (int)(h & (unsigned long long)(map->slot_capacity - 1));
+    while (map->slots[pos] >= 0) {
+        int id = map->slots[pos];
+        if (strcmp(map->symbols[id], symbol) == 0) {
+            return id;
+        }
+        pos = (pos + 1) & (map->slot_capacity - 1);
+    }
+    return -1;
+}
+
+// Look up a symbol, adding it if absent; returns its id or -1 on failure
+int symbol_map_insert(SymbolMap* map, const char* symbol) {
+    int id = symbol_map_find(map, symbol);
+    if (id >= 0 || !map || !symbol) {
+        return id;
+    }
+
+    if (map->count == map->symbol_capacity) {
+        int new_capacity = map->symbol_capacity * 2;
+        void* grown = realloc(map->symbols, (size_t)new_capacity * sizeof(*map->symbols));
+        if (!grown) {
+            return -1;
+        }
+        map->symbols = grown;
+        map->symbol_capacity = new_capacity;
+    }
+    if ((map->count + 1) * 2 > map->slot_capacity &&
+        !symbol_map_rehash(map, map->slot_capacity * 2)) {
+        return -1;
+    }
+
+    id = map->count++;
+    strncpy(map->symbols[id], symbol, MAX_SYMBOL_LENGTH - 1);
+    map->symbols[id][MAX_SYMBOL_LENGTH - 1] = '\0';
+
+    unsigned long long h = sim_symbol_hash(map->symbols[id]);
+    int pos = (int)(h & (unsigned long long)(map->slot_capacity - 1));
+    while (map->slots[pos] >= 0) {
+        pos = (pos + 1) & (map->slot_capacity - 1);
+    }
+    map->slots[pos] = id;
+    return id;
+}
+
+// Symbol string for an id
+const char* symbol_map_name(const SymbolMap* map, int id) {
+    if (!map || id < 0 || id >= map->count) {
+        return NULL;
+    }
+    return map->symbols[id];
+}
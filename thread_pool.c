@@ -0,0 +1,114 @@
+/*
+ * Smart Stock Tracker - Parallel Loops
+ * Splits index ranges into chunks processed by a set of worker threads
+ * Author: [Your Name]
+ * Date: October 2025
+ */
+
+#include "stock_tracker.h"
+#include <pthread.h>
+#include <unistd.h>
+
+// Shared state of one parallel_for call
+typedef struct {
+    ParallelTask task;
+    void* context;
+    int item_count;
+    int chunk_size;
+    int next_chunk;           // Claimed with an atomic add
+} ParallelJob;
+
+typedef struct {
+    ParallelJob* job;
+    int worker;
+} ParallelWorker;
+
+// Worker loop: claim chunks until the range is exhausted
+static void* parallel_worker_main(void* arg) {
+    ParallelWorker* worker = (ParallelWorker*)arg;
+    ParallelJob* job = worker->job;
+
+    for (;;) {
+        int chunk = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+        long long begin = (long long)chunk * job->chunk_size;
+        if (begin >= job->item_count) {
+            break;
+        }
+        long long end = begin + job->chunk_size;
+        if (end > job->item_count) {
+            end = job->item_count;
+        }
+        job->task((int)begin, (int)end, worker->worker, job->context);
+    }
+    return NULL;
+}
+
+// Number of worker threads to use by default
+int parallel_default_threads() {
+    const char* env = getenv("STOCK_THREADS");
+    if (env && atoi(env) > 0) {
+        return atoi(env);
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) {
+        cpus = 1;
+    }
+    if (cpus > PARALLEL_MAX_THREADS) {
+        cpus = PARALLEL_MAX_THREADS;
+    }
+    return (int)cpus;
+}
+
+// Run task over [0, item_count) in chunks on up to thread_count threads
+int parallel_for(int item_count, int chunk_size, int thread_count,
+                 ParallelTask task, void* context) {
+    if (!task || item_count <= 0) {
+        return 0;
+    }
+    if (chunk_size <= 0) {
+        chunk_size = 1;
+    }
+    if (thread_count <= 0) {
+        thread_count = parallel_default_threads();
+    }
+    if (thread_count > PARALLEL_MAX_THREADS) {
+        thread_count = PARALLEL_MAX_THREADS;
+    }
+
+    int chunk_count = (item_count + chunk_size - 1) / chunk_size;
+    if (thread_count > chunk_count) {
+        thread_count = chunk_count;
+    }
+
+    ParallelJob job;
+    job.task = task;
+    job.context = context;
+    job.item_count = item_count;
+    job.chunk_size = chunk_size;
+    job.next_chunk = 0;
+
+    ParallelWorker workers[PARALLEL_MAX_THREADS];
+    pthread_t threads[PARALLEL_MAX_THREADS];
+    int started = 0;
+
+    // Worker 0 is the calling thread; the rest are spawned
+    for (int i = 1; i < thread_count; i++) {
+        workers[i].job = &job;
+        workers[i].worker = i;
+        if (pthread_create(&threads[i], NULL, parallel_worker_main, &workers[i]) != 0) {
+            break;  // Run with fewer threads rather than fail
+        }
+        started = i;
+    }
+
+    workers[0].job = &job;
+    workers[0].worker = 0;
+    parallel_worker_main(&workers[0]);
+
+    for (int i = 1; i <= started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    return started + 1;
+}
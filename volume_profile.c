@@ -0,0 +1,326 @@
+/*
+ * Smart Stock Tracker - Volume Profile
+ * Streaming time-of-day volume baselines and mergeable quantile sketches
+ * Author: [Your Name]
+ * Date: October 2025
+ *
+ * find_unusual_volume_stock() returns the largest absolute volume, which
+ * is always a mega-cap. Here every symbol is compared with itself: the
+ * volume traded since its previous quote becomes a rate (shares per
+ * minute), and the rate's log is scored against an exponentially weighted
+ * mean and variance kept for that half hour of the session, since volume
+ * is U-shaped through the day. A log-bucketed sketch of past rates gives a
+ * percentile as well. State per symbol is fixed size, an update is O(1),
+ * and shards built over different symbols or days merge by adding counts.
+ */
+
+#include "stock_tracker.h"
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+
+#define SECONDS_PER_DAY 86400LL
+
+// Time-of-day slot of a Unix time, clamped to the session
+static int volume_bucket(long long when) {
+    long long second_of_day = ((when % SECONDS_PER_DAY) + SECONDS_PER_DAY) % SECONDS_PER_DAY;
+    long long bucket = (second_of_day - SESSION_OPEN_UTC) / VOLUME_BUCKET_SECONDS;
+    if (second_of_day < SESSION_OPEN_UTC || bucket < 0) {
+        return 0;
+    }
+    return bucket >= VOLUME_BUCKETS ? VOLUME_BUCKETS - 1 : (int)bucket;
+}
+
+// Sketch bin of a rate: bin 0 holds rates below 1, bin i holds [gamma^(i-1), gamma^i)
+static int sketch_bin(double rate) {
+    if (!(rate >= 1.0)) {
+        return 0;
+    }
+    int bin = (int)(log(rate) / log(VOLUME_SKETCH_GAMMA)) + 1;
+    return bin >= VOLUME_SKETCH_BINS ? VOLUME_SKETCH_BINS - 1 : bin;
+}
+
+// Halve every count so recent rates dominate and the counts stay bounded
+static void sketch_decay(VolumeSketch* sketch) {
+    sketch->total = 0;
+    for (int b = 0; b < VOLUME_SKETCH_BINS; b++) {
+        sketch->counts[b] >>= 1;
+        sketch->total += sketch->counts[b];
+    }
+}
+
+// Add a rate to a sketch
+void volume_sketch_add(VolumeSketch* sketch, double rate) {
+    if (!sketch) {
+        return;
+    }
+    sketch->counts[sketch_bin(rate)]++;
+    if (++sketch->total >= VOLUME_SKETCH_WINDOW) {
+        sketch_decay(sketch);
+    }
+}
+
+// Add one sketch's counts to another
+void volume_sketch_merge(VolumeSketch* into, const VolumeSketch* from) {
+    if (!into || !from) {
+        return;
+    }
+    for (int b = 0; b < VOLUME_SKETCH_BINS; b++) {
+        into->counts[b] += from->counts[b];
+    }
+    into->total += from->total;
+    while (into->total >= VOLUME_SKETCH_WINDOW) {
+        sketch_decay(into);
+    }
+}
+
+// Share of rates below a value; a rate's own bin counts as half below
+double volume_sketch_percentile(const VolumeSketch* sketch, double rate) {
+    if (!sketch || sketch->total == 0) {
+        return -1.0;
+    }
+    int bin = sketch_bin(rate);
+    unsigned int below = 0;
+    for (int b = 0; b < bin; b++) {
+        below += sketch->counts[b];
+    }
+    return 100.0 * (below + 0.5 * sketch->counts[bin]) / sketch->total;
+}
+
+// Approximate rate at a quantile (geometric middle of the bin it falls in)
+double volume_sketch_quantile(const VolumeSketch* sketch, double percentile) {
+    if (!sketch || sketch->total == 0) {
+        return 0.0;
+    }
+    double target = percentile / 100.0 * sketch->total;
+    unsigned int seen = 0;
+    int bin = 0;
+    for (; bin < VOLUME_SKETCH_BINS - 1; bin++) {
+        seen += sketch->counts[bin];
+        if (seen > target) {
+            break;
+        }
+    }
+    return bin == 0 ? 0.0 : pow(VOLUME_SKETCH_GAMMA, bin - 0.5);
+}
+
+// Grow the per-symbol states to cover every id in the symbol map
+static int volume_profile_reserve(VolumeProfile* profile, int count) {
+    if (count <= profile->capacity) {
+        return 1;
+    }
+    int new_capacity = profile->capacity ? profile->capacity : 64;
+    while (new_capacity < count) {
+        new_capacity *= 2;
+    }
+    VolumeSymbol* grown = realloc(profile->states, (size_t)new_capacity * sizeof(VolumeSymbol));
+    if (!grown) {
+        return 0;
+    }
+    memset(&grown[profile->capacity], 0, (size_t)(new_capacity - profile->capacity) * sizeof(VolumeSymbol));
+    profile->states = grown;
+    profile->capacity = new_capacity;
+    return 1;
+}
+
+// State of a symbol, added if it is new
+static VolumeSymbol* volume_symbol(VolumeProfile* profile, const char* symbol) {
+    if (!symbol || !symbol[0] || strlen(symbol) >= MAX_SYMBOL_LENGTH) {
+        return NULL;
+    }
+    int id = symbol_map_insert(&profile->symbols, symbol);
+    if (id < 0 || !volume_profile_reserve(profile, id + 1)) {
+        return NULL;
+    }
+    return &profile->states[id];
+}
+
+// Initialize an empty profile
+int volume_profile_init(VolumeProfile* profile, int expected_symbols) {
+    if (!profile) {
+        return 0;
+    }
+    memset(profile, 0, sizeof(*profile));
+    if (!symbol_map_init(&profile->symbols, expected_symbols) ||
+        !volume_profile_reserve(profile, expected_symbols > 0 ? expected_symbols : 1)) {
+        volume_profile_free(profile);
+        return 0;
+    }
+    return 1;
+}
+
+// Release the profile's memory
+void volume_profile_free(VolumeProfile* profile) {
+    if (!profile) {
+        return;
+    }
+    free(profile->states);
+    symbol_map_free(&profile->symbols);
+    memset(profile, 0, sizeof(*profile));
+}
+
+// Score an interval against its slot baseline, then learn from it
+int volume_profile_observe(VolumeProfile* profile, const char* symbol, double volume,
+                           double seconds, long long when, VolumeScore* score) {
+    if (!profile || volume < 0 || seconds <= 0) {
+        return 0;
+    }
+    VolumeSymbol* state = volume_symbol(profile, symbol);
+    if (!state) {
+        return 0;
+    }
+
+    VolumeScore result;
+    result.rate = volume * 60.0 / seconds;
+    result.bucket = volume_bucket(when);
+    result.time = when;
+
+    // Score against what was known before this interval
+    VolumeBaseline* baseline = &state->buckets[result.bucket];
+    double x = log1p(result.rate);
+    result.expected = baseline->samples > 0 ? expm1(baseline->mean) : 0.0;
+    result.z_score = 0.0;
+    if (baseline->samples >= VOLUME_MIN_SAMPLES) {
+        double deviation = sqrt(baseline->variance);
+        result.z_score = (x - baseline->mean) / (deviation > VOLUME_MIN_STDDEV ? deviation : VOLUME_MIN_STDDEV);
+    }
+    result.percentile = volume_sketch_percentile(&state->sketch, result.rate);
+
+    // Exponentially weighted mean and variance of the log rate
+    if (baseline->samples == 0) {
+        baseline->mean = x;
+        baseline->variance = 0.0;
+    } else {
+        double diff = x - baseline->mean;
+        double increment = VOLUME_EWMA_ALPHA * diff;
+        baseline->mean += increment;
+        baseline->variance = (1.0 - VOLUME_EWMA_ALPHA) * (baseline->variance + diff * increment);
+    }
+    if (baseline->samples < UINT_MAX) {
+        baseline->samples++;
+    }
+    volume_sketch_add(&state->sketch, result.rate);
+
+    state->last = result;
+    if (score) {
+        *score = result;
+    }
+    return 1;
+}
+
+// Score the volume a quote added since the symbol's previous quote
+int volume_profile_update(VolumeProfile* profile, const Stock* stock, VolumeScore* score) {
+    if (!profile || !stock || stock->current_price <= 0 || stock->volume < 0) {
+        return 0;
+    }
+    VolumeSymbol* state = volume_symbol(profile, stock->symbol);
+    if (!state) {
+        return 0;
+    }
+
+    long long when = stock->last_update > 0 ? (long long)stock->last_update : (long long)time(NULL);
+    long long day = when / SECONDS_PER_DAY;
+    double volume, seconds;
+    if (state->last_time == 0 || state->last_time / SECONDS_PER_DAY != day ||
+        stock->volume < state->last_cumulative) {
+        // First quote of a session: everything since the open
+        volume = stock->volume;
+        seconds = (double)(when - (day * SECONDS_PER_DAY + SESSION_OPEN_UTC));
+        if (seconds < 60.0) {
+            seconds = 60.0;
+        }
+    } else {
+        volume = stock->volume - state->last_cumulative;
+        seconds = (double)(when - state->last_time);
+        if (volume <= 0 || seconds <= 0) {
+            return 0;  // Same quote again; its volume joins the next interval
+        }
+    }
+
+    state->last_cumulative = stock->volume;
+    state->last_time = when;
+    if (volume <= 0) {
+        return 0;
+    }
+    return volume_profile_observe(profile, stock->symbol, volume, seconds, when, score);
+}
+
+// Highest latest z-scores, kept sorted in ids[] while scanning
+int volume_profile_top(const VolumeProfile* profile, int count, int ids[]) {
+    if (!profile || !ids || count <= 0) {
+        return 0;
+    }
+    int written = 0;
+    for (int id = 0; id < profile->symbols.count; id++) {
+        const VolumeScore* candidate = &profile->states[id].last;
+        if (candidate->time == 0) {
+            continue;
+        }
+        if (written == count && candidate->z_score <= profile->states[ids[written - 1]].last.z_score) {
+            continue;
+        }
+        int slot = written < count ? written++ : count - 1;
+        while (slot > 0 && profile->states[ids[slot - 1]].last.z_score < candidate->z_score) {
+            ids[slot] = ids[slot - 1];
+            slot--;
+        }
+        ids[slot] = id;
+    }
+    return written;
+}
+
+// Latest score of a symbol id
+const VolumeScore* volume_profile_score(const VolumeProfile* profile, int id) {
+    if (!profile || id < 0 || id >= profile->symbols.count) {
+        return NULL;
+    }
+    return &profile->states[id].last;
+}
+
+// Symbol for an id
+const char* volume_profile_name(const VolumeProfile* profile, int id) {
+    return profile ? symbol_map_name(&profile->symbols, id) : NULL;
+}
+
+// Pool two slot baselines as if their samples had been seen together
+static void baseline_merge(VolumeBaseline* into, const VolumeBaseline* from) {
+    if (from->samples == 0) {
+        return;
+    }
+    if (into->samples == 0) {
+        *into = *from;
+        return;
+    }
+    double total = (double)into->samples + from->samples;
+    double w = from->samples / total;
+    double diff = from->mean - into->mean;
+    into->mean += w * diff;
+    into->variance = (1.0 - w) * into->variance + w * from->variance + w * (1.0 - w) * diff * diff;
+    into->samples = total > UINT_MAX ? UINT_MAX : (unsigned int)total;
+}
+
+// Merge another shard into a profile
+int volume_profile_merge(VolumeProfile* into, const VolumeProfile* from) {
+    if (!into || !from) {
+        return 0;
+    }
+    for (int id = 0; id < from->symbols.count; id++) {
+        const VolumeSymbol* source = &from->states[id];
+        VolumeSymbol* target = volume_symbol(into, symbol_map_name(&from->symbols, id));
+        if (!target) {
+            return 0;
+        }
+        for (int b = 0; b < VOLUME_BUCKETS; b++) {
+            baseline_merge(&target->buckets[b], &source->buckets[b]);
+        }
+        volume_sketch_merge(&target->sketch, &source->sketch);
+        if (source->last.time > target->last.time) {
+            target->last = source->last;
+        }
+        if (source->last_time > target->last_time) {
+            target->last_time = source->last_time;
+            target->last_cumulative = source->last_cumulative;
+        }
+    }
+    return 1;
+}